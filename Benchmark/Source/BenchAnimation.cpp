@@ -0,0 +1,279 @@
+#include "Benchmark.h"
+#include "Assets/SkeletalMesh.h"
+#include "Nodes/3D/SkeletalMesh3d.h"
+#include "AssetManager.h"
+#include "Stream.h"
+#include "Utilities.h"
+#include "Log.h"
+
+// Animates 500 characters with 60 bones each on long clips, which is where a linear key search
+// per channel used to dominate. Times normal playback (key cursors) and random seeks (binary search),
+// and checks that both reach the same pose.
+
+static const uint32_t kNumCharacters = 500;
+static const uint32_t kNumBones = 60;
+static const uint32_t kClipKeys = 2000;
+static const float kTicksPerSecond = 60.0f;
+
+static glm::vec3 KeyPosition(uint32_t bone, float t)
+{
+    return glm::vec3(sinf(t * 0.05f + bone), cosf(t * 0.03f + bone * 0.5f), sinf(t * 0.07f) * 0.5f);
+}
+
+static glm::quat KeyRotation(uint32_t bone, float t)
+{
+    glm::vec3 axis = glm::normalize(glm::vec3(1.0f, float(bone % 3), 0.5f));
+    return glm::angleAxis(sinf(t * 0.04f + bone) * 1.5f, axis);
+}
+
+static glm::vec3 KeyScale(uint32_t bone, float t)
+{
+    return glm::vec3(1.0f + 0.1f * sinf(t * 0.02f + bone));
+}
+
+static void WriteClip(Stream& stream, const char* name, uint32_t numKeys)
+{
+    stream.WriteString(name);
+    stream.WriteFloat(float(numKeys - 1)); // Duration in ticks
+    stream.WriteFloat(kTicksPerSecond);
+    stream.WriteUint32(kNumBones);
+
+    for (uint32_t bone = 0; bone < kNumBones; ++bone)
+    {
+        stream.WriteInt32(int32_t(bone));
+
+        // Mocap style clips have a key every tick. Give each track a different count
+        // so their cursors don't all move in step.
+        uint32_t numPositionKeys = numKeys;
+        uint32_t numRotationKeys = numKeys - (bone % 7) * (numKeys / 16);
+        uint32_t numScaleKeys = glm::max(numKeys / 8, 2u);
+        float duration = float(numKeys - 1);
+
+        stream.WriteUint32(numPositionKeys);
+        for (uint32_t k = 0; k < numPositionKeys; ++k)
+        {
+            float t = duration * k / (numPositionKeys - 1);
+            stream.WriteFloat(t);
+            stream.WriteVec3(KeyPosition(bone, t));
+        }
+
+        stream.WriteUint32(numRotationKeys);
+        for (uint32_t k = 0; k < numRotationKeys; ++k)
+        {
+            float t = duration * k / (numRotationKeys - 1);
+            stream.WriteFloat(t);
+            stream.WriteQuat(KeyRotation(bone, t));
+        }
+
+        stream.WriteUint32(numScaleKeys);
+        for (uint32_t k = 0; k < numScaleKeys; ++k)
+        {
+            float t = duration * k / (numScaleKeys - 1);
+            stream.WriteFloat(t);
+            stream.WriteVec3(KeyScale(bone, t));
+        }
+    }
+
+    stream.WriteUint32(0); // Event tracks
+}
+
+// Builds the mesh from a stream in the pre-compression format, which still loads and
+// doesn't need the editor's importer or the cooked vertex blocks.
+static SkeletalMesh* CreateBenchMesh()
+{
+    Stream stream;
+    stream.WriteUint32(ASSET_MAGIC_NUMBER);
+    stream.WriteUint32(ASSET_VERSION_COMPRESSION);
+    stream.WriteUint32(uint32_t(SkeletalMesh::GetStaticType()));
+    stream.WriteUint8(0); // Embedded
+    stream.WriteUint8(uint8_t(AssetCompression::None));
+    stream.WriteUint8(0); // Compressed
+    stream.WriteString("SK_BenchCharacter");
+
+    // One triangle per bone.
+    const uint32_t numVertices = kNumBones * 3;
+    stream.WriteUint32(numVertices);
+    stream.WriteUint32(numVertices);
+    stream.WriteString(""); // Material
+    stream.WriteString(""); // Animation lookup mesh
+    stream.WriteMatrix(glm::mat4(1.0f));
+
+    stream.WriteUint32(kNumBones);
+    for (uint32_t bone = 0; bone < kNumBones; ++bone)
+    {
+        stream.WriteString("Bone" + std::to_string(bone));
+        stream.WriteInt32(int32_t(bone));
+        stream.WriteInt32((bone == 0) ? -1 : int32_t((bone - 1) / 2));
+        stream.WriteMatrix(glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, -float(bone) * 0.1f, 0.0f)));
+    }
+
+    stream.WriteUint32(2);
+    WriteClip(stream, "Run", kClipKeys);
+    WriteClip(stream, "Idle", kClipKeys / 10);
+
+    for (uint32_t v = 0; v < numVertices; ++v)
+    {
+        stream.WriteVec3(glm::vec3(float(v % 3), float(v / 3) * 0.1f, 0.0f));
+        stream.WriteVec2(glm::vec2(0.0f));
+        stream.WriteVec3(glm::vec3(0.0f, 0.0f, 1.0f));
+
+        for (uint32_t b = 0; b < MAX_BONE_INFLUENCES; ++b)
+        {
+            stream.WriteUint8(uint8_t((v / 3 + b) % kNumBones));
+        }
+
+        for (uint32_t b = 0; b < MAX_BONE_INFLUENCES; ++b)
+        {
+            stream.WriteFloat(1.0f / MAX_BONE_INFLUENCES);
+        }
+    }
+
+    for (uint32_t i = 0; i < numVertices; ++i)
+    {
+        stream.WriteUint32(i);
+    }
+
+    stream.WriteVec3(glm::vec3(0.0f));
+    stream.WriteFloat(10.0f); // Bounds radius
+    stream.WriteFloat(1.1f); // Bounds scale
+
+    SkeletalMesh* mesh = NewTransientAsset<SkeletalMesh>();
+    stream.SetPos(0);
+    mesh->LoadStream(stream, GetPlatform());
+    mesh->Create();
+    return mesh;
+}
+
+static void AnimateFrame(std::vector<SkeletalMesh3D*>& characters, float deltaTime)
+{
+    for (uint32_t i = 0; i < characters.size(); ++i)
+    {
+        characters[i]->UpdateAnimation(deltaTime, true);
+    }
+}
+
+// UpdateAnimation() only runs once per tick, so clear that flag outside of the timed loops.
+static void BeginFrame(std::vector<SkeletalMesh3D*>& characters)
+{
+    for (uint32_t i = 0; i < characters.size(); ++i)
+    {
+        characters[i]->Tick(0.0f);
+    }
+}
+
+static bool PosesMatch(SkeletalMesh3D* a, SkeletalMesh3D* b)
+{
+    for (uint32_t bone = 0; bone < kNumBones; ++bone)
+    {
+        if (a->GetBoneTransform(int32_t(bone)) != b->GetBoneTransform(int32_t(bone)))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static void CheckSeekMatchesPlayback(SkeletalMesh* mesh)
+{
+    SkeletalMesh3D* played = Node::Construct<SkeletalMesh3D>();
+    SkeletalMesh3D* seeked = Node::Construct<SkeletalMesh3D>();
+    played->SetSkeletalMesh(mesh);
+    seeked->SetSkeletalMesh(mesh);
+
+    // Forward playback steps the cursors. Seeking straight to the same time uses the binary search.
+    // Backwards playback wraps around the start of the clip.
+    const float kSpeeds[] = { 1.0f, -1.0f, 3.7f };
+
+    for (float speed : kSpeeds)
+    {
+        played->StopAllAnimations();
+        seeked->StopAllAnimations();
+        played->PlayAnimation("Run", true, speed);
+        seeked->PlayAnimation("Run", true, speed);
+
+        const float deltaTime = 1.0f / 60.0f;
+        const uint32_t numFrames = 300;
+
+        for (uint32_t f = 0; f < numFrames; ++f)
+        {
+            played->Tick(0.0f);
+            played->UpdateAnimation(deltaTime, true);
+        }
+
+        seeked->Tick(0.0f);
+        seeked->FindActiveAnimation("Run")->mTime = played->FindActiveAnimation("Run")->mTime;
+        seeked->UpdateAnimation(0.0f, true);
+
+        BenchCheck(PosesMatch(played, seeked), "Animation: pose after playback at speed %.1f differs from seeking to the same time", speed);
+    }
+
+    Node::Destruct(played);
+    Node::Destruct(seeked);
+}
+
+void BenchAnimation()
+{
+    SkeletalMesh* mesh = CreateBenchMesh();
+    BenchCheck(mesh->GetNumBones() == kNumBones && mesh->GetAnimations().size() == 2, "Animation: benchmark mesh failed to load");
+
+    CheckSeekMatchesPlayback(mesh);
+
+    std::vector<SkeletalMesh3D*> characters(kNumCharacters);
+    BenchRandom random(7);
+
+    for (uint32_t i = 0; i < kNumCharacters; ++i)
+    {
+        characters[i] = Node::Construct<SkeletalMesh3D>();
+        characters[i]->SetSkeletalMesh(mesh);
+        characters[i]->PlayAnimation("Run", true, random.NextFloat(0.8f, 1.2f));
+
+        // A blend on some characters, so they sample two clips.
+        if (i % 4 == 0)
+        {
+            characters[i]->PlayAnimation("Idle", true, 1.0f, 0.5f);
+        }
+    }
+
+    const uint32_t kNumFrames = 120;
+    const float kDeltaTime = 1.0f / 60.0f;
+    uint64_t playbackTime = 0;
+    uint64_t seekTime = 0;
+
+    for (uint32_t f = 0; f < kNumFrames; ++f)
+    {
+        BeginFrame(characters);
+        uint64_t startTime = SYS_GetTimeMicroseconds();
+        AnimateFrame(characters, kDeltaTime);
+        playbackTime += SYS_GetTimeMicroseconds() - startTime;
+    }
+
+    for (uint32_t f = 0; f < kNumFrames; ++f)
+    {
+        BeginFrame(characters);
+
+        // Jump every character to a random time, as if scrubbing or starting new clips.
+        for (uint32_t i = 0; i < kNumCharacters; ++i)
+        {
+            characters[i]->FindActiveAnimation("Run")->mTime = random.NextFloat(0.0f, (kClipKeys - 1) / kTicksPerSecond);
+        }
+
+        uint64_t startTime = SYS_GetTimeMicroseconds();
+        AnimateFrame(characters, 0.0f);
+        seekTime += SYS_GetTimeMicroseconds() - startTime;
+    }
+
+    double playbackMs = playbackTime / 1000.0 / kNumFrames;
+    double seekMs = seekTime / 1000.0 / kNumFrames;
+    double numChannels = double(kNumCharacters) * kNumBones * 1.25;
+
+    LogDebug("%u characters x %u bones, %u key clips: playback %.2f ms/frame (%.0f ns/channel), seek %.2f ms/frame (%.0f ns/channel)",
+        kNumCharacters, kNumBones, kClipKeys,
+        playbackMs, playbackMs * 1e6 / numChannels,
+        seekMs, seekMs * 1e6 / numChannels);
+
+    for (uint32_t i = 0; i < kNumCharacters; ++i)
+    {
+        Node::Destruct(characters[i]);
+    }
+}
@@ -0,0 +1,305 @@
+#if PLATFORM_LINUX
+
+#include "Benchmark.h"
+#include "Audio/AudioMixer.h"
+#include "Log.h"
+#include "Maths.h"
+
+#include <string.h>
+
+// Renders synthetic voices through the software mixer without an audio device, so results
+// don't depend on ALSA timing. Checks the mixer against a per-frame reference first.
+
+static const uint32_t kRenderFrames = 512;
+
+struct BenchWave
+{
+    std::vector<uint8_t> mData;
+    uint32_t mNumFrames = 0;
+    uint32_t mNumChannels = 2;
+    uint32_t mBytesPerSample = 2;
+    int32_t mSampleRate = AUDIO_OUTPUT_RATE;
+};
+
+static void GenerateWave(BenchWave& wave, uint32_t numFrames, uint32_t numChannels, uint32_t bytesPerSample, int32_t sampleRate, uint32_t seed)
+{
+    BenchRandom random(seed);
+    float frequency = random.NextFloat(110.0f, 880.0f);
+
+    wave.mNumFrames = numFrames;
+    wave.mNumChannels = numChannels;
+    wave.mBytesPerSample = bytesPerSample;
+    wave.mSampleRate = sampleRate;
+    wave.mData.resize(numFrames * numChannels * bytesPerSample);
+
+    for (uint32_t f = 0; f < numFrames; ++f)
+    {
+        for (uint32_t c = 0; c < numChannels; ++c)
+        {
+            float phase = 2.0f * PI * frequency * (c + 1) * f / float(sampleRate);
+            float value = sinf(phase) * 0.8f + random.NextFloat(-0.1f, 0.1f);
+            uint32_t sample = f * numChannels + c;
+
+            if (bytesPerSample == 1)
+            {
+                wave.mData[sample] = uint8_t(glm::clamp(value * 127.0f + 128.0f, 0.0f, 255.0f));
+            }
+            else
+            {
+                int16_t value16 = int16_t(value * 32000.0f);
+                memcpy(&wave.mData[sample * 2], &value16, sizeof(value16));
+            }
+        }
+    }
+}
+
+static SoundVoice MakeVoice(BenchWave& wave, float pitch, float volumeL, float volumeR, bool loop)
+{
+    SoundVoice voice;
+    voice.mSampleRate = wave.mSampleRate;
+    voice.mPitch = pitch;
+    voice.mVolumeL = volumeL;
+    voice.mVolumeR = volumeR;
+    voice.mSrcBuffer = wave.mData.data();
+    voice.mSrcBufferLen = uint32_t(wave.mData.size());
+    voice.mSrcFrames = wave.mNumFrames;
+    voice.mNumChannels = wave.mNumChannels;
+    voice.mBytesPerSample = wave.mBytesPerSample;
+    voice.mLoop = loop;
+    voice.mActive = true;
+    return voice;
+}
+
+static float ReadSample(const SoundVoice& voice, uint32_t frame, uint32_t channel)
+{
+    channel = (voice.mNumChannels == 1) ? 0 : channel;
+    uint32_t sample = frame * voice.mNumChannels + channel;
+
+    if (voice.mBytesPerSample == 1)
+    {
+        return float(voice.mSrcBuffer[sample]) * 256.0f - 32767.0f;
+    }
+
+    int16_t value;
+    memcpy(&value, voice.mSrcBuffer + sample * 2, sizeof(value));
+    return float(value);
+}
+
+// One frame at a time with no fast paths, to check MixSoundVoice() against.
+static void MixVoiceReference(SoundVoice& voice, float* busL, float* busR, uint32_t numFrames)
+{
+    double step = glm::max(double(voice.mPitch) * (double(voice.mSampleRate) / AUDIO_OUTPUT_RATE), 0.0);
+    double pos = voice.mCurFrame;
+    uint32_t f = 0;
+
+    for (; f < numFrames; ++f)
+    {
+        uint32_t srcFrame = uint32_t(pos);
+
+        if (srcFrame >= voice.mSrcFrames)
+        {
+            break;
+        }
+
+        uint32_t nextFrame = srcFrame + 1;
+        bool hasNext = nextFrame < voice.mSrcFrames || voice.mLoop;
+        nextFrame = nextFrame % voice.mSrcFrames;
+        float a = float(pos - double(srcFrame));
+
+        for (uint32_t c = 0; c < 2; ++c)
+        {
+            float s0 = ReadSample(voice, srcFrame, c);
+            float s1 = hasNext ? ReadSample(voice, nextFrame, c) : 0.0f;
+            float* bus = (c == 0) ? busL : busR;
+            float volume = (c == 0) ? voice.mVolumeL : voice.mVolumeR;
+            bus[f] += (s0 + (s1 - s0) * a) * volume;
+        }
+
+        pos += step;
+
+        while (voice.mLoop && pos >= double(voice.mSrcFrames))
+        {
+            pos -= double(voice.mSrcFrames);
+        }
+    }
+
+    if (f < numFrames)
+    {
+        pos = double(voice.mSrcFrames);
+    }
+
+    voice.mCurFrame = pos;
+}
+
+static void CheckMixer()
+{
+    // Every source format, with pitches that hit the aligned, interpolated and wrap paths.
+    struct MixCase
+    {
+        uint32_t mNumChannels;
+        uint32_t mBytesPerSample;
+        int32_t mSampleRate;
+        float mPitch;
+        bool mLoop;
+    };
+
+    const MixCase kCases[] =
+    {
+        { 2, 2, 44100, 1.0f, false },
+        { 2, 2, 44100, 1.0f, true },
+        { 1, 2, 22050, 1.0f, true },
+        { 2, 1, 44100, 1.37f, false },
+        { 1, 1, 11025, 0.73f, true },
+        { 2, 2, 48000, 2.5f, true },
+        { 1, 2, 44100, 0.5f, false },
+    };
+
+    const uint32_t kNumCases = sizeof(kCases) / sizeof(kCases[0]);
+    float busL[kRenderFrames];
+    float busR[kRenderFrames];
+    float refL[kRenderFrames];
+    float refR[kRenderFrames];
+
+    for (uint32_t i = 0; i < kNumCases; ++i)
+    {
+        const MixCase& mixCase = kCases[i];
+
+        // Short waves so the renders below run past the end or loop several times.
+        BenchWave wave;
+        GenerateWave(wave, 701 + i * 37, mixCase.mNumChannels, mixCase.mBytesPerSample, mixCase.mSampleRate, 100 + i);
+
+        SoundVoice voice = MakeVoice(wave, mixCase.mPitch, 0.7f, 0.4f, mixCase.mLoop);
+        SoundVoice refVoice = voice;
+        float maxError = 0.0f;
+
+        for (uint32_t block = 0; block < 8; ++block)
+        {
+            memset(busL, 0, sizeof(busL));
+            memset(busR, 0, sizeof(busR));
+            memset(refL, 0, sizeof(refL));
+            memset(refR, 0, sizeof(refR));
+
+            // Odd block sizes keep the SIMD loops from always ending on a multiple of 4.
+            uint32_t numFrames = kRenderFrames - block * 13;
+
+            if (voice.mCurFrame < double(voice.mSrcFrames))
+            {
+                MixSoundVoice(voice, busL, busR, numFrames);
+            }
+
+            if (refVoice.mCurFrame < double(refVoice.mSrcFrames))
+            {
+                MixVoiceReference(refVoice, refL, refR, numFrames);
+            }
+
+            for (uint32_t f = 0; f < numFrames; ++f)
+            {
+                maxError = glm::max(maxError, glm::abs(busL[f] - refL[f]));
+                maxError = glm::max(maxError, glm::abs(busR[f] - refR[f]));
+            }
+        }
+
+        BenchCheck(maxError < 0.5f, "Audio: mix case %u differs from the reference by %.3f", i, maxError);
+        BenchCheck(glm::abs(voice.mCurFrame - refVoice.mCurFrame) < 1e-3,
+            "Audio: mix case %u ended at frame %.3f instead of %.3f", i, voice.mCurFrame, refVoice.mCurFrame);
+    }
+
+    // Conversion must round and saturate the same way as the scalar tail.
+    for (uint32_t f = 0; f < kRenderFrames; ++f)
+    {
+        busL[f] = (float(f) - kRenderFrames / 2) * 200.3f;
+        busR[f] = -busL[f] * 0.37f;
+    }
+
+    int16_t pcm[kRenderFrames * 2];
+    ConvertBusToPcm(busL, busR, pcm, kRenderFrames);
+    uint32_t numPcmErrors = 0;
+
+    for (uint32_t f = 0; f < kRenderFrames; ++f)
+    {
+        int32_t expectedL = glm::clamp(int32_t(glm::round(busL[f])), -32768, 32767);
+        int32_t expectedR = glm::clamp(int32_t(glm::round(busR[f])), -32768, 32767);
+
+        // SIMD conversion rounds halves to even, so allow one step of difference.
+        if (glm::abs(pcm[f * 2] - expectedL) > 1 || glm::abs(pcm[f * 2 + 1] - expectedR) > 1)
+        {
+            numPcmErrors++;
+        }
+    }
+
+    BenchCheck(numPcmErrors == 0, "Audio: %u frames converted to PCM incorrectly", numPcmErrors);
+}
+
+static void TimeMixer()
+{
+    const uint32_t kVoiceCounts[] = { 1, 8, 32, 128 };
+    const uint32_t kNumVoiceCounts = sizeof(kVoiceCounts) / sizeof(kVoiceCounts[0]);
+    const uint32_t kNumWaves = 4;
+    const uint32_t kRenderSeconds = 10;
+
+    // Looping waves in each source format, a few seconds long so reads aren't all from cache.
+    BenchWave waves[kNumWaves];
+    GenerateWave(waves[0], 44100 * 3, 2, 2, 44100, 1);
+    GenerateWave(waves[1], 22050 * 3, 1, 2, 22050, 2);
+    GenerateWave(waves[2], 48000 * 3, 2, 1, 48000, 3);
+    GenerateWave(waves[3], 11025 * 3, 1, 1, 11025, 4);
+
+    std::vector<float> busL(kRenderFrames);
+    std::vector<float> busR(kRenderFrames);
+    std::vector<int16_t> pcm(kRenderFrames * 2);
+
+    for (uint32_t c = 0; c < kNumVoiceCounts; ++c)
+    {
+        const uint32_t numVoices = kVoiceCounts[c];
+        std::vector<SoundVoice> voices(numVoices);
+        BenchRandom random(numVoices);
+
+        for (uint32_t v = 0; v < numVoices; ++v)
+        {
+            // Half the voices play at their native rate so the aligned path is timed too.
+            float pitch = (v % 2 == 0) ? 1.0f : random.NextFloat(0.5f, 2.0f);
+            voices[v] = MakeVoice(waves[v % kNumWaves], pitch, random.NextFloat(0.0f, 0.2f), random.NextFloat(0.0f, 0.2f), true);
+        }
+
+        const uint32_t numBlocks = kRenderSeconds * AUDIO_OUTPUT_RATE / kRenderFrames;
+        uint64_t startTime = SYS_GetTimeMicroseconds();
+
+        for (uint32_t b = 0; b < numBlocks; ++b)
+        {
+            memset(busL.data(), 0, kRenderFrames * sizeof(float));
+            memset(busR.data(), 0, kRenderFrames * sizeof(float));
+
+            for (uint32_t v = 0; v < numVoices; ++v)
+            {
+                MixSoundVoice(voices[v], busL.data(), busR.data(), kRenderFrames);
+            }
+
+            ConvertBusToPcm(busL.data(), busR.data(), pcm.data(), kRenderFrames);
+        }
+
+        uint64_t elapsedUs = glm::max<uint64_t>(SYS_GetTimeMicroseconds() - startTime, 1);
+        KeepAlive(pcm[0]);
+
+        double audioMs = numBlocks * kRenderFrames * 1000.0 / AUDIO_OUTPUT_RATE;
+        double wallMs = elapsedUs / 1000.0;
+
+        // How many voices one core could keep mixing in real time at this load.
+        LogDebug("%u voices: %.0f ms of audio in %.1f ms, %.0f voice-ms mixed per ms (%.0fx real time)",
+            numVoices, audioMs, wallMs, numVoices * audioMs / wallMs, audioMs / wallMs);
+    }
+}
+
+void BenchAudio()
+{
+    CheckMixer();
+    TimeMixer();
+}
+
+#else
+
+void BenchAudio()
+{
+
+}
+
+#endif
@@ -0,0 +1,211 @@
+#include "Benchmark.h"
+#include "Assets/Scene.h"
+#include "Assets/SoundWave.h"
+#include "Nodes/3D/Audio3d.h"
+#include "AssetManager.h"
+#include "AssetRef.h"
+#include "Stream.h"
+#include "Log.h"
+
+// Instantiates a large scene over and over, first alone and then while the async loader threads
+// load copies of the same scene. Every node references one shared SoundWave, so the main thread
+// and the loader threads (in Stream::ReadAsset) keep taking and dropping refs on the same asset.
+// With ASSET_LIVE_REF_TRACKING each of those also links or unlinks the ref in the asset's live list.
+
+static const uint32_t kNumGroups = 100;
+static const uint32_t kNodesPerGroup = 4;
+static const uint32_t kNumInstances = 200;
+static const uint32_t kNumAsyncScenes = 16;
+static const uint32_t kNumNodes = 1 + kNumGroups * (1 + kNodesPerGroup);
+static const char* kSharedWaveName = "SW_BenchShared";
+
+static std::string GetAsyncSceneName(uint32_t index)
+{
+    return "SC_BenchAsync" + std::to_string(index);
+}
+
+static Scene* CaptureLargeScene(SoundWave* wave)
+{
+    Node3D* root = Node::Construct<Node3D>();
+    root->SetName("Root");
+
+    for (uint32_t g = 0; g < kNumGroups; ++g)
+    {
+        Node3D* group = Node::Construct<Node3D>();
+        group->SetName("Group" + std::to_string(g));
+        group->SetPosition(glm::vec3(float(g % 10) * 10.0f, 0.0f, float(g / 10) * 10.0f));
+        root->AddChild(group);
+
+        for (uint32_t n = 0; n < kNodesPerGroup; ++n)
+        {
+            Audio3D* audio = Node::Construct<Audio3D>();
+            audio->SetName("Audio" + std::to_string(n));
+            audio->SetSoundWave(wave);
+            audio->SetPosition(glm::vec3(float(n), 1.0f, 0.0f));
+            group->AddChild(audio);
+        }
+    }
+
+    Scene* scene = NewTransientAsset<Scene>();
+    scene->Create();
+    scene->Capture(root);
+    Node::Destruct(root);
+
+    return scene;
+}
+
+// Counts the nodes under root, and how many of them are Audio3Ds playing the given wave.
+static void CountNodes(Node* node, SoundWave* wave, uint32_t& outNumNodes, uint32_t& outNumAudio)
+{
+    outNumNodes++;
+
+    if (node->GetType() == Audio3D::GetStaticType() &&
+        static_cast<Audio3D*>(node)->GetSoundWave() == wave)
+    {
+        outNumAudio++;
+    }
+
+    for (uint32_t i = 0; i < node->GetNumChildren(); ++i)
+    {
+        CountNodes(node->GetChild(i), wave, outNumNodes, outNumAudio);
+    }
+}
+
+static bool IsSceneComplete(Scene* scene, SoundWave* wave)
+{
+    uint32_t numNodes = 0;
+    uint32_t numAudio = 0;
+    Node* root = scene->Instantiate();
+
+    if (root != nullptr)
+    {
+        CountNodes(root, wave, numNodes, numAudio);
+        Node::Destruct(root);
+    }
+
+    return numNodes == kNumNodes && numAudio == kNumGroups * kNodesPerGroup;
+}
+
+static void QueueAsyncScenes(std::vector<AssetRef>& sceneRefs)
+{
+    for (uint32_t i = 0; i < sceneRefs.size(); ++i)
+    {
+        AssetManager::Get()->AsyncLoadAsset(GetAsyncSceneName(i), &sceneRefs[i]);
+    }
+}
+
+static void ReleaseAsyncScenes(std::vector<AssetRef>& sceneRefs)
+{
+    for (uint32_t i = 0; i < sceneRefs.size(); ++i)
+    {
+        sceneRefs[i] = nullptr;
+        AssetManager::Get()->UnloadAsset(GetAsyncSceneName(i));
+    }
+}
+
+static bool WaitForAsyncLoads()
+{
+    AssetManager* am = AssetManager::Get();
+    uint64_t startTime = SYS_GetTimeMicroseconds();
+
+    while (am->GetNumPendingAsyncLoads() > 0)
+    {
+        if (SYS_GetTimeMicroseconds() - startTime > 10000000)
+        {
+            return false;
+        }
+
+        am->Update(0.0f);
+        SYS_Sleep(1);
+    }
+
+    return true;
+}
+
+// Returns the average time of one Instantiate() + Destruct() in microseconds. Finishing async loads
+// on the main thread (AssetManager::Update) happens between instances and isn't timed.
+static double InstantiateScenes(Scene* scene, std::vector<AssetRef>* sceneRefs, uint32_t& outNumLoads)
+{
+    AssetManager* am = AssetManager::Get();
+    uint64_t instantiateTime = 0;
+
+    for (uint32_t i = 0; i < kNumInstances; ++i)
+    {
+        // Keep the loader threads busy for the whole run.
+        if (sceneRefs != nullptr && am->GetNumPendingAsyncLoads() == 0)
+        {
+            ReleaseAsyncScenes(*sceneRefs);
+            QueueAsyncScenes(*sceneRefs);
+            outNumLoads += kNumAsyncScenes;
+        }
+
+        uint64_t startTime = SYS_GetTimeMicroseconds();
+        Node* root = scene->Instantiate();
+        Node::Destruct(root);
+        instantiateTime += SYS_GetTimeMicroseconds() - startTime;
+
+        am->Update(0.0f);
+    }
+
+    return double(instantiateTime) / kNumInstances;
+}
+
+void BenchContention()
+{
+    Stream waveStream;
+    WriteBenchSoundWave(waveStream, kSharedWaveName, 256);
+    RegisterBenchAsset(kSharedWaveName, waveStream);
+
+    SoundWaveRef wave = LoadAsset<SoundWave>(kSharedWaveName);
+    BenchCheck(wave.Get() != nullptr, "Contention: failed to load %s", kSharedWaveName);
+
+    if (wave.Get() == nullptr)
+        return;
+
+    SceneRef scene = CaptureLargeScene(wave.Get<SoundWave>());
+
+    for (uint32_t i = 0; i < kNumAsyncScenes; ++i)
+    {
+        Stream sceneStream;
+        WriteBenchScene(sceneStream, scene.Get<Scene>(), GetAsyncSceneName(i));
+        RegisterBenchAsset(GetAsyncSceneName(i), sceneStream);
+    }
+
+    scene.Get()->SetName("SC_BenchLarge");
+
+    // Also warms up, and builds the scene's instantiation plan.
+    BenchCheck(IsSceneComplete(scene.Get<Scene>(), wave.Get<SoundWave>()), "Contention: captured scene instantiated incorrectly");
+    int32_t waveRefCount = wave.Get()->GetRefCount();
+
+    uint32_t numLoads = 0;
+    std::vector<AssetRef> sceneRefs(kNumAsyncScenes);
+
+    double aloneUs = InstantiateScenes(scene.Get<Scene>(), nullptr, numLoads);
+    double contendedUs = InstantiateScenes(scene.Get<Scene>(), &sceneRefs, numLoads);
+
+    BenchCheck(WaitForAsyncLoads(), "Contention: async loads did not finish");
+
+    uint32_t numBadScenes = 0;
+
+    for (uint32_t i = 0; i < kNumAsyncScenes; ++i)
+    {
+        Scene* loaded = sceneRefs[i].Get<Scene>();
+
+        if (loaded == nullptr || !IsSceneComplete(loaded, wave.Get<SoundWave>()))
+        {
+            numBadScenes++;
+        }
+    }
+
+    BenchCheck(numBadScenes == 0, "Contention: %u async loaded scenes are missing or incomplete", numBadScenes);
+
+    ReleaseAsyncScenes(sceneRefs);
+
+    // Every ref taken on either thread must have been dropped again.
+    BenchCheck(wave.Get()->GetRefCount() == waveRefCount, "Contention: shared wave has %d refs, expected %d",
+        wave.Get()->GetRefCount(), waveRefCount);
+
+    LogDebug("%u node scene x %u (live ref tracking %s): alone %.0f us, during %u async scene loads %.0f us (%.2fx)",
+        kNumNodes, kNumInstances, ASSET_LIVE_REF_TRACKING ? "on" : "off",
+        aloneUs, numLoads, contendedUs, contendedUs / glm::max(aloneUs, 1.0));
+}
@@ -0,0 +1,188 @@
+#include "Benchmark.h"
+#include "FrustumCuller.h"
+#include "CameraFrustum.h"
+#include "EngineTypes.h"
+#include "Log.h"
+
+// Compares the batched FrustumCuller against the per-draw CameraFrustum test the renderer used before,
+// which erased culled draws one at a time. Also checks both tests agree on which draws are visible.
+
+static void SetupFrustum(CameraFrustum& frustum)
+{
+    frustum.SetPerspective(60.0f, 16.0f / 9.0f, 0.1f, 200.0f);
+    frustum.SetPosition(glm::vec3(0.0f, 2.0f, 0.0f));
+
+    glm::vec3 forward = glm::normalize(glm::vec3(0.3f, -0.1f, -1.0f));
+    glm::vec3 right = glm::normalize(glm::cross(forward, glm::vec3(0.0f, 1.0f, 0.0f)));
+    glm::vec3 up = glm::cross(right, forward);
+    frustum.SetBasis(forward, up, right);
+}
+
+static void GenerateDraws(uint32_t numDraws, std::vector<DrawData>& outDraws)
+{
+    BenchRandom random(numDraws);
+    outDraws.resize(numDraws);
+
+    for (uint32_t i = 0; i < numDraws; ++i)
+    {
+        DrawData& draw = outDraws[i];
+        draw = {};
+        draw.mBounds.mCenter = glm::vec3(random.NextFloat(-250.0f, 250.0f), random.NextFloat(-20.0f, 20.0f), random.NextFloat(-250.0f, 250.0f));
+        draw.mBounds.mRadius = random.NextFloat(0.25f, 4.0f);
+        draw.mSortPriority = int32_t(i);
+    }
+}
+
+static uint32_t CullErase(const CameraFrustum& frustum, std::vector<DrawData>& drawData)
+{
+    uint32_t numCulled = 0;
+
+    for (int32_t i = int32_t(drawData.size()) - 1; i >= 0; --i)
+    {
+        if (!frustum.IsSphereInFrustum(drawData[i].mBounds.mCenter, drawData[i].mBounds.mRadius))
+        {
+            drawData.erase(drawData.begin() + i);
+            numCulled++;
+        }
+    }
+
+    return numCulled;
+}
+
+static uint32_t CullPerDrawCompact(const CameraFrustum& frustum, std::vector<DrawData>& drawData, std::vector<uint8_t>& visible)
+{
+    visible.resize(drawData.size());
+
+    for (uint32_t i = 0; i < drawData.size(); ++i)
+    {
+        visible[i] = frustum.IsSphereInFrustum(drawData[i].mBounds.mCenter, drawData[i].mBounds.mRadius) ? 1 : 0;
+    }
+
+    return CompactVisible(drawData, visible.data());
+}
+
+// Same as Renderer::FrustumCullDraws(), minus the per-node visibility callbacks.
+static uint32_t CullBatched(const CameraFrustum& frustum, FrustumCuller& culler, std::vector<DrawData>& drawData, std::vector<uint8_t>& visible)
+{
+    const uint32_t numDraws = uint32_t(drawData.size());
+    culler.SetFrustum(frustum);
+    culler.Clear();
+    culler.Reserve(numDraws);
+
+    for (uint32_t i = 0; i < numDraws; ++i)
+    {
+        culler.AddSphere(drawData[i].mBounds.mCenter, drawData[i].mBounds.mRadius);
+    }
+
+    visible.resize(numDraws);
+    culler.Cull(visible.data());
+
+    return CompactVisible(drawData, visible.data());
+}
+
+static void CheckCulling(const CameraFrustum& frustum, const std::vector<DrawData>& draws)
+{
+    FrustumCuller culler;
+    culler.SetFrustum(frustum);
+
+    for (uint32_t i = 0; i < draws.size(); ++i)
+    {
+        culler.AddSphere(draws[i].mBounds.mCenter, draws[i].mBounds.mRadius);
+    }
+
+    std::vector<uint8_t> visible(draws.size());
+    culler.Cull(visible.data());
+
+    uint32_t numMismatches = 0;
+
+    for (uint32_t i = 0; i < draws.size(); ++i)
+    {
+        const Bounds& bounds = draws[i].mBounds;
+        bool expected = frustum.IsSphereInFrustum(bounds.mCenter, bounds.mRadius);
+
+        // The plane test and the radar test round differently, so spheres that just touch a plane may disagree.
+        bool onBoundary =
+            frustum.IsSphereInFrustum(bounds.mCenter, bounds.mRadius * 1.001f) !=
+            frustum.IsSphereInFrustum(bounds.mCenter, bounds.mRadius * 0.999f);
+
+        if ((visible[i] != 0) != expected && !onBoundary)
+        {
+            numMismatches++;
+        }
+    }
+
+    BenchCheck(numMismatches == 0, "Culling: %u of %u draws differ from CameraFrustum::IsSphereInFrustum()",
+        numMismatches, uint32_t(draws.size()));
+}
+
+void BenchCulling()
+{
+    const uint32_t kDrawCounts[] = { 1000, 10000, 100000 };
+    const uint32_t kNumDrawCounts = sizeof(kDrawCounts) / sizeof(kDrawCounts[0]);
+
+    CameraFrustum frustum;
+    SetupFrustum(frustum);
+
+    FrustumCuller culler;
+    std::vector<DrawData> sourceDraws;
+    std::vector<DrawData> draws;
+    std::vector<uint8_t> visible;
+
+    for (uint32_t c = 0; c < kNumDrawCounts; ++c)
+    {
+        const uint32_t numDraws = kDrawCounts[c];
+        GenerateDraws(numDraws, sourceDraws);
+        CheckCulling(frustum, sourceDraws);
+
+        // Culling consumes the draw list, so only the cull itself is timed, not the copy before it.
+        // The erase path is quadratic, so it gets fewer iterations on large lists.
+        uint32_t iterations = 1000000 / numDraws;
+        uint32_t eraseIterations = (numDraws >= 100000) ? 1 : iterations;
+        uint64_t eraseTime = 0;
+        uint64_t compactTime = 0;
+        uint64_t batchedTime = 0;
+        uint32_t numCulledErase = 0;
+        uint32_t numCulledBatched = 0;
+
+        for (uint32_t i = 0; i < eraseIterations; ++i)
+        {
+            draws = sourceDraws;
+            uint64_t startTime = SYS_GetTimeMicroseconds();
+            numCulledErase = CullErase(frustum, draws);
+            eraseTime += SYS_GetTimeMicroseconds() - startTime;
+        }
+
+        for (uint32_t i = 0; i < iterations; ++i)
+        {
+            draws = sourceDraws;
+            uint64_t startTime = SYS_GetTimeMicroseconds();
+            CullPerDrawCompact(frustum, draws, visible);
+            compactTime += SYS_GetTimeMicroseconds() - startTime;
+        }
+
+        for (uint32_t i = 0; i < iterations; ++i)
+        {
+            draws = sourceDraws;
+            uint64_t startTime = SYS_GetTimeMicroseconds();
+            numCulledBatched = CullBatched(frustum, culler, draws, visible);
+            batchedTime += SYS_GetTimeMicroseconds() - startTime;
+        }
+
+        // Compaction must keep the surviving draws in their original order.
+        bool ordered = true;
+
+        for (uint32_t i = 1; i < draws.size(); ++i)
+        {
+            ordered = ordered && (draws[i - 1].mSortPriority < draws[i].mSortPriority);
+        }
+
+        BenchCheck(ordered, "Culling: visible draws were reordered (%u draws)", numDraws);
+
+        double eraseUs = double(eraseTime) / eraseIterations;
+        double compactUs = double(compactTime) / iterations;
+        double batchedUs = double(batchedTime) / iterations;
+
+        LogDebug("%u draws (%u / %u culled): per-draw+erase %.1f us, per-draw+compact %.1f us, batched %.1f us (%.1fx)",
+            numDraws, numCulledErase, numCulledBatched, eraseUs, compactUs, batchedUs, eraseUs / batchedUs);
+    }
+}
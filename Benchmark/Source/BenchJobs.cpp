@@ -0,0 +1,126 @@
+#include "Benchmark.h"
+#include "JobSystem.h"
+#include "Log.h"
+
+#include <math.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+// Measures the fixed cost of scheduling a job and how ParallelFor() scales as workers are added.
+// The job system is recreated for each worker count and restored to the default afterwards.
+
+static const uint32_t kNumEmptyJobs = 100000;
+static const uint32_t kNumElements = 1 << 20;
+
+static void TimeJobOverhead()
+{
+    JobSystem* jobSystem = JobSystem::Get();
+    std::atomic<uint32_t> numRan(0);
+
+    double runUs = TimeIterations(1, [&]()
+    {
+        JobCounter counter;
+
+        for (uint32_t i = 0; i < kNumEmptyJobs; ++i)
+        {
+            jobSystem->Run([&numRan]() { numRan++; }, &counter);
+        }
+
+        jobSystem->Wait(&counter);
+    });
+
+    BenchCheck(numRan.load() == kNumEmptyJobs, "Jobs: %u of %u jobs ran", numRan.load(), kNumEmptyJobs);
+
+    // A chain where every job waits on the previous one measures the continuation path.
+    numRan = 0;
+    const uint32_t kChainLength = 10000;
+
+    double chainUs = TimeIterations(1, [&]()
+    {
+        std::vector<JobCounter> counters(kChainLength);
+        jobSystem->Run([&numRan]() { numRan++; }, &counters[0]);
+
+        for (uint32_t i = 1; i < kChainLength; ++i)
+        {
+            jobSystem->RunAfter(&counters[i - 1], [&numRan]() { numRan++; }, &counters[i]);
+        }
+
+        for (uint32_t i = 0; i < kChainLength; ++i)
+        {
+            jobSystem->Wait(&counters[i]);
+        }
+    });
+
+    BenchCheck(numRan.load() == kChainLength, "Jobs: %u of %u chained jobs ran", numRan.load(), kChainLength);
+
+    LogDebug("%u workers: Run+Wait %.0f ns/job, RunAfter chain %.0f ns/job",
+        jobSystem->GetNumWorkers(),
+        runUs * 1000.0 / kNumEmptyJobs,
+        chainUs * 1000.0 / kChainLength);
+}
+
+static double TimeParallelFor(std::vector<float>& values, uint32_t batchSize, uint32_t iterations)
+{
+    JobSystem* jobSystem = JobSystem::Get();
+
+    return TimeIterations(iterations, [&]()
+    {
+        jobSystem->ParallelFor(kNumElements, batchSize, [&values](uint32_t start, uint32_t end)
+        {
+            for (uint32_t i = start; i < end; ++i)
+            {
+                float x = float(i) * 0.001f;
+                values[i] = sinf(x) * cosf(x * 0.5f) + sqrtf(x);
+            }
+        });
+    });
+}
+
+void BenchJobs()
+{
+    uint32_t numCores = std::thread::hardware_concurrency();
+    numCores = (numCores > 0) ? numCores : 1;
+
+    std::vector<float> reference(kNumElements);
+    std::vector<float> values(kNumElements);
+    double serialUs = 0.0;
+
+    // 0, 1, 2, 4... workers, always ending on the count the engine uses by default.
+    std::vector<uint32_t> workerCounts;
+
+    for (uint32_t numWorkers = 0; numWorkers < numCores - 1; numWorkers = (numWorkers == 0) ? 1 : numWorkers * 2)
+    {
+        workerCounts.push_back(numWorkers);
+    }
+
+    if (workerCounts.size() == 0 || workerCounts.back() != numCores - 1)
+    {
+        workerCounts.push_back(numCores - 1);
+    }
+
+    for (uint32_t w = 0; w < workerCounts.size(); ++w)
+    {
+        uint32_t numWorkers = workerCounts[w];
+        JobSystem::Create(int32_t(numWorkers));
+
+        TimeJobOverhead();
+
+        std::fill(values.begin(), values.end(), 0.0f);
+        double coarseUs = TimeParallelFor(values, 4096, 20);
+        double fineUs = TimeParallelFor(values, 64, 20);
+
+        if (numWorkers == 0)
+        {
+            serialUs = coarseUs;
+            reference = values;
+        }
+
+        BenchCheck(values == reference, "Jobs: ParallelFor result differs with %u workers", numWorkers);
+
+        LogDebug("%u workers: ParallelFor %u elements, batch 4096 %.0f us (%.2fx), batch 64 %.0f us (%.2fx)",
+            numWorkers, kNumElements, coarseUs, serialUs / coarseUs, fineUs, serialUs / fineUs);
+    }
+
+    JobSystem::Create();
+}
@@ -0,0 +1,236 @@
+#include "Benchmark.h"
+#include "NetworkManager.h"
+#include "NetDatum.h"
+#include "NetMsg.h"
+#include "BitStream.h"
+#include "Stream.h"
+#include "Nodes/3D/Node3d.h"
+#include "Log.h"
+
+#include <string.h>
+
+// Offline bandwidth comparison of the byte-aligned Replicate messages against packed replication,
+// for a crowd of moving Node3Ds. Messages are encoded the same way the NetworkManager does, but no
+// sockets are involved, and the client is assumed to ack every snapshot before the next tick.
+// Every delta is also decoded again to check that it round trips.
+
+static const uint32_t kNumNodes = 64;
+static const uint32_t kNumTicks = 300;
+static const float kTickRate = 30.0f;
+
+struct ReplicationTotals
+{
+    uint64_t mAlignedBytes = 0;
+    uint64_t mPackedFullBytes = 0;
+    uint64_t mPackedDeltaBytes = 0;
+    uint32_t mRoundTripErrors = 0;
+};
+
+static void MoveNode(Node3D* node, uint32_t index, float time)
+{
+    // A quarter of the crowd stands still, the rest walk in circles of different sizes.
+    if (index % 4 == 3)
+        return;
+
+    float radius = 5.0f + float(index);
+    float angle = time * (5.0f / radius) + index;
+    node->SetPosition(glm::vec3(cosf(angle) * radius, 0.0f, sinf(angle) * radius));
+    node->SetRotation(glm::vec3(0.0f, -angle * RADIANS_TO_DEGREES, 0.0f));
+}
+
+static uint32_t GetAlignedSize(Node* node)
+{
+    std::vector<NetDatum>& repData = node->GetReplicatedData();
+    NetMsgReplicate msg;
+    msg.mNodeNetId = node->GetNetId();
+
+    for (uint32_t i = 0; i < repData.size(); ++i)
+    {
+        if (repData[i].ShouldReplicate())
+        {
+            msg.mIndices.push_back(uint16_t(i));
+            msg.mData.push_back(Datum(repData[i]));
+            repData[i].PostReplicate();
+        }
+    }
+
+    if (msg.mIndices.size() == 0)
+        return 0;
+
+    msg.mNumVariables = uint16_t(msg.mIndices.size());
+
+    Stream stream;
+    msg.Write(stream);
+    return stream.GetPos();
+}
+
+// Same layout as NetworkManager's packed writer: with a baseline, each datum has a presence bit
+// and its words are delta encoded.
+static void WritePacked(BitStream& stream, const std::vector<NetDatum>& repData, const uint32_t* words, const uint32_t* baseWords)
+{
+    uint32_t offset = 0;
+
+    for (uint32_t i = 0; i < repData.size(); ++i)
+    {
+        uint32_t numWords = repData[i].GetNumPackedWords();
+
+        if (numWords == 0)
+            continue;
+
+        if (baseWords != nullptr)
+        {
+            bool present = memcmp(words + offset, baseWords + offset, numWords * sizeof(uint32_t)) != 0;
+            stream.WriteBool(present);
+
+            if (present)
+            {
+                repData[i].WritePacked(stream, words + offset, baseWords + offset);
+            }
+        }
+        else
+        {
+            repData[i].WritePacked(stream, words + offset, nullptr);
+        }
+
+        offset += numWords;
+    }
+}
+
+static bool ReadPackedMatches(const BitStream& written, const std::vector<NetDatum>& repData, const std::vector<uint32_t>& words, const uint32_t* baseWords)
+{
+    BitStream stream((const char*)written.GetData(), written.GetNumBytes());
+    std::vector<uint32_t> outWords(words.size());
+    uint32_t offset = 0;
+
+    for (uint32_t i = 0; i < repData.size(); ++i)
+    {
+        uint32_t numWords = repData[i].GetNumPackedWords();
+
+        if (numWords == 0)
+            continue;
+
+        if (stream.ReadBool())
+        {
+            Datum value;
+            repData[i].ReadPacked(stream, baseWords + offset, outWords.data() + offset, value);
+        }
+        else
+        {
+            memcpy(outWords.data() + offset, baseWords + offset, numWords * sizeof(uint32_t));
+        }
+
+        offset += numWords;
+    }
+
+    return !stream.IsOverflowed() && outWords == words;
+}
+
+static ReplicationTotals SimulateCrowd()
+{
+    std::vector<Node3D*> nodes(kNumNodes);
+    std::vector<std::vector<uint32_t>> baselines(kNumNodes);
+    std::vector<uint32_t> words;
+    BitStream bits;
+    ReplicationTotals totals;
+
+    for (uint32_t i = 0; i < kNumNodes; ++i)
+    {
+        nodes[i] = Node::Construct<Node3D>();
+        nodes[i]->SetReplicate(true);
+        nodes[i]->SetReplicateTransform(true);
+        nodes[i]->SetNetId(NetId(i + 1));
+        MoveNode(nodes[i], i, 0.0f);
+
+        // Quantization is read from the NetworkManager when the datums are gathered.
+        nodes[i]->GatherReplicatedData(nodes[i]->GetReplicatedData());
+    }
+
+    for (uint32_t tick = 0; tick < kNumTicks; ++tick)
+    {
+        float time = tick / kTickRate;
+
+        for (uint32_t i = 0; i < kNumNodes; ++i)
+        {
+            Node3D* node = nodes[i];
+            const std::vector<NetDatum>& repData = node->GetReplicatedData();
+            MoveNode(node, i, time);
+
+            totals.mAlignedBytes += GetAlignedSize(node);
+
+            words.clear();
+            for (uint32_t d = 0; d < repData.size(); ++d)
+            {
+                uint32_t start = uint32_t(words.size());
+                words.resize(start + repData[d].GetNumPackedWords());
+                repData[d].GatherPackedWords(words.data() + start);
+            }
+
+            std::vector<uint32_t>& baseline = baselines[i];
+            bool changed = baseline.empty() || baseline != words;
+
+            if (!changed)
+                continue;
+
+            bits.Reset();
+            WritePacked(bits, repData, words.data(), nullptr);
+            totals.mPackedFullBytes += NetMsgReplicatePacked::HeaderSize + bits.GetNumBytes();
+
+            if (baseline.empty())
+            {
+                // The first snapshot has nothing to delta against.
+                totals.mPackedDeltaBytes += NetMsgReplicatePacked::HeaderSize + bits.GetNumBytes();
+            }
+            else
+            {
+                bits.Reset();
+                WritePacked(bits, repData, words.data(), baseline.data());
+                totals.mPackedDeltaBytes += NetMsgReplicatePacked::HeaderSize + bits.GetNumBytes();
+
+                if (!ReadPackedMatches(bits, repData, words, baseline.data()))
+                {
+                    totals.mRoundTripErrors++;
+                }
+            }
+
+            baseline = words;
+        }
+    }
+
+    for (uint32_t i = 0; i < kNumNodes; ++i)
+    {
+        Node::Destruct(nodes[i]);
+    }
+
+    return totals;
+}
+
+static void LogTotals(const char* label, const ReplicationTotals& totals)
+{
+    const double seconds = kNumTicks / kTickRate;
+
+    LogDebug("%s: aligned %.0f B/s, packed %.0f B/s (%.0f%%), packed delta %.0f B/s (%.0f%%)",
+        label,
+        totals.mAlignedBytes / seconds,
+        totals.mPackedFullBytes / seconds, 100.0 * totals.mPackedFullBytes / totals.mAlignedBytes,
+        totals.mPackedDeltaBytes / seconds, 100.0 * totals.mPackedDeltaBytes / totals.mAlignedBytes);
+
+    BenchCheck(totals.mRoundTripErrors == 0, "Replication (%s): %u packed deltas did not decode to the sent state", label, totals.mRoundTripErrors);
+}
+
+void BenchReplication()
+{
+    NetworkManager* netMan = NetworkManager::Get();
+    NetQuantization prevPosition = netMan->GetPositionQuantization();
+    NetQuantization prevRotation = netMan->GetRotationQuantization();
+
+    LogDebug("%u Node3Ds (3/4 moving), %u ticks at %.0f Hz", kNumNodes, kNumTicks, kTickRate);
+
+    LogTotals("default quantization", SimulateCrowd());
+
+    netMan->SetPositionQuantization(1024.0f, 20);
+    netMan->SetRotationQuantization(10);
+    LogTotals("20 bit positions, 10 bit rotations", SimulateCrowd());
+
+    netMan->SetPositionQuantization(prevPosition.mMax, prevPosition.mBits);
+    netMan->SetRotationQuantization(prevRotation.mBits);
+}
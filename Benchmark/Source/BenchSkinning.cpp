@@ -0,0 +1,214 @@
+#include "Benchmark.h"
+#include "CpuSkinning.h"
+#include "Log.h"
+
+#include <math.h>
+
+// Checks the SSE/NEON skinning kernel against the scalar kernel and against the original
+// full matrix blend, then measures throughput of each path.
+
+static const uint32_t kNumBones = 60;
+
+static void GenerateBones(BenchRandom& random, std::vector<glm::mat4>& outMatrices)
+{
+    outMatrices.resize(kNumBones);
+
+    for (uint32_t i = 0; i < kNumBones; ++i)
+    {
+        glm::vec3 axis = glm::normalize(glm::vec3(random.NextFloat(-1.0f, 1.0f), random.NextFloat(-1.0f, 1.0f), 1.0f));
+        glm::mat4 m = glm::translate(glm::mat4(1.0f), glm::vec3(random.NextFloat(-2.0f, 2.0f), random.NextFloat(-2.0f, 2.0f), random.NextFloat(-2.0f, 2.0f)));
+        m = glm::rotate(m, random.NextFloat(-3.14f, 3.14f), axis);
+        m = glm::scale(m, glm::vec3(random.NextFloat(0.5f, 1.5f)));
+        outMatrices[i] = m;
+    }
+}
+
+// usedInfluences is how many of the MAX_BONE_INFLUENCES slots get a non-zero weight.
+// 0 picks a random count per vertex.
+static void GenerateVertices(BenchRandom& random, uint32_t numVerts, uint32_t usedInfluences, std::vector<VertexSkinned>& outVerts)
+{
+    outVerts.resize(numVerts);
+
+    for (uint32_t i = 0; i < numVerts; ++i)
+    {
+        VertexSkinned& vert = outVerts[i];
+        vert.mPosition = glm::vec3(random.NextFloat(-1.0f, 1.0f), random.NextFloat(0.0f, 2.0f), random.NextFloat(-1.0f, 1.0f));
+        vert.mNormal = glm::normalize(glm::vec3(random.NextFloat(-1.0f, 1.0f), random.NextFloat(-1.0f, 1.0f), 0.5f));
+        vert.mTexcoord0 = glm::vec2(random.NextFloat(0.0f, 1.0f), random.NextFloat(0.0f, 1.0f));
+        vert.mTexcoord1 = glm::vec2(random.NextFloat(0.0f, 1.0f), random.NextFloat(0.0f, 1.0f));
+
+        uint32_t numUsed = (usedInfluences > 0) ? usedInfluences : (1 + random.NextUint() % MAX_BONE_INFLUENCES);
+        float totalWeight = 0.0f;
+
+        for (uint32_t b = 0; b < MAX_BONE_INFLUENCES; ++b)
+        {
+            vert.mBoneIndices[b] = uint8_t(random.NextUint() % kNumBones);
+            vert.mBoneWeights[b] = (b < numUsed) ? random.NextFloat(0.1f, 1.0f) : 0.0f;
+            totalWeight += vert.mBoneWeights[b];
+        }
+
+        for (uint32_t b = 0; b < MAX_BONE_INFLUENCES; ++b)
+        {
+            vert.mBoneWeights[b] /= totalWeight;
+        }
+    }
+}
+
+// The blend SkeletalMesh3D did before the affine kernels existed.
+static void SkinVerticesMatrix(
+    const VertexSkinned* srcVerts,
+    Vertex* dstVerts,
+    uint32_t numVerts,
+    const std::vector<glm::mat4>& matrices,
+    uint32_t numInfluences)
+{
+    for (uint32_t i = 0; i < numVerts; ++i)
+    {
+        const VertexSkinned& srcVert = srcVerts[i];
+        glm::mat4 boneMat = matrices[srcVert.mBoneIndices[0]];
+
+        if (numInfluences > 1)
+        {
+            boneMat *= srcVert.mBoneWeights[0];
+
+            for (uint32_t b = 1; b < MAX_BONE_INFLUENCES; ++b)
+            {
+                boneMat += matrices[srcVert.mBoneIndices[b]] * srcVert.mBoneWeights[b];
+            }
+        }
+
+        dstVerts[i].mPosition = glm::vec3(boneMat * glm::vec4(srcVert.mPosition, 1.0f));
+        dstVerts[i].mNormal = glm::vec3(boneMat * glm::vec4(srcVert.mNormal, 0.0f));
+        dstVerts[i].mTexcoord0 = srcVert.mTexcoord0;
+        dstVerts[i].mTexcoord1 = srcVert.mTexcoord1;
+    }
+}
+
+static bool NearlyEqual(const glm::vec3& a, const glm::vec3& b)
+{
+    // Values stay within a few units, so an absolute tolerance is enough for the
+    // different summation order of the SIMD path.
+    glm::vec3 diff = glm::abs(a - b);
+    return diff.x <= 1e-4f && diff.y <= 1e-4f && diff.z <= 1e-4f;
+}
+
+static void CompareVertices(const char* label, const Vertex* a, const Vertex* b, uint32_t numVerts, uint32_t numInfluences, uint32_t usedInfluences)
+{
+    uint32_t numMismatches = 0;
+    uint32_t firstMismatch = 0;
+
+    for (uint32_t i = 0; i < numVerts; ++i)
+    {
+        bool match =
+            NearlyEqual(a[i].mPosition, b[i].mPosition) &&
+            NearlyEqual(a[i].mNormal, b[i].mNormal) &&
+            a[i].mTexcoord0 == b[i].mTexcoord0 &&
+            a[i].mTexcoord1 == b[i].mTexcoord1;
+
+        if (!match)
+        {
+            if (numMismatches == 0)
+            {
+                firstMismatch = i;
+            }
+
+            numMismatches++;
+        }
+    }
+
+    BenchCheck(numMismatches == 0, "Skinning %s: %u of %u vertices differ (influences=%u, used=%u, first=%u)",
+        label, numMismatches, numVerts, numInfluences, usedInfluences, firstMismatch);
+}
+
+static void CheckSkinning(const std::vector<glm::mat4>& matrices, const std::vector<BoneAffine>& bones)
+{
+    // Odd counts leave a remainder after the parallel batches, and the larger ones cross the threshold
+    // where SkinVertices() splits the mesh across the job system.
+    const uint32_t kVertexCounts[] = { 1, 3, 17, 1023, 4095, 4096, 4096 + 1024 * 3 + 7 };
+    const uint32_t kNumVertexCounts = sizeof(kVertexCounts) / sizeof(kVertexCounts[0]);
+
+    BenchRandom random(1234);
+    std::vector<VertexSkinned> srcVerts;
+    std::vector<Vertex> simdVerts;
+    std::vector<Vertex> scalarVerts;
+    std::vector<Vertex> matrixVerts;
+
+    for (uint32_t c = 0; c < kNumVertexCounts; ++c)
+    {
+        uint32_t numVerts = kVertexCounts[c];
+
+        for (uint32_t usedInfluences = 0; usedInfluences <= MAX_BONE_INFLUENCES; ++usedInfluences)
+        {
+            GenerateVertices(random, numVerts, usedInfluences, srcVerts);
+
+            for (uint32_t numInfluences = 1; numInfluences <= MAX_BONE_INFLUENCES; numInfluences += MAX_BONE_INFLUENCES - 1)
+            {
+                // Fill the outputs with NaN so any vertex a kernel skips fails the comparison.
+                Vertex poison = {};
+                poison.mPosition = glm::vec3(NAN);
+                poison.mNormal = glm::vec3(NAN);
+                simdVerts.assign(numVerts, poison);
+                scalarVerts.assign(numVerts, poison);
+                matrixVerts.assign(numVerts, poison);
+
+                SkinVertices(srcVerts.data(), simdVerts.data(), numVerts, bones.data(), numInfluences);
+                SkinVerticesScalar(srcVerts.data(), scalarVerts.data(), 0, numVerts, bones.data(), numInfluences);
+                SkinVerticesMatrix(srcVerts.data(), matrixVerts.data(), numVerts, matrices, numInfluences);
+
+                CompareVertices("simd vs scalar", simdVerts.data(), scalarVerts.data(), numVerts, numInfluences, usedInfluences);
+                CompareVertices("scalar vs matrix", scalarVerts.data(), matrixVerts.data(), numVerts, numInfluences, usedInfluences);
+            }
+        }
+    }
+}
+
+static void TimeSkinning(const std::vector<glm::mat4>& matrices, const std::vector<BoneAffine>& bones)
+{
+    const uint32_t kNumVerts = 16384;
+    const uint32_t kIterations = 200;
+
+    BenchRandom random(5678);
+    std::vector<VertexSkinned> srcVerts;
+    std::vector<Vertex> dstVerts(kNumVerts);
+    GenerateVertices(random, kNumVerts, 0, srcVerts);
+
+    for (uint32_t numInfluences = 1; numInfluences <= MAX_BONE_INFLUENCES; numInfluences += MAX_BONE_INFLUENCES - 1)
+    {
+        double matrixUs = TimeIterations(kIterations, [&]()
+        {
+            SkinVerticesMatrix(srcVerts.data(), dstVerts.data(), kNumVerts, matrices, numInfluences);
+        });
+
+        double scalarUs = TimeIterations(kIterations, [&]()
+        {
+            SkinVerticesScalar(srcVerts.data(), dstVerts.data(), 0, kNumVerts, bones.data(), numInfluences);
+        });
+
+        double simdUs = TimeIterations(kIterations, [&]()
+        {
+            SkinVerticesRange(srcVerts.data(), dstVerts.data(), 0, kNumVerts, bones.data(), numInfluences);
+        });
+
+        double parallelUs = TimeIterations(kIterations, [&]()
+        {
+            SkinVertices(srcVerts.data(), dstVerts.data(), kNumVerts, bones.data(), numInfluences);
+        });
+
+        KeepAlive(dstVerts[kNumVerts - 1].mPosition.x);
+
+        LogDebug("%u verts, %u influence(s): matrix %.1f us, scalar %.1f us, simd %.1f us, simd+jobs %.1f us (%.2f Mverts/s)",
+            kNumVerts, numInfluences, matrixUs, scalarUs, simdUs, parallelUs, kNumVerts / parallelUs);
+    }
+}
+
+void BenchSkinning()
+{
+    BenchRandom random(42);
+    std::vector<glm::mat4> matrices;
+    std::vector<BoneAffine> bones;
+    GenerateBones(random, matrices);
+    ConvertBoneMatrices(matrices, bones);
+
+    CheckSkinning(matrices, bones);
+    TimeSkinning(matrices, bones);
+}
@@ -0,0 +1,217 @@
+#include "Benchmark.h"
+#include "Assets/Scene.h"
+#include "Nodes/3D/Box3d.h"
+#include "Nodes/3D/Sphere3d.h"
+#include "Nodes/3D/PointLight3d.h"
+#include "Nodes/3D/Audio3d.h"
+#include "AssetManager.h"
+#include "Property.h"
+#include "World.h"
+#include "Engine.h"
+#include "Stream.h"
+#include "Log.h"
+
+// Spawns a ~200 node prefab through World::SpawnScene() over and over. The first instantiation
+// builds the scene's instantiation plan, every later one applies it. Checks that both produce
+// the same nodes and property values as the nodes the prefab was captured from.
+
+static const uint32_t kNumGroups = 11;
+static const uint32_t kNodesPerGroup = 17;
+static const uint32_t kNumSpawns = 1000;
+static const uint32_t kSpawnBatch = 100;
+static const char* kPrefabName = "SC_BenchPrefab";
+
+static Node* CreatePrefabNodes()
+{
+    Node3D* root = Node::Construct<Node3D>();
+    root->SetName("Prefab");
+
+    for (uint32_t g = 0; g < kNumGroups; ++g)
+    {
+        Node3D* group = Node::Construct<Node3D>();
+        group->SetName("Group" + std::to_string(g));
+        group->SetPosition(glm::vec3(float(g) * 2.0f, 0.0f, 0.0f));
+        group->SetRotation(glm::vec3(0.0f, float(g) * 15.0f, 0.0f));
+        root->AddChild(group);
+
+        for (uint32_t n = 0; n < kNodesPerGroup; ++n)
+        {
+            Node3D* node = nullptr;
+            float f = float(g * kNodesPerGroup + n);
+
+            switch (n % 5)
+            {
+            case 0:
+            {
+                Box3D* box = Node::Construct<Box3D>();
+                box->SetExtents(glm::vec3(1.0f + n * 0.1f, 0.5f, 2.0f));
+                node = box;
+                break;
+            }
+            case 1:
+            {
+                Sphere3D* sphere = Node::Construct<Sphere3D>();
+                sphere->SetRadius(0.25f + n * 0.05f);
+                node = sphere;
+                break;
+            }
+            case 2:
+            {
+                PointLight3D* light = Node::Construct<PointLight3D>();
+                light->SetColor(glm::vec4(f / 200.0f, 0.5f, 1.0f - f / 200.0f, 1.0f));
+                light->SetRadius(5.0f + n);
+                node = light;
+                break;
+            }
+            case 3:
+            {
+                Audio3D* audio = Node::Construct<Audio3D>();
+                audio->SetVolume(0.1f + n * 0.05f);
+                audio->SetPitch(0.9f + n * 0.01f);
+                node = audio;
+                break;
+            }
+            default:
+                node = Node::Construct<Node3D>();
+                break;
+            }
+
+            node->SetName("Node" + std::to_string(n));
+            node->SetPosition(glm::vec3(0.0f, f * 0.1f, float(n)));
+            node->SetScale(glm::vec3(1.0f + n * 0.01f));
+            group->AddChild(node);
+        }
+    }
+
+    return root;
+}
+
+static uint32_t CountNodes(Node* node)
+{
+    uint32_t count = 1;
+
+    for (uint32_t i = 0; i < node->GetNumChildren(); ++i)
+    {
+        count += CountNodes(node->GetChild(i));
+    }
+
+    return count;
+}
+
+// Returns the number of nodes whose type, name, child count or properties differ.
+static uint32_t CompareNodes(Node* expected, Node* actual)
+{
+    if (expected->GetType() != actual->GetType() ||
+        expected->GetName() != actual->GetName() ||
+        expected->GetNumChildren() != actual->GetNumChildren())
+    {
+        return CountNodes(expected);
+    }
+
+    std::vector<Property> expectedProps;
+    std::vector<Property> actualProps;
+    expected->GatherProperties(expectedProps);
+    actual->GatherProperties(actualProps);
+
+    uint32_t numMismatches = 0;
+
+    if (expectedProps.size() != actualProps.size())
+    {
+        numMismatches++;
+    }
+    else
+    {
+        for (uint32_t i = 0; i < expectedProps.size(); ++i)
+        {
+            if (expectedProps[i] != actualProps[i])
+            {
+                numMismatches++;
+                break;
+            }
+        }
+    }
+
+    for (uint32_t i = 0; i < expected->GetNumChildren(); ++i)
+    {
+        numMismatches += CompareNodes(expected->GetChild(i), actual->GetChild(i));
+    }
+
+    return numMismatches;
+}
+
+void BenchSpawn()
+{
+    World* world = GetWorld(0);
+    Node* prefabNodes = CreatePrefabNodes();
+    const uint32_t numNodes = CountNodes(prefabNodes);
+
+    Scene* capture = NewTransientAsset<Scene>();
+    capture->Create();
+    capture->Capture(prefabNodes);
+
+    Stream stream;
+    WriteBenchScene(stream, capture, kPrefabName);
+    RegisterBenchAsset(kPrefabName, stream);
+
+    SceneRef prefab = LoadAsset<Scene>(kPrefabName);
+    BenchCheck(prefab.Get() != nullptr, "Spawn: failed to load %s", kPrefabName);
+
+    if (prefab.Get() == nullptr)
+    {
+        Node::Destruct(prefabNodes);
+        return;
+    }
+
+    // Spawned prefabs go under a root like they would in a game.
+    Node* spawnRoot = nullptr;
+
+    if (world->GetRootNode() == nullptr)
+    {
+        spawnRoot = world->SpawnNode<Node3D>();
+    }
+
+    uint64_t startTime = SYS_GetTimeMicroseconds();
+    Node* firstSpawn = world->SpawnScene(kPrefabName);
+    uint64_t firstSpawnTime = SYS_GetTimeMicroseconds() - startTime;
+
+    uint32_t numMismatches = (firstSpawn != nullptr) ? CompareNodes(prefabNodes, firstSpawn) : numNodes;
+    BenchCheck(numMismatches == 0, "Spawn: %u nodes differ from the prefab on the first spawn", numMismatches);
+    Node::Destruct(firstSpawn);
+
+    std::vector<Node*> spawned;
+    spawned.reserve(kSpawnBatch);
+    uint64_t spawnTime = 0;
+
+    for (uint32_t i = 0; i < kNumSpawns; i += kSpawnBatch)
+    {
+        startTime = SYS_GetTimeMicroseconds();
+
+        for (uint32_t s = 0; s < kSpawnBatch; ++s)
+        {
+            spawned.push_back(world->SpawnScene(kPrefabName));
+        }
+
+        spawnTime += SYS_GetTimeMicroseconds() - startTime;
+
+        if (i == 0)
+        {
+            numMismatches = (spawned.back() != nullptr) ? CompareNodes(prefabNodes, spawned.back()) : numNodes;
+            BenchCheck(numMismatches == 0, "Spawn: %u nodes differ from the prefab on a planned spawn", numMismatches);
+        }
+
+        for (uint32_t s = 0; s < spawned.size(); ++s)
+        {
+            Node::Destruct(spawned[s]);
+        }
+
+        spawned.clear();
+    }
+
+    double spawnUs = double(spawnTime) / kNumSpawns;
+
+    LogDebug("%u node prefab: first spawn %.0f us, later spawns %.0f us (%.0f ns/node, %.0f spawns/s)",
+        numNodes, double(firstSpawnTime), spawnUs, spawnUs * 1000.0 / numNodes, 1e6 / glm::max(spawnUs, 0.001));
+
+    Node::Destruct(spawnRoot);
+    Node::Destruct(prefabNodes);
+}
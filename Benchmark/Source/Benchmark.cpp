@@ -0,0 +1,101 @@
+#include "Benchmark.h"
+#include "Assets/SoundWave.h"
+#include "Assets/Scene.h"
+#include "AssetManager.h"
+#include "EmbeddedFile.h"
+#include "Stream.h"
+#include "Log.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+
+static uint32_t sNumFailures = 0;
+
+struct BenchAsset
+{
+    std::string mName;
+    std::vector<char> mData;
+    EmbeddedFile mFile;
+};
+
+// The AssetManager keeps pointers to the embedded files, so these are never freed.
+static std::vector<BenchAsset*> sBenchAssets;
+
+void BenchCheck(bool condition, const char* format, ...)
+{
+    if (!condition)
+    {
+        char message[512];
+        va_list args;
+        va_start(args, format);
+        vsnprintf(message, sizeof(message), format, args);
+        va_end(args);
+
+        LogError("FAILED: %s", message);
+        sNumFailures++;
+    }
+}
+
+uint32_t GetNumBenchFailures()
+{
+    return sNumFailures;
+}
+
+void WriteBenchSoundWave(Stream& stream, const std::string& name, uint32_t waveSize)
+{
+    stream.WriteUint32(ASSET_MAGIC_NUMBER);
+    stream.WriteUint32(ASSET_VERSION_CURRENT);
+    stream.WriteUint32(uint32_t(SoundWave::GetStaticType()));
+    stream.WriteUint8(0); // Embedded
+    stream.WriteUint8(uint8_t(AssetCompression::None));
+    stream.WriteUint8(0); // Compressed
+    stream.WriteString(name);
+
+    stream.WriteFloat(1.0f); // Volume
+    stream.WriteFloat(1.0f); // Pitch
+    stream.WriteInt8(0); // Audio class
+    stream.WriteBool(false); // Compress
+    stream.WriteBool(false); // Compress internal
+
+    stream.WriteUint32(1); // Channels
+    stream.WriteUint32(16); // Bits per sample
+    stream.WriteUint32(22050);
+    stream.WriteUint32(waveSize / 2);
+    stream.WriteUint32(2); // Block align
+    stream.WriteUint32(22050 * 2);
+
+    stream.WriteBool(false); // Compressed
+    stream.WriteUint32(waveSize);
+
+    for (uint32_t i = 0; i < waveSize; ++i)
+    {
+        stream.WriteUint8(uint8_t(i * 31));
+    }
+}
+
+void WriteBenchScene(Stream& stream, Scene* scene, const std::string& name)
+{
+    scene->SetName(name);
+
+#if !EDITOR
+    // Asset::SaveStream() only writes the header and name in editor builds.
+    scene->WriteHeader(stream);
+    stream.WriteString(name);
+#endif
+
+    scene->SaveStream(stream, Platform::Count);
+}
+
+void RegisterBenchAsset(const std::string& name, Stream& stream)
+{
+    BenchAsset* asset = new BenchAsset();
+    asset->mName = name;
+    asset->mData.assign(stream.GetData(), stream.GetData() + stream.GetSize());
+    asset->mFile.mName = asset->mName.c_str();
+    asset->mFile.mData = asset->mData.data();
+    asset->mFile.mSize = uint32_t(asset->mData.size());
+    asset->mFile.mEngine = false;
+    sBenchAssets.push_back(asset);
+
+    AssetManager::Get()->DiscoverEmbeddedAssets(&asset->mFile, 1);
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <stdint.h>
+#include <string>
+
+#include "System/System.h"
+
+class Stream;
+class Scene;
+
+typedef void(*BenchmarkFunc)();
+
+struct BenchmarkDef
+{
+    const char* mName;
+    BenchmarkFunc mFunc;
+};
+
+// Records a failed correctness check. The run still continues so every failure gets logged.
+void BenchCheck(bool condition, const char* format, ...);
+uint32_t GetNumBenchFailures();
+
+// Writes a cooked, uncompressed 16 bit mono SoundWave asset of the given size into the stream.
+void WriteBenchSoundWave(Stream& stream, const std::string& name, uint32_t waveSize);
+
+// Writes a scene (usually a transient one made with Scene::Capture) as a cooked asset with the given name.
+void WriteBenchScene(Stream& stream, Scene* scene, const std::string& name);
+
+// Registers a cooked asset with the AssetManager as an embedded file, so it can be loaded by name.
+// The data is copied and kept until the process exits.
+void RegisterBenchAsset(const std::string& name, Stream& stream);
+
+// Runs func the given number of times and returns the average time of one run in microseconds.
+template<typename Func>
+double TimeIterations(uint32_t iterations, Func func)
+{
+    uint64_t startTime = SYS_GetTimeMicroseconds();
+
+    for (uint32_t i = 0; i < iterations; ++i)
+    {
+        func();
+    }
+
+    uint64_t endTime = SYS_GetTimeMicroseconds();
+    return double(endTime - startTime) / double(iterations);
+}
+
+// Stops the optimizer from discarding results that are only computed to be timed.
+template<typename T>
+void KeepAlive(const T& value)
+{
+    static volatile T sSink;
+    sSink = value;
+    (void)sSink;
+}
+
+// Small deterministic generator so every run times the same data.
+class BenchRandom
+{
+public:
+
+    explicit BenchRandom(uint32_t seed) : mState(seed) {}
+
+    uint32_t NextUint()
+    {
+        mState ^= mState << 13;
+        mState ^= mState >> 17;
+        mState ^= mState << 5;
+        return mState;
+    }
+
+    float NextFloat(float minValue, float maxValue)
+    {
+        float alpha = (NextUint() & 0xffffff) / float(0xffffff);
+        return minValue + (maxValue - minValue) * alpha;
+    }
+
+private:
+
+    uint32_t mState;
+};
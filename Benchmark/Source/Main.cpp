@@ -0,0 +1,106 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#undef min
+#undef max
+
+#include "Engine.h"
+#include "Log.h"
+
+#include "Benchmark.h"
+
+// Runs engine micro-benchmarks and correctness checks, then quits.
+// Pass "-bench <name>" to run a single benchmark. The process exits with 1 if any check failed.
+
+void BenchSkinning();
+void BenchJobs();
+void BenchCulling();
+void BenchAudio();
+void BenchAnimation();
+void BenchReplication();
+void BenchAssetLoad();
+void BenchContention();
+void BenchSpawn();
+
+static const BenchmarkDef sBenchmarks[] =
+{
+    { "skinning", BenchSkinning },
+    { "jobs", BenchJobs },
+    { "culling", BenchCulling },
+    { "audio", BenchAudio },
+    { "animation", BenchAnimation },
+    { "replication", BenchReplication },
+    { "assetload", BenchAssetLoad },
+    { "contention", BenchContention },
+    { "spawn", BenchSpawn },
+};
+
+static const char* GetBenchFilter()
+{
+    EngineState* engineState = GetEngineState();
+
+    for (int32_t i = 0; i + 1 < engineState->mArgC; ++i)
+    {
+        if (strcmp(engineState->mArgV[i], "-bench") == 0)
+        {
+            return engineState->mArgV[i + 1];
+        }
+    }
+
+    return nullptr;
+}
+
+InitOptions OctPreInitialize()
+{
+    InitOptions initOptions;
+    initOptions.mStandalone = true;
+    initOptions.mWidth = 320;
+    initOptions.mHeight = 240;
+    return initOptions;
+}
+
+void OctPostInitialize()
+{
+    const char* filter = GetBenchFilter();
+    uint32_t numBenchmarks = sizeof(sBenchmarks) / sizeof(sBenchmarks[0]);
+
+    for (uint32_t i = 0; i < numBenchmarks; ++i)
+    {
+        if (filter == nullptr || strcmp(filter, sBenchmarks[i].mName) == 0)
+        {
+            LogDebug("---- %s ----", sBenchmarks[i].mName);
+            sBenchmarks[i].mFunc();
+        }
+    }
+
+    Quit();
+}
+
+void OctPreUpdate()
+{
+
+}
+
+void OctPostUpdate()
+{
+
+}
+
+void OctPreShutdown()
+{
+
+}
+
+void OctPostShutdown()
+{
+    uint32_t numFailures = GetNumBenchFailures();
+
+    if (numFailures > 0)
+    {
+        // The log has already shut down at this point.
+        fprintf(stderr, "%u check(s) failed\n", numFailures);
+        exit(1);
+    }
+}
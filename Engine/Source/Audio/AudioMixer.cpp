@@ -0,0 +1,282 @@
+#if PLATFORM_LINUX
+
+#include "Audio/AudioMixer.h"
+
+#include "Assertion.h"
+#include "Maths.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define MIX_SSE 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#define MIX_NEON 1
+#include <arm_neon.h>
+#endif
+
+static inline float SampleToFloat(uint8_t sample)
+{
+    return float(sample) * 256.0f - 32767.0f;
+}
+
+static inline float SampleToFloat(int16_t sample)
+{
+    return float(sample);
+}
+
+template<typename SampleT, uint32_t kNumChannels>
+static inline void ReadFrame(const SoundVoice& voice, uint32_t frame, float& outL, float& outR)
+{
+    const SampleT* src = (const SampleT*)voice.mSrcBuffer + frame * kNumChannels;
+    outL = SampleToFloat(src[0]);
+    outR = (kNumChannels == 1) ? outL : SampleToFloat(src[1]);
+}
+
+static void Accumulate(const float* src, float volume, float* bus, uint32_t count)
+{
+    uint32_t i = 0;
+
+#if MIX_SSE
+    __m128 vol = _mm_set1_ps(volume);
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 s = _mm_loadu_ps(src + i);
+        __m128 b = _mm_loadu_ps(bus + i);
+        _mm_storeu_ps(bus + i, _mm_add_ps(b, _mm_mul_ps(s, vol)));
+    }
+#elif MIX_NEON
+    for (; i + 4 <= count; i += 4)
+    {
+        float32x4_t s = vld1q_f32(src + i);
+        float32x4_t b = vld1q_f32(bus + i);
+        vst1q_f32(bus + i, vmlaq_n_f32(b, s, volume));
+    }
+#endif
+
+    for (; i < count; ++i)
+    {
+        bus[i] += src[i] * volume;
+    }
+}
+
+static void LerpAccumulate(const float* src0, const float* src1, const float* alpha, float volume, float* bus, uint32_t count)
+{
+    uint32_t i = 0;
+
+#if MIX_SSE
+    __m128 vol = _mm_set1_ps(volume);
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 s0 = _mm_loadu_ps(src0 + i);
+        __m128 s1 = _mm_loadu_ps(src1 + i);
+        __m128 a = _mm_loadu_ps(alpha + i);
+        __m128 s = _mm_add_ps(s0, _mm_mul_ps(_mm_sub_ps(s1, s0), a));
+        __m128 b = _mm_loadu_ps(bus + i);
+        _mm_storeu_ps(bus + i, _mm_add_ps(b, _mm_mul_ps(s, vol)));
+    }
+#elif MIX_NEON
+    for (; i + 4 <= count; i += 4)
+    {
+        float32x4_t s0 = vld1q_f32(src0 + i);
+        float32x4_t s1 = vld1q_f32(src1 + i);
+        float32x4_t a = vld1q_f32(alpha + i);
+        float32x4_t s = vmlaq_f32(s0, vsubq_f32(s1, s0), a);
+        float32x4_t b = vld1q_f32(bus + i);
+        vst1q_f32(bus + i, vmlaq_n_f32(b, s, volume));
+    }
+#endif
+
+    for (; i < count; ++i)
+    {
+        float s = src0[i] + (src1[i] - src0[i]) * alpha[i];
+        bus[i] += s * volume;
+    }
+}
+
+// Mixes frames [0, numFrames) of the voice into the float bus, specialized per source format
+// so the inner loops don't branch on channel count or sample size.
+template<typename SampleT, uint32_t kNumChannels>
+static void MixVoice(SoundVoice& voice, float* busL, float* busR, uint32_t numFrames)
+{
+    float src0L[AUDIO_MIX_BLOCK_FRAMES];
+    float src0R[AUDIO_MIX_BLOCK_FRAMES];
+    float src1L[AUDIO_MIX_BLOCK_FRAMES];
+    float src1R[AUDIO_MIX_BLOCK_FRAMES];
+    float alpha[AUDIO_MIX_BLOCK_FRAMES];
+
+    const uint32_t srcFrames = voice.mSrcFrames;
+    const double step = glm::max(double(voice.mPitch) * (double(voice.mSampleRate) / AUDIO_OUTPUT_RATE), 0.0);
+    const double lastSafePos = double(srcFrames) - 1.0;
+    double pos = voice.mCurFrame;
+    uint32_t frame = 0;
+
+    while (frame < numFrames)
+    {
+        uint32_t remaining = glm::min(numFrames - frame, uint32_t(AUDIO_MIX_BLOCK_FRAMES));
+
+        if (pos < lastSafePos)
+        {
+            // Run of frames where both interpolation taps are inside the source, so no wrap checks are needed.
+            uint32_t count = remaining;
+
+            if (step > 0.0)
+            {
+                double runFrames = glm::ceil((lastSafePos - pos) / step);
+                count = uint32_t(glm::min(runFrames, double(remaining)));
+
+                while (count > 1 && pos + (count - 1) * step >= lastSafePos)
+                {
+                    --count;
+                }
+
+                count = glm::max(count, 1u);
+            }
+
+            if (step == 1.0 && pos == glm::floor(pos))
+            {
+                // Same rate as the output and aligned on a source frame, nothing to interpolate.
+                uint32_t srcFrame = uint32_t(pos);
+
+                for (uint32_t i = 0; i < count; ++i)
+                {
+                    ReadFrame<SampleT, kNumChannels>(voice, srcFrame + i, src0L[i], src0R[i]);
+                }
+
+                Accumulate(src0L, voice.mVolumeL, busL + frame, count);
+                Accumulate((kNumChannels == 1) ? src0L : src0R, voice.mVolumeR, busR + frame, count);
+            }
+            else
+            {
+                for (uint32_t i = 0; i < count; ++i)
+                {
+                    double srcPos = pos + i * step;
+                    uint32_t srcFrame = uint32_t(srcPos);
+                    alpha[i] = float(srcPos - double(srcFrame));
+                    ReadFrame<SampleT, kNumChannels>(voice, srcFrame, src0L[i], src0R[i]);
+                    ReadFrame<SampleT, kNumChannels>(voice, srcFrame + 1, src1L[i], src1R[i]);
+                }
+
+                LerpAccumulate(src0L, src1L, alpha, voice.mVolumeL, busL + frame, count);
+
+                if (kNumChannels == 1)
+                {
+                    LerpAccumulate(src0L, src1L, alpha, voice.mVolumeR, busR + frame, count);
+                }
+                else
+                {
+                    LerpAccumulate(src0R, src1R, alpha, voice.mVolumeR, busR + frame, count);
+                }
+            }
+
+            pos += count * step;
+            frame += count;
+
+            // With a step above 1 the run can end past the last frame.
+            while (voice.mLoop && pos >= double(srcFrames))
+            {
+                pos -= double(srcFrames);
+            }
+        }
+        else
+        {
+            // The second tap is past the last source frame. Wrap for looping sounds, otherwise fade into silence.
+            uint32_t srcFrame = uint32_t(pos);
+
+            if (srcFrame >= srcFrames)
+            {
+                OCT_ASSERT(!voice.mLoop);
+                break;
+            }
+
+            float s0L, s0R;
+            float s1L = 0.0f;
+            float s1R = 0.0f;
+            ReadFrame<SampleT, kNumChannels>(voice, srcFrame, s0L, s0R);
+
+            if (voice.mLoop)
+            {
+                ReadFrame<SampleT, kNumChannels>(voice, (srcFrame + 1) % srcFrames, s1L, s1R);
+            }
+
+            float a = float(pos - double(srcFrame));
+            busL[frame] += (s0L + (s1L - s0L) * a) * voice.mVolumeL;
+            busR[frame] += (s0R + (s1R - s0R) * a) * voice.mVolumeR;
+
+            pos += step;
+            frame += 1;
+
+            while (voice.mLoop && pos >= double(srcFrames))
+            {
+                pos -= double(srcFrames);
+            }
+        }
+    }
+
+    if (!voice.mLoop && frame < numFrames)
+    {
+        // Ran off the end of the sound.
+        pos = double(srcFrames);
+    }
+
+    voice.mCurFrame = pos;
+}
+
+void ConvertBusToPcm(const float* busL, const float* busR, int16_t* dst, uint32_t numFrames)
+{
+    uint32_t i = 0;
+
+#if MIX_SSE
+    for (; i + 4 <= numFrames; i += 4)
+    {
+        __m128i l = _mm_cvtps_epi32(_mm_loadu_ps(busL + i));
+        __m128i r = _mm_cvtps_epi32(_mm_loadu_ps(busR + i));
+
+        // Interleave L/R and narrow with saturation.
+        __m128i lo = _mm_unpacklo_epi32(l, r);
+        __m128i hi = _mm_unpackhi_epi32(l, r);
+        _mm_storeu_si128((__m128i*)(dst + i * 2), _mm_packs_epi32(lo, hi));
+    }
+#elif MIX_NEON
+    // vcvtq truncates, so add +/-0.5 first to round like the other paths.
+    const float32x4_t half = vdupq_n_f32(0.5f);
+    const uint32x4_t signMask = vdupq_n_u32(0x80000000);
+
+    for (; i + 4 <= numFrames; i += 4)
+    {
+        float32x4_t l = vld1q_f32(busL + i);
+        float32x4_t r = vld1q_f32(busR + i);
+        float32x4_t halfL = vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(half), vandq_u32(vreinterpretq_u32_f32(l), signMask)));
+        float32x4_t halfR = vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(half), vandq_u32(vreinterpretq_u32_f32(r), signMask)));
+
+        int16x4x2_t lr;
+        lr.val[0] = vqmovn_s32(vcvtq_s32_f32(vaddq_f32(l, halfL)));
+        lr.val[1] = vqmovn_s32(vcvtq_s32_f32(vaddq_f32(r, halfR)));
+        vst2_s16(dst + i * 2, lr);
+    }
+#endif
+
+    for (; i < numFrames; ++i)
+    {
+        dst[i * 2 + 0] = int16_t(glm::clamp(int32_t(glm::round(busL[i])), -32768, 32767));
+        dst[i * 2 + 1] = int16_t(glm::clamp(int32_t(glm::round(busR[i])), -32768, 32767));
+    }
+}
+
+void MixSoundVoice(SoundVoice& voice, float* busL, float* busR, uint32_t numFrames)
+{
+    if (voice.mBytesPerSample == 1)
+    {
+        if (voice.mNumChannels == 1)
+            MixVoice<uint8_t, 1>(voice, busL, busR, numFrames);
+        else
+            MixVoice<uint8_t, 2>(voice, busL, busR, numFrames);
+    }
+    else
+    {
+        if (voice.mNumChannels == 1)
+            MixVoice<int16_t, 1>(voice, busL, busR, numFrames);
+        else
+            MixVoice<int16_t, 2>(voice, busL, busR, numFrames);
+    }
+}
+
+#endif
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <stdint.h>
+
+// Software mixer for platforms that output a single stereo PCM stream (currently Linux).
+// Voices are mixed into float buses, then converted to interleaved 16-bit PCM.
+#define AUDIO_OUTPUT_RATE 44100
+#define AUDIO_MIX_BLOCK_FRAMES 256
+
+struct SoundVoice
+{
+    int32_t mSampleRate = 44100;
+    float mPitch = 1.0f;
+    float mVolumeL = 1.0f;
+    float mVolumeR = 1.0f;
+    uint8_t* mSrcBuffer = nullptr;
+    uint32_t mSrcBufferLen = 0;
+    uint32_t mSrcFrames = 0;
+    double mCurFrame = 0.0;
+    uint32_t mNumChannels = 2;
+    uint32_t mBytesPerSample = 2;
+    uint32_t mSerial = 0;
+    bool mLoop = false;
+    bool mActive = false;
+};
+
+// Adds frames [0, numFrames) of the voice to the buses and advances voice.mCurFrame.
+// Once a non-looping voice runs off the end, mCurFrame is left at mSrcFrames.
+void MixSoundVoice(SoundVoice& voice, float* busL, float* busR, uint32_t numFrames);
+
+// Rounds and saturates the buses into interleaved stereo samples.
+void ConvertBusToPcm(const float* busL, const float* busR, int16_t* dst, uint32_t numFrames);
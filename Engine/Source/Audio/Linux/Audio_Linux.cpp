@@ -2,6 +2,7 @@
 
 #include "Audio/Audio.h"
 #include "Audio/AudioConstants.h"
+#include "Audio/AudioMixer.h"
 #include "System/System.h"
 
 #include "Assets/SoundWave.h"
@@ -9,30 +10,198 @@
 #include "Maths.h"
 
 #include <alsa/asoundlib.h>
+#include <pthread.h>
+#include <sched.h>
+#include <atomic>
+
+// Mixing runs on its own thread that blocks on ALSA one period at a time, so latency
+// doesn't depend on the game's frame rate. The main thread only pushes commands.
+#define AUDIO_PERIOD_FRAMES 512
+#define AUDIO_NUM_PERIODS 4
+#define AUDIO_COMMAND_QUEUE_SIZE 1024
+#define AUDIO_MIN_BACKOFF_MS 10u
+#define AUDIO_MAX_BACKOFF_MS 500u
+
+static_assert((AUDIO_COMMAND_QUEUE_SIZE & (AUDIO_COMMAND_QUEUE_SIZE - 1)) == 0, "Command queue size must be a power of two");
 
 snd_pcm_t* sSoundDevice = nullptr;
-snd_pcm_uframes_t sPlaybackFrames = 0;
-uint32_t sMixBufferLen = 0;
+snd_pcm_uframes_t sPeriodFrames = 0;
 int16_t* sMixBuffer = nullptr;
+float* sBusL = nullptr;
+float* sBusR = nullptr;
 
-struct SoundVoice
+enum class AudioCommandType : uint8_t
 {
-    int32_t mSampleRate = 44100;
-    float mPitch = 1.0f;
+    Play,
+    Stop,
+    SetVolume,
+    SetPitch,
+    FreeBuffer,
+
+    Count
+};
+
+struct AudioCommand
+{
+    AudioCommandType mType = AudioCommandType::Count;
+    uint32_t mVoiceIndex = 0;
     float mVolumeL = 1.0f;
     float mVolumeR = 1.0f;
-    uint8_t* mSrcBuffer = nullptr;
-    uint32_t mSrcBufferLen = 0;
-    uint32_t mSrcFrames = 0;
-    float mCurFrame = 0;
-    uint32_t mNumChannels = 2;
-    uint32_t mBytesPerSample = 2;
-    bool mLoop = false;
-    bool mActive = false;
+    float mPitch = 1.0f;
+    void* mBuffer = nullptr;
+    SoundVoice mVoice;
 };
 
+// Voices are only touched by the mixing thread once it is running.
 static SoundVoice sVoices[AUDIO_MAX_VOICES];
 
+// Main thread view of each voice. A voice is playing until the mixer reports that the
+// sound started with the current serial has finished.
+static bool sVoicePlaying[AUDIO_MAX_VOICES] = {};
+static uint32_t sVoicePlaySerial[AUDIO_MAX_VOICES] = {};
+static std::atomic<uint32_t> sVoiceFinishedSerial[AUDIO_MAX_VOICES];
+
+// Single producer (main thread), single consumer (mixing thread) ring buffer.
+static AudioCommand sCommands[AUDIO_COMMAND_QUEUE_SIZE];
+static std::atomic<uint32_t> sCommandHead(0);
+static std::atomic<uint32_t> sCommandTail(0);
+
+static ThreadObject* sMixThread = nullptr;
+static std::atomic<bool> sMixThreadRunning(false);
+static std::atomic<bool> sShutdownMixThread(false);
+
+static void PushCommand(const AudioCommand& command)
+{
+    uint32_t head = sCommandHead.load(std::memory_order_relaxed);
+
+    // The mixer drains the queue every period, so this only waits if thousands of commands are issued at once.
+    while (head - sCommandTail.load(std::memory_order_acquire) >= AUDIO_COMMAND_QUEUE_SIZE)
+    {
+        SYS_Sleep(1);
+    }
+
+    sCommands[head & (AUDIO_COMMAND_QUEUE_SIZE - 1)] = command;
+    sCommandHead.store(head + 1, std::memory_order_release);
+}
+
+static void ProcessCommands()
+{
+    uint32_t tail = sCommandTail.load(std::memory_order_relaxed);
+    uint32_t head = sCommandHead.load(std::memory_order_acquire);
+
+    while (tail != head)
+    {
+        const AudioCommand& command = sCommands[tail & (AUDIO_COMMAND_QUEUE_SIZE - 1)];
+        SoundVoice& voice = sVoices[command.mVoiceIndex];
+
+        switch (command.mType)
+        {
+        case AudioCommandType::Play:
+            voice = command.mVoice;
+            break;
+        case AudioCommandType::Stop:
+            voice.mActive = false;
+            break;
+        case AudioCommandType::SetVolume:
+            voice.mVolumeL = command.mVolumeL;
+            voice.mVolumeR = command.mVolumeR;
+            break;
+        case AudioCommandType::SetPitch:
+            voice.mPitch = command.mPitch;
+            break;
+        case AudioCommandType::FreeBuffer:
+            // Queued after any Stop for voices using this buffer, so nothing reads it anymore.
+            SYS_AlignedFree(command.mBuffer);
+            break;
+        default:
+            OCT_ASSERT(0);
+            break;
+        }
+
+        ++tail;
+    }
+
+    sCommandTail.store(tail, std::memory_order_release);
+}
+
+static void MixFrames(int16_t* dst, uint32_t numFrames)
+{
+    memset(sBusL, 0, numFrames * sizeof(float));
+    memset(sBusR, 0, numFrames * sizeof(float));
+
+    for (uint32_t i = 0; i < AUDIO_MAX_VOICES; ++i)
+    {
+        SoundVoice& voice = sVoices[i];
+
+        if (!voice.mActive ||
+            voice.mCurFrame >= double(voice.mSrcFrames))
+        {
+            continue;
+        }
+
+        OCT_ASSERT(voice.mSrcFrames > 0);
+
+        MixSoundVoice(voice, sBusL, sBusR, numFrames);
+
+        if (voice.mCurFrame >= double(voice.mSrcFrames))
+        {
+            // Let the main thread know this sound is done.
+            sVoiceFinishedSerial[i].store(voice.mSerial, std::memory_order_release);
+        }
+    }
+
+    ConvertBusToPcm(sBusL, sBusR, dst, numFrames);
+}
+
+static ThreadFuncRet MixThreadFunc(void* arg)
+{
+    // Ask for real-time scheduling so the mixer isn't starved by the game threads.
+    // This usually requires extra privileges, in which case we just keep the default policy.
+    sched_param param = {};
+    param.sched_priority = sched_get_priority_min(SCHED_FIFO);
+    pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+
+    uint32_t backoffMs = 0;
+
+    while (!sShutdownMixThread.load(std::memory_order_acquire))
+    {
+        ProcessCommands();
+        MixFrames(sMixBuffer, uint32_t(sPeriodFrames));
+
+        // Blocks until there is room for a period, which paces this loop.
+        snd_pcm_sframes_t framesWritten = snd_pcm_writei(sSoundDevice, sMixBuffer, sPeriodFrames);
+
+        if (framesWritten < 0)
+        {
+            // Recovers from underruns (-EPIPE) and suspends.
+            int err = snd_pcm_recover(sSoundDevice, int(framesWritten), 1);
+
+            if (err < 0)
+            {
+                // The device is gone (e.g. unplugged), so writei won't block anymore.
+                // Keep draining commands so buffers still get freed, but back off instead of spinning.
+                if (backoffMs == 0)
+                {
+                    LogError("Audio device write failed: %s", snd_strerror(err));
+                }
+
+                backoffMs = glm::clamp(backoffMs * 2, AUDIO_MIN_BACKOFF_MS, AUDIO_MAX_BACKOFF_MS);
+                SYS_Sleep(backoffMs);
+                snd_pcm_prepare(sSoundDevice);
+                continue;
+            }
+        }
+
+        if (backoffMs != 0 && framesWritten >= 0)
+        {
+            LogDebug("Audio device recovered");
+            backoffMs = 0;
+        }
+    }
+
+    THREAD_RETURN();
+}
+
 void AUD_Initialize()
 {
     int err = snd_pcm_open( &sSoundDevice, "default", SND_PCM_STREAM_PLAYBACK, 0 );
@@ -42,6 +211,7 @@ void AUD_Initialize()
     {
         LogError("Cannot open audio device");
         OCT_ASSERT(0);
+        sSoundDevice = nullptr;
         return;
     }
     else
@@ -63,187 +233,85 @@ void AUD_Initialize()
         return;
     }
 
-    // Create enough buffer room for a 30 fps update rate.
-    sPlaybackFrames = snd_pcm_uframes_t((1 / 15.0f) * 44100);
-
     err = snd_pcm_hw_params_set_rate_resample(sSoundDevice, hw_params, 1);
     err = snd_pcm_hw_params_set_access(sSoundDevice, hw_params, SND_PCM_ACCESS_RW_INTERLEAVED);
     err = snd_pcm_hw_params_set_format(sSoundDevice, hw_params, SND_PCM_FORMAT_S16_LE);
     err = snd_pcm_hw_params_set_channels(sSoundDevice, hw_params, 2);
-    err = snd_pcm_hw_params_set_buffer_size(sSoundDevice, hw_params, sPlaybackFrames);
 
-    unsigned int playbackRate = 44100;
+    unsigned int playbackRate = AUDIO_OUTPUT_RATE;
     err = snd_pcm_hw_params_set_rate_near(sSoundDevice, hw_params, &playbackRate, 0);
 
+    // Small periods since the mixing thread no longer waits on the game's frame.
+    snd_pcm_uframes_t periodFrames = AUDIO_PERIOD_FRAMES;
+    err = snd_pcm_hw_params_set_period_size_near(sSoundDevice, hw_params, &periodFrames, 0);
+    snd_pcm_uframes_t bufferFrames = periodFrames * AUDIO_NUM_PERIODS;
+    err = snd_pcm_hw_params_set_buffer_size_near(sSoundDevice, hw_params, &bufferFrames);
+
     err = snd_pcm_hw_params(sSoundDevice, hw_params);
 
     snd_pcm_uframes_t bufferSize;
     snd_pcm_hw_params_get_buffer_size( hw_params, &bufferSize );
     LogDebug("Buffer size = %d frames", (int32_t) bufferSize);
-    sPlaybackFrames = bufferSize;
     LogDebug("Significant bits for linear samples = %d",snd_pcm_hw_params_get_sbits(hw_params));
 
-    snd_pcm_uframes_t periodFrames = 0;
-	snd_pcm_hw_params_get_period_size(hw_params, &periodFrames, 0);
-	LogDebug("Period Frames: %lu\n", periodFrames);
+    snd_pcm_hw_params_get_period_size(hw_params, &periodFrames, 0);
+    LogDebug("Period Frames: %lu\n", periodFrames);
+    sPeriodFrames = periodFrames;
 
     snd_pcm_hw_params_free(hw_params);
     err = snd_pcm_prepare(sSoundDevice);
 
-    sMixBufferLen = sPlaybackFrames * 4; // ( 2 samples (L/R) * 2 bytes per sample)
-    sMixBuffer = new int16_t[sMixBufferLen / 2];
-    memset(sMixBuffer, 0, sMixBufferLen);
-    snd_pcm_writei(sSoundDevice, sMixBuffer, sPlaybackFrames);
-    //snd_pcm_start(sSoundDevice);
+    sMixBuffer = new int16_t[sPeriodFrames * 2];
+    sBusL = new float[sPeriodFrames];
+    sBusR = new float[sPeriodFrames];
+    memset(sMixBuffer, 0, sPeriodFrames * 4);
 
     LogDebug("PCM name: '%s'", snd_pcm_name(sSoundDevice));
     LogDebug("PCM state: %s", snd_pcm_state_name(snd_pcm_state(sSoundDevice)));
+
+    for (uint32_t i = 0; i < AUDIO_MAX_VOICES; ++i)
+    {
+        sVoiceFinishedSerial[i].store(0);
+    }
+
+    sShutdownMixThread = false;
+    sMixThreadRunning = true;
+    sMixThread = SYS_CreateThread(MixThreadFunc, nullptr);
 }
 
 void AUD_Shutdown()
 {
+    if (sMixThread != nullptr)
+    {
+        sShutdownMixThread = true;
+        SYS_JoinThread(sMixThread);
+        SYS_DestroyThread(sMixThread);
+        sMixThread = nullptr;
+    }
+
+    sMixThreadRunning = false;
+
+    // Handle anything queued after the last mix (buffer frees in particular).
+    ProcessCommands();
+
     delete [] sMixBuffer;
     sMixBuffer = nullptr;
+    delete [] sBusL;
+    sBusL = nullptr;
+    delete [] sBusR;
+    sBusR = nullptr;
 
     if (sSoundDevice != nullptr)
     {
+        snd_pcm_drop(sSoundDevice);
         snd_pcm_close(sSoundDevice);
+        sSoundDevice = nullptr;
     }
 }
 
 void AUD_Update()
-{   
-    int32_t frames = (int32_t) snd_pcm_avail(sSoundDevice);
-    frames = glm::min(int32_t(sMixBufferLen) / 4, frames);
-
-    //LogDebug("Frames to mix: %d", frames);
-    //LogDebug("PCM state: %s", snd_pcm_state_name(snd_pcm_state(sSoundDevice)));
-
-    if (frames > 0)
-    {
-        // We need to mix an audio buffer
-        //OCT_ASSERT(frames * 4  <= int32_t(sMixBufferLen));
-        memset(sMixBuffer, 0, frames * 4);
-
-        for (uint32_t i = 0; i < AUDIO_MAX_VOICES; ++i)
-        {
-            if (sVoices[i].mActive)
-            {
-                SoundVoice& voice = sVoices[i];
-                OCT_ASSERT(voice.mSrcFrames > 0);
-
-                // If the voice is active, that means we need to mix *frames* number of frames
-                // into the mix buffer. The src voice may move at a faster or slower pace based on the 
-                // pitch value, so we will need to interpolate between frames.
-
-                // TODO: Handle pitch
-                float srcDeltaFrame = 1 * voice.mPitch * (voice.mSampleRate / 44100.0f);
-
-                for (int32_t dstFrame = 0; dstFrame < frames; ++dstFrame)
-                {
-                    float srcFrameFloat = voice.mCurFrame + (dstFrame * srcDeltaFrame);
-
-                    int32_t srcFrames[2] = { int32_t(srcFrameFloat), int32_t(srcFrameFloat) + 1 };
-                    float frameInterpAlpha = fmod(srcFrameFloat, 1.0f);
-
-                    int16_t srcSampleL[2] = { 0, 0 };
-                    int16_t srcSampleR[2] = { 0, 0 };
-
-                    if (voice.mLoop)
-                    {
-                        if (srcFrames[0] >= int32_t(voice.mSrcFrames))
-                            srcFrames[0] = srcFrames[0] % voice.mSrcFrames;
-                        if (srcFrames[1] >= int32_t(voice.mSrcFrames))
-                            srcFrames[1] = srcFrames[1] % voice.mSrcFrames;
-                    }
-
-                    // Interpolate between the two src frames
-                    for (int32_t f = 0; f < 2; ++f)
-                    {
-                        int32_t frameIndex = srcFrames[f];
-
-                        if (frameIndex >= int32_t(voice.mSrcFrames))
-                        {
-                            srcSampleL[f] = 0;
-                            srcSampleR[f] = 0;
-                        }
-                        else if (voice.mNumChannels == 1)
-                        {
-                            // Use same src sample for left and right dst samples
-
-                            if (voice.mBytesPerSample == 1)
-                            {
-                                // uint8 samples
-                                // Convert from uint8_t to int16_t
-                                srcSampleL[f] = *((uint8_t*) (voice.mSrcBuffer + (frameIndex * 1 * 1)));
-                                srcSampleL[f] = srcSampleL[f] * 256 - 32767;
-                                srcSampleR[f] = srcSampleL[f];   
-                            }
-                            else
-                            {
-                                // int16 samples
-                                srcSampleL[f] = *((int16_t*) (voice.mSrcBuffer + (frameIndex * 1 * 2)));
-                                srcSampleR[f] = srcSampleL[f];
-                            }
-                        }
-                        else
-                        {
-                            if (voice.mBytesPerSample == 1)
-                            {
-                                // uint8 samples
-                                srcSampleL[f] = *((uint8_t*) (voice.mSrcBuffer + (frameIndex * 2 * 1)));
-                                srcSampleR[f] = *((uint8_t*) (voice.mSrcBuffer + (frameIndex * 2 * 1 + 1)));
-                                srcSampleL[f] = srcSampleL[f] * 256 - 32767;
-                                srcSampleR[f] = srcSampleR[f] * 256 - 32767;
-                            }
-                            else
-                            {
-                                // int16 samples
-                                srcSampleL[f] = *((int16_t*) (voice.mSrcBuffer + (frameIndex * 2 * 2)));
-                                srcSampleR[f] = *((int16_t*) (voice.mSrcBuffer + (frameIndex * 2 * 2 + 2)));
-                            }
-                        }
-                    }
-
-                    // We have four samples now, so now we need to linearly interpolate between the left and right channels
-                    // to get a final 2 samples that we will accumulate into the mix buffer.
-                    int32_t finalSampleL = (int32_t)glm::mix(srcSampleL[0], srcSampleL[1], frameInterpAlpha);
-                    int32_t finalSampleR = (int32_t)glm::mix(srcSampleR[0], srcSampleR[1], frameInterpAlpha);
-                    finalSampleL = int32_t(finalSampleL * voice.mVolumeL);
-                    finalSampleR = int32_t(finalSampleR * voice.mVolumeR);
-                    finalSampleL = glm::clamp(finalSampleL + (int32_t)sMixBuffer[dstFrame * 2 + 0], -32768, 32767);
-                    finalSampleR = glm::clamp(finalSampleR + (int32_t)sMixBuffer[dstFrame * 2 + 1], -32768, 32767);
-                    sMixBuffer[dstFrame * 2 + 0] = (int16_t)finalSampleL;
-                    sMixBuffer[dstFrame * 2 + 1] = (int16_t)finalSampleR;
-                }
-
-                // We've finished getting all of the samples for this voice. Increase the current sample value
-                // to keep track of where to pick up next frame. If the sound is looping we need to mod the frame value
-                // otherwise let the curFrame exceed the *voice.mSrcFrames* count so we can determine that it is finished playing.
-
-                voice.mCurFrame += (frames * srcDeltaFrame);
-
-                if (voice.mLoop)
-                {
-                    voice.mCurFrame = fmod(voice.mCurFrame, (float) voice.mSrcFrames);
-                }
-            }
-        }
-    }
-
-    snd_pcm_sframes_t framesWritten = 0;
-    // We've generated the frames we need for this update, so now we just need to sent it to the audio driver.
-    if (frames < 0 ||
-        (frames > 0 && (framesWritten = snd_pcm_writei(sSoundDevice, sMixBuffer, frames)) == -EPIPE))
-    {
-        //LogWarning("Audio buffer underrun.");
-        snd_pcm_prepare(sSoundDevice);
-    } 
-    else if (framesWritten < 0)
-    {
-        LogError("Can't write to PCM device. %s", snd_strerror(framesWritten));
-        return;
-    }
+{
+    // Mixing happens on the mixing thread.
 }
 
 void AUD_Play(
@@ -255,48 +323,90 @@ void AUD_Play(
     float startTime,
     bool spatial)
 {
-    OCT_ASSERT(!sVoices[voiceIndex].mActive);
-
-    sVoices[voiceIndex].mActive = true;
-    sVoices[voiceIndex].mBytesPerSample = soundWave->GetBitsPerSample() / 8;
-    sVoices[voiceIndex].mCurFrame = 0.0f;
-    sVoices[voiceIndex].mLoop = loop;
-    sVoices[voiceIndex].mNumChannels = soundWave->GetNumChannels();
-    sVoices[voiceIndex].mPitch = pitch;
-    sVoices[voiceIndex].mSampleRate = soundWave->GetSampleRate();
-    sVoices[voiceIndex].mSrcBuffer = soundWave->GetWaveData();
-    sVoices[voiceIndex].mSrcBufferLen = soundWave->GetWaveDataSize();
-    sVoices[voiceIndex].mVolumeL = spatial ? 0.0f : volume;
-    sVoices[voiceIndex].mVolumeR = spatial ? 0.0f : volume;
-    
-    int32_t bytesPerFrame = sVoices[voiceIndex].mBytesPerSample * sVoices[voiceIndex].mNumChannels;
-    sVoices[voiceIndex].mSrcFrames = sVoices[voiceIndex].mSrcBufferLen / bytesPerFrame;
-
-    OCT_ASSERT(sVoices[voiceIndex].mSrcBufferLen % bytesPerFrame == 0);
+    OCT_ASSERT(!sVoicePlaying[voiceIndex]);
+
+    if (!sMixThreadRunning)
+    {
+        return;
+    }
+
+    AudioCommand command;
+    command.mType = AudioCommandType::Play;
+    command.mVoiceIndex = voiceIndex;
+
+    SoundVoice& voice = command.mVoice;
+    voice.mActive = true;
+    voice.mBytesPerSample = soundWave->GetBitsPerSample() / 8;
+    voice.mCurFrame = 0.0;
+    voice.mLoop = loop;
+    voice.mNumChannels = soundWave->GetNumChannels();
+    voice.mPitch = pitch;
+    voice.mSampleRate = soundWave->GetSampleRate();
+    voice.mSrcBuffer = soundWave->GetWaveData();
+    voice.mSrcBufferLen = soundWave->GetWaveDataSize();
+    voice.mVolumeL = spatial ? 0.0f : volume;
+    voice.mVolumeR = spatial ? 0.0f : volume;
+
+    int32_t bytesPerFrame = voice.mBytesPerSample * voice.mNumChannels;
+    voice.mSrcFrames = voice.mSrcBufferLen / bytesPerFrame;
+
+    OCT_ASSERT(voice.mSrcBufferLen % bytesPerFrame == 0);
     OCT_ASSERT(bytesPerFrame > 0 &&
            bytesPerFrame <= 4);
+
+    if (voice.mSrcFrames == 0)
+    {
+        return;
+    }
+
+    voice.mSerial = ++sVoicePlaySerial[voiceIndex];
+    sVoicePlaying[voiceIndex] = true;
+
+    PushCommand(command);
 }
 
 void AUD_Stop(uint32_t voiceIndex)
 {
-    sVoices[voiceIndex].mActive = false;
+    if (sVoicePlaying[voiceIndex])
+    {
+        sVoicePlaying[voiceIndex] = false;
+
+        AudioCommand command;
+        command.mType = AudioCommandType::Stop;
+        command.mVoiceIndex = voiceIndex;
+        PushCommand(command);
+    }
 }
 
 bool AUD_IsPlaying(uint32_t voiceIndex)
 {
-    return sVoices[voiceIndex].mActive &&
-           sVoices[voiceIndex].mCurFrame < sVoices[voiceIndex].mSrcFrames;
+    return sVoicePlaying[voiceIndex] &&
+           sVoiceFinishedSerial[voiceIndex].load(std::memory_order_acquire) != sVoicePlaySerial[voiceIndex];
 }
 
 void AUD_SetVolume(uint32_t voiceIndex, float leftVolume, float rightVolume)
 {
-    sVoices[voiceIndex].mVolumeL = leftVolume;
-    sVoices[voiceIndex].mVolumeR = rightVolume;
+    if (sVoicePlaying[voiceIndex])
+    {
+        AudioCommand command;
+        command.mType = AudioCommandType::SetVolume;
+        command.mVoiceIndex = voiceIndex;
+        command.mVolumeL = leftVolume;
+        command.mVolumeR = rightVolume;
+        PushCommand(command);
+    }
 }
 
 void AUD_SetPitch(uint32_t voiceIndex, float pitch)
 {
-    sVoices[voiceIndex].mPitch = pitch;
+    if (sVoicePlaying[voiceIndex])
+    {
+        AudioCommand command;
+        command.mType = AudioCommandType::SetPitch;
+        command.mVoiceIndex = voiceIndex;
+        command.mPitch = pitch;
+        PushCommand(command);
+    }
 }
 
 uint8_t* AUD_AllocWaveBuffer(uint32_t size)
@@ -306,7 +416,18 @@ uint8_t* AUD_AllocWaveBuffer(uint32_t size)
 
 void AUD_FreeWaveBuffer(void* buffer)
 {
-    SYS_AlignedFree(buffer);
+    if (sMixThreadRunning)
+    {
+        // The mixer may still be reading this buffer until it handles the Stop commands queued before this.
+        AudioCommand command;
+        command.mType = AudioCommandType::FreeBuffer;
+        command.mBuffer = buffer;
+        PushCommand(command);
+    }
+    else
+    {
+        SYS_AlignedFree(buffer);
+    }
 }
 
 void AUD_ProcessWaveBuffer(SoundWave* soundWave)
@@ -32,6 +32,8 @@
 #include "Assets/Font.h"
 #include "AssetDir.h"
 #include "EmbeddedFile.h"
+#include "AssetArchive.h"
+#include "LuaBytecode.h"
 #include "Utilities.h"
 #include "EditorUtils.h"
 #include "EditorImgui.h"
@@ -122,6 +124,7 @@ void ActionManager::BuildData(Platform platform, bool embedded)
     const std::string& projectName = engineState->mProjectName;
 
     std::vector<std::pair<AssetStub*, std::string> > embeddedAssets;
+    std::vector<AssetArchiveSource> archiveSources;
 
     if (projectDir == "")
     {
@@ -181,7 +184,7 @@ void ActionManager::BuildData(Platform platform, bool embedded)
             }
 
             std::string packFile = packDir + stub->mAsset->GetName() + ".oct";
-            stub->mAsset->SaveFile(packFile.c_str(), platform);
+            stub->mAsset->SaveFile(packFile.c_str(), platform, true);
 
             if (true)
             {
@@ -196,6 +199,14 @@ void ActionManager::BuildData(Platform platform, bool embedded)
             {
                 embeddedAssets.push_back({ stub, packFile });
             }
+            else
+            {
+                AssetArchiveSource source;
+                source.mName = stub->mName;
+                source.mPath = packFile;
+                source.mEngine = engine;
+                archiveSources.push_back(source);
+            }
 
             if (!alreadyLoaded)
             {
@@ -258,6 +269,27 @@ void ActionManager::BuildData(Platform platform, bool embedded)
         registryFile = nullptr;
     }
 
+    // Non-embedded builds also get every cooked asset packed into a single archive, which the
+    // game mounts instead of opening each .oct file listed in the registry. Once the archive is
+    // written the loose .oct files are only duplicates, so they are removed. If writing it fails,
+    // they're kept and the game falls back to loading them through the registry.
+    if (!embedded)
+    {
+        std::string archiveFileName = packagedDir + projectName + "/Assets.octa";
+
+        if (AssetArchive::Write(archiveFileName.c_str(), archiveSources))
+        {
+            for (uint32_t i = 0; i < archiveSources.size(); ++i)
+            {
+                SYS_RemoveFile(archiveSources[i].mPath.c_str());
+            }
+        }
+        else
+        {
+            LogWarning("Failed to write %s, packaging loose asset files instead", archiveFileName.c_str());
+        }
+    }
+
     // Create a Generated folder inside the project folder if it doesn't exist
     if (!DoesDirExist((projectDir + "Generated").c_str()))
     {
@@ -286,13 +318,35 @@ void ActionManager::BuildData(Platform platform, bool embedded)
             // Remove LuaPanda on consoles (it's a 148 KB file)
             SYS_Exec(std::string("rm " + packagedDir + "Engine/Scripts" + "/LuaPanda.lua").c_str());
         }
+
+        // Write precompiled bytecode next to each packaged script so the game can skip parsing at load time.
+        std::vector<std::string> packagedScriptFiles;
+        GatherScriptFiles(packagedDir + "Engine/Scripts/", packagedScriptFiles);
+        GatherScriptFiles(packagedDir + projectName + "/Scripts/", packagedScriptFiles);
+
+        for (uint32_t i = 0; i < packagedScriptFiles.size(); ++i)
+        {
+            const std::string& luaFile = packagedScriptFiles[i];
+
+            Stream sourceStream;
+            sourceStream.ReadFile(luaFile.c_str(), false);
+            std::string source(sourceStream.GetData(), sourceStream.GetSize());
+            std::string chunkName = "@" + ScriptUtils::GetClassNameFromFileName(luaFile) + ".lua";
+
+            std::string cookedScript;
+            if (CookScript(source, chunkName, platform, cookedScript))
+            {
+                Stream cookedStream(cookedScript.data(), uint32_t(cookedScript.size()));
+                cookedStream.WriteFile((luaFile + "c").c_str());
+            }
+        }
     }
 
     // Generate embedded script source files, even if not doing an embedded build. 
     // So we don't need to worry about whether we include code that links to the embedded script array / script count.
     std::string scriptHeaderPath = projectDir + "Generated/EmbeddedScripts.h";
     std::string scriptSourcePath = projectDir + "Generated/EmbeddedScripts.cpp";
-    GenerateEmbeddedScriptFiles(scriptFiles, scriptHeaderPath.c_str(), scriptSourcePath.c_str());
+    GenerateEmbeddedScriptFiles(scriptFiles, platform, scriptHeaderPath.c_str(), scriptSourcePath.c_str());
 
     if (standalone)
     {
@@ -1674,6 +1728,7 @@ void ActionManager::GenerateEmbeddedAssetFiles(std::vector<std::pair<AssetStub*,
 
 void ActionManager::GenerateEmbeddedScriptFiles(
     std::vector<std::string> files,
+    Platform platform,
     const char* headerPath,
     const char* sourcePath)
 {
@@ -1705,7 +1760,16 @@ void ActionManager::GenerateEmbeddedScriptFiles(
             // Handle special case for level
             stream.ReadFile(luaFile.c_str(), false);
             uint32_t size = uint32_t(stream.GetSize());
-            char* data = stream.GetData();
+            const char* data = stream.GetData();
+
+            // Embed precompiled bytecode when possible, otherwise fall back to the source.
+            std::string source(data, size);
+            std::string cookedScript;
+            if (CookScript(source, "@" + luaClass + ".lua", platform, cookedScript))
+            {
+                size = uint32_t(cookedScript.size());
+                data = cookedScript.data();
+            }
 
             std::string sourceString;
             sourceString.reserve(2048);
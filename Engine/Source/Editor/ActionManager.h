@@ -85,6 +85,7 @@ protected:
 
     void GenerateEmbeddedScriptFiles(
         std::vector<std::string> files,
+        Platform platform,
         const char* headerPath,
         const char* sourcePath);
 
@@ -227,7 +227,7 @@ void PaintManager::UpdateDynamicsWorld()
 
                     btCollisionObject* colObject = paintCol.mCollisionObject;
                     btCollisionShape* colShape = colObject->getCollisionShape();
-                    const glm::mat4& curTransform = meshNode->GetTransform();
+                    glm::mat4 curTransform = meshNode->GetTransform();
 
                     bool meshChanged = curMesh != paintCol.mMesh.Get();
                     bool posChanged = glm::any(glm::epsilonNotEqual(paintCol.mPosition, curPosition, 0.00001f));
@@ -521,7 +521,7 @@ void PaintManager::UpdatePaintDraw()
                     pendingData = &mPendingColorData.back();
                 }
 
-                const glm::mat4& transform = mesh3d->GetTransform();
+                glm::mat4 transform = mesh3d->GetTransform();
                 bool anyVertColored = false;
 
                 for (uint32_t v = 0; v < numVerts; ++v)
@@ -0,0 +1,405 @@
+#include "AnimCompression.h"
+#include "BitStream.h"
+#include "Assertion.h"
+
+#include <algorithm>
+
+static const uint32_t kVec3QuantBits = 16;
+static const uint32_t kQuatQuantBits = 15;
+static const uint32_t kWordsPerKey = 3;
+
+static void DecodeKey(const uint16_t* words, const CompressedTrack& track, glm::vec3& outValue)
+{
+    const float kScale = 1.0f / 65535.0f;
+    outValue.x = track.mMin.x + track.mExtent.x * (float(words[0]) * kScale);
+    outValue.y = track.mMin.y + track.mExtent.y * (float(words[1]) * kScale);
+    outValue.z = track.mMin.z + track.mExtent.z * (float(words[2]) * kScale);
+}
+
+static void DecodeKey(const uint16_t* words, const CompressedTrack& track, glm::quat& outValue)
+{
+    // The two bit index of the dropped component is split across the top bits of the first two words.
+    uint32_t quatWords[4];
+    quatWords[0] = uint32_t(words[0] >> 15) | (uint32_t(words[1] >> 15) << 1);
+    quatWords[1] = words[0] & 0x7fff;
+    quatWords[2] = words[1] & 0x7fff;
+    quatWords[3] = words[2] & 0x7fff;
+
+    outValue = BitStream::DequantizeQuat(quatWords, kQuatQuantBits);
+}
+
+static glm::vec3 Blend(const glm::vec3& a, const glm::vec3& b, float alpha)
+{
+    return glm::mix(a, b, alpha);
+}
+
+static glm::quat Blend(const glm::quat& a, const glm::quat& b, float alpha)
+{
+    return glm::normalize(glm::slerp(a, b, alpha));
+}
+
+template<typename T>
+static T SampleTrack(const uint16_t* keys, const CompressedTrack& track, float duration, float time)
+{
+    OCT_ASSERT(track.mNumKeys > 0);
+    const uint16_t* trackKeys = keys + track.mOffset;
+
+    T start;
+
+    if (track.mNumKeys == 1)
+    {
+        DecodeKey(trackKeys, track, start);
+        return start;
+    }
+
+    float alpha = (duration > 0.0f) ? glm::clamp(time / duration, 0.0f, 1.0f) : 0.0f;
+    float keyPos = alpha * float(track.mNumKeys - 1);
+    uint32_t index = glm::min(uint32_t(keyPos), track.mNumKeys - 2);
+    float factor = keyPos - float(index);
+
+    T end;
+    DecodeKey(trackKeys + index * kWordsPerKey, track, start);
+    DecodeKey(trackKeys + (index + 1) * kWordsPerKey, track, end);
+
+    return Blend(start, end, factor);
+}
+
+glm::vec3 SampleCompressedVec3(const Animation& anim, const CompressedTrack& track, float time)
+{
+    return SampleTrack<glm::vec3>(anim.mCompressedKeys.data(), track, anim.mDuration, time);
+}
+
+glm::quat SampleCompressedQuat(const Animation& anim, const CompressedTrack& track, float time)
+{
+    return SampleTrack<glm::quat>(anim.mCompressedKeys.data(), track, anim.mDuration, time);
+}
+
+#if EDITOR
+static void EncodeKey(const glm::vec3& value, const CompressedTrack& track, uint16_t* outWords)
+{
+    for (uint32_t c = 0; c < 3; ++c)
+    {
+        outWords[c] = (track.mExtent[c] > 0.0f) ?
+            uint16_t(BitStream::QuantizeFloat(value[c], track.mMin[c], track.mMin[c] + track.mExtent[c], kVec3QuantBits)) :
+            0;
+    }
+}
+
+static void EncodeKey(const glm::quat& value, const CompressedTrack& track, uint16_t* outWords)
+{
+    uint32_t quatWords[4];
+    BitStream::QuantizeQuat(value, kQuatQuantBits, quatWords);
+
+    outWords[0] = uint16_t(quatWords[1] | ((quatWords[0] & 1) << 15));
+    outWords[1] = uint16_t(quatWords[2] | ((quatWords[0] >> 1) << 15));
+    outWords[2] = uint16_t(quatWords[3]);
+}
+
+static void SetupRange(const std::vector<glm::vec3>& samples, CompressedTrack& track)
+{
+    glm::vec3 minValue = samples[0];
+    glm::vec3 maxValue = samples[0];
+
+    for (uint32_t i = 1; i < samples.size(); ++i)
+    {
+        minValue = glm::min(minValue, samples[i]);
+        maxValue = glm::max(maxValue, samples[i]);
+    }
+
+    track.mMin = minValue;
+    track.mExtent = maxValue - minValue;
+}
+
+static void SetupRange(const std::vector<glm::quat>& samples, CompressedTrack& track)
+{
+    track.mMin = {};
+    track.mExtent = {};
+}
+
+static float GetError(const glm::vec3& a, const glm::vec3& b)
+{
+    return glm::length(a - b);
+}
+
+static float GetError(const glm::quat& a, const glm::quat& b)
+{
+    float cosHalfAngle = glm::min(fabsf(glm::dot(a, b)), 1.0f);
+    return 2.0f * acosf(cosHalfAngle);
+}
+
+// Matches the interpolation SkeletalMesh3D uses for uncompressed keys.
+template<typename T>
+static T SampleRawTrack(const float* times, const T* values, uint32_t numKeys, float time)
+{
+    if (numKeys == 1)
+    {
+        return values[0];
+    }
+
+    const float* upper = std::upper_bound(times + 1, times + numKeys, time);
+    uint32_t index = glm::min(uint32_t(upper - (times + 1)), numKeys - 2);
+
+    float factor = (time - times[index]) / (times[index + 1] - times[index]);
+    factor = glm::clamp(factor, 0.0f, 1.0f);
+
+    return Blend(values[index], values[index + 1], factor);
+}
+
+template<typename T>
+static float BuildTrack(
+    const float* times,
+    const T* values,
+    uint32_t numSrcKeys,
+    float duration,
+    uint32_t numKeys,
+    const std::vector<float>& errorTimes,
+    CompressedTrack& outTrack,
+    std::vector<uint16_t>& outKeys)
+{
+    std::vector<T> samples(numKeys);
+
+    for (uint32_t i = 0; i < numKeys; ++i)
+    {
+        float time = (numKeys > 1) ? duration * (float(i) / float(numKeys - 1)) : 0.0f;
+        samples[i] = SampleRawTrack(times, values, numSrcKeys, time);
+    }
+
+    outTrack.mOffset = 0;
+    outTrack.mNumKeys = numKeys;
+    SetupRange(samples, outTrack);
+
+    outKeys.resize(numKeys * kWordsPerKey);
+    for (uint32_t i = 0; i < numKeys; ++i)
+    {
+        EncodeKey(samples[i], outTrack, &outKeys[i * kWordsPerKey]);
+    }
+
+    float maxError = 0.0f;
+
+    for (uint32_t i = 0; i < errorTimes.size(); ++i)
+    {
+        T srcValue = SampleRawTrack(times, values, numSrcKeys, errorTimes[i]);
+        T dstValue = SampleTrack<T>(outKeys.data(), outTrack, duration, errorTimes[i]);
+        maxError = glm::max(maxError, GetError(srcValue, dstValue));
+    }
+
+    return maxError;
+}
+
+// Bytes a compressed track stores besides its keys (the quantization range).
+template<typename T>
+static uint32_t GetRangeBytes();
+
+template<>
+uint32_t GetRangeBytes<glm::vec3>()
+{
+    return 2 * sizeof(glm::vec3);
+}
+
+template<>
+uint32_t GetRangeBytes<glm::quat>()
+{
+    return 0;
+}
+
+template<typename T>
+static void CopyRawTrack(
+    const float* times,
+    const T* values,
+    uint32_t numSrcKeys,
+    std::vector<float>& outTimes,
+    std::vector<T>& outValues,
+    uint32_t& outStart,
+    uint32_t& outNumKeys)
+{
+    outStart = uint32_t(outTimes.size());
+    outNumKeys = numSrcKeys;
+    outTimes.insert(outTimes.end(), times, times + numSrcKeys);
+    outValues.insert(outValues.end(), values, values + numSrcKeys);
+}
+
+// Returns false if the track should keep its raw keys, either because it has none, compressing it
+// wouldn't save anything, or no uniform rate it can afford stays within tolerance.
+template<typename T>
+static bool CompressTrack(
+    const float* times,
+    const T* values,
+    uint32_t numSrcKeys,
+    float duration,
+    float tolerance,
+    CompressedTrack& outTrack,
+    std::vector<uint16_t>& outKeys,
+    float& outError)
+{
+    outTrack = CompressedTrack();
+    outTrack.mOffset = uint32_t(outKeys.size());
+    outError = 0.0f;
+
+    if (numSrcKeys == 0)
+    {
+        return false;
+    }
+
+    // The most keys the compressed track can have while still being smaller than the raw one.
+    const uint32_t keyBytes = kWordsPerKey * sizeof(uint16_t);
+    const uint32_t rawBytes = numSrcKeys * (sizeof(float) + sizeof(T));
+    const uint32_t rangeBytes = GetRangeBytes<T>();
+    const uint32_t maxKeys = (rawBytes > rangeBytes) ? (rawBytes - rangeBytes - 1) / keyBytes : 0;
+
+    if (maxKeys == 0)
+    {
+        return false;
+    }
+
+    // A uniform rate fine enough to land on the closest pair of source keys.
+    float minSpacing = duration;
+    for (uint32_t i = 1; i < numSrcKeys; ++i)
+    {
+        float spacing = times[i] - times[i - 1];
+        if (spacing > 0.0f)
+        {
+            minSpacing = glm::min(minSpacing, spacing);
+        }
+    }
+
+    uint32_t fullKeys = 1;
+    if (numSrcKeys > 1 && duration > 0.0f && minSpacing > 0.0f)
+    {
+        fullKeys = uint32_t(ceilf(duration / minSpacing)) + 1;
+        fullKeys = glm::clamp(fullKeys, 2u, maxKeys);
+    }
+
+    // Measure error at the source keys and everywhere the full rate would put a key.
+    std::vector<float> errorTimes(times, times + numSrcKeys);
+    for (uint32_t i = 0; i < fullKeys && fullKeys > 1; ++i)
+    {
+        errorTimes.push_back(duration * (float(i) / float(fullKeys - 1)));
+    }
+
+    CompressedTrack track;
+    std::vector<uint16_t> keys;
+
+    // Constant track?
+    uint32_t bestKeys = 1;
+    float bestError = BuildTrack(times, values, numSrcKeys, duration, 1, errorTimes, track, keys);
+
+    if (bestError > tolerance)
+    {
+        if (fullKeys < 2)
+        {
+            return false;
+        }
+
+        bestKeys = fullKeys;
+        bestError = BuildTrack(times, values, numSrcKeys, duration, fullKeys, errorTimes, track, keys);
+
+        if (bestError > tolerance)
+        {
+            return false;
+        }
+
+        // Halve the rate for as long as the error stays within tolerance.
+        uint32_t numKeys = fullKeys;
+        while (numKeys > 2)
+        {
+            numKeys = (numKeys - 1) / 2 + 1;
+            float error = BuildTrack(times, values, numSrcKeys, duration, numKeys, errorTimes, track, keys);
+
+            if (error > tolerance)
+                break;
+
+            bestKeys = numKeys;
+            bestError = error;
+        }
+    }
+
+    BuildTrack(times, values, numSrcKeys, duration, bestKeys, errorTimes, track, keys);
+
+    track.mOffset = uint32_t(outKeys.size());
+    outTrack = track;
+    outKeys.insert(outKeys.end(), keys.begin(), keys.end());
+    outError = bestError;
+
+    return true;
+}
+
+void CompressAnimation(const Animation& src, const AnimCompressionTolerance& tolerance, Animation& dst, AnimCompressionStats& outStats)
+{
+    outStats = AnimCompressionStats();
+
+    if (src.mCompressed)
+    {
+        // Already compressed when it was loaded, the source keys are gone.
+        dst = src;
+        return;
+    }
+
+    dst = Animation();
+    dst.mName = src.mName;
+    dst.mDuration = src.mDuration;
+    dst.mTicksPerSecond = src.mTicksPerSecond;
+    dst.mEventTracks = src.mEventTracks;
+    dst.mCompressed = true;
+
+    dst.mChannels.resize(src.mChannels.size());
+
+    for (uint32_t i = 0; i < src.mChannels.size(); ++i)
+    {
+        const Channel& srcChannel = src.mChannels[i];
+        Channel& dstChannel = dst.mChannels[i];
+        dstChannel.mBoneIndex = srcChannel.mBoneIndex;
+
+        const float* posTimes = src.mPositionTimes.data() + srcChannel.mPositionStart;
+        const glm::vec3* posValues = src.mPositionValues.data() + srcChannel.mPositionStart;
+        float posError = 0.0f;
+
+        if (!CompressTrack(posTimes, posValues, srcChannel.mNumPositionKeys, src.mDuration, tolerance.mPosition,
+            dstChannel.mPositionTrack, dst.mCompressedKeys, posError))
+        {
+            CopyRawTrack(posTimes, posValues, srcChannel.mNumPositionKeys, dst.mPositionTimes, dst.mPositionValues,
+                dstChannel.mPositionStart, dstChannel.mNumPositionKeys);
+            outStats.mNumRawTracks++;
+        }
+
+        const float* rotTimes = src.mRotationTimes.data() + srcChannel.mRotationStart;
+        const glm::quat* rotValues = src.mRotationValues.data() + srcChannel.mRotationStart;
+        float rotError = 0.0f;
+
+        if (!CompressTrack(rotTimes, rotValues, srcChannel.mNumRotationKeys, src.mDuration, tolerance.mRotation,
+            dstChannel.mRotationTrack, dst.mCompressedKeys, rotError))
+        {
+            CopyRawTrack(rotTimes, rotValues, srcChannel.mNumRotationKeys, dst.mRotationTimes, dst.mRotationValues,
+                dstChannel.mRotationStart, dstChannel.mNumRotationKeys);
+            outStats.mNumRawTracks++;
+        }
+
+        const float* scaleTimes = src.mScaleTimes.data() + srcChannel.mScaleStart;
+        const glm::vec3* scaleValues = src.mScaleValues.data() + srcChannel.mScaleStart;
+        float scaleError = 0.0f;
+
+        if (!CompressTrack(scaleTimes, scaleValues, srcChannel.mNumScaleKeys, src.mDuration, tolerance.mScale,
+            dstChannel.mScaleTrack, dst.mCompressedKeys, scaleError))
+        {
+            CopyRawTrack(scaleTimes, scaleValues, srcChannel.mNumScaleKeys, dst.mScaleTimes, dst.mScaleValues,
+                dstChannel.mScaleStart, dstChannel.mNumScaleKeys);
+            outStats.mNumRawTracks++;
+        }
+
+        outStats.mMaxPositionError = glm::max(outStats.mMaxPositionError, posError);
+        outStats.mMaxRotationError = glm::max(outStats.mMaxRotationError, rotError);
+        outStats.mMaxScaleError = glm::max(outStats.mMaxScaleError, scaleError);
+    }
+
+    outStats.mRawBytes = uint32_t(
+        src.mPositionTimes.size() * (sizeof(float) + sizeof(glm::vec3)) +
+        src.mRotationTimes.size() * (sizeof(float) + sizeof(glm::quat)) +
+        src.mScaleTimes.size() * (sizeof(float) + sizeof(glm::vec3)));
+
+    outStats.mCompressedBytes = uint32_t(
+        dst.mCompressedKeys.size() * sizeof(uint16_t) +
+        dst.mChannels.size() * 3 * sizeof(CompressedTrack) +
+        dst.mPositionTimes.size() * (sizeof(float) + sizeof(glm::vec3)) +
+        dst.mRotationTimes.size() * (sizeof(float) + sizeof(glm::quat)) +
+        dst.mScaleTimes.size() * (sizeof(float) + sizeof(glm::vec3)));
+}
+#endif
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "Assets/SkeletalMesh.h"
+
+glm::vec3 SampleCompressedVec3(const Animation& anim, const CompressedTrack& track, float time);
+glm::quat SampleCompressedQuat(const Animation& anim, const CompressedTrack& track, float time);
+
+#if EDITOR
+struct AnimCompressionTolerance
+{
+    float mPosition = 0.001f;
+    float mRotation = 0.001f; // Radians
+    float mScale = 0.001f;
+};
+
+struct AnimCompressionStats
+{
+    uint32_t mRawBytes = 0;
+    uint32_t mCompressedBytes = 0;
+    uint32_t mNumRawTracks = 0;
+    float mMaxPositionError = 0.0f;
+    float mMaxRotationError = 0.0f; // Radians
+    float mMaxScaleError = 0.0f;
+};
+
+// Resamples every track at the lowest uniform key rate that stays within its channel's tolerance, so constant
+// tracks collapse to a single key and linearly redundant keys are dropped. A track that can't meet its
+// tolerance, or wouldn't get any smaller, keeps its raw keys instead (see CompressedTrack).
+void CompressAnimation(const Animation& src, const AnimCompressionTolerance& tolerance, Animation& dst, AnimCompressionStats& outStats);
+#endif
@@ -151,18 +151,63 @@ void Asset::IncrementRefCount()
 
 void Asset::DecrementRefCount()
 {
-    mRefCount--;
-    OCT_ASSERT(mRefCount >= 0 || AssetManager::Get()->IsPurging());
+    int32_t refCount = --mRefCount;
+    OCT_ASSERT(refCount >= 0 || AssetManager::Get()->IsPurging());
 }
 
-void Asset::LoadFile(const char* path, AsyncLoadRequest* request)
+static const char* sCompressionStrings[] =
+{
+    "Default",
+    "None",
+    "Fast",
+    "Max"
+};
+static_assert(uint32_t(AssetCompression::Count) == 4, "Need to update compression string table");
+
+// Inflates a compressed asset in place and tracks how many bytes were read vs decoded.
+// Runs on the async loader threads too, so it must not touch anything that isn't thread safe.
+static bool DecodeAssetStream(Stream& stream)
+{
+    if (stream.GetData() == nullptr ||
+        stream.GetSize() < sizeof(AssetHeader))
+    {
+        return false;
+    }
+
+    uint32_t readSize = stream.GetSize();
+    AssetHeader header = Asset::ReadHeader(stream);
+
+    if (header.mCompressed)
+    {
+        if (!stream.Decompress())
+        {
+            return false;
+        }
+    }
+    else
+    {
+        stream.SetPos(0);
+    }
+
+    AssetManager::Get()->AddLoadStats(readSize, stream.GetSize());
+    return true;
+}
+
+bool Asset::LoadFile(const char* path, AsyncLoadRequest* request)
 {
     if (IsLoaded())
-        return;
+        return true;
 
     Stream stream;
     stream.SetAsyncRequest(request);
     stream.ReadFile(path, true);
+
+    if (!DecodeAssetStream(stream))
+    {
+        LogError("Failed to load asset file %s", path);
+        return false;
+    }
+
     LoadStream(stream, GetPlatform());
 
     // Only "finish" the load if not async.
@@ -172,21 +217,50 @@ void Asset::LoadFile(const char* path, AsyncLoadRequest* request)
     }
 
     LogDebug("Asset loaded: %s", mName.c_str());
+    return true;
 }
 
-void Asset::SaveFile(const char* path, Platform platform)
+void Asset::SaveFile(const char* path, Platform platform, bool compress)
 {
 #if EDITOR
     Stream stream;
     SaveStream(stream, platform);
+
+    AssetCompression compression = (mCompression == AssetCompression::Default) ? GetDefaultCompression() : mCompression;
+
+    if (compress &&
+        compression != AssetCompression::None &&
+        stream.GetSize() >= ASSET_COMPRESSION_MIN_SIZE)
+    {
+        // The header stays uncompressed so the asset type can be discovered without decompressing.
+        Stream compressedStream;
+        WriteHeader(compressedStream, true);
+        compressedStream.WriteCompressed(stream.GetData(), stream.GetSize(),
+            (compression == AssetCompression::Max) ? STREAM_COMPRESSION_MAX : STREAM_COMPRESSION_FAST);
+
+        if (compressedStream.GetSize() < stream.GetSize())
+        {
+            compressedStream.WriteFile(path);
+            LogDebug("Asset saved: %s (compressed %d -> %d bytes)", mName.c_str(), stream.GetSize(), compressedStream.GetSize());
+            return;
+        }
+    }
+
     stream.WriteFile(path);
     LogDebug("Asset saved: %s", mName.c_str());
 #endif
 }
 
-void Asset::LoadEmbedded(const EmbeddedFile* embeddedAsset, AsyncLoadRequest* request)
+bool Asset::LoadEmbedded(const EmbeddedFile* embeddedAsset, AsyncLoadRequest* request)
 {
     Stream stream(embeddedAsset->mData, embeddedAsset->mSize);
+
+    if (!DecodeAssetStream(stream))
+    {
+        LogError("Failed to load embedded asset %s", embeddedAsset->mName);
+        return false;
+    }
+
     LoadStream(stream, GetPlatform());
     SetEmbedded(true);
 
@@ -197,6 +271,7 @@ void Asset::LoadEmbedded(const EmbeddedFile* embeddedAsset, AsyncLoadRequest* re
     }
 
     LogDebug("Asset loaded: %s", mName.c_str());
+    return true;
 }
 
 void Asset::LoadStream(Stream& stream, Platform platform)
@@ -205,6 +280,7 @@ void Asset::LoadStream(Stream& stream, Platform platform)
     mVersion = header.mVersion;
     mType = header.mType;
     mEmbedded = header.mEmbedded;
+    mCompression = AssetCompression(header.mCompression);
 
     stream.ReadString(mName);
 }
@@ -225,6 +301,7 @@ void Asset::Import(const std::string& path, ImportOptions* options)
 void Asset::GatherProperties(std::vector<Property>& outProps)
 {
     outProps.push_back(Property(DatumType::String, "Name", this, &mName, 1, HandleAssetNamePropChange));
+    outProps.push_back(Property(DatumType::Byte, "Compression", this, &mCompression, 1, nullptr, 0, int32_t(AssetCompression::Count), sCompressionStrings));
 }
 
 glm::vec4 Asset::GetTypeColor()
@@ -252,6 +329,21 @@ void Asset::SetTransient(bool transient)
     mTransient = transient;
 }
 
+AssetCompression Asset::GetCompression() const
+{
+    return mCompression;
+}
+
+void Asset::SetCompression(AssetCompression compression)
+{
+    mCompression = compression;
+}
+
+AssetCompression Asset::GetDefaultCompression() const
+{
+    return AssetCompression::Fast;
+}
+
 AssetHeader Asset::ReadHeader(Stream& stream)
 {
     AssetHeader header;
@@ -260,15 +352,23 @@ AssetHeader Asset::ReadHeader(Stream& stream)
     header.mType = TypeId(stream.ReadUint32());
     header.mEmbedded = stream.ReadUint8();
 
+    if (header.mVersion >= ASSET_VERSION_COMPRESSION)
+    {
+        header.mCompression = stream.ReadUint8();
+        header.mCompressed = stream.ReadUint8();
+    }
+
     return header;
 }
 
-void Asset::WriteHeader(Stream& stream)
+void Asset::WriteHeader(Stream& stream, bool compressed)
 {
     stream.WriteUint32(ASSET_MAGIC_NUMBER);
     stream.WriteUint32(ASSET_VERSION_CURRENT);
     stream.WriteUint32(uint32_t(mType));
     stream.WriteUint8(mEmbedded);
+    stream.WriteUint8(uint8_t(mCompression));
+    stream.WriteUint8(compressed);
 }
 
 
@@ -6,13 +6,19 @@
 #include "RTTI.h"
 #include "Maths.h"
 
+#if ASSET_LIVE_REF_TRACKING
+#include "JobSystem.h"
+#endif
+
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include <atomic>
 
 class Stream;
 class Property;
 class AssetDir;
+class AssetRef;
 
 #define ASSET_MAGIC_NUMBER 0x4f435421
 
@@ -21,8 +27,12 @@ class AssetDir;
 // ---------------------------------------------------
 #define ASSET_VERSION_BASE 1
 #define ASSET_VERSION_SCENE_EXTRA_DATA 2
+#define ASSET_VERSION_COMPRESSION 3
+#define ASSET_VERSION_ANIM_COMPRESSION 4
+#define ASSET_VERSION_MESH_BLOCKS 5
+#define ASSET_VERSION_COOKED_COLLISION 6
 
-#define ASSET_VERSION_CURRENT 2
+#define ASSET_VERSION_CURRENT 6
 // ----------------------------------------------------
 
 #define DECLARE_ASSET(Base, Parent) DECLARE_FACTORY(Base, Asset); DECLARE_RTTI(Base, Parent);
@@ -38,12 +48,28 @@ enum class AssetLoadState
     Count
 };
 
+// Smaller assets aren't worth the decompression cost.
+#define ASSET_COMPRESSION_MIN_SIZE 4096
+
+enum class AssetCompression : uint8_t
+{
+    Default,
+    None,
+    Fast,
+    Max,
+
+    Count
+};
+
 struct AssetHeader
 {
     uint32_t mMagic = ASSET_MAGIC_NUMBER;
     uint32_t mVersion = ASSET_VERSION_CURRENT;
     TypeId mType = INVALID_TYPE_ID;
     uint8_t mEmbedded = false;
+    uint8_t mCompression = uint8_t(AssetCompression::Default);
+    // When set, the rest of the file is the block compressed asset (including its own uncompressed header).
+    uint8_t mCompressed = false;
 };
 
 struct AssetStub
@@ -102,9 +128,10 @@ public:
     void IncrementRefCount();
     void DecrementRefCount();
 
-    void LoadFile(const char* path, AsyncLoadRequest* request = nullptr);
-    void LoadEmbedded(const EmbeddedFile* embeddedAsset, AsyncLoadRequest* request = nullptr);
-    void SaveFile(const char* path, Platform platform);
+    // Returns false if the asset data could not be read or decompressed. LoadStream() is skipped in that case.
+    bool LoadFile(const char* path, AsyncLoadRequest* request = nullptr);
+    bool LoadEmbedded(const EmbeddedFile* embeddedAsset, AsyncLoadRequest* request = nullptr);
+    void SaveFile(const char* path, Platform platform, bool compress = false);
 
     virtual void LoadStream(Stream& stream, Platform platform);
 	virtual void SaveStream(Stream& stream, Platform platform);
@@ -117,8 +144,14 @@ public:
     bool IsTransient() const;
     void SetTransient(bool transient);
 
+    AssetCompression GetCompression() const;
+    void SetCompression(AssetCompression compression);
+
+    // The compression used when this asset's policy is left at Default.
+    virtual AssetCompression GetDefaultCompression() const;
+
     static AssetHeader ReadHeader(Stream& stream);
-    void WriteHeader(Stream& stream);
+    void WriteHeader(Stream& stream, bool compressed = false);
 
     static std::string GetNameFromPath(const std::string& path);
     static std::string GetDirectoryFromPath(const std::string& path);
@@ -135,7 +168,18 @@ protected:
     bool mEnableRefCount = true;
     bool mEngineAsset = false;
     bool mTransient = false;
+    AssetCompression mCompression = AssetCompression::Default;
 
     std::string mName = "Asset";
-    int32_t mRefCount = 0;
+    // Async loads take refs on loader threads while the main thread does the same.
+    std::atomic<int32_t> mRefCount{ 0 };
+
+#if ASSET_LIVE_REF_TRACKING
+    friend class AssetRef;
+
+    // Intrusive list of the AssetRefs currently pointing at this asset.
+    // Guarded per asset so the async loader and the main thread only contend when they touch the same asset.
+    AssetRef* mLiveRefs = nullptr;
+    JobSpinLock mLiveRefLock;
+#endif
 };
\ No newline at end of file
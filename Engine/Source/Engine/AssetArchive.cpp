@@ -0,0 +1,252 @@
+#include "AssetArchive.h"
+#include "Stream.h"
+#include "Utilities.h"
+#include "Log.h"
+#include "Profiler.h"
+
+#include "System/System.h"
+
+#include <string.h>
+#include <algorithm>
+
+static const uint32_t kHeaderSize = 4 * sizeof(uint32_t);
+static const uint32_t kEntrySize = 5 * sizeof(uint32_t);
+
+AssetArchive::AssetArchive()
+{
+
+}
+
+AssetArchive::~AssetArchive()
+{
+    Close();
+}
+
+bool AssetArchive::Open(const char* path, bool isAsset)
+{
+    SCOPED_STAT("AssetArchive::Open");
+    Close();
+
+    if (!SYS_MapFile(path, isAsset, mFile))
+    {
+        return false;
+    }
+
+    if (mFile.mSize < kHeaderSize)
+    {
+        LogError("Asset archive is too small: %s", path);
+        Close();
+        return false;
+    }
+
+    Stream stream(mFile.mData, mFile.mSize);
+
+    uint32_t magic = stream.ReadUint32();
+    uint32_t version = stream.ReadUint32();
+    uint32_t numEntries = stream.ReadUint32();
+    uint32_t stringTableSize = stream.ReadUint32();
+
+    // Sized in 64 bits so a corrupt entry count or string table size can't wrap past the check.
+    uint64_t stringTableEnd = kHeaderSize + uint64_t(numEntries) * kEntrySize + stringTableSize;
+
+    if (magic != ASSET_ARCHIVE_MAGIC ||
+        version != ASSET_ARCHIVE_VERSION ||
+        stringTableEnd > mFile.mSize)
+    {
+        LogError("Invalid asset archive: %s", path);
+        Close();
+        return false;
+    }
+
+    // Both fit in mFile.mSize from here on.
+    uint32_t stringTableOffset = kHeaderSize + numEntries * kEntrySize;
+
+    mHashes.resize(numEntries);
+    mFiles.resize(numEntries);
+
+    for (uint32_t i = 0; i < numEntries; ++i)
+    {
+        AssetArchiveEntry entry;
+        entry.mNameHash = stream.ReadUint32();
+        entry.mNameOffset = stream.ReadUint32();
+        entry.mDataOffset = stream.ReadUint32();
+        entry.mDataSize = stream.ReadUint32();
+        entry.mFlags = stream.ReadUint32();
+
+        if (entry.mNameOffset < stringTableOffset ||
+            entry.mNameOffset >= stringTableOffset + stringTableSize ||
+            entry.mDataOffset > mFile.mSize ||
+            entry.mDataSize > mFile.mSize - entry.mDataOffset)
+        {
+            LogError("Corrupt entry %d in asset archive: %s", i, path);
+            Close();
+            return false;
+        }
+
+        mHashes[i] = entry.mNameHash;
+
+        EmbeddedFile& file = mFiles[i];
+        file.mName = mFile.mData + entry.mNameOffset;
+        file.mData = mFile.mData + entry.mDataOffset;
+        file.mSize = entry.mDataSize;
+        file.mEngine = (entry.mFlags & ASSET_ARCHIVE_FLAG_ENGINE) != 0;
+    }
+
+    // The last name must be terminated inside the string table, otherwise strcmp could run off the end.
+    if (stringTableSize > 0 &&
+        mFile.mData[stringTableOffset + stringTableSize - 1] != '\0')
+    {
+        LogError("Unterminated string table in asset archive: %s", path);
+        Close();
+        return false;
+    }
+
+    LogDebug("Opened asset archive %s with %d files", path, numEntries);
+
+    return true;
+}
+
+void AssetArchive::Close()
+{
+    mHashes.clear();
+    mFiles.clear();
+
+    if (mFile.mData != nullptr)
+    {
+        SYS_UnmapFile(mFile);
+    }
+}
+
+bool AssetArchive::IsOpen() const
+{
+    return mFile.mData != nullptr;
+}
+
+const EmbeddedFile* AssetArchive::Find(const char* name) const
+{
+    uint32_t hash = OctHashString(name);
+    auto it = std::lower_bound(mHashes.begin(), mHashes.end(), hash);
+
+    // Walk the run of equal hashes in case of a collision.
+    for (; it != mHashes.end() && *it == hash; ++it)
+    {
+        const EmbeddedFile& file = mFiles[it - mHashes.begin()];
+
+        if (strcmp(file.mName, name) == 0)
+        {
+            return &file;
+        }
+    }
+
+    return nullptr;
+}
+
+uint32_t AssetArchive::GetNumFiles() const
+{
+    return uint32_t(mFiles.size());
+}
+
+EmbeddedFile* AssetArchive::GetFiles()
+{
+    return mFiles.data();
+}
+
+static void PadStream(Stream& stream, uint32_t alignment)
+{
+    while ((stream.GetPos() % alignment) != 0)
+    {
+        stream.WriteUint8(0);
+    }
+}
+
+bool AssetArchive::Write(const char* path, std::vector<AssetArchiveSource>& sources)
+{
+    SCOPED_STAT("AssetArchive::Write");
+
+    std::vector<uint32_t> hashes(sources.size());
+    std::vector<uint32_t> order(sources.size());
+
+    for (uint32_t i = 0; i < sources.size(); ++i)
+    {
+        hashes[i] = OctHashString(sources[i].mName.c_str());
+        order[i] = i;
+    }
+
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b)
+    {
+        return hashes[a] < hashes[b];
+    });
+
+    const uint32_t numEntries = uint32_t(sources.size());
+    const uint32_t stringTableOffset = kHeaderSize + numEntries * kEntrySize;
+
+    std::vector<AssetArchiveEntry> entries(numEntries);
+    uint32_t stringTableSize = 0;
+
+    for (uint32_t i = 0; i < numEntries; ++i)
+    {
+        const AssetArchiveSource& source = sources[order[i]];
+        entries[i].mNameHash = hashes[order[i]];
+        entries[i].mNameOffset = stringTableOffset + stringTableSize;
+        entries[i].mFlags = source.mEngine ? ASSET_ARCHIVE_FLAG_ENGINE : 0;
+        stringTableSize += uint32_t(source.mName.size()) + 1;
+    }
+
+    // Write the data first, then come back and fill in the TOC now that the offsets are known.
+    Stream stream;
+    stream.Resize(stringTableOffset);
+    stream.SetPos(stringTableOffset);
+
+    for (uint32_t i = 0; i < numEntries; ++i)
+    {
+        const std::string& name = sources[order[i]].mName;
+        stream.WriteBytes((const uint8_t*)name.c_str(), uint32_t(name.size()) + 1);
+    }
+
+    for (uint32_t i = 0; i < numEntries; ++i)
+    {
+        const AssetArchiveSource& source = sources[order[i]];
+
+        Stream fileStream;
+        fileStream.ReadFile(source.mPath.c_str(), false);
+
+        if (fileStream.GetData() == nullptr)
+        {
+            LogError("Failed to read %s for asset archive", source.mPath.c_str());
+            return false;
+        }
+
+        PadStream(stream, ASSET_ARCHIVE_ALIGNMENT);
+        entries[i].mDataOffset = stream.GetPos();
+        entries[i].mDataSize = fileStream.GetSize();
+        stream.WriteBytes((const uint8_t*)fileStream.GetData(), fileStream.GetSize());
+    }
+
+    stream.SetPos(0);
+    stream.WriteUint32(ASSET_ARCHIVE_MAGIC);
+    stream.WriteUint32(ASSET_ARCHIVE_VERSION);
+    stream.WriteUint32(numEntries);
+    stream.WriteUint32(stringTableSize);
+
+    for (uint32_t i = 0; i < numEntries; ++i)
+    {
+        stream.WriteUint32(entries[i].mNameHash);
+        stream.WriteUint32(entries[i].mNameOffset);
+        stream.WriteUint32(entries[i].mDataOffset);
+        stream.WriteUint32(entries[i].mDataSize);
+        stream.WriteUint32(entries[i].mFlags);
+    }
+
+    stream.WriteFile(path);
+
+    // Packaging deletes the loose source files after this succeeds, so make sure the archive landed.
+    if (!SYS_DoesFileExist(path, false))
+    {
+        LogError("Failed to write asset archive %s", path);
+        return false;
+    }
+
+    LogDebug("Wrote asset archive %s with %d files (%d bytes)", path, numEntries, stream.GetSize());
+
+    return true;
+}
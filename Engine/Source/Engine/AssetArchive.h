@@ -0,0 +1,63 @@
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "EmbeddedFile.h"
+#include "System/SystemTypes.h"
+
+#define ASSET_ARCHIVE_MAGIC 0x4154434f // "OCTA"
+#define ASSET_ARCHIVE_VERSION 1
+#define ASSET_ARCHIVE_ALIGNMENT 16
+#define ASSET_ARCHIVE_FLAG_ENGINE 0x01
+
+// Archive layout (all offsets are from the start of the file):
+//   Header       magic, version, entry count, string table size
+//   TOC          one entry per file, sorted by name hash
+//   String table null terminated asset names
+//   Data         file contents, each aligned to ASSET_ARCHIVE_ALIGNMENT
+struct AssetArchiveEntry
+{
+    uint32_t mNameHash = 0;
+    uint32_t mNameOffset = 0;
+    uint32_t mDataOffset = 0;
+    uint32_t mDataSize = 0;
+    uint32_t mFlags = 0;
+};
+
+struct AssetArchiveSource
+{
+    std::string mName;
+    std::string mPath;
+    bool mEngine = false;
+};
+
+// A single packed file holding many cooked assets. The file is memory mapped and each
+// entry is exposed as an EmbeddedFile whose data points straight into the mapping,
+// so assets are deserialized without an intermediate copy.
+class AssetArchive
+{
+public:
+
+    AssetArchive();
+    ~AssetArchive();
+
+    bool Open(const char* path, bool isAsset);
+    void Close();
+    bool IsOpen() const;
+
+    // Binary search on the name hash. Returns nullptr if the archive has no such file.
+    const EmbeddedFile* Find(const char* name) const;
+
+    uint32_t GetNumFiles() const;
+    EmbeddedFile* GetFiles();
+
+    static bool Write(const char* path, std::vector<AssetArchiveSource>& sources);
+
+private:
+
+    MappedFile mFile;
+    std::vector<uint32_t> mHashes;
+    std::vector<EmbeddedFile> mFiles;
+};
@@ -7,6 +7,7 @@
 #include "Constants.h"
 #include "Utilities.h"
 #include "EmbeddedFile.h"
+#include "AssetArchive.h"
 #include "Renderer.h"
 
 #include "Assets/Scene.h"
@@ -25,12 +26,15 @@
 
 #include <string>
 #include <functional>
+#include <algorithm>
+#include <thread>
 
 #if EDITOR
 #include "Editor/EditorState.h"
 #endif
 
 #define ASYNC_REQUEUE_LIMIT 30
+#define ASYNC_LOAD_MAX_THREADS 4
 
 AssetManager* AssetManager::sInstance = nullptr;
 
@@ -49,9 +53,20 @@ void UnloadAsset(const std::string& name)
     AssetManager::Get()->UnloadAsset(name);
 }
 
-void AsyncLoadAsset(const std::string& name, AssetRef* targetRef)
+void AsyncLoadAsset(const std::string& name, AssetRef* targetRef, int32_t priority)
 {
-    AssetManager::Get()->AsyncLoadAsset(name, targetRef);
+    AssetManager::Get()->AsyncLoadAsset(name, targetRef, priority);
+}
+
+static bool AsyncLoadRequestLess(const AsyncLoadRequest* a, const AsyncLoadRequest* b)
+{
+    // Higher priority first, then first come first served.
+    if (a->mPriority != b->mPriority)
+    {
+        return a->mPriority < b->mPriority;
+    }
+
+    return a->mSequence > b->mSequence;
 }
 
 AssetStub* FetchAssetStub(const std::string& name)
@@ -91,16 +106,59 @@ AssetManager::~AssetManager()
     Purge(true);
 
     SYS_LockMutex(mMutex);
-    // Flag that we are destructing so that the async load thread can exit.
+    // Flag that we are destructing so that the async load threads can exit.
     mDestructing = true;
     SYS_UnlockMutex(mMutex);
 
-    SYS_JoinThread(mAsyncLoadThread);
-    SYS_DestroyThread(mAsyncLoadThread);
-    mAsyncLoadThread = nullptr;
+    SYS_SignalSemaphore(mAsyncLoadSemaphore, uint32_t(mAsyncLoadThreads.size()));
+
+    for (uint32_t i = 0; i < mAsyncLoadThreads.size(); ++i)
+    {
+        SYS_JoinThread(mAsyncLoadThreads[i]);
+        SYS_DestroyThread(mAsyncLoadThreads[i]);
+    }
+
+    mAsyncLoadThreads.clear();
+
+    // Drop any loads that never finished. Detach every ref first, since deleting a loaded
+    // asset destroys its own refs, which may be waiting on other requests.
+    for (auto& pair : mAsyncLoadRequests)
+    {
+        std::vector<AssetRef*>& refs = pair.second->mTargetRefs;
+
+        for (uint32_t i = 0; i < refs.size(); ++i)
+        {
+            refs[i]->mLoadRequest = nullptr;
+        }
+    }
+
+    for (auto& pair : mAsyncLoadRequests)
+    {
+        // Asset::Create() was never called, so there is nothing to Destroy().
+        delete pair.second->mAsset;
+        delete pair.second;
+    }
+
+    mAsyncLoadRequests.clear();
+    mBeginLoadQueue.clear();
+    mEndLoadQueue.clear();
+
+    SYS_DestroySemaphore(mAsyncLoadSemaphore);
+    mAsyncLoadSemaphore = nullptr;
+
+    // Stubs point into the archive mappings, so only unmap them once everything is unloaded.
+    for (uint32_t i = 0; i < mArchives.size(); ++i)
+    {
+        delete mArchives[i];
+    }
+
+    mArchives.clear();
 
     SYS_DestroyMutex(mMutex);
     mMutex = nullptr;
+
+    SYS_DestroyMutex(mLoadStatsMutex);
+    mLoadStatsMutex = nullptr;
 }
 
 void AssetManager::Initialize()
@@ -108,7 +166,21 @@ void AssetManager::Initialize()
     mRootDirectory = new AssetDir("Root", "", nullptr);
 
     mMutex = SYS_CreateMutex();
-    mAsyncLoadThread = SYS_CreateThread(AsyncLoadThreadFunc, this);
+    mLoadStatsMutex = SYS_CreateMutex();
+    mAsyncLoadSemaphore = SYS_CreateSemaphore(0);
+
+    uint32_t numThreads = 1;
+
+#if PLATFORM_WINDOWS || PLATFORM_LINUX || PLATFORM_ANDROID
+    // Loading is mostly IO and decompression, so use about half of the cores and leave the rest for the job system.
+    numThreads = std::thread::hardware_concurrency() / 2;
+    numThreads = glm::clamp<uint32_t>(numThreads, 1, ASYNC_LOAD_MAX_THREADS);
+#endif
+
+    for (uint32_t i = 0; i < numThreads; ++i)
+    {
+        mAsyncLoadThreads.push_back(SYS_CreateThread(AsyncLoadThreadFunc, this));
+    }
 }
 
 void AssetManager::Update(float deltaTime)
@@ -397,6 +469,25 @@ void AssetManager::DiscoverEmbeddedAssets(EmbeddedFile* assets, uint32_t numAsse
     }
 }
 
+bool AssetManager::MountArchive(const char* archivePath)
+{
+    SCOPED_STAT("MountArchive");
+
+    AssetArchive* archive = new AssetArchive();
+
+    if (!archive->Open(archivePath, true))
+    {
+        delete archive;
+        return false;
+    }
+
+    // Archive entries are registered like embedded assets, so loading reads straight out of the mapped file.
+    DiscoverEmbeddedAssets(archive->GetFiles(), archive->GetNumFiles());
+    mArchives.push_back(archive);
+
+    return true;
+}
+
 void AssetManager::Purge(bool purgeEngineAssets)
 {
     // Destroy all assets in the map and empty the map.
@@ -552,7 +643,12 @@ void AssetManager::LoadAll()
         if (stub->mAsset == nullptr)
         {
             stub->mAsset = Asset::CreateInstance(stub->mType);
-            stub->mAsset->LoadFile(stub->mPath.c_str());
+
+            if (!stub->mAsset->LoadFile(stub->mPath.c_str()))
+            {
+                delete stub->mAsset;
+                stub->mAsset = nullptr;
+            }
         }
     }
 }
@@ -742,21 +838,29 @@ Asset* AssetManager::LoadAsset(AssetStub& stub)
     if (stub.mAsset == nullptr)
     {
         stub.mAsset = Asset::CreateInstance(stub.mType);
+        bool loaded = false;
 
         if (stub.mEmbeddedData != nullptr)
         {
-            stub.mAsset->LoadEmbedded(stub.mEmbeddedData);
+            loaded = stub.mAsset->LoadEmbedded(stub.mEmbeddedData);
         }
         else
         {
-            stub.mAsset->LoadFile(stub.mPath.c_str());
+            loaded = stub.mAsset->LoadFile(stub.mPath.c_str());
+        }
+
+        if (!loaded)
+        {
+            // LoadStream() was never run, so there is nothing to Destroy().
+            delete stub.mAsset;
+            stub.mAsset = nullptr;
         }
     }
 
     return stub.mAsset;
 }
 
-void AssetManager::AsyncLoadAsset(const std::string& name, AssetRef* targetRef)
+void AssetManager::AsyncLoadAsset(const std::string& name, AssetRef* targetRef, int32_t priority)
 {
     SCOPED_LOCK(mMutex);
     // (1) Check to see if an asset stub exists at all, if not, then log an error and return.
@@ -767,11 +871,12 @@ void AssetManager::AsyncLoadAsset(const std::string& name, AssetRef* targetRef)
         return;
     }
 
-    // Erase ref from current pending request
+    // Erase ref from current pending request (unless it's already waiting on this asset)
     if (targetRef != nullptr &&
-        targetRef->mLoadRequest != nullptr)
+        targetRef->mLoadRequest != nullptr &&
+        targetRef->mLoadRequest->mName != name)
     {
-        EraseAsyncLoadRef(*targetRef);
+        EraseAsyncLoadRefInternal(*targetRef);
     }
 
     // (2) Check to see if the asset is already loaded. If so, assign the target ref immediately.
@@ -785,41 +890,52 @@ void AssetManager::AsyncLoadAsset(const std::string& name, AssetRef* targetRef)
         return;
     }
 
-    // (3) Check to see if an AsyncLoadRequest is already in flight (in begin/end queues) and if so, add this ref to the list.
-    for (uint32_t i = 0; i < mBeginLoadQueue.size(); ++i)
+    // (3) Check to see if an AsyncLoadRequest is already in flight and if so, add this ref to the list.
+    AsyncLoadRequest* request = nullptr;
+    auto it = mAsyncLoadRequests.find(name);
+
+    if (it != mAsyncLoadRequests.end())
     {
-        if (mBeginLoadQueue[i]->mName == name)
+        request = it->second;
+
+        if (request->mPriority < priority)
         {
-            mBeginLoadQueue[i]->mTargetRefs.push_back(targetRef);
-            return;
+            request->mPriority = priority;
+
+            if (request->mState == AsyncLoadState::Queued)
+            {
+                std::make_heap(mBeginLoadQueue.begin(), mBeginLoadQueue.end(), AsyncLoadRequestLess);
+            }
         }
     }
-
-    for (uint32_t i = 0; i < mEndLoadQueue.size(); ++i)
+    else
     {
-        if (mEndLoadQueue[i]->mName == name)
-        {
-            mEndLoadQueue[i]->mTargetRefs.push_back(targetRef);
-            return;
-        }
+        // (4) Otherwise, malloc and enqueue a new AsyncLoadRequest to the BeginLoadQueue
+        request = new AsyncLoadRequest();
+        request->mName = name;
+        request->mPath = stub->mPath;
+        request->mType = stub->mType;
+        request->mEmbeddedData = stub->mEmbeddedData;
+        request->mPriority = priority;
+        request->mSequence = mNextAsyncLoadSequence++;
+
+        mAsyncLoadRequests.insert({ name, request });
+        mBeginLoadQueue.push_back(request);
+        std::push_heap(mBeginLoadQueue.begin(), mBeginLoadQueue.end(), AsyncLoadRequestLess);
+
+        // Wake up one of the loader threads.
+        SYS_SignalSemaphore(mAsyncLoadSemaphore, 1);
     }
-    
-    // (4) Otherwise, malloc and enqueue a new AsyncLoadRequest to the BeginLoadQueue
-    AsyncLoadRequest* newRequest = new AsyncLoadRequest();
-    mBeginLoadQueue.push_back(newRequest);
-
-    // (5) Set the data on the request, including the targetRef.
-    newRequest->mName = name;
-    newRequest->mPath = stub->mPath;
-    newRequest->mType = stub->mType;
-    newRequest->mEmbeddedData = stub->mEmbeddedData;
 
-    if (targetRef != nullptr)
+    // (5) Add the target ref to the request and set the request pointer on the AssetRef.
+    if (targetRef == nullptr)
     {
-        newRequest->mTargetRefs.push_back(targetRef);
-
-        // (6) Set the request pointer on the AssetRef.
-        targetRef->mLoadRequest = newRequest;
+        request->mKeepAlive = true;
+    }
+    else if (targetRef->mLoadRequest != request)
+    {
+        request->mTargetRefs.push_back(targetRef);
+        targetRef->mLoadRequest = request;
     }
 }
 
@@ -914,27 +1030,92 @@ bool AssetManager::UnloadAsset(AssetStub& stub)
 void AssetManager::EraseAsyncLoadRef(AssetRef& assetRef)
 {
     SCOPED_LOCK(mMutex);
+    EraseAsyncLoadRefInternal(assetRef);
+}
+
+void AssetManager::SetAsyncLoadTimeBudget(float milliseconds)
+{
+    mAsyncLoadTimeBudget = milliseconds;
+}
+
+float AssetManager::GetAsyncLoadTimeBudget() const
+{
+    return mAsyncLoadTimeBudget;
+}
+
+uint32_t AssetManager::GetNumPendingAsyncLoads()
+{
+    SCOPED_LOCK(mMutex);
+    return uint32_t(mAsyncLoadRequests.size());
+}
+
+void AssetManager::AddLoadStats(uint32_t bytesRead, uint32_t bytesDecoded)
+{
+    SCOPED_LOCK(mLoadStatsMutex);
+    mNumBytesRead += bytesRead;
+    mNumBytesDecoded += bytesDecoded;
+}
 
-    auto eraseRef = [](std::deque<AsyncLoadRequest*>& queue, AssetRef& ref)
+uint64_t AssetManager::GetNumBytesRead() const
+{
+    SCOPED_LOCK(mLoadStatsMutex);
+    return mNumBytesRead;
+}
+
+uint64_t AssetManager::GetNumBytesDecoded() const
+{
+    SCOPED_LOCK(mLoadStatsMutex);
+    return mNumBytesDecoded;
+}
+
+void AssetManager::ResetLoadStats()
+{
+    SCOPED_LOCK(mLoadStatsMutex);
+    mNumBytesRead = 0;
+    mNumBytesDecoded = 0;
+}
+
+void AssetManager::EraseAsyncLoadRefInternal(AssetRef& assetRef)
+{
+    // Expects mMutex to be locked already.
+    AsyncLoadRequest* request = assetRef.mLoadRequest;
+    assetRef.mLoadRequest = nullptr;
+
+    if (request == nullptr)
+        return;
+
+    std::vector<AssetRef*>& refs = request->mTargetRefs;
+
+    for (int32_t r = int32_t(refs.size()) - 1; r >= 0; --r)
     {
-        for (uint32_t i = 0; i < queue.size(); ++i)
+        if (refs[r] == &assetRef)
         {
-            std::vector<AssetRef*>& refs = queue[i]->mTargetRefs;
-
-            for (int32_t r = int32_t(refs.size()) - 1; r >= 0; --r)
-            {
-                if (refs[r] == &ref)
-                {
-                    refs.erase(refs.begin() + r);
-                }
-            }
+            refs.erase(refs.begin() + r);
         }
-    };
+    }
 
-    eraseRef(mBeginLoadQueue, assetRef);
-    eraseRef(mEndLoadQueue, assetRef);
+    // Nobody is waiting on this asset anymore. If no loader thread has picked it up yet, just drop it.
+    // Once loading has started, the request is allowed to finish so the work isn't thrown away.
+    if (refs.size() == 0 &&
+        !request->mKeepAlive &&
+        request->mState == AsyncLoadState::Queued)
+    {
+        CancelAsyncLoad(request);
+    }
+}
 
-    assetRef.mLoadRequest = nullptr;
+void AssetManager::CancelAsyncLoad(AsyncLoadRequest* request)
+{
+    OCT_ASSERT(request->mState == AsyncLoadState::Queued);
+    LogDebug("Canceled Async Loading: %s", request->mName.c_str());
+
+    auto it = std::find(mBeginLoadQueue.begin(), mBeginLoadQueue.end(), request);
+    OCT_ASSERT(it != mBeginLoadQueue.end());
+    mBeginLoadQueue.erase(it);
+    std::make_heap(mBeginLoadQueue.begin(), mBeginLoadQueue.end(), AsyncLoadRequestLess);
+
+    mAsyncLoadRequests.erase(request->mName);
+    delete request;
 }
 
 bool AssetManager::DoesAssetExist(const std::string& name)
@@ -1083,19 +1264,23 @@ std::unordered_map<std::string, AssetStub*>& AssetManager::GetAssetMap()
 ThreadFuncRet AssetManager::AsyncLoadThreadFunc(void* in)
 {
     AssetManager& am = *((AssetManager*)in);
-    bool exit = false;
 
-    while (!exit)
+    while (true)
     {
+        // Sleep until a request is queued (or we are shutting down).
+        SYS_WaitSemaphore(am.mAsyncLoadSemaphore);
+
         AsyncLoadRequest* request = nullptr;
 
-        // Pop off the next request from the queue.
+        // Pop off the highest priority request.
         SYS_LockMutex(am.mMutex);
         bool exit = am.mDestructing;
-        if (am.mBeginLoadQueue.size() > 0)
+        if (!exit && am.mBeginLoadQueue.size() > 0)
         {
-            request = am.mBeginLoadQueue.front();
-            am.mBeginLoadQueue.pop_front();
+            std::pop_heap(am.mBeginLoadQueue.begin(), am.mBeginLoadQueue.end(), AsyncLoadRequestLess);
+            request = am.mBeginLoadQueue.back();
+            am.mBeginLoadQueue.pop_back();
+            request->mState = AsyncLoadState::Loading;
         }
         SYS_UnlockMutex(am.mMutex);
 
@@ -1104,6 +1289,7 @@ ThreadFuncRet AssetManager::AsyncLoadThreadFunc(void* in)
             break;
         }
 
+        // The request may have been canceled after its semaphore signal.
         if (request != nullptr)
         {
             // We have a request, so we need to
@@ -1114,28 +1300,32 @@ ThreadFuncRet AssetManager::AsyncLoadThreadFunc(void* in)
             // (2) Load the file into a stream
             // (3) Call asset->LoadStream()
             // The call to Asset::Create() is made on the main thread, that's why we queue it up on the EndLoadQueue
+            bool loaded = false;
+
             if (request->mEmbeddedData != nullptr)
             {
-                newAsset->LoadEmbedded(request->mEmbeddedData, request);
+                loaded = newAsset->LoadEmbedded(request->mEmbeddedData, request);
             }
             else
             {
-                newAsset->LoadFile(request->mPath.c_str(), request);
+                loaded = newAsset->LoadFile(request->mPath.c_str(), request);
             }
 
-            request->mAsset = newAsset;
+            if (!loaded)
+            {
+                // The request still goes through the EndLoadQueue so its refs get released on the main thread.
+                delete newAsset;
+                newAsset = nullptr;
+            }
 
             // (4) Add the request to the EndLoadQueue
             {
                 SCOPED_LOCK(am.mMutex);
+                request->mAsset = newAsset;
+                request->mState = AsyncLoadState::Loaded;
                 am.mEndLoadQueue.push_back(request);
             }
         }
-        else
-        {
-            // If nothing to process then sleep, for a bit so we don't was cpu cycles checking.
-            SYS_Sleep(2);
-        }
     }
 
     THREAD_RETURN();
@@ -1143,99 +1333,129 @@ ThreadFuncRet AssetManager::AsyncLoadThreadFunc(void* in)
 
 void AssetManager::UpdateEndLoadQueue()
 {
-    SCOPED_LOCK(mMutex);
+    SCOPED_STAT("UpdateEndLoadQueue");
+
+    const uint64_t startTime = SYS_GetTimeMicroseconds();
+    const uint64_t budgetUs = uint64_t(mAsyncLoadTimeBudget * 1000.0f);
 
-    const uint32_t maxIterations = 3;
-    uint32_t numIterations = 0;
+    SYS_LockMutex(mMutex);
 
-    bool handled = false;
+    // Only visit each request once per frame, requests waiting on dependencies get pushed to the back.
+    uint32_t numRequests = uint32_t(mEndLoadQueue.size());
 
-    do
+    for (uint32_t r = 0; r < numRequests && mEndLoadQueue.size() > 0; ++r)
     {
-        handled = false;
-        AsyncLoadRequest* loadRequest = (mEndLoadQueue.size() > 0) ? mEndLoadQueue.front() : nullptr;
+        AsyncLoadRequest* loadRequest = mEndLoadQueue.front();
+        mEndLoadQueue.pop_front();
 
-        if (mEndLoadQueue.size() > 0)
+        // Check load dependencies before finish the load
+        bool allDependenciesLoaded = true;
+
+        for (uint32_t i = 0; i < loadRequest->mDependentAssets.size(); ++i)
         {
-            mEndLoadQueue.pop_front();
+            if (loadRequest->mDependentAssets[i]->mAsset == nullptr)
+            {
+                allDependenciesLoaded = false;
+                break;
+            }
         }
 
-        if (loadRequest != nullptr)
+        if (allDependenciesLoaded)
         {
-            numIterations++;
-
-            // Check load dependencies before finish the load
-            bool allDependenciesLoaded = true;
-
-            for (uint32_t i = 0; i < loadRequest->mDependentAssets.size(); ++i)
+            // Don't hold the lock while creating the asset, Create() may issue more loads.
+            loadRequest->mState = AsyncLoadState::Finalizing;
+            SYS_UnlockMutex(mMutex);
+            bool finished = FinishAsyncLoad(loadRequest);
+            SYS_LockMutex(mMutex);
+
+            // Always finish at least one request per frame, then stop once the budget is used up.
+            if (finished &&
+                SYS_GetTimeMicroseconds() - startTime >= budgetUs)
             {
-                if (loadRequest->mDependentAssets[i]->mAsset == nullptr)
-                {
-                    allDependenciesLoaded = false;
-                    break;
-                }
+                break;
             }
+        }
+        else
+        {
+            // Still waiting on some dependent assets, so push this on the back of the queue
+            // This might happen several times before the dependent assests make their way to the front
+            // of the mEndLoadQueue.
+            mEndLoadQueue.push_back(loadRequest);
+            loadRequest->mRequeueCount++;
 
-            if (allDependenciesLoaded)
+            if (loadRequest->mRequeueCount >= ASYNC_REQUEUE_LIMIT)
             {
-                handled = true;
+                LogWarning("Exceeded requeue limit for %s, possible cyclical dependency. Forcing load.", loadRequest->mName.c_str());
+                SYS_UnlockMutex(mMutex);
+                LoadAsset(loadRequest->mName);
+                SYS_LockMutex(mMutex);
+            }
+        }
+    }
 
-                AssetStub* stub = GetAssetStub(loadRequest->mName);
+    SYS_UnlockMutex(mMutex);
+}
 
-                if (stub == nullptr)
-                {
-                    LogError("Cannot find asset for async load request");
-                }
-                else if (stub->mAsset != nullptr)
-                {
-                    LogWarning("AsyncLoadRequest not finished because the asset has already been loaded");
-                }
-                else
-                {
-                    LogDebug("Finished Async Loading: %s", loadRequest->mName.c_str());
-
-                    // Finish the load on the main thread and assign the stub's mAsset so that it is officially "Loaded"
-                    OCT_ASSERT(loadRequest->mAsset != nullptr);
-                    loadRequest->mAsset->Create();
-                    stub->mAsset = loadRequest->mAsset;
-
-                    // Now assign the asset to all of the refs that had requested the load
-                    for (uint32_t i = 0; i < loadRequest->mTargetRefs.size(); ++i)
-                    {
-                        if (loadRequest->mTargetRefs[i] != nullptr)
-                        {
-                            // The load request of the target ref should match this load request but...
-                            // We need to make sure we handle the case where an AssetRef is assigned twice to an async load
-                            // before the first one finishes. Might mean Canceling the request if one already exists in AsyncLoadAsset()
-                            OCT_ASSERT(loadRequest->mTargetRefs[i]->mLoadRequest == nullptr ||
-                                loadRequest->mTargetRefs[i]->mLoadRequest == loadRequest);
-
-                            (*loadRequest->mTargetRefs[i]) = loadRequest->mAsset;
-                            loadRequest->mTargetRefs[i]->mLoadRequest = nullptr;
-                        }
-                    }
-                }
+bool AssetManager::FinishAsyncLoad(AsyncLoadRequest* loadRequest)
+{
+    bool created = false;
 
-                delete loadRequest;
-                loadRequest = nullptr;
-            }
-            else
-            {
-                // Still waiting on some dependent assets, so push this on the back of the queue
-                // This might happen several times before the dependent assests make their way to the front
-                // of the mEndLoadQueue.
-                LogWarning("Async load for %s is still waiting on dependencies", loadRequest->mName.c_str());
-                mEndLoadQueue.push_back(loadRequest);
-                loadRequest->mRequeueCount++;
-
-                if (loadRequest->mRequeueCount >= ASYNC_REQUEUE_LIMIT)
-                {
-                    LogWarning("Exceeded requeue limit for %s, possible cyclical dependency. Forcing load.", loadRequest->mName.c_str());
-                    LoadAsset(loadRequest->mName);
-                }
-            }
-        }
-    } while (handled && numIterations < maxIterations);
+    AssetStub* stub = GetAssetStub(loadRequest->mName);
+
+    if (stub == nullptr)
+    {
+        LogError("Cannot find asset for async load request");
+    }
+    else if (loadRequest->mAsset == nullptr)
+    {
+        // The loader thread already logged why. Refs are cleared below.
+        LogError("Async load failed: %s", loadRequest->mName.c_str());
+    }
+    else if (stub->mAsset != nullptr)
+    {
+        // Someone loaded it synchronously in the meantime. Hand out that asset instead.
+        LogWarning("AsyncLoadRequest not finished because the asset has already been loaded");
+    }
+    else
+    {
+        LogDebug("Finished Async Loading: %s", loadRequest->mName.c_str());
+
+        // Finish the load on the main thread and assign the stub's mAsset so that it is officially "Loaded"
+        loadRequest->mAsset->Create();
+        created = true;
+    }
+
+    Asset* discardedAsset = created ? nullptr : loadRequest->mAsset;
+
+    SYS_LockMutex(mMutex);
+
+    if (created)
+    {
+        stub->mAsset = loadRequest->mAsset;
+    }
+
+    // Now assign the asset to all of the refs that had requested the load
+    Asset* asset = (stub != nullptr) ? stub->mAsset : nullptr;
+
+    for (uint32_t i = 0; i < loadRequest->mTargetRefs.size(); ++i)
+    {
+        AssetRef* targetRef = loadRequest->mTargetRefs[i];
+        OCT_ASSERT(targetRef->mLoadRequest == loadRequest);
+
+        (*targetRef) = asset;
+        targetRef->mLoadRequest = nullptr;
+    }
+
+    mAsyncLoadRequests.erase(loadRequest->mName);
+
+    SYS_UnlockMutex(mMutex);
+
+    // Deleting the unused asset releases its own refs, which take the lock.
+    // Asset::Create() was never called on it, so there is nothing to Destroy().
+    delete discardedAsset;
+    delete loadRequest;
+
+    return created;
 }
 
 #if EDITOR
@@ -8,13 +8,23 @@
 
 #include <string>
 #include <deque>
+#include <vector>
 #include <unordered_map>
 
 class Asset;
+class AssetArchive;
 class AssetDir;
 class Material;
 class ParticleSystem;
 
+enum class AsyncLoadState
+{
+    Queued,
+    Loading,
+    Loaded,
+    Finalizing
+};
+
 struct AsyncLoadRequest
 {
     std::string mName;
@@ -25,12 +35,18 @@ struct AsyncLoadRequest
     TypeId mType = INVALID_TYPE_ID;
     Asset* mAsset = nullptr;
     int32_t mRequeueCount = 0;
+    int32_t mPriority = 0;
+    uint32_t mSequence = 0;
+    AsyncLoadState mState = AsyncLoadState::Queued;
+
+    // Set when the load was requested without a target ref, so it can't be canceled.
+    bool mKeepAlive = false;
 };
 
 Asset* FetchAsset(const std::string& name);
 Asset* LoadAsset(const std::string& name);
 void UnloadAsset(const std::string& name);
-void AsyncLoadAsset(const std::string& name, AssetRef* targetRef = nullptr);
+void AsyncLoadAsset(const std::string& name, AssetRef* targetRef = nullptr, int32_t priority = 0);
 AssetStub* FetchAssetStub(const std::string& name);
 
 template<typename T>
@@ -78,6 +94,7 @@ public:
     void Discover(const char* directoryName, const char* directoryPath);
     void DiscoverAssetRegistry(const char* registryPath);
     void DiscoverEmbeddedAssets(struct EmbeddedFile* assets, uint32_t numAssets);
+    bool MountArchive(const char* archivePath);
     void Purge(bool purgeEngineAssets);
     bool PurgeAsset(const char* name);
     void RefSweep();
@@ -92,13 +109,24 @@ public:
     Asset* GetAsset(const std::string& name);
     Asset* LoadAsset(const std::string& name);
     Asset* LoadAsset(AssetStub& stub);
-    void AsyncLoadAsset(const std::string& name, AssetRef* targetRef);
+    void AsyncLoadAsset(const std::string& name, AssetRef* targetRef, int32_t priority = 0);
     void SaveAsset(const std::string& name);
     void SaveAsset(AssetStub& stub);
     bool UnloadAsset(const std::string& name);
     bool UnloadAsset(AssetStub& stub);
     void EraseAsyncLoadRef(AssetRef& assetRef);
 
+    // Max time (in milliseconds) spent finishing async loads on the main thread each frame.
+    void SetAsyncLoadTimeBudget(float milliseconds);
+    float GetAsyncLoadTimeBudget() const;
+    uint32_t GetNumPendingAsyncLoads();
+
+    // Bytes read from disk vs bytes handed to the asset after decompression.
+    void AddLoadStats(uint32_t bytesRead, uint32_t bytesDecoded);
+    uint64_t GetNumBytesRead() const;
+    uint64_t GetNumBytesDecoded() const;
+    void ResetLoadStats();
+
     bool DoesAssetExist(const std::string& name);
     bool RenameAsset(Asset* asset, const std::string& newName);
     bool RenameDirectory(AssetDir* dir, const std::string& newName);
@@ -122,16 +150,33 @@ protected:
     AssetManager();
 
     void UpdateEndLoadQueue();
+    bool FinishAsyncLoad(AsyncLoadRequest* request);
+    void EraseAsyncLoadRefInternal(AssetRef& assetRef);
+    void CancelAsyncLoad(AsyncLoadRequest* request);
 
     std::unordered_map<std::string, AssetStub*> mAssetMap;
     std::vector<Asset*> mTransientAssets;
+    std::vector<AssetArchive*> mArchives;
     AssetDir* mRootDirectory = nullptr;
     bool mPurging = false;
     bool mDestructing = false;
-    std::deque<AsyncLoadRequest*> mBeginLoadQueue;
+
+    // Max-heap ordered by priority, then by request order.
+    std::vector<AsyncLoadRequest*> mBeginLoadQueue;
     std::deque<AsyncLoadRequest*> mEndLoadQueue;
-    ThreadObject* mAsyncLoadThread = {};
+
+    // Every request that hasn't finished yet, regardless of which stage it's in.
+    std::unordered_map<std::string, AsyncLoadRequest*> mAsyncLoadRequests;
+    uint32_t mNextAsyncLoadSequence = 0;
+    float mAsyncLoadTimeBudget = 4.0f;
+    uint64_t mNumBytesRead = 0;
+    uint64_t mNumBytesDecoded = 0;
+
+    std::vector<ThreadObject*> mAsyncLoadThreads;
+    SemaphoreObject* mAsyncLoadSemaphore = {};
     MutexObject* mMutex = {};
+    // Separate from mMutex since stats are added while loading, which can happen with mMutex held.
+    MutexObject* mLoadStatsMutex = {};
 
 #if EDITOR
 public:
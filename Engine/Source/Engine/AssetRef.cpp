@@ -13,33 +13,63 @@
 #include "Assertion.h"
 
 #if ASSET_LIVE_REF_TRACKING
-// Need a mutex so that newly added AssetRefs during async load won't mess up operations.
-static MutexObject* GetLiveRefMutex()
+void AssetRef::ReplaceReferencesToAsset(Asset* oldAsset, Asset* newAsset)
 {
-    static MutexObject* sLiveRefMutex = SYS_CreateMutex();
-    return sLiveRefMutex;
-}
+    if (oldAsset == nullptr ||
+        oldAsset == newAsset)
+    {
+        return;
+    }
 
-static std::unordered_set<AssetRef*>& GetLiveRefMap()
-{
-    static std::unordered_set<AssetRef*> sLiveAssetRefs;
-    return sLiveAssetRefs;
-}
+    AssetManager* am = AssetManager::Get();
+    bool purging = am && am->IsPurging();
+    bool decrement = !(purging || IsShuttingDown());
 
-void AssetRef::ReplaceReferencesToAsset(Asset* oldAsset, Asset* newAsset)
-{
-    SCOPED_LOCK(GetLiveRefMutex());
+    // Hold the old asset's lock for the whole walk. A ref being removed on another thread
+    // waits for it, then sees that its asset changed (see RemoveLiveRef).
+    oldAsset->mLiveRefLock.Lock();
 
-    if (oldAsset != nullptr)
+    while (oldAsset->mLiveRefs != nullptr)
     {
-        for (AssetRef* ref : GetLiveRefMap())
+        AssetRef* ref = oldAsset->mLiveRefs;
+        oldAsset->mLiveRefs = ref->mNextLiveRef;
+
+        if (ref->mNextLiveRef != nullptr)
+        {
+            ref->mNextLiveRef->mPrevLiveRef = nullptr;
+        }
+
+        ref->mPrevLiveRef = nullptr;
+        ref->mNextLiveRef = nullptr;
+
+        if (decrement)
         {
-            if (ref->Get() == oldAsset)
+            oldAsset->DecrementRefCount();
+        }
+
+        if (newAsset != nullptr)
+        {
+            newAsset->IncrementRefCount();
+
+            // Link the ref into the new list before publishing the new target. A RemoveLiveRef() that
+            // sees mAsset == newAsset and takes newAsset's lock then always finds the ref linked.
+            newAsset->mLiveRefLock.Lock();
+
+            if (!IsShuttingDown())
             {
-                *ref = newAsset;
+                LinkLiveRef(newAsset, ref);
             }
+
+            ref->mAsset.store(newAsset, std::memory_order_release);
+            newAsset->mLiveRefLock.Unlock();
+        }
+        else
+        {
+            ref->mAsset.store(nullptr, std::memory_order_release);
         }
     }
+
+    oldAsset->mLiveRefLock.Unlock();
 }
 
 void AssetRef::EraseReferencesToAsset(Asset* asset)
@@ -49,33 +79,86 @@ void AssetRef::EraseReferencesToAsset(Asset* asset)
 
 void AssetRef::AddLiveRef(AssetRef* ref)
 {
-    if (!IsShuttingDown())
+    Asset* asset = ref->mAsset.load(std::memory_order_acquire);
+
+    if (asset != nullptr &&
+        !IsShuttingDown())
     {
-        SCOPED_LOCK(GetLiveRefMutex());
+        asset->mLiveRefLock.Lock();
+        LinkLiveRef(asset, ref);
+        asset->mLiveRefLock.Unlock();
+    }
+}
 
-        // Ensure that we are not adding this ref a second time to the list.
-        OCT_ASSERT(GetLiveRefMap().find(ref) == GetLiveRefMap().end());
+void AssetRef::LinkLiveRef(Asset* asset, AssetRef* ref)
+{
+    OCT_ASSERT(ref->mPrevLiveRef == nullptr && ref->mNextLiveRef == nullptr);
+
+    ref->mNextLiveRef = asset->mLiveRefs;
 
-        GetLiveRefMap().insert(ref);
+    if (asset->mLiveRefs != nullptr)
+    {
+        asset->mLiveRefs->mPrevLiveRef = ref;
     }
+
+    asset->mLiveRefs = ref;
 }
 
 void AssetRef::RemoveLiveRef(AssetRef* ref)
 {
-    if (!IsShuttingDown())
+    if (IsShuttingDown())
+    {
+        return;
+    }
+
+    // The asset is loaded before any lock is held. The only other thread that writes a ref's mAsset is
+    // ReplaceReferencesToAsset(), and it does so atomically while holding the old asset's lock, so
+    // re-loading it under the lock tells us whether we locked the list the ref is actually in.
+    // If not, retry against the new target.
+    while (true)
     {
-        SCOPED_LOCK(GetLiveRefMutex());
+        Asset* asset = ref->mAsset.load(std::memory_order_acquire);
+
+        if (asset == nullptr)
+        {
+            break;
+        }
+
+        asset->mLiveRefLock.Lock();
+
+        if (ref->mAsset.load(std::memory_order_acquire) != asset)
+        {
+            // Retargeted by ReplaceReferencesToAsset() while we waited for the lock.
+            asset->mLiveRefLock.Unlock();
+            continue;
+        }
+
+        if (ref->mPrevLiveRef != nullptr)
+        {
+            ref->mPrevLiveRef->mNextLiveRef = ref->mNextLiveRef;
+        }
+        else if (asset->mLiveRefs == ref)
+        {
+            asset->mLiveRefs = ref->mNextLiveRef;
+        }
+
+        if (ref->mNextLiveRef != nullptr)
+        {
+            ref->mNextLiveRef->mPrevLiveRef = ref->mPrevLiveRef;
+        }
 
-        GetLiveRefMap().erase(ref);
+        ref->mPrevLiveRef = nullptr;
+        ref->mNextLiveRef = nullptr;
+
+        asset->mLiveRefLock.Unlock();
+        break;
     }
 }
 #endif
 
 AssetRef::AssetRef()
 {
-#if ASSET_LIVE_REF_TRACKING
-    AddLiveRef(this);
-#endif
+
 }
 
 AssetRef::AssetRef(Asset* asset) :
@@ -85,23 +168,24 @@ AssetRef::AssetRef(Asset* asset) :
     AddLiveRef(this);
 #endif
 
-    if (mAsset != nullptr)
+    if (asset != nullptr)
     {
-        mAsset->IncrementRefCount();
+        asset->IncrementRefCount();
     }
 }
 
 AssetRef::AssetRef(const AssetRef& src)
 {
-    mAsset = src.mAsset;
+    Asset* asset = src.Get();
+    mAsset = asset;
 
 #if ASSET_LIVE_REF_TRACKING
     AddLiveRef(this);
 #endif
 
-    if (mAsset != nullptr)
+    if (asset != nullptr)
     {
-        mAsset->IncrementRefCount();
+        asset->IncrementRefCount();
     }
 
     if (mLoadRequest != nullptr)
@@ -124,9 +208,11 @@ AssetRef::~AssetRef()
     bool purging = am && am->IsPurging();
     bool decrement = !(purging || IsShuttingDown());
 
-    if (decrement && mAsset != nullptr)
+    Asset* asset = mAsset;
+
+    if (decrement && asset != nullptr)
     {
-        mAsset->DecrementRefCount();
+        asset->DecrementRefCount();
     }
 
 #if ASSET_LIVE_REF_TRACKING
@@ -136,7 +222,7 @@ AssetRef::~AssetRef()
 
 AssetRef& AssetRef::operator=(const AssetRef& src)
 {
-    return operator=(src.mAsset);
+    return operator=(src.Get());
 }
 
 AssetRef& AssetRef::operator=(const Asset* srcAsset)
@@ -145,17 +231,28 @@ AssetRef& AssetRef::operator=(const Asset* srcAsset)
     bool purging = am && am->IsPurging();
     bool decrement = !(purging || IsShuttingDown());
 
-    if (decrement && mAsset != nullptr)
+    Asset* oldAsset = mAsset;
+
+    if (decrement && oldAsset != nullptr)
     {
-        mAsset->DecrementRefCount();
+        oldAsset->DecrementRefCount();
     }
 
+#if ASSET_LIVE_REF_TRACKING
+    if (oldAsset != srcAsset)
+    {
+        RemoveLiveRef(this);
+        mAsset = const_cast<Asset*>(srcAsset);
+        AddLiveRef(this);
+    }
+#else
     mAsset = const_cast<Asset*>(srcAsset);
+#endif
 
     // Increment the new asset if it's valid.
-    if (mAsset != nullptr)
+    if (srcAsset != nullptr)
     {
-        mAsset->IncrementRefCount();
+        const_cast<Asset*>(srcAsset)->IncrementRefCount();
     }
 
     return *this;
@@ -163,7 +260,7 @@ AssetRef& AssetRef::operator=(const Asset* srcAsset)
 
 bool AssetRef::operator==(const AssetRef& other) const
 {
-    return mAsset == other.mAsset;
+    return Get() == other.Get();
 }
 
 bool AssetRef::operator!=(const AssetRef& other) const
@@ -173,12 +270,12 @@ bool AssetRef::operator!=(const AssetRef& other) const
 
 bool AssetRef::operator==(const Asset* other) const
 {
-    return (mAsset == other);
+    return (Get() == other);
 }
 
 bool AssetRef::operator!=(const Asset* other) const
 {
-    return (mAsset != other);
+    return (Get() != other);
 }
 
 Asset* AssetRef::Get() const
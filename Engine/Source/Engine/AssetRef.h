@@ -3,10 +3,9 @@
 #include "Asset.h"
 #include "Constants.h"
 #include <vector>
+#include <atomic>
 #include "Assertion.h"
 
-#include <unordered_set>
-
 //class Asset;
 class AssetManager;
 struct AsyncLoadRequest;
@@ -34,22 +33,35 @@ public:
     template<typename T>
     T* Get() const
     {
-        OCT_ASSERT(!mAsset || mAsset->GetType() == T::GetStaticType() || mAsset->Is(T::ClassRuntimeId()));
-        return static_cast<T*>(Get());
+        Asset* asset = Get();
+        OCT_ASSERT(!asset || asset->GetType() == T::GetStaticType() || asset->Is(T::ClassRuntimeId()));
+        return static_cast<T*>(asset);
     }
 
 private:
 
+#if ASSET_LIVE_REF_TRACKING
+    // ReplaceReferencesToAsset() retargets refs on the main thread while async loads
+    // may be creating and destroying refs on loader threads.
+    std::atomic<Asset*> mAsset{ nullptr };
+#else
     Asset* mAsset = nullptr;
+#endif
     AsyncLoadRequest* mLoadRequest = nullptr;
 
 #if ASSET_LIVE_REF_TRACKING
 public:
+    // Both only walk the refs that point at the given asset. Main thread only.
     static void ReplaceReferencesToAsset(Asset* oldAsset, Asset* newAsset);
     static void EraseReferencesToAsset(Asset* asset);
 private:
     static void AddLiveRef(AssetRef* ref);
     static void RemoveLiveRef(AssetRef* ref);
+    static void LinkLiveRef(Asset* asset, AssetRef* ref);
+
+    // Links in the referenced asset's live ref list. Null refs aren't tracked.
+    AssetRef* mPrevLiveRef = nullptr;
+    AssetRef* mNextLiveRef = nullptr;
 #endif
 
 };
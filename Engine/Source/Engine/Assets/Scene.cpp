@@ -54,6 +54,9 @@ void Scene::LoadStream(Stream& stream, Platform platform)
 {
     Asset::LoadStream(stream, platform);
 
+    // May be on the async loading thread.
+    sPlanGeneration++;
+
     uint32_t numNodeDefs = stream.ReadUint32();
     OCT_ASSERT(numNodeDefs < 65535); // Something reasonable?
     mNodeDefs.resize(numNodeDefs);
@@ -199,9 +202,254 @@ const char* Scene::GetTypeName()
     return "Scene";
 }
 
+std::atomic<uint32_t> Scene::sPlanGeneration(1);
+
+static int32_t FindPropertyIndex(const std::vector<Property>& props, const Property& srcProp)
+{
+    int32_t index = -1;
+
+    for (uint32_t i = 0; i < props.size(); ++i)
+    {
+        if (props[i].mName == srcProp.mName &&
+            props[i].mType == srcProp.mType)
+        {
+            index = int32_t(i);
+            break;
+        }
+    }
+
+    return index;
+}
+
+// Same as CopyPropertyValues(), but the src -> dst matching is cached in the pass. Each binding is
+// still checked before use, and everything is rebound if the node gathered a different number of properties.
+static void CopyBoundPropertyValues(
+    std::vector<Property>& dstProps,
+    const std::vector<Property>& srcProps,
+    ScenePropertyPass& pass)
+{
+    std::vector<int32_t>& bindings = pass.mBindings;
+
+    if (bindings.size() != srcProps.size() ||
+        pass.mNumGatheredProps != dstProps.size())
+    {
+        bindings.resize(srcProps.size());
+        pass.mNumGatheredProps = uint32_t(dstProps.size());
+
+        for (uint32_t i = 0; i < srcProps.size(); ++i)
+        {
+            bindings[i] = FindPropertyIndex(dstProps, srcProps[i]);
+        }
+    }
+
+    for (uint32_t i = 0; i < srcProps.size(); ++i)
+    {
+        int32_t dstIndex = bindings[i];
+
+        if (dstIndex >= 0 &&
+            (dstProps[dstIndex].mType != srcProps[i].mType || dstProps[dstIndex].mName != srcProps[i].mName))
+        {
+            dstIndex = FindPropertyIndex(dstProps, srcProps[i]);
+            bindings[i] = dstIndex;
+        }
+
+        if (dstIndex >= 0)
+        {
+            CopyPropertyValue(dstProps[dstIndex], srcProps[i]);
+        }
+    }
+}
+
+static uint32_t GetNumScriptProps(Node* node)
+{
+    Script* script = node->GetScript();
+    return (script != nullptr) ? uint32_t(script->GetScriptProperties().size()) : 0;
+}
+
+// Records the pass's bindings as direct targets. Fails if any target's data isn't inside the node
+// (or the node's script properties), since it couldn't be found on another node without gathering.
+static bool BuildBoundProperties(Node* node, const std::vector<Property>& dstProps, ScenePropertyPass& pass)
+{
+    pass.mBoundProps.clear();
+
+    Factory* factory = Node::FindFactory(node->GetType());
+    if (factory == nullptr)
+    {
+        return false;
+    }
+
+    const uint8_t* nodeBegin = reinterpret_cast<const uint8_t*>(node);
+    const uint8_t* nodeEnd = nodeBegin + factory->GetInstanceSize();
+    auto isInNode = [&](const void* data) -> bool
+    {
+        return data >= nodeBegin && data < nodeEnd;
+    };
+
+    // AppendScriptProperties() puts the script properties last.
+    const uint32_t firstScriptProp = uint32_t(dstProps.size()) - pass.mNumScriptProps;
+
+    for (uint32_t i = 0; i < pass.mBindings.size(); ++i)
+    {
+        int32_t dstIndex = pass.mBindings[i];
+
+        if (dstIndex < 0)
+        {
+            continue;
+        }
+
+        pass.mBoundProps.emplace_back();
+        SceneBoundProperty& bound = pass.mBoundProps.back();
+        bound.mSrcIndex = i;
+
+        if (uint32_t(dstIndex) >= firstScriptProp)
+        {
+            bound.mScriptPropIndex = dstIndex - int32_t(firstScriptProp);
+            continue;
+        }
+
+        const Property& dstProp = dstProps[dstIndex];
+
+        if (dstProp.mOwner != node)
+        {
+            return false;
+        }
+
+        if (dstProp.IsVector())
+        {
+            // The element pointer is refreshed from the vector when it is resized during the copy.
+            if (!isInNode(dstProp.mVector))
+            {
+                return false;
+            }
+
+            bound.mVectorOffset = reinterpret_cast<const uint8_t*>(dstProp.mVector) - nodeBegin;
+        }
+        else
+        {
+            if (!dstProp.mExternal ||
+                !isInNode(dstProp.mData.vp))
+            {
+                return false;
+            }
+
+            bound.mDataOffset = reinterpret_cast<const uint8_t*>(dstProp.mData.vp) - nodeBegin;
+        }
+
+        bound.mTarget = dstProp;
+    }
+
+    return true;
+}
+
+static bool CanApplyBoundProperties(Node* node, const std::vector<Property>& srcProps, const ScenePropertyPass& pass)
+{
+    if (!pass.mDirect ||
+        GetNumScriptProps(node) != pass.mNumScriptProps)
+    {
+        return false;
+    }
+
+    if (pass.mNumScriptProps > 0)
+    {
+        // A script's property set only changes if the script does, so the count and types are enough to trust the indices.
+        const std::vector<Property>& scriptProps = node->GetScript()->GetScriptProperties();
+
+        for (uint32_t i = 0; i < pass.mBoundProps.size(); ++i)
+        {
+            const SceneBoundProperty& bound = pass.mBoundProps[i];
+
+            if (bound.mScriptPropIndex >= 0 &&
+                scriptProps[bound.mScriptPropIndex].mType != srcProps[bound.mSrcIndex].mType)
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+static void ApplyBoundProperties(Node* node, const std::vector<Property>& srcProps, ScenePropertyPass& pass)
+{
+    uint8_t* nodeBase = reinterpret_cast<uint8_t*>(node);
+
+    // Same script a gather at the start of the pass would have appended the properties of.
+    Script* script = node->GetScript();
+
+    for (uint32_t i = 0; i < pass.mBoundProps.size(); ++i)
+    {
+        SceneBoundProperty& bound = pass.mBoundProps[i];
+        const Property& srcProp = srcProps[bound.mSrcIndex];
+
+        if (bound.mScriptPropIndex >= 0)
+        {
+            script->CopyScriptPropertyValue(uint32_t(bound.mScriptPropIndex), srcProp);
+            continue;
+        }
+
+        // The target is rebased in place, so it always points at the node that was spawned last.
+        Property& dstProp = bound.mTarget;
+        dstProp.mOwner = node;
+
+        if (dstProp.mIsVector)
+        {
+            dstProp.mVector = nodeBase + bound.mVectorOffset;
+        }
+        else
+        {
+            dstProp.mData.vp = nodeBase + bound.mDataOffset;
+        }
+
+        CopyPropertyValue(dstProp, srcProp);
+    }
+}
+
+// Copies the def's properties onto the node for one pass, directly if the plan allows it.
+static void CopyPassProperties(
+    Node* node,
+    const std::vector<Property>& srcProps,
+    ScenePropertyPass& pass,
+    std::vector<Property>& dstProps,
+    bool buildPlan)
+{
+    if (!buildPlan &&
+        CanApplyBoundProperties(node, srcProps, pass))
+    {
+        ApplyBoundProperties(node, srcProps, pass);
+        return;
+    }
+
+    uint32_t numScriptProps = GetNumScriptProps(node);
+
+    dstProps.clear();
+    node->GatherProperties(dstProps);
+    CopyBoundPropertyValues(dstProps, srcProps, pass);
+
+    if (buildPlan)
+    {
+        pass.mNumScriptProps = numScriptProps;
+        pass.mDirect = BuildBoundProperties(node, dstProps, pass);
+    }
+}
+
+static Node* FindExistingChild(Node* parent, const SceneNodeDef& nodeDef)
+{
+    Node* existingChild = parent->FindChild(nodeDef.mName, false);
+
+    if (existingChild != nullptr &&
+        (existingChild->GetType() != nodeDef.mType ||
+         existingChild->GetScene() != nodeDef.mScene.Get()))
+    {
+        existingChild = nullptr;
+    }
+
+    return existingChild;
+}
+
 void Scene::Capture(Node* root, Platform platform)
 {
     mNodeDefs.clear();
+    sPlanGeneration++;
 
     if (root == nullptr)
         return;
@@ -217,6 +465,16 @@ Node* Scene::Instantiate()
     if (mNodeDefs.size() > 0)
     {
         std::vector<Node*> nodeList;
+        std::vector<Property> dstProps;
+
+        // The first instantiation resolves child matches and property bindings, later ones reuse them.
+        bool buildPlan = !IsInstantiationPlanValid();
+        uint32_t planGeneration = sPlanGeneration;
+        if (buildPlan)
+        {
+            mNodePlans.clear();
+            mNodePlans.resize(mNodeDefs.size());
+        }
 
         // The nativeChildren vector holds a list of all children by created in C++ for the nodes in this scene.
         // If there is no SceneNodeDef for the nativeChild, then we must destroy it. This will happen
@@ -227,19 +485,42 @@ Node* Scene::Instantiate()
         {
             Node* node = nullptr;
             Node* parent = (i > 0) ? nodeList[mNodeDefs[i].mParentIndex] : nullptr;
+            SceneNodePlan& plan = mNodePlans[i];
 
-            if (parent != nullptr)
+            if (parent != nullptr && !buildPlan)
             {
-                // See if the node already exists. This can happen if lets say,
-                // the root node spawned other nodes on Create() in C++.
-                Node* existingChild = parent->FindChild(mNodeDefs[i].mName, false);
-
-                if (existingChild != nullptr &&
-                    existingChild->GetType() == mNodeDefs[i].mType &&
-                    existingChild->GetScene() == mNodeDefs[i].mScene.Get())
+                if (parent->GetNumChildren() != plan.mNumParentChildren)
                 {
-                    node = existingChild;
+                    // The parent didn't create the same native children as when the plan was built,
+                    // so the planned match (or lack of one) can't be trusted this time.
+                    node = FindExistingChild(parent, mNodeDefs[i]);
+                }
+                else if (plan.mExistingChildIndex >= 0)
+                {
+                    Node* existingChild = (plan.mExistingChildIndex < int32_t(parent->GetNumChildren())) ?
+                        parent->GetChild(plan.mExistingChildIndex) :
+                        nullptr;
+
+                    if (existingChild != nullptr &&
+                        existingChild->GetType() == mNodeDefs[i].mType &&
+                        existingChild->GetScene() == mNodeDefs[i].mScene.Get() &&
+                        existingChild->GetName() == mNodeDefs[i].mName)
+                    {
+                        node = existingChild;
+                    }
+                    else
+                    {
+                        node = FindExistingChild(parent, mNodeDefs[i]);
+                    }
                 }
+            }
+            else if (parent != nullptr)
+            {
+                plan.mNumParentChildren = parent->GetNumChildren();
+
+                // See if the node already exists. This can happen if lets say,
+                // the root node spawned other nodes on Create() in C++.
+                node = FindExistingChild(parent, mNodeDefs[i]);
 
                 if (node != nullptr)
                 {
@@ -264,6 +545,8 @@ Node* Scene::Instantiate()
                     }
 
                     OCT_ASSERT(isNativeChild);
+
+                    plan.mExistingChildIndex = parent->FindChildIndex(node);
                 }
             }
 
@@ -283,18 +566,26 @@ Node* Scene::Instantiate()
                 {
                     node = Node::Construct(mNodeDefs[i].mType);
 
-                    for (uint32_t c = 0; c < node->GetNumChildren(); ++c)
+                    if (buildPlan)
                     {
-                        nativeChildren.push_back(node->GetChild(c));
+                        for (uint32_t c = 0; c < node->GetNumChildren(); ++c)
+                        {
+                            nativeChildren.push_back(node->GetChild(c));
+                        }
                     }
                 }
             }
 
             OCT_ASSERT(node);
 
-            std::vector<Property> dstProps;
-            node->GatherProperties(dstProps);
-            CopyPropertyValues(dstProps, mNodeDefs[i].mProperties);
+            // Bound properties are only valid for the node type they were planned with, so replan them if it differs.
+            bool planProps = buildPlan || (node->GetType() != plan.mNodeType);
+            if (planProps)
+            {
+                plan.mNodeType = node->GetType();
+            }
+
+            CopyPassProperties(node, mNodeDefs[i].mProperties, plan.mPropPass, dstProps, planProps);
 
             if (mNodeDefs[i].mExtraData.size() > 0)
             {
@@ -307,11 +598,10 @@ Node* Scene::Instantiate()
             // copy we just did. So to copy all of the script properties we need to gather + copy them a second time.
             // During the second gather, node->mScript will be non-null and thus we can get the default script values that 
             // we will now override during the second copy.
+            // The plan can skip the second gather when the script's property set matches the one it was built with.
             if (node->GetScript() != nullptr)
             {
-                dstProps.clear();
-                node->GatherProperties(dstProps);
-                CopyPropertyValues(dstProps, mNodeDefs[i].mProperties);
+                CopyPassProperties(node, mNodeDefs[i].mProperties, plan.mScriptPropPass, dstProps, planProps);
             }
 
             if (i > 0)
@@ -356,6 +646,11 @@ Node* Scene::Instantiate()
             nodeList.push_back(node);
         }
 
+        if (buildPlan)
+        {
+            mPlanGeneration = planGeneration;
+        }
+
         rootNode = nodeList[0];
         OCT_ASSERT(rootNode);
 
@@ -407,6 +702,12 @@ Node* Scene::Instantiate()
     return rootNode;
 }
 
+bool Scene::IsInstantiationPlanValid() const
+{
+    return mPlanGeneration == sPlanGeneration &&
+        mNodePlans.size() == mNodeDefs.size();
+}
+
 void Scene::ApplyRenderSettings(World* world)
 {
     glm::vec4 ambientLight = DEFAULT_AMBIENT_LIGHT_COLOR;
@@ -5,6 +5,9 @@
 #include "Factory.h"
 #include "AssetRef.h"
 
+#include <atomic>
+#include <stddef.h>
+
 class World;
 class Node;
 
@@ -20,6 +23,48 @@ struct SceneNodeDef
     bool mExposeVariable = false;
 };
 
+// A def property bound straight to its target, so later spawns can copy it without gathering.
+// Native targets keep the gathered Property with its data/vector pointer stored as an offset
+// from the node, and are rebased onto each new node. Script targets index the Script's properties.
+struct SceneBoundProperty
+{
+    Property mTarget;
+    uint32_t mSrcIndex = 0;
+    int32_t mScriptPropIndex = -1;
+    ptrdiff_t mDataOffset = 0;
+    ptrdiff_t mVectorOffset = 0;
+};
+
+// One gather + copy of a def's properties onto its node.
+struct ScenePropertyPass
+{
+    // For each of the def's properties, the index of the matching property gathered from the node (-1 if none).
+    std::vector<int32_t> mBindings;
+    uint32_t mNumGatheredProps = 0;
+
+    // Only filled if every bound target could be rebased (its data lives inside the node or in its script's
+    // property list). Later spawns then copy through these without gathering, as long as the script still has
+    // mNumScriptProps properties of the bound types. Otherwise they gather and copy through mBindings.
+    std::vector<SceneBoundProperty> mBoundProps;
+    uint32_t mNumScriptProps = 0;
+    bool mDirect = false;
+};
+
+// Work resolved the first time a SceneNodeDef is instantiated so that later spawns can skip the searches.
+struct SceneNodePlan
+{
+    // Index in the parent's children of the natively created child that this def overrides, or -1 to create a new node.
+    // mNumParentChildren is the parent's child count when this def was reached. If a later spawn sees a different
+    // count, the parent created different native children that time, so the child is searched for by name again.
+    int32_t mExistingChildIndex = -1;
+    uint32_t mNumParentChildren = 0;
+    TypeId mNodeType = INVALID_TYPE_ID;
+
+    // The second pass runs after the script is assigned, which adds the script properties.
+    ScenePropertyPass mPropPass;
+    ScenePropertyPass mScriptPropPass;
+};
+
 class Scene : public Asset
 {
 public:
@@ -49,9 +94,16 @@ protected:
 
     void AddNodeDef(Node* node, Platform platform, std::vector<Node*>& nodeList);
     int32_t FindNodeIndex(Node* node, const std::vector<Node*>& nodeList);
+    bool IsInstantiationPlanValid() const;
 
     std::vector<SceneNodeDef> mNodeDefs;
 
+    // Parallel to mNodeDefs. Plans can depend on other scenes (nested scenes create children that
+    // defs may override), so capturing or loading any scene invalidates every scene's plan.
+    std::vector<SceneNodePlan> mNodePlans;
+    uint32_t mPlanGeneration = 0;
+    static std::atomic<uint32_t> sPlanGeneration;
+
     // World render properties (used when this scene is the world root).
     bool mSetAmbientLightColor = false;
     bool mSetShadowColor = false;
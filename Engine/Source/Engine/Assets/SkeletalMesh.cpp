@@ -4,6 +4,8 @@
 #include "AssetManager.h"
 #include "Log.h"
 #include "Maths.h"
+#include "AnimCompression.h"
+#include "MeshBlocks.h"
 
 #include "Graphics/Graphics.h"
 
@@ -18,6 +20,41 @@ using namespace std;
 FORCE_LINK_DEF(SkeletalMesh);
 DEFINE_ASSET(SkeletalMesh);
 
+void Animation::AddChannel(
+    int32_t boneIndex,
+    const std::vector<PositionKey>& positionKeys,
+    const std::vector<RotationKey>& rotationKeys,
+    const std::vector<ScaleKey>& scaleKeys)
+{
+    mChannels.push_back(Channel());
+    Channel& channel = mChannels.back();
+    channel.mBoneIndex = boneIndex;
+
+    channel.mPositionStart = uint32_t(mPositionTimes.size());
+    channel.mNumPositionKeys = uint32_t(positionKeys.size());
+    for (uint32_t i = 0; i < positionKeys.size(); ++i)
+    {
+        mPositionTimes.push_back(positionKeys[i].mTime);
+        mPositionValues.push_back(positionKeys[i].mValue);
+    }
+
+    channel.mRotationStart = uint32_t(mRotationTimes.size());
+    channel.mNumRotationKeys = uint32_t(rotationKeys.size());
+    for (uint32_t i = 0; i < rotationKeys.size(); ++i)
+    {
+        mRotationTimes.push_back(rotationKeys[i].mTime);
+        mRotationValues.push_back(rotationKeys[i].mValue);
+    }
+
+    channel.mScaleStart = uint32_t(mScaleTimes.size());
+    channel.mNumScaleKeys = uint32_t(scaleKeys.size());
+    for (uint32_t i = 0; i < scaleKeys.size(); ++i)
+    {
+        mScaleTimes.push_back(scaleKeys[i].mTime);
+        mScaleValues.push_back(scaleKeys[i].mValue);
+    }
+}
+
 SkeletalMesh::SkeletalMesh() :
     mMaterial(nullptr),
     mNumVertices(0),
@@ -47,6 +84,41 @@ void SkeletalMesh::SetMaterial(class Material* newMaterial)
     mMaterial = newMaterial;
 }
 
+static void ReadCompressedTrack(Stream& stream, Animation& animation, CompressedTrack& track, bool hasRange)
+{
+    track.mOffset = uint32_t(animation.mCompressedKeys.size());
+    track.mNumKeys = stream.ReadUint32();
+
+    if (hasRange)
+    {
+        track.mMin = stream.ReadVec3();
+        track.mExtent = stream.ReadVec3();
+    }
+
+    for (uint32_t i = 0; i < track.mNumKeys * 3; ++i)
+    {
+        animation.mCompressedKeys.push_back(stream.ReadUint16());
+    }
+}
+
+#if EDITOR
+static void WriteCompressedTrack(Stream& stream, const Animation& animation, const CompressedTrack& track, bool hasRange)
+{
+    stream.WriteUint32(track.mNumKeys);
+
+    if (hasRange)
+    {
+        stream.WriteVec3(track.mMin);
+        stream.WriteVec3(track.mExtent);
+    }
+
+    for (uint32_t i = track.mOffset; i < track.mOffset + track.mNumKeys * 3; ++i)
+    {
+        stream.WriteUint16(animation.mCompressedKeys[i]);
+    }
+}
+#endif
+
 void SkeletalMesh::LoadStream(Stream& stream, Platform platform)
 {
     Asset::LoadStream(stream, platform);
@@ -86,6 +158,7 @@ void SkeletalMesh::LoadStream(Stream& stream, Platform platform)
         stream.ReadString(animation.mName);
         animation.mDuration = stream.ReadFloat();
         animation.mTicksPerSecond = stream.ReadFloat();
+        animation.mCompressed = (mVersion >= ASSET_VERSION_ANIM_COMPRESSION) ? stream.ReadBool() : false;
         uint32_t numChannels = stream.ReadUint32();
         animation.mChannels.resize(numChannels);
 
@@ -94,28 +167,53 @@ void SkeletalMesh::LoadStream(Stream& stream, Platform platform)
             Channel& channel = animation.mChannels[chanIndex];
             channel.mBoneIndex = stream.ReadInt32();
 
-            uint32_t numPositionKeys = stream.ReadUint32();
-            channel.mPositionKeys.resize(numPositionKeys);
-            for (uint32_t i = 0; i < numPositionKeys; ++i)
+            // Compressed animations keep the raw keys of any track that didn't compress well.
+            if (animation.mCompressed)
             {
-                channel.mPositionKeys[i].mTime = stream.ReadFloat();
-                channel.mPositionKeys[i].mValue = stream.ReadVec3();
+                ReadCompressedTrack(stream, animation, channel.mPositionTrack, true);
             }
 
-            uint32_t numRotationKeys = stream.ReadUint32();
-            channel.mRotationKeys.resize(numRotationKeys);
-            for (uint32_t i = 0; i < numRotationKeys; ++i)
+            if (!animation.mCompressed || channel.mPositionTrack.mNumKeys == 0)
             {
-                channel.mRotationKeys[i].mTime = stream.ReadFloat();
-                channel.mRotationKeys[i].mValue = stream.ReadQuat();
+                channel.mNumPositionKeys = stream.ReadUint32();
+                channel.mPositionStart = uint32_t(animation.mPositionTimes.size());
+                for (uint32_t i = 0; i < channel.mNumPositionKeys; ++i)
+                {
+                    animation.mPositionTimes.push_back(stream.ReadFloat());
+                    animation.mPositionValues.push_back(stream.ReadVec3());
+                }
             }
 
-            uint32_t numScaleKeys = stream.ReadUint32();
-            channel.mScaleKeys.resize(numScaleKeys);
-            for (uint32_t i = 0; i < numScaleKeys; ++i)
+            if (animation.mCompressed)
             {
-                channel.mScaleKeys[i].mTime = stream.ReadFloat();
-                channel.mScaleKeys[i].mValue = stream.ReadVec3();
+                ReadCompressedTrack(stream, animation, channel.mRotationTrack, false);
+            }
+
+            if (!animation.mCompressed || channel.mRotationTrack.mNumKeys == 0)
+            {
+                channel.mNumRotationKeys = stream.ReadUint32();
+                channel.mRotationStart = uint32_t(animation.mRotationTimes.size());
+                for (uint32_t i = 0; i < channel.mNumRotationKeys; ++i)
+                {
+                    animation.mRotationTimes.push_back(stream.ReadFloat());
+                    animation.mRotationValues.push_back(stream.ReadQuat());
+                }
+            }
+
+            if (animation.mCompressed)
+            {
+                ReadCompressedTrack(stream, animation, channel.mScaleTrack, true);
+            }
+
+            if (!animation.mCompressed || channel.mScaleTrack.mNumKeys == 0)
+            {
+                channel.mNumScaleKeys = stream.ReadUint32();
+                channel.mScaleStart = uint32_t(animation.mScaleTimes.size());
+                for (uint32_t i = 0; i < channel.mNumScaleKeys; ++i)
+                {
+                    animation.mScaleTimes.push_back(stream.ReadFloat());
+                    animation.mScaleValues.push_back(stream.ReadVec3());
+                }
             }
         }
 
@@ -140,31 +238,48 @@ void SkeletalMesh::LoadStream(Stream& stream, Platform platform)
     }
 
     mVertices.resize(mNumVertices);
-    for (uint32_t i = 0; i < mNumVertices; ++i)
+    mIndices.resize(mNumIndices);
+
+    if (mVersion >= ASSET_VERSION_MESH_BLOCKS)
     {
-        mVertices[i].mPosition = stream.ReadVec3();
-        mVertices[i].mTexcoord0 = stream.ReadVec2();
-        mVertices[i].mTexcoord1 = { 0.0f, 0.0f };// stream.ReadVec2();
-        mVertices[i].mNormal = stream.ReadVec3();
-        mVertices[i].mBoneIndices[0] = stream.ReadUint8();
-        mVertices[i].mBoneIndices[1] = stream.ReadUint8();
-        mVertices[i].mBoneIndices[2] = stream.ReadUint8();
-        mVertices[i].mBoneIndices[3] = stream.ReadUint8();
-        mVertices[i].mBoneWeights[0] = stream.ReadFloat();
-        mVertices[i].mBoneWeights[1] = stream.ReadFloat();
-        mVertices[i].mBoneWeights[2] = stream.ReadFloat();
-        mVertices[i].mBoneWeights[3] = stream.ReadFloat();
+        ReadVertexBlock(stream, mVertices.data(), mNumVertices, VertexType::VertexSkinned);
+        ReadIndexBlock(stream, mIndices.data(), mNumIndices);
     }
-
-    mIndices.resize(mNumIndices);
-    for (uint32_t i = 0; i < mNumIndices; ++i)
+    else
     {
-        mIndices[i] = (IndexType) stream.ReadUint32();
+        for (uint32_t i = 0; i < mNumVertices; ++i)
+        {
+            mVertices[i].mPosition = stream.ReadVec3();
+            mVertices[i].mTexcoord0 = stream.ReadVec2();
+            mVertices[i].mTexcoord1 = { 0.0f, 0.0f };// stream.ReadVec2();
+            mVertices[i].mNormal = stream.ReadVec3();
+            mVertices[i].mBoneIndices[0] = stream.ReadUint8();
+            mVertices[i].mBoneIndices[1] = stream.ReadUint8();
+            mVertices[i].mBoneIndices[2] = stream.ReadUint8();
+            mVertices[i].mBoneIndices[3] = stream.ReadUint8();
+            mVertices[i].mBoneWeights[0] = stream.ReadFloat();
+            mVertices[i].mBoneWeights[1] = stream.ReadFloat();
+            mVertices[i].mBoneWeights[2] = stream.ReadFloat();
+            mVertices[i].mBoneWeights[3] = stream.ReadFloat();
+        }
+
+        for (uint32_t i = 0; i < mNumIndices; ++i)
+        {
+            mIndices[i] = (IndexType) stream.ReadUint32();
+        }
     }
 
     mBounds.mCenter = stream.ReadVec3();
     mBounds.mRadius = stream.ReadFloat();
     mBoundsScale = stream.ReadFloat();
+
+    if (mVersion >= ASSET_VERSION_ANIM_COMPRESSION)
+    {
+        mCompressAnimations = stream.ReadBool();
+        mPositionTolerance = stream.ReadFloat();
+        mRotationTolerance = stream.ReadFloat();
+        mScaleTolerance = stream.ReadFloat();
+    }
 }
 
 void SkeletalMesh::SaveStream(Stream& stream, Platform platform)
@@ -191,38 +306,90 @@ void SkeletalMesh::SaveStream(Stream& stream, Platform platform)
     stream.WriteUint32(uint32_t(mAnimations.size()));
     for (uint32_t animIndex = 0; animIndex < uint32_t(mAnimations.size()); ++animIndex)
     {
-        Animation& animation = mAnimations[animIndex];
+        // Compression is lossy, so only cooked assets get it. Project saves (Platform::Count)
+        // keep the full precision keys, otherwise every save and reload would lose more.
+        Animation compressedAnim;
+        const Animation* srcAnim = &mAnimations[animIndex];
+
+        if (mCompressAnimations &&
+            platform != Platform::Count &&
+            !srcAnim->mCompressed)
+        {
+            AnimCompressionTolerance tolerance;
+            tolerance.mPosition = mPositionTolerance;
+            tolerance.mRotation = glm::radians(mRotationTolerance);
+            tolerance.mScale = mScaleTolerance;
+
+            AnimCompressionStats stats;
+            CompressAnimation(*srcAnim, tolerance, compressedAnim, stats);
+            srcAnim = &compressedAnim;
+
+            LogDebug("Compressed animation %s: %u -> %u bytes, %u raw tracks, max error: pos %.5f, rot %.4f deg, scale %.5f",
+                srcAnim->mName.c_str(),
+                stats.mRawBytes,
+                stats.mCompressedBytes,
+                stats.mNumRawTracks,
+                stats.mMaxPositionError,
+                glm::degrees(stats.mMaxRotationError),
+                stats.mMaxScaleError);
+        }
+
+        const Animation& animation = *srcAnim;
         stream.WriteString(animation.mName);
         stream.WriteFloat(animation.mDuration);
         stream.WriteFloat(animation.mTicksPerSecond);
+        stream.WriteBool(animation.mCompressed);
         stream.WriteUint32(uint32_t(animation.mChannels.size()));
 
         uint32_t numChannels = uint32_t(animation.mChannels.size());
         for (uint32_t chanIndex = 0; chanIndex < numChannels; ++chanIndex)
         {
-            Channel& channel = animation.mChannels[chanIndex];
+            const Channel& channel = animation.mChannels[chanIndex];
             stream.WriteInt32(channel.mBoneIndex);
 
+            if (animation.mCompressed)
+            {
+                WriteCompressedTrack(stream, animation, channel.mPositionTrack, true);
+            }
 
-            stream.WriteUint32((uint32_t)channel.mPositionKeys.size());
-            for (uint32_t i = 0; i < uint32_t(channel.mPositionKeys.size()); ++i)
+            if (!animation.mCompressed || channel.mPositionTrack.mNumKeys == 0)
             {
-                stream.WriteFloat(channel.mPositionKeys[i].mTime);
-                stream.WriteVec3(channel.mPositionKeys[i].mValue);
+                stream.WriteUint32(channel.mNumPositionKeys);
+                for (uint32_t i = channel.mPositionStart; i < channel.mPositionStart + channel.mNumPositionKeys; ++i)
+                {
+                    stream.WriteFloat(animation.mPositionTimes[i]);
+                    stream.WriteVec3(animation.mPositionValues[i]);
+                }
             }
 
-            stream.WriteUint32((uint32_t)channel.mRotationKeys.size());
-            for (uint32_t i = 0; i < uint32_t(channel.mRotationKeys.size()); ++i)
+            if (animation.mCompressed)
             {
-                stream.WriteFloat(channel.mRotationKeys[i].mTime);
-                stream.WriteQuat(channel.mRotationKeys[i].mValue);
+                WriteCompressedTrack(stream, animation, channel.mRotationTrack, false);
             }
 
-            stream.WriteUint32((uint32_t)channel.mScaleKeys.size());
-            for (uint32_t i = 0; i < uint32_t(channel.mScaleKeys.size()); ++i)
+            if (!animation.mCompressed || channel.mRotationTrack.mNumKeys == 0)
             {
-                stream.WriteFloat(channel.mScaleKeys[i].mTime);
-                stream.WriteVec3(channel.mScaleKeys[i].mValue);
+                stream.WriteUint32(channel.mNumRotationKeys);
+                for (uint32_t i = channel.mRotationStart; i < channel.mRotationStart + channel.mNumRotationKeys; ++i)
+                {
+                    stream.WriteFloat(animation.mRotationTimes[i]);
+                    stream.WriteQuat(animation.mRotationValues[i]);
+                }
+            }
+
+            if (animation.mCompressed)
+            {
+                WriteCompressedTrack(stream, animation, channel.mScaleTrack, true);
+            }
+
+            if (!animation.mCompressed || channel.mScaleTrack.mNumKeys == 0)
+            {
+                stream.WriteUint32(channel.mNumScaleKeys);
+                for (uint32_t i = channel.mScaleStart; i < channel.mScaleStart + channel.mNumScaleKeys; ++i)
+                {
+                    stream.WriteFloat(animation.mScaleTimes[i]);
+                    stream.WriteVec3(animation.mScaleValues[i]);
+                }
             }
         }
 
@@ -231,7 +398,7 @@ void SkeletalMesh::SaveStream(Stream& stream, Platform platform)
 
         for (uint32_t i = 0; i < numEventTracks; ++i)
         {
-            AnimEventTrack& track = animation.mEventTracks[i];
+            const AnimEventTrack& track = animation.mEventTracks[i];
             stream.WriteString(track.mName);
 
             uint32_t numEventKeys = (uint32_t)track.mEventKeys.size();
@@ -239,7 +406,7 @@ void SkeletalMesh::SaveStream(Stream& stream, Platform platform)
 
             for (uint32_t k = 0; k < numEventKeys; ++k)
             {
-                AnimEventKey& key = track.mEventKeys[k];
+                const AnimEventKey& key = track.mEventKeys[k];
                 stream.WriteFloat(key.mTime);
                 stream.WriteVec3(key.mValue);
             }
@@ -247,31 +414,17 @@ void SkeletalMesh::SaveStream(Stream& stream, Platform platform)
     }
 
     OCT_ASSERT(mNumVertices == mVertices.size());
-    for (uint32_t i = 0; i < mNumVertices; ++i)
-    {
-        stream.WriteVec3(mVertices[i].mPosition);
-        stream.WriteVec2(mVertices[i].mTexcoord0);
-        //stream.WriteVec2(mVertices[i].mTexcoord1);
-        stream.WriteVec3(mVertices[i].mNormal);
-        stream.WriteUint8(mVertices[i].mBoneIndices[0]);
-        stream.WriteUint8(mVertices[i].mBoneIndices[1]);
-        stream.WriteUint8(mVertices[i].mBoneIndices[2]);
-        stream.WriteUint8(mVertices[i].mBoneIndices[3]);
-        stream.WriteFloat(mVertices[i].mBoneWeights[0]);
-        stream.WriteFloat(mVertices[i].mBoneWeights[1]);
-        stream.WriteFloat(mVertices[i].mBoneWeights[2]);
-        stream.WriteFloat(mVertices[i].mBoneWeights[3]);
-    }
-
     OCT_ASSERT(mNumIndices == mIndices.size());
-    for (uint32_t i = 0; i < mNumIndices; ++i)
-    {
-        stream.WriteUint32(mIndices[i]);
-    }
+    WriteVertexBlock(stream, mVertices.data(), mNumVertices, VertexType::VertexSkinned, platform);
+    WriteIndexBlock(stream, mIndices.data(), mNumIndices, platform);
 
     stream.WriteVec3(mBounds.mCenter);
     stream.WriteFloat(mBounds.mRadius);
     stream.WriteFloat(mBoundsScale);
+    stream.WriteBool(mCompressAnimations);
+    stream.WriteFloat(mPositionTolerance);
+    stream.WriteFloat(mRotationTolerance);
+    stream.WriteFloat(mScaleTolerance);
 #endif
 }
 
@@ -336,6 +489,10 @@ void SkeletalMesh::GatherProperties(std::vector<Property>& outProps)
     outProps.push_back(Property(DatumType::Asset, "Material", this, &mMaterial, 1, nullptr, int32_t(Material::GetStaticType())));
     outProps.push_back(Property(DatumType::Asset, "Animation Lookup", this, &mAnimationLookupMesh, 1, nullptr, int32_t(SkeletalMesh::GetStaticType())));
     outProps.push_back(Property(DatumType::Float, "Bounds Scale", this, &mBoundsScale));
+    outProps.push_back(Property(DatumType::Bool, "Compress Animations", this, &mCompressAnimations));
+    outProps.push_back(Property(DatumType::Float, "Position Tolerance", this, &mPositionTolerance));
+    outProps.push_back(Property(DatumType::Float, "Rotation Tolerance", this, &mRotationTolerance));
+    outProps.push_back(Property(DatumType::Float, "Scale Tolerance", this, &mScaleTolerance));
 
     // TODO: Do we want default animations?
     //outProps.push_back(Property(DatumType::String, "Default Animation", this, &mDefaultAnimation));
@@ -420,21 +577,54 @@ const std::vector<Animation>& SkeletalMesh::GetAnimations() const
 
 const Animation* SkeletalMesh::GetAnimation(const char* name)
 {
-    const Animation* retAnim = nullptr;
+    return GetAnimation(FindAnimationIndex(name));
+}
 
-    for (uint32_t i = 0; i < mAnimations.size(); ++i)
+int32_t SkeletalMesh::FindAnimationIndex(const char* name)
+{
+    int32_t index = -1;
+
+    // The lookup mesh overrides this mesh's animations.
+    if (mAnimationLookupMesh != nullptr)
     {
-        if (mAnimations[i].mName == name)
+        SkeletalMesh* animLookup = mAnimationLookupMesh.Get<SkeletalMesh>();
+        int32_t lookupIndex = animLookup->FindAnimationIndex(name);
+
+        if (lookupIndex != -1)
         {
-            retAnim = &mAnimations[i];
-            break;
+            index = int32_t(mAnimations.size()) + lookupIndex;
+        }
+    }
+    else
+    {
+        for (uint32_t i = 0; i < mAnimations.size(); ++i)
+        {
+            if (mAnimations[i].mName == name)
+            {
+                index = int32_t(i);
+                break;
+            }
         }
     }
 
-    if (mAnimationLookupMesh != nullptr)
+    return index;
+}
+
+const Animation* SkeletalMesh::GetAnimation(int32_t index)
+{
+    const Animation* retAnim = nullptr;
+
+    if (index >= 0)
     {
-        SkeletalMesh* animLookup = mAnimationLookupMesh.Get<SkeletalMesh>();
-        retAnim = animLookup->GetAnimation(name);
+        if (index < int32_t(mAnimations.size()))
+        {
+            retAnim = &mAnimations[index];
+        }
+        else if (mAnimationLookupMesh != nullptr)
+        {
+            SkeletalMesh* animLookup = mAnimationLookupMesh.Get<SkeletalMesh>();
+            retAnim = animLookup->GetAnimation(index - int32_t(mAnimations.size()));
+        }
     }
 
     return retAnim;
@@ -821,45 +1011,42 @@ void SkeletalMesh::SetupAnimations(const aiScene& scene)
             else if (boneIndex != -1)
             {
                 // Normal non-event bone that deforms the mesh.
-                dstAnim.mChannels.push_back(Channel());
-                Channel& dstChannel = dstAnim.mChannels.back();
-                dstChannel.mBoneIndex = boneIndex;
-                dstChannel.mPositionKeys.resize(srcChannel->mNumPositionKeys);
-                dstChannel.mRotationKeys.resize(srcChannel->mNumRotationKeys);
-                dstChannel.mScaleKeys.resize(srcChannel->mNumScalingKeys);
+                std::vector<PositionKey> positionKeys(srcChannel->mNumPositionKeys);
+                std::vector<RotationKey> rotationKeys(srcChannel->mNumRotationKeys);
+                std::vector<ScaleKey> scaleKeys(srcChannel->mNumScalingKeys);
 
                 // Copy position keys
                 for (uint32_t i = 0; i < srcChannel->mNumPositionKeys; ++i)
                 {
-                    dstChannel.mPositionKeys[i].mTime = (float)srcChannel->mPositionKeys[i].mTime;
-                    dstChannel.mPositionKeys[i].mValue.x = (float)srcChannel->mPositionKeys[i].mValue.x;
-                    dstChannel.mPositionKeys[i].mValue.y = (float)srcChannel->mPositionKeys[i].mValue.y;
-                    dstChannel.mPositionKeys[i].mValue.z = (float)srcChannel->mPositionKeys[i].mValue.z;
+                    positionKeys[i].mTime = (float)srcChannel->mPositionKeys[i].mTime;
+                    positionKeys[i].mValue.x = (float)srcChannel->mPositionKeys[i].mValue.x;
+                    positionKeys[i].mValue.y = (float)srcChannel->mPositionKeys[i].mValue.y;
+                    positionKeys[i].mValue.z = (float)srcChannel->mPositionKeys[i].mValue.z;
                 }
 
                 // Copy rotation keys
                 for (uint32_t i = 0; i < srcChannel->mNumRotationKeys; ++i)
                 {
-                    dstChannel.mRotationKeys[i].mTime = (float)srcChannel->mRotationKeys[i].mTime;
-                    dstChannel.mRotationKeys[i].mValue.x = (float)srcChannel->mRotationKeys[i].mValue.x;
-                    dstChannel.mRotationKeys[i].mValue.y = (float)srcChannel->mRotationKeys[i].mValue.y;
-                    dstChannel.mRotationKeys[i].mValue.z = (float)srcChannel->mRotationKeys[i].mValue.z;
-                    dstChannel.mRotationKeys[i].mValue.w = (float)srcChannel->mRotationKeys[i].mValue.w;
+                    rotationKeys[i].mTime = (float)srcChannel->mRotationKeys[i].mTime;
+                    rotationKeys[i].mValue.x = (float)srcChannel->mRotationKeys[i].mValue.x;
+                    rotationKeys[i].mValue.y = (float)srcChannel->mRotationKeys[i].mValue.y;
+                    rotationKeys[i].mValue.z = (float)srcChannel->mRotationKeys[i].mValue.z;
+                    rotationKeys[i].mValue.w = (float)srcChannel->mRotationKeys[i].mValue.w;
                 }
 
                 // Copy scale keys
                 for (uint32_t i = 0; i < srcChannel->mNumScalingKeys; ++i)
                 {
-                    dstChannel.mScaleKeys[i].mTime = (float)srcChannel->mScalingKeys[i].mTime;
-                    dstChannel.mScaleKeys[i].mValue.x = (float)srcChannel->mScalingKeys[i].mValue.x;
-                    dstChannel.mScaleKeys[i].mValue.y = (float)srcChannel->mScalingKeys[i].mValue.y;
-                    dstChannel.mScaleKeys[i].mValue.z = (float)srcChannel->mScalingKeys[i].mValue.z;
+                    scaleKeys[i].mTime = (float)srcChannel->mScalingKeys[i].mTime;
+                    scaleKeys[i].mValue.x = (float)srcChannel->mScalingKeys[i].mValue.x;
+                    scaleKeys[i].mValue.y = (float)srcChannel->mScalingKeys[i].mValue.y;
+                    scaleKeys[i].mValue.z = (float)srcChannel->mScalingKeys[i].mValue.z;
                 }
 
                 // Cut out unnecessary keyframes.
                 // Remove keyframes that don't change transform.
                 {
-                    std::vector<PositionKey>& keys = dstChannel.mPositionKeys;
+                    std::vector<PositionKey>& keys = positionKeys;
                     int32_t keyCount = (int32_t)keys.size();
                     for (int32_t i = keyCount - 2; i > 0; --i)
                     {
@@ -872,7 +1059,7 @@ void SkeletalMesh::SetupAnimations(const aiScene& scene)
                 }
 
                 {
-                    std::vector<RotationKey>& keys = dstChannel.mRotationKeys;
+                    std::vector<RotationKey>& keys = rotationKeys;
                     int32_t keyCount = (int32_t)keys.size();
                     for (int32_t i = keyCount - 2; i > 0; --i)
                     {
@@ -885,7 +1072,7 @@ void SkeletalMesh::SetupAnimations(const aiScene& scene)
                 }
 
                 {
-                    std::vector<ScaleKey>& keys = dstChannel.mScaleKeys;
+                    std::vector<ScaleKey>& keys = scaleKeys;
                     int32_t keyCount = (int32_t)keys.size();
                     for (int32_t i = keyCount - 2; i > 0; --i)
                     {
@@ -896,6 +1083,8 @@ void SkeletalMesh::SetupAnimations(const aiScene& scene)
                         }
                     }
                 }
+
+                dstAnim.AddChannel(boneIndex, positionKeys, rotationKeys, scaleKeys);
             }
             else
             {
@@ -65,12 +65,34 @@ struct AnimEvent
     glm::vec3 mValue = {};
 };
 
+// Keys are spread evenly over the animation's duration, so sampling is a direct index instead of a search.
+// Values are quantized to 16 bits per component (smallest three for rotations).
+// A track with no keys uses the channel's raw key range instead, which is always the case in uncompressed
+// animations and happens in compressed ones for tracks that didn't compress well.
+struct CompressedTrack
+{
+    uint32_t mOffset = 0; // First key in Animation::mCompressedKeys
+    uint32_t mNumKeys = 0; // 1 for constant tracks, 0 for raw tracks
+    glm::vec3 mMin = {}; // Quantization range, positions and scales only
+    glm::vec3 mExtent = {};
+};
+
 struct Channel
 {
     int32_t mBoneIndex = -1;
-    std::vector<PositionKey> mPositionKeys;
-    std::vector<RotationKey> mRotationKeys;
-    std::vector<ScaleKey> mScaleKeys;
+
+    // Key ranges within the owning Animation's key arrays.
+    uint32_t mPositionStart = 0;
+    uint32_t mNumPositionKeys = 0;
+    uint32_t mRotationStart = 0;
+    uint32_t mNumRotationKeys = 0;
+    uint32_t mScaleStart = 0;
+    uint32_t mNumScaleKeys = 0;
+
+    // Used instead of the key ranges when the animation is compressed.
+    CompressedTrack mPositionTrack;
+    CompressedTrack mRotationTrack;
+    CompressedTrack mScaleTrack;
 };
 
 struct Animation
@@ -80,6 +102,25 @@ struct Animation
     float mTicksPerSecond = 0.0f;
     std::vector<Channel> mChannels;
     std::vector<AnimEventTrack> mEventTracks;
+
+    // Keys for every channel, packed contiguously with times split from values
+    // so that key searches only walk the time arrays.
+    std::vector<float> mPositionTimes;
+    std::vector<glm::vec3> mPositionValues;
+    std::vector<float> mRotationTimes;
+    std::vector<glm::quat> mRotationValues;
+    std::vector<float> mScaleTimes;
+    std::vector<glm::vec3> mScaleValues;
+
+    // Compressed animations keep most of their keys here. The key arrays above only hold raw tracks.
+    bool mCompressed = false;
+    std::vector<uint16_t> mCompressedKeys;
+
+    void AddChannel(
+        int32_t boneIndex,
+        const std::vector<PositionKey>& positionKeys,
+        const std::vector<RotationKey>& rotationKeys,
+        const std::vector<ScaleKey>& scaleKeys);
 };
 
 class SkeletalMesh : public Asset
@@ -123,6 +164,10 @@ public:
     const std::vector<Animation>& GetAnimations() const;
     const Animation* GetAnimation(const char* name);
 
+    // Indices include the animation lookup mesh's animations, which are numbered after this mesh's own.
+    int32_t FindAnimationIndex(const char* name);
+    const Animation* GetAnimation(int32_t index);
+
     // Get length of animation in seconds
     float GetAnimationDuration(const char* name);
 
@@ -161,6 +206,12 @@ private:
     Bounds mBounds;
     float mBoundsScale = 1.1f;
 
+    // Animations are only compressed when cooking, project saves keep the raw keys.
+    bool mCompressAnimations = true;
+    float mPositionTolerance = 0.001f;
+    float mRotationTolerance = 0.05f; // Degrees
+    float mScaleTolerance = 0.001f;
+
     // Graphics Resource
     SkeletalMeshResource mResource;
 
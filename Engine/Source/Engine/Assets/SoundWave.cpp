@@ -392,6 +392,12 @@ const char* SoundWave::GetTypeImportExt()
     return ".wav";
 }
 
+AssetCompression SoundWave::GetDefaultCompression() const
+{
+    // Uncompressed PCM is large and rarely loaded, so spend the extra time for the best ratio.
+    return AssetCompression::Max;
+}
+
 void SoundWave::SetPitchMultiplier(float pitch)
 {
     mPitchMultiplier = pitch;
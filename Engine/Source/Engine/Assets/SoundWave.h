@@ -20,6 +20,7 @@ public:
     virtual glm::vec4 GetTypeColor() override;
     virtual const char* GetTypeName() override;
     virtual const char* GetTypeImportExt() override;
+    virtual AssetCompression GetDefaultCompression() const override;
 
     void SetPcmData(uint8_t* data, uint32_t size, uint32_t numSamples, uint32_t bitsPerSample, uint32_t numChannels, uint32_t sampleRate);
 
@@ -4,6 +4,8 @@
 #include "AssetManager.h"
 #include "Utilities.h"
 #include "Log.h"
+#include "MeshBlocks.h"
+#include "CookedCollision.h"
 
 #include "Graphics/Graphics.h"
 
@@ -49,7 +51,10 @@ StaticMesh::StaticMesh() :
     mTriangleCollisionShape(nullptr),
     mTriangleIndexVertexArray(nullptr),
     mTriangleInfoMap(nullptr),
+    mTriangleBvh(nullptr),
+    mTriangleCollisionHash(0),
     mGenerateTriangleCollisionMesh(false),
+    mCookTriangleCollision(true),
     mHasVertexColor(false)
 {
     mType = StaticMesh::GetStaticType();
@@ -69,6 +74,7 @@ void StaticMesh::CreateRaw(
     mNumVertices = numVertices;
     mNumIndices = numIndices;
     mHasVertexColor = false;
+    DestroyTriangleCollisionShape();
     ResizeVertexArray(numVertices);
     ResizeIndexArray(numIndices);
 
@@ -112,35 +118,43 @@ void StaticMesh::LoadStream(Stream& stream, Platform platform)
     mHasVertexColor = stream.ReadBool();
 
     ResizeVertexArray(mNumVertices);
+    ResizeIndexArray(mNumIndices);
 
-    if (mHasVertexColor)
+    if (mVersion >= ASSET_VERSION_MESH_BLOCKS)
     {
-        VertexColor* vertices = GetColorVertices();
-        for (uint32_t i = 0; i < mNumVertices; ++i)
-        {
-            vertices[i].mPosition = stream.ReadVec3();
-            vertices[i].mTexcoord0 = stream.ReadVec2();
-            vertices[i].mTexcoord1 = stream.ReadVec2();
-            vertices[i].mNormal = stream.ReadVec3();
-            vertices[i].mColor = stream.ReadUint32();
-        }
+        ReadVertexBlock(stream, mVertices, mNumVertices, mHasVertexColor ? VertexType::VertexColor : VertexType::Vertex);
+        ReadIndexBlock(stream, mIndices, mNumIndices);
     }
     else
     {
-        Vertex* vertices = GetVertices();
-        for (uint32_t i = 0; i < mNumVertices; ++i)
+        if (mHasVertexColor)
+        {
+            VertexColor* vertices = GetColorVertices();
+            for (uint32_t i = 0; i < mNumVertices; ++i)
+            {
+                vertices[i].mPosition = stream.ReadVec3();
+                vertices[i].mTexcoord0 = stream.ReadVec2();
+                vertices[i].mTexcoord1 = stream.ReadVec2();
+                vertices[i].mNormal = stream.ReadVec3();
+                vertices[i].mColor = stream.ReadUint32();
+            }
+        }
+        else
         {
-            vertices[i].mPosition = stream.ReadVec3();
-            vertices[i].mTexcoord0 = stream.ReadVec2();
-            vertices[i].mTexcoord1 = stream.ReadVec2();
-            vertices[i].mNormal = stream.ReadVec3();
+            Vertex* vertices = GetVertices();
+            for (uint32_t i = 0; i < mNumVertices; ++i)
+            {
+                vertices[i].mPosition = stream.ReadVec3();
+                vertices[i].mTexcoord0 = stream.ReadVec2();
+                vertices[i].mTexcoord1 = stream.ReadVec2();
+                vertices[i].mNormal = stream.ReadVec3();
+            }
         }
-    }
 
-    ResizeIndexArray(mNumIndices);
-    for (uint32_t i = 0; i < mNumIndices; ++i)
-    {
-        mIndices[i] = (IndexType) stream.ReadUint32();
+        for (uint32_t i = 0; i < mNumIndices; ++i)
+        {
+            mIndices[i] = (IndexType) stream.ReadUint32();
+        }
     }
 
     // Collision shapes
@@ -217,6 +231,30 @@ void StaticMesh::LoadStream(Stream& stream, Platform platform)
 
     mBounds.mCenter = stream.ReadVec3();
     mBounds.mRadius = stream.ReadFloat();
+
+    if (mVersion >= ASSET_VERSION_COOKED_COLLISION)
+    {
+        mCookTriangleCollision = stream.ReadBool();
+
+        if (stream.ReadBool())
+        {
+            uint32_t hash = stream.ReadUint32();
+
+            DestroyTriangleCollisionShape();
+            mTriangleBvh = new CookedBvh();
+            mTriangleBvh->ReadStream(stream);
+            mTriangleInfoMap = new btTriangleInfoMap();
+            ReadTriangleInfoMap(stream, *mTriangleInfoMap);
+            mTriangleCollisionHash = hash;
+
+            if (hash != ComputeTriangleCollisionHash())
+            {
+                // Vertex data doesn't match what the collision was cooked from (e.g. indices that don't fit this platform's IndexType).
+                LogWarning("Discarding stale cooked collision for %s", mName.c_str());
+                DestroyTriangleCollisionShape();
+            }
+        }
+    }
 }
 
 void StaticMesh::SaveStream(Stream& stream, Platform platform)
@@ -232,34 +270,8 @@ void StaticMesh::SaveStream(Stream& stream, Platform platform)
     stream.WriteBool(mGenerateTriangleCollisionMesh);
     stream.WriteBool(mHasVertexColor);
 
-    if (mHasVertexColor)
-    {
-        VertexColor* vertices = GetColorVertices();
-        for (uint32_t i = 0; i < mNumVertices; ++i)
-        {
-            stream.WriteVec3(vertices[i].mPosition);
-            stream.WriteVec2(vertices[i].mTexcoord0);
-            stream.WriteVec2(vertices[i].mTexcoord1);
-            stream.WriteVec3(vertices[i].mNormal);
-            stream.WriteUint32(vertices[i].mColor);
-        }
-    }
-    else
-    {
-        Vertex* vertices = GetVertices();
-        for (uint32_t i = 0; i < mNumVertices; ++i)
-        {
-            stream.WriteVec3(vertices[i].mPosition);
-            stream.WriteVec2(vertices[i].mTexcoord0);
-            stream.WriteVec2(vertices[i].mTexcoord1);
-            stream.WriteVec3(vertices[i].mNormal);
-        }
-    }
-
-    for (uint32_t i = 0; i < mNumIndices; ++i)
-    {
-        stream.WriteUint32(mIndices[i]);
-    }
+    WriteVertexBlock(stream, mVertices, mNumVertices, mHasVertexColor ? VertexType::VertexColor : VertexType::Vertex, platform);
+    WriteIndexBlock(stream, mIndices, mNumIndices, platform);
 
     // Collision shapes
     uint32_t numCollisionShapes = 0;
@@ -355,6 +367,47 @@ void StaticMesh::SaveStream(Stream& stream, Platform platform)
 
     stream.WriteVec3(mBounds.mCenter);
     stream.WriteFloat(mBounds.mRadius);
+
+    // Bake the BVH and internal edge info so cooked meshes can skip building them at load time.
+    stream.WriteBool(mCookTriangleCollision);
+
+    bool cookCollision = mGenerateTriangleCollisionMesh && mCookTriangleCollision && mNumIndices > 0;
+    stream.WriteBool(cookCollision);
+
+    if (cookCollision)
+    {
+        uint32_t hash = ComputeTriangleCollisionHash();
+        stream.WriteUint32(hash);
+
+        if (mTriangleBvh != nullptr &&
+            mTriangleInfoMap != nullptr &&
+            mTriangleCollisionHash == hash)
+        {
+            mTriangleBvh->WriteStream(stream);
+            WriteTriangleInfoMap(stream, *mTriangleInfoMap);
+        }
+        else
+        {
+            // Missing or out of date with the vertices. Build a temporary copy rather than
+            // replacing the live shape, which physics bodies may still be referencing.
+            btTriangleIndexVertexArray* meshInterface = CreateTriangleMeshInterface();
+            btBvhTriangleMeshShape* shape = new btBvhTriangleMeshShape(meshInterface, true, false);
+            CookedBvh* bvh = new CookedBvh();
+            btTriangleInfoMap* infoMap = new btTriangleInfoMap();
+
+            bvh->Build(shape);
+            shape->setOptimizedBvh(bvh);
+            btGenerateInternalEdgeInfo(shape, infoMap);
+
+            bvh->WriteStream(stream);
+            WriteTriangleInfoMap(stream, *infoMap);
+
+            delete shape;
+            delete bvh;
+            delete infoMap;
+            delete meshInterface;
+        }
+    }
 #endif
 }
 
@@ -470,6 +523,7 @@ void StaticMesh::GatherProperties(std::vector<Property>& outProps)
     Asset::GatherProperties(outProps);
     outProps.push_back(Property(DatumType::Asset, "Material", this, &mMaterial, 1, nullptr, int32_t(Material::GetStaticType())));
     outProps.push_back(Property(DatumType::Bool, "Generate Triangle Collision Mesh", this, &mGenerateTriangleCollisionMesh, 1, HandlePropChange));
+    outProps.push_back(Property(DatumType::Bool, "Cook Triangle Collision", this, &mCookTriangleCollision));
 }
 
 glm::vec4 StaticMesh::GetTypeColor()
@@ -636,38 +690,54 @@ void StaticMesh::CreateTriangleCollisionShape()
     if (mTriangleIndexVertexArray == nullptr &&
         mTriangleCollisionShape == nullptr)
     {
-        mTriangleIndexVertexArray = new btTriangleIndexVertexArray();
+        mTriangleIndexVertexArray = CreateTriangleMeshInterface();
 
-        btIndexedMesh mesh;
-        mesh.m_numTriangles = mNumIndices / 3;
-        mesh.m_triangleIndexBase = (const unsigned char*)mIndices;
-        mesh.m_triangleIndexStride = sizeof(IndexType) * 3;
-        mesh.m_numVertices = mNumVertices;
-        mesh.m_vertexBase = (const unsigned char*)mVertices;
-        mesh.m_vertexStride = GetVertexSize();
+        // The BVH is owned by the mesh rather than the shape so that it can come from the cooked asset.
+        bool useQuantizedAabbCompression = true;
+        bool buildBvh = false;
+        mTriangleCollisionShape = new btBvhTriangleMeshShape(mTriangleIndexVertexArray, useQuantizedAabbCompression, buildBvh);
 
-        mTriangleIndexVertexArray->addIndexedMesh(mesh, sizeof(IndexType) == 2 ? PHY_SHORT : PHY_INTEGER);
+        if (mTriangleBvh != nullptr &&
+            mTriangleInfoMap != nullptr)
+        {
+            mTriangleCollisionShape->setOptimizedBvh(mTriangleBvh);
+            mTriangleCollisionShape->setTriangleInfoMap(mTriangleInfoMap);
+        }
+        else
+        {
+            delete mTriangleBvh;
+            delete mTriangleInfoMap;
 
-        bool useQuantizedAabbCompression = true;
+            mTriangleBvh = new CookedBvh();
+            mTriangleBvh->Build(mTriangleCollisionShape);
+            mTriangleCollisionShape->setOptimizedBvh(mTriangleBvh);
+
+            mTriangleInfoMap = new btTriangleInfoMap();
+            btGenerateInternalEdgeInfo(mTriangleCollisionShape, mTriangleInfoMap);
 
-        mTriangleCollisionShape = new btBvhTriangleMeshShape(mTriangleIndexVertexArray, useQuantizedAabbCompression);
-        mTriangleInfoMap = new btTriangleInfoMap();
-        btGenerateInternalEdgeInfo(mTriangleCollisionShape, mTriangleInfoMap);
+            mTriangleCollisionHash = ComputeTriangleCollisionHash();
+        }
     }
 }
 
 void StaticMesh::DestroyTriangleCollisionShape()
 {
+    if (mTriangleCollisionShape != nullptr)
+    {
+        delete mTriangleCollisionShape;
+        mTriangleCollisionShape = nullptr;
+    }
+
     if (mTriangleInfoMap != nullptr)
     {
         delete mTriangleInfoMap;
         mTriangleInfoMap = nullptr;
     }
 
-    if (mTriangleCollisionShape != nullptr)
+    if (mTriangleBvh != nullptr)
     {
-        delete mTriangleCollisionShape;
-        mTriangleCollisionShape = nullptr;
+        delete mTriangleBvh;
+        mTriangleBvh = nullptr;
     }
 
     if (mTriangleIndexVertexArray != nullptr)
@@ -677,6 +747,28 @@ void StaticMesh::DestroyTriangleCollisionShape()
     }
 }
 
+btTriangleIndexVertexArray* StaticMesh::CreateTriangleMeshInterface()
+{
+    btTriangleIndexVertexArray* meshInterface = new btTriangleIndexVertexArray();
+
+    btIndexedMesh mesh;
+    mesh.m_numTriangles = mNumIndices / 3;
+    mesh.m_triangleIndexBase = (const unsigned char*)mIndices;
+    mesh.m_triangleIndexStride = sizeof(IndexType) * 3;
+    mesh.m_numVertices = mNumVertices;
+    mesh.m_vertexBase = (const unsigned char*)mVertices;
+    mesh.m_vertexStride = GetVertexSize();
+
+    meshInterface->addIndexedMesh(mesh, sizeof(IndexType) == 2 ? PHY_SHORT : PHY_INTEGER);
+
+    return meshInterface;
+}
+
+uint32_t StaticMesh::ComputeTriangleCollisionHash() const
+{
+    return HashTriangleData(mVertices, mNumVertices, GetVertexSize(), mIndices, mNumIndices);
+}
+
 void StaticMesh::ResizeVertexArray(uint32_t newSize)
 {
     if (mVertices != nullptr)
@@ -14,6 +14,8 @@
 #include <assimp/scene.h>
 #endif
 
+class CookedBvh;
+
 class StaticMesh : public Asset
 {
 public:
@@ -73,6 +75,8 @@ private:
 
     void CreateTriangleCollisionShape();
     void DestroyTriangleCollisionShape();
+    btTriangleIndexVertexArray* CreateTriangleMeshInterface();
+    uint32_t ComputeTriangleCollisionHash() const;
 
     void ResizeVertexArray(uint32_t newSize);
     void ResizeIndexArray(uint32_t newSize);
@@ -93,7 +97,10 @@ private:
     btBvhTriangleMeshShape* mTriangleCollisionShape;
     btTriangleIndexVertexArray* mTriangleIndexVertexArray;
     btTriangleInfoMap* mTriangleInfoMap;
+    CookedBvh* mTriangleBvh;
+    uint32_t mTriangleCollisionHash;
     bool mGenerateTriangleCollisionMesh;
+    bool mCookTriangleCollision;
     bool mHasVertexColor;
 
     // Graphics Resource
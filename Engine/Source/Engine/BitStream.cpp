@@ -0,0 +1,308 @@
+#include "BitStream.h"
+#include "Assertion.h"
+
+#include <string.h>
+
+// Smallest three components are always within +/- 1/sqrt(2)
+static const float kQuatComponentRange = 0.70710678f;
+
+BitStream::BitStream()
+{
+
+}
+
+BitStream::BitStream(const char* externalData, uint32_t externalSize)
+{
+    mExternalData = (const uint8_t*)externalData;
+    mNumBits = externalSize * 8;
+}
+
+void BitStream::Reset()
+{
+    mBuffer.clear();
+    mExternalData = nullptr;
+    mNumBits = 0;
+    mBitPos = 0;
+    mOverflow = false;
+}
+
+const uint8_t* BitStream::GetData() const
+{
+    return mExternalData ? mExternalData : mBuffer.data();
+}
+
+uint32_t BitStream::GetNumBits() const
+{
+    return mNumBits;
+}
+
+uint32_t BitStream::GetNumBytes() const
+{
+    return (mNumBits + 7) / 8;
+}
+
+uint32_t BitStream::GetBitPos() const
+{
+    return mBitPos;
+}
+
+bool BitStream::IsOverflowed() const
+{
+    return mOverflow;
+}
+
+void BitStream::WriteBits(uint32_t value, uint32_t numBits)
+{
+    OCT_ASSERT(mExternalData == nullptr);
+    OCT_ASSERT(numBits <= 32);
+
+    if (numBits < 32)
+    {
+        value &= (1u << numBits) - 1;
+    }
+
+    mBuffer.resize((mNumBits + numBits + 7) / 8, 0);
+
+    while (numBits > 0)
+    {
+        uint32_t byteIndex = mNumBits / 8;
+        uint32_t bitOffset = mNumBits % 8;
+        uint32_t count = glm::min(numBits, 8 - bitOffset);
+
+        mBuffer[byteIndex] |= uint8_t((value & ((1u << count) - 1)) << bitOffset);
+
+        value >>= count;
+        numBits -= count;
+        mNumBits += count;
+    }
+}
+
+uint32_t BitStream::ReadBits(uint32_t numBits)
+{
+    OCT_ASSERT(numBits <= 32);
+
+    if (numBits > mNumBits - mBitPos)
+    {
+        mOverflow = true;
+        mBitPos = mNumBits;
+        return 0;
+    }
+
+    const uint8_t* data = GetData();
+    uint32_t value = 0;
+    uint32_t shift = 0;
+
+    while (numBits > 0)
+    {
+        uint32_t byteIndex = mBitPos / 8;
+        uint32_t bitOffset = mBitPos % 8;
+        uint32_t count = glm::min(numBits, 8 - bitOffset);
+
+        uint32_t bits = (data[byteIndex] >> bitOffset) & ((1u << count) - 1);
+        value |= bits << shift;
+
+        shift += count;
+        numBits -= count;
+        mBitPos += count;
+    }
+
+    return value;
+}
+
+void BitStream::WriteBool(bool value)
+{
+    WriteBits(value ? 1 : 0, 1);
+}
+
+bool BitStream::ReadBool()
+{
+    return ReadBits(1) != 0;
+}
+
+void BitStream::WriteVarUint(uint32_t value)
+{
+    do
+    {
+        uint32_t group = value & 0x7f;
+        value >>= 7;
+        WriteBits(group, 7);
+        WriteBool(value != 0);
+    } while (value != 0);
+}
+
+uint32_t BitStream::ReadVarUint()
+{
+    uint32_t value = 0;
+
+    for (uint32_t shift = 0; shift < 32; shift += 7)
+    {
+        value |= ReadBits(7) << shift;
+
+        if (!ReadBool())
+            break;
+    }
+
+    return value;
+}
+
+void BitStream::WriteRangedInt(int32_t value, int32_t min, int32_t max)
+{
+    OCT_ASSERT(max >= min);
+    value = glm::clamp(value, min, max);
+    WriteBits(uint32_t(value - min), GetBitsRequired(uint32_t(max - min)));
+}
+
+int32_t BitStream::ReadRangedInt(int32_t min, int32_t max)
+{
+    OCT_ASSERT(max >= min);
+    uint32_t value = ReadBits(GetBitsRequired(uint32_t(max - min)));
+    return glm::min(int32_t(value + uint32_t(min)), max);
+}
+
+void BitStream::WriteQuantizedFloat(float value, float min, float max, uint32_t numBits)
+{
+    WriteBits(QuantizeFloat(value, min, max, numBits), numBits);
+}
+
+float BitStream::ReadQuantizedFloat(float min, float max, uint32_t numBits)
+{
+    return DequantizeFloat(ReadBits(numBits), min, max, numBits);
+}
+
+void BitStream::WriteQuat(glm::quat value, uint32_t numBits)
+{
+    uint32_t words[4];
+    QuantizeQuat(value, numBits, words);
+
+    WriteBits(words[0], 2);
+    WriteBits(words[1], numBits);
+    WriteBits(words[2], numBits);
+    WriteBits(words[3], numBits);
+}
+
+glm::quat BitStream::ReadQuat(uint32_t numBits)
+{
+    uint32_t words[4];
+    words[0] = ReadBits(2);
+    words[1] = ReadBits(numBits);
+    words[2] = ReadBits(numBits);
+    words[3] = ReadBits(numBits);
+
+    return DequantizeQuat(words, numBits);
+}
+
+void BitStream::WriteString(const std::string& value)
+{
+    WriteVarUint(uint32_t(value.size()));
+
+    for (uint32_t i = 0; i < value.size(); ++i)
+    {
+        WriteBits(uint8_t(value[i]), 8);
+    }
+}
+
+void BitStream::ReadString(std::string& outValue)
+{
+    uint32_t size = ReadVarUint();
+
+    // Don't trust the length until we know the bits are actually there.
+    // Compare in bytes, size comes off the wire and size * 8 can wrap.
+    if (size > (mNumBits - mBitPos) / 8)
+    {
+        mOverflow = true;
+        mBitPos = mNumBits;
+        outValue.clear();
+        return;
+    }
+
+    outValue.resize(size);
+
+    for (uint32_t i = 0; i < size; ++i)
+    {
+        outValue[i] = char(ReadBits(8));
+    }
+}
+
+uint32_t BitStream::GetBitsRequired(uint32_t maxValue)
+{
+    uint32_t bits = 0;
+
+    while (maxValue > 0)
+    {
+        maxValue >>= 1;
+        ++bits;
+    }
+
+    return bits;
+}
+
+uint32_t BitStream::QuantizeFloat(float value, float min, float max, uint32_t numBits)
+{
+    OCT_ASSERT(numBits > 0 && numBits <= 31);
+    OCT_ASSERT(max > min);
+
+    uint32_t maxInt = (1u << numBits) - 1;
+    float alpha = glm::clamp((value - min) / (max - min), 0.0f, 1.0f);
+
+    return uint32_t(alpha * float(maxInt) + 0.5f);
+}
+
+float BitStream::DequantizeFloat(uint32_t value, float min, float max, uint32_t numBits)
+{
+    OCT_ASSERT(numBits > 0 && numBits <= 31);
+
+    uint32_t maxInt = (1u << numBits) - 1;
+    float alpha = float(glm::min(value, maxInt)) / float(maxInt);
+
+    return min + alpha * (max - min);
+}
+
+void BitStream::QuantizeQuat(glm::quat value, uint32_t numBits, uint32_t outWords[4])
+{
+    value = glm::normalize(value);
+    float comps[4] = { value.x, value.y, value.z, value.w };
+
+    uint32_t largest = 0;
+    for (uint32_t i = 1; i < 4; ++i)
+    {
+        if (fabsf(comps[i]) > fabsf(comps[largest]))
+        {
+            largest = i;
+        }
+    }
+
+    // q and -q are the same rotation, so flip the sign to make the dropped component positive.
+    float sign = (comps[largest] < 0.0f) ? -1.0f : 1.0f;
+
+    outWords[0] = largest;
+
+    uint32_t w = 1;
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        if (i != largest)
+        {
+            outWords[w++] = QuantizeFloat(comps[i] * sign, -kQuatComponentRange, kQuatComponentRange, numBits);
+        }
+    }
+}
+
+glm::quat BitStream::DequantizeQuat(const uint32_t words[4], uint32_t numBits)
+{
+    uint32_t largest = words[0] & 3;
+    float comps[4] = {};
+    float sumSquares = 0.0f;
+
+    uint32_t w = 1;
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        if (i != largest)
+        {
+            comps[i] = DequantizeFloat(words[w++], -kQuatComponentRange, kQuatComponentRange, numBits);
+            sumSquares += comps[i] * comps[i];
+        }
+    }
+
+    comps[largest] = sqrtf(glm::max(1.0f - sumSquares, 0.0f));
+
+    return glm::normalize(glm::quat(comps[3], comps[0], comps[1], comps[2]));
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "Maths.h"
+
+// Bit-level counterpart to Stream, used for packing replicated data.
+// Bits are packed LSB first into bytes, so the layout is the same on every platform
+// and no endian swapping is needed. Reads past the end return 0 and set the overflow
+// flag instead of asserting, since the data usually comes straight off the network.
+class BitStream
+{
+public:
+
+    BitStream();
+    BitStream(const char* externalData, uint32_t externalSize);
+
+    void Reset();
+
+    const uint8_t* GetData() const;
+    uint32_t GetNumBits() const;
+    uint32_t GetNumBytes() const;
+    uint32_t GetBitPos() const;
+    bool IsOverflowed() const;
+
+    void WriteBits(uint32_t value, uint32_t numBits);
+    uint32_t ReadBits(uint32_t numBits);
+
+    void WriteBool(bool value);
+    bool ReadBool();
+
+    // Variable length unsigned integer (7 bits per group).
+    void WriteVarUint(uint32_t value);
+    uint32_t ReadVarUint();
+
+    // Writes (value - min) using just enough bits to cover [min, max].
+    void WriteRangedInt(int32_t value, int32_t min, int32_t max);
+    int32_t ReadRangedInt(int32_t min, int32_t max);
+
+    void WriteQuantizedFloat(float value, float min, float max, uint32_t numBits);
+    float ReadQuantizedFloat(float min, float max, uint32_t numBits);
+
+    // Smallest three encoding: index of the largest component plus the other three at numBits each.
+    void WriteQuat(glm::quat value, uint32_t numBits);
+    glm::quat ReadQuat(uint32_t numBits);
+
+    void WriteString(const std::string& value);
+    void ReadString(std::string& outValue);
+
+    static uint32_t GetBitsRequired(uint32_t maxValue);
+    static uint32_t QuantizeFloat(float value, float min, float max, uint32_t numBits);
+    static float DequantizeFloat(uint32_t value, float min, float max, uint32_t numBits);
+
+    // Words are { largest index (2 bits), a, b, c (numBits each) }.
+    static void QuantizeQuat(glm::quat value, uint32_t numBits, uint32_t outWords[4]);
+    static glm::quat DequantizeQuat(const uint32_t words[4], uint32_t numBits);
+
+private:
+
+    std::vector<uint8_t> mBuffer;
+    const uint8_t* mExternalData = nullptr;
+    uint32_t mNumBits = 0;
+    uint32_t mBitPos = 0;
+    bool mOverflow = false;
+};
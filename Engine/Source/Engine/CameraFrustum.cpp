@@ -150,3 +150,36 @@ bool CameraFrustum::IsSphereInFrustumOrtho(glm::vec3 center, float radius) const
 
     return true;
 }
+
+static glm::vec4 MakePlane(glm::vec3 normal, glm::vec3 point)
+{
+    normal = glm::normalize(normal);
+    return glm::vec4(normal, -glm::dot(normal, point));
+}
+
+void CameraFrustum::GetPlanes(glm::vec4* outPlanes) const
+{
+    glm::vec3 nearPoint = mPosition + mBasisZ * mNearDist;
+    glm::vec3 farPoint = mPosition + mBasisZ * mFarDist;
+
+    outPlanes[0] = MakePlane(mBasisZ, nearPoint);
+    outPlanes[1] = MakePlane(-mBasisZ, farPoint);
+
+    if (mOrtho)
+    {
+        outPlanes[2] = MakePlane(mBasisY, mPosition - mBasisY * mNearHeight);
+        outPlanes[3] = MakePlane(-mBasisY, mPosition + mBasisY * mNearHeight);
+        outPlanes[4] = MakePlane(mBasisX, mPosition - mBasisX * mNearWidth);
+        outPlanes[5] = MakePlane(-mBasisX, mPosition + mBasisX * mNearWidth);
+    }
+    else
+    {
+        // Side planes all pass through the camera position.
+        float vert = mTangent;
+        float hori = mTangent * mAspectRatio;
+        outPlanes[2] = MakePlane(mBasisZ * vert + mBasisY, mPosition);
+        outPlanes[3] = MakePlane(mBasisZ * vert - mBasisY, mPosition);
+        outPlanes[4] = MakePlane(mBasisZ * hori + mBasisX, mPosition);
+        outPlanes[5] = MakePlane(mBasisZ * hori - mBasisX, mPosition);
+    }
+}
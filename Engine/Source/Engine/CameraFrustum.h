@@ -35,4 +35,8 @@ public:
 
     bool IsPointInFrustumOrtho(glm::vec3 p) const;
     bool IsSphereInFrustumOrtho(glm::vec3 center, float radius) const;
+
+    // Writes the 6 bounding planes (near, far, bottom, top, left, right) as (normal, d).
+    // Normals face inward, so a point p is inside when dot(normal, p) + d >= 0 for every plane.
+    void GetPlanes(glm::vec4* outPlanes) const;
 };
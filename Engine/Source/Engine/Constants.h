@@ -50,13 +50,33 @@
 
 #define LARGE_BOUNDS 10000.0f
 
+// Merge consecutive quad/text widget draws that share a texture and scissor into one draw (Vulkan only).
+#define UI_BATCHING 1
+
+// Can be forced on for a game build, but the engine and the game must agree since it changes AssetRef's layout.
+#ifndef ASSET_LIVE_REF_TRACKING
 #if EDITOR
 #define ASSET_LIVE_REF_TRACKING 1
 #else
 #define ASSET_LIVE_REF_TRACKING 0
 #endif
+#endif
+
+// Allocate nodes from per-size slab pools (see NodePool.h) instead of the general heap.
+#define NODE_POOL_ALLOCATION 1
 
 #define LUA_ENABLED 1
 #define LUA_TYPE_CHECK 1
-#define LUA_SAFE_NODE 0
+
+// Queue script ticks during the world tick and run them all from one Lua loop afterwards.
+// Cuts the C/Lua transitions per scripted node, but script Tick() then runs after every native Tick().
+#define LUA_BATCHED_TICK 0
+
+// Compare cooked script bytecode against the source it was compiled from (when the source is present)
+// and fall back to the source if it has changed since cooking.
+#if defined(_DEBUG) || EDITOR
+#define LUA_BYTECODE_SOURCE_CHECK 1
+#else
+#define LUA_BYTECODE_SOURCE_CHECK 0
+#endif
 
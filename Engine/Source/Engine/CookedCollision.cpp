@@ -0,0 +1,196 @@
+#include "CookedCollision.h"
+#include "Stream.h"
+#include "Assertion.h"
+
+#include <string.h>
+
+static void WriteBulletVec3(Stream& stream, const btVector3& value)
+{
+    stream.WriteFloat(float(value.x()));
+    stream.WriteFloat(float(value.y()));
+    stream.WriteFloat(float(value.z()));
+}
+
+static btVector3 ReadBulletVec3(Stream& stream)
+{
+    float x = stream.ReadFloat();
+    float y = stream.ReadFloat();
+    float z = stream.ReadFloat();
+    return btVector3(x, y, z);
+}
+
+static void WriteQuantizedAabb(Stream& stream, const unsigned short* aabbMin, const unsigned short* aabbMax)
+{
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        stream.WriteUint16(aabbMin[i]);
+    }
+
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        stream.WriteUint16(aabbMax[i]);
+    }
+}
+
+static void ReadQuantizedAabb(Stream& stream, unsigned short* aabbMin, unsigned short* aabbMax)
+{
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        aabbMin[i] = stream.ReadUint16();
+    }
+
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        aabbMax[i] = stream.ReadUint16();
+    }
+}
+
+void CookedBvh::Build(const btBvhTriangleMeshShape* shape)
+{
+    // Same as btBvhTriangleMeshShape::buildOptimizedBvh(), but the shape won't own the tree.
+    build(
+        const_cast<btStridingMeshInterface*>(shape->getMeshInterface()),
+        true,
+        shape->getLocalAabbMin(),
+        shape->getLocalAabbMax());
+}
+
+void CookedBvh::WriteStream(Stream& stream) const
+{
+    OCT_ASSERT(m_useQuantization);
+
+    WriteBulletVec3(stream, m_bvhAabbMin);
+    WriteBulletVec3(stream, m_bvhAabbMax);
+    WriteBulletVec3(stream, m_bvhQuantization);
+    stream.WriteInt32(m_curNodeIndex);
+    stream.WriteUint32(uint32_t(m_traversalMode));
+
+    stream.WriteUint32(uint32_t(m_quantizedContiguousNodes.size()));
+    for (int32_t i = 0; i < m_quantizedContiguousNodes.size(); ++i)
+    {
+        const btQuantizedBvhNode& node = m_quantizedContiguousNodes[i];
+        WriteQuantizedAabb(stream, node.m_quantizedAabbMin, node.m_quantizedAabbMax);
+        stream.WriteInt32(node.m_escapeIndexOrTriangleIndex);
+    }
+
+    stream.WriteUint32(uint32_t(m_SubtreeHeaders.size()));
+    for (int32_t i = 0; i < m_SubtreeHeaders.size(); ++i)
+    {
+        const btBvhSubtreeInfo& subtree = m_SubtreeHeaders[i];
+        WriteQuantizedAabb(stream, subtree.m_quantizedAabbMin, subtree.m_quantizedAabbMax);
+        stream.WriteInt32(subtree.m_rootNodeIndex);
+        stream.WriteInt32(subtree.m_subtreeSize);
+    }
+}
+
+void CookedBvh::ReadStream(Stream& stream)
+{
+    m_useQuantization = true;
+    m_bvhAabbMin = ReadBulletVec3(stream);
+    m_bvhAabbMax = ReadBulletVec3(stream);
+    m_bvhQuantization = ReadBulletVec3(stream);
+    m_curNodeIndex = stream.ReadInt32();
+    m_traversalMode = btTraversalMode(stream.ReadUint32());
+
+    uint32_t numNodes = stream.ReadUint32();
+    m_quantizedContiguousNodes.resize(int32_t(numNodes));
+    for (uint32_t i = 0; i < numNodes; ++i)
+    {
+        btQuantizedBvhNode& node = m_quantizedContiguousNodes[i];
+        ReadQuantizedAabb(stream, node.m_quantizedAabbMin, node.m_quantizedAabbMax);
+        node.m_escapeIndexOrTriangleIndex = stream.ReadInt32();
+    }
+
+    uint32_t numSubtrees = stream.ReadUint32();
+    m_SubtreeHeaders.resize(int32_t(numSubtrees));
+    for (uint32_t i = 0; i < numSubtrees; ++i)
+    {
+        btBvhSubtreeInfo& subtree = m_SubtreeHeaders[i];
+        ReadQuantizedAabb(stream, subtree.m_quantizedAabbMin, subtree.m_quantizedAabbMax);
+        subtree.m_rootNodeIndex = stream.ReadInt32();
+        subtree.m_subtreeSize = stream.ReadInt32();
+    }
+
+    m_subtreeHeaderCount = m_SubtreeHeaders.size();
+}
+
+void WriteTriangleInfoMap(Stream& stream, const btTriangleInfoMap& infoMap)
+{
+    stream.WriteFloat(float(infoMap.m_convexEpsilon));
+    stream.WriteFloat(float(infoMap.m_planarEpsilon));
+    stream.WriteFloat(float(infoMap.m_equalVertexThreshold));
+    stream.WriteFloat(float(infoMap.m_edgeDistanceThreshold));
+    stream.WriteFloat(float(infoMap.m_maxEdgeAngleThreshold));
+    stream.WriteFloat(float(infoMap.m_zeroAreaThreshold));
+
+    stream.WriteUint32(uint32_t(infoMap.size()));
+    for (int32_t i = 0; i < infoMap.size(); ++i)
+    {
+        const btTriangleInfo* info = infoMap.getAtIndex(i);
+        stream.WriteInt32(infoMap.getKeyAtIndex(i).getUid1());
+        stream.WriteInt32(info->m_flags);
+        stream.WriteFloat(float(info->m_edgeV0V1Angle));
+        stream.WriteFloat(float(info->m_edgeV1V2Angle));
+        stream.WriteFloat(float(info->m_edgeV2V0Angle));
+    }
+}
+
+void ReadTriangleInfoMap(Stream& stream, btTriangleInfoMap& infoMap)
+{
+    infoMap.m_convexEpsilon = stream.ReadFloat();
+    infoMap.m_planarEpsilon = stream.ReadFloat();
+    infoMap.m_equalVertexThreshold = stream.ReadFloat();
+    infoMap.m_edgeDistanceThreshold = stream.ReadFloat();
+    infoMap.m_maxEdgeAngleThreshold = stream.ReadFloat();
+    infoMap.m_zeroAreaThreshold = stream.ReadFloat();
+
+    uint32_t numInfos = stream.ReadUint32();
+    for (uint32_t i = 0; i < numInfos; ++i)
+    {
+        int32_t key = stream.ReadInt32();
+
+        btTriangleInfo info;
+        info.m_flags = stream.ReadInt32();
+        info.m_edgeV0V1Angle = stream.ReadFloat();
+        info.m_edgeV1V2Angle = stream.ReadFloat();
+        info.m_edgeV2V0Angle = stream.ReadFloat();
+
+        infoMap.insert(btHashInt(key), info);
+    }
+}
+
+uint32_t HashTriangleData(const void* vertices, uint32_t numVertices, uint32_t vertexStride, const IndexType* indices, uint32_t numIndices)
+{
+    // FNV-1a over 32 bit values rather than raw bytes so the result doesn't depend on endianness or index width.
+    uint32_t hash = 2166136261u;
+
+    auto hashValue = [&hash](uint32_t value)
+    {
+        hash ^= value;
+        hash *= 16777619u;
+    };
+
+    hashValue(numVertices);
+    hashValue(numIndices);
+
+    const uint8_t* vertexBytes = (const uint8_t*)vertices;
+    for (uint32_t i = 0; i < numVertices; ++i)
+    {
+        float position[3];
+        memcpy(position, vertexBytes + i * vertexStride, sizeof(position));
+
+        for (uint32_t c = 0; c < 3; ++c)
+        {
+            uint32_t bits;
+            memcpy(&bits, &position[c], sizeof(bits));
+            hashValue(bits);
+        }
+    }
+
+    for (uint32_t i = 0; i < numIndices; ++i)
+    {
+        hashValue(uint32_t(indices[i]));
+    }
+
+    return hash;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "btBulletDynamicsCommon.h"
+#include "BulletCollision/CollisionShapes/btOptimizedBvh.h"
+#include "BulletCollision/CollisionShapes/btTriangleInfoMap.h"
+
+#include "Graphics/GraphicsTypes.h"
+
+class Stream;
+
+// Quantized BVH for a triangle mesh that can be written to and read from an asset stream,
+// so cooked meshes don't have to rebuild the tree at load time. Fields are written one at a time
+// rather than with Bullet's in-place serializer, whose layout depends on the pointer size of the editor.
+ATTRIBUTE_ALIGNED16(class) CookedBvh : public btOptimizedBvh
+{
+public:
+
+    BT_DECLARE_ALIGNED_ALLOCATOR();
+
+    void Build(const btBvhTriangleMeshShape* shape);
+
+    void WriteStream(Stream& stream) const;
+    void ReadStream(Stream& stream);
+};
+
+void WriteTriangleInfoMap(Stream& stream, const btTriangleInfoMap& infoMap);
+void ReadTriangleInfoMap(Stream& stream, btTriangleInfoMap& infoMap);
+
+// Hash of the vertex positions and triangle indices, used to tell if cooked collision data is stale.
+// Vertices must start with a glm::vec3 position.
+uint32_t HashTriangleData(const void* vertices, uint32_t numVertices, uint32_t vertexStride, const IndexType* indices, uint32_t numIndices);
@@ -0,0 +1,217 @@
+#include "CpuSkinning.h"
+#include "JobSystem.h"
+#include "Assertion.h"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define SKIN_SSE 1
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON)
+#define SKIN_NEON 1
+#include <arm_neon.h>
+#endif
+
+// Below this many vertices, splitting the work across threads costs more than it saves.
+static const uint32_t kParallelSkinThreshold = 4096;
+static const uint32_t kSkinBatchSize = 1024;
+
+void ConvertBoneMatrices(const std::vector<glm::mat4>& matrices, std::vector<BoneAffine>& outBones)
+{
+    outBones.resize(matrices.size());
+
+    for (uint32_t i = 0; i < matrices.size(); ++i)
+    {
+        // glm matrices are column major, so gather each row across the columns.
+        const glm::mat4& m = matrices[i];
+        outBones[i].mRows[0] = glm::vec4(m[0][0], m[1][0], m[2][0], m[3][0]);
+        outBones[i].mRows[1] = glm::vec4(m[0][1], m[1][1], m[2][1], m[3][1]);
+        outBones[i].mRows[2] = glm::vec4(m[0][2], m[1][2], m[2][2], m[3][2]);
+    }
+}
+
+void SkinVertices(
+    const VertexSkinned* srcVerts,
+    Vertex* dstVerts,
+    uint32_t numVerts,
+    const BoneAffine* bones,
+    uint32_t numInfluences)
+{
+    JobSystem* jobSystem = JobSystem::Get();
+
+    if (jobSystem != nullptr &&
+        numVerts >= kParallelSkinThreshold)
+    {
+        jobSystem->ParallelFor(numVerts, kSkinBatchSize, [&](uint32_t start, uint32_t end)
+        {
+            SkinVerticesRange(srcVerts, dstVerts, start, end, bones, numInfluences);
+        });
+    }
+    else
+    {
+        SkinVerticesRange(srcVerts, dstVerts, 0, numVerts, bones, numInfluences);
+    }
+}
+
+void SkinVerticesRange(
+    const VertexSkinned* srcVerts,
+    Vertex* dstVerts,
+    uint32_t start,
+    uint32_t end,
+    const BoneAffine* bones,
+    uint32_t numInfluences)
+{
+    OCT_ASSERT(numInfluences == 1 || numInfluences == MAX_BONE_INFLUENCES);
+
+#if SKIN_SSE
+    for (uint32_t i = start; i < end; ++i)
+    {
+        const VertexSkinned& srcVert = srcVerts[i];
+        Vertex& dstVert = dstVerts[i];
+
+        const BoneAffine& bone0 = bones[srcVert.mBoneIndices[0]];
+        __m128 r0 = _mm_loadu_ps(&bone0.mRows[0].x);
+        __m128 r1 = _mm_loadu_ps(&bone0.mRows[1].x);
+        __m128 r2 = _mm_loadu_ps(&bone0.mRows[2].x);
+
+        if (numInfluences > 1)
+        {
+            __m128 w = _mm_set1_ps(srcVert.mBoneWeights[0]);
+            r0 = _mm_mul_ps(r0, w);
+            r1 = _mm_mul_ps(r1, w);
+            r2 = _mm_mul_ps(r2, w);
+
+            for (uint32_t b = 1; b < MAX_BONE_INFLUENCES; ++b)
+            {
+                const BoneAffine& bone = bones[srcVert.mBoneIndices[b]];
+                w = _mm_set1_ps(srcVert.mBoneWeights[b]);
+                r0 = _mm_add_ps(r0, _mm_mul_ps(_mm_loadu_ps(&bone.mRows[0].x), w));
+                r1 = _mm_add_ps(r1, _mm_mul_ps(_mm_loadu_ps(&bone.mRows[1].x), w));
+                r2 = _mm_add_ps(r2, _mm_mul_ps(_mm_loadu_ps(&bone.mRows[2].x), w));
+            }
+        }
+
+        // Transpose the blended rows into columns so the transform is 3 multiply-adds per vector.
+        __m128 r3 = _mm_setzero_ps();
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+        __m128 pos = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(r0, _mm_set1_ps(srcVert.mPosition.x)), _mm_mul_ps(r1, _mm_set1_ps(srcVert.mPosition.y))),
+            _mm_add_ps(_mm_mul_ps(r2, _mm_set1_ps(srcVert.mPosition.z)), r3));
+
+        __m128 nrm = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(r0, _mm_set1_ps(srcVert.mNormal.x)), _mm_mul_ps(r1, _mm_set1_ps(srcVert.mNormal.y))),
+            _mm_mul_ps(r2, _mm_set1_ps(srcVert.mNormal.z)));
+
+        float posOut[4];
+        float nrmOut[4];
+        _mm_storeu_ps(posOut, pos);
+        _mm_storeu_ps(nrmOut, nrm);
+
+        dstVert.mPosition = glm::vec3(posOut[0], posOut[1], posOut[2]);
+        dstVert.mNormal = glm::vec3(nrmOut[0], nrmOut[1], nrmOut[2]);
+        dstVert.mTexcoord0 = srcVert.mTexcoord0;
+        dstVert.mTexcoord1 = srcVert.mTexcoord1;
+    }
+#elif SKIN_NEON
+    for (uint32_t i = start; i < end; ++i)
+    {
+        const VertexSkinned& srcVert = srcVerts[i];
+        Vertex& dstVert = dstVerts[i];
+
+        const BoneAffine& bone0 = bones[srcVert.mBoneIndices[0]];
+        float32x4_t r0 = vld1q_f32(&bone0.mRows[0].x);
+        float32x4_t r1 = vld1q_f32(&bone0.mRows[1].x);
+        float32x4_t r2 = vld1q_f32(&bone0.mRows[2].x);
+
+        if (numInfluences > 1)
+        {
+            float w = srcVert.mBoneWeights[0];
+            r0 = vmulq_n_f32(r0, w);
+            r1 = vmulq_n_f32(r1, w);
+            r2 = vmulq_n_f32(r2, w);
+
+            for (uint32_t b = 1; b < MAX_BONE_INFLUENCES; ++b)
+            {
+                const BoneAffine& bone = bones[srcVert.mBoneIndices[b]];
+                w = srcVert.mBoneWeights[b];
+                r0 = vmlaq_n_f32(r0, vld1q_f32(&bone.mRows[0].x), w);
+                r1 = vmlaq_n_f32(r1, vld1q_f32(&bone.mRows[1].x), w);
+                r2 = vmlaq_n_f32(r2, vld1q_f32(&bone.mRows[2].x), w);
+            }
+        }
+
+        // Transpose the blended rows into columns so the transform is 3 multiply-adds per vector.
+        float32x4x2_t t01 = vtrnq_f32(r0, r1);
+        float32x4x2_t t23 = vtrnq_f32(r2, vdupq_n_f32(0.0f));
+        float32x4_t c0 = vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0]));
+        float32x4_t c1 = vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1]));
+        float32x4_t c2 = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+        float32x4_t c3 = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+
+        float32x4_t pos = c3;
+        pos = vmlaq_n_f32(pos, c0, srcVert.mPosition.x);
+        pos = vmlaq_n_f32(pos, c1, srcVert.mPosition.y);
+        pos = vmlaq_n_f32(pos, c2, srcVert.mPosition.z);
+
+        float32x4_t nrm = vmulq_n_f32(c0, srcVert.mNormal.x);
+        nrm = vmlaq_n_f32(nrm, c1, srcVert.mNormal.y);
+        nrm = vmlaq_n_f32(nrm, c2, srcVert.mNormal.z);
+
+        float posOut[4];
+        float nrmOut[4];
+        vst1q_f32(posOut, pos);
+        vst1q_f32(nrmOut, nrm);
+
+        dstVert.mPosition = glm::vec3(posOut[0], posOut[1], posOut[2]);
+        dstVert.mNormal = glm::vec3(nrmOut[0], nrmOut[1], nrmOut[2]);
+        dstVert.mTexcoord0 = srcVert.mTexcoord0;
+        dstVert.mTexcoord1 = srcVert.mTexcoord1;
+    }
+#else
+    SkinVerticesScalar(srcVerts, dstVerts, start, end, bones, numInfluences);
+#endif
+}
+
+void SkinVerticesScalar(
+    const VertexSkinned* srcVerts,
+    Vertex* dstVerts,
+    uint32_t start,
+    uint32_t end,
+    const BoneAffine* bones,
+    uint32_t numInfluences)
+{
+    for (uint32_t i = start; i < end; ++i)
+    {
+        const VertexSkinned& srcVert = srcVerts[i];
+        Vertex& dstVert = dstVerts[i];
+
+        const BoneAffine& bone0 = bones[srcVert.mBoneIndices[0]];
+        glm::vec4 r0 = bone0.mRows[0];
+        glm::vec4 r1 = bone0.mRows[1];
+        glm::vec4 r2 = bone0.mRows[2];
+
+        if (numInfluences > 1)
+        {
+            float w = srcVert.mBoneWeights[0];
+            r0 *= w;
+            r1 *= w;
+            r2 *= w;
+
+            for (uint32_t b = 1; b < MAX_BONE_INFLUENCES; ++b)
+            {
+                const BoneAffine& bone = bones[srcVert.mBoneIndices[b]];
+                w = srcVert.mBoneWeights[b];
+                r0 += bone.mRows[0] * w;
+                r1 += bone.mRows[1] * w;
+                r2 += bone.mRows[2] * w;
+            }
+        }
+
+        glm::vec4 pos = glm::vec4(srcVert.mPosition, 1.0f);
+        glm::vec4 nrm = glm::vec4(srcVert.mNormal, 0.0f);
+
+        dstVert.mPosition = glm::vec3(glm::dot(r0, pos), glm::dot(r1, pos), glm::dot(r2, pos));
+        dstVert.mNormal = glm::vec3(glm::dot(r0, nrm), glm::dot(r1, nrm), glm::dot(r2, nrm));
+        dstVert.mTexcoord0 = srcVert.mTexcoord0;
+        dstVert.mTexcoord1 = srcVert.mTexcoord1;
+    }
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+#include "Maths.h"
+#include "Vertex.h"
+
+// Top three rows of an affine bone matrix. The bottom row is always (0, 0, 0, 1),
+// so blending four influences only needs 12 multiply-adds per bone instead of 16.
+struct BoneAffine
+{
+    glm::vec4 mRows[3];
+};
+
+void ConvertBoneMatrices(const std::vector<glm::mat4>& matrices, std::vector<BoneAffine>& outBones);
+
+// Linear blend skinning of positions and normals with either 1 or 4 bone influences.
+// Uses SSE or NEON when available. Large meshes are split into ranges that are skinned on the JobSystem.
+void SkinVertices(
+    const VertexSkinned* srcVerts,
+    Vertex* dstVerts,
+    uint32_t numVerts,
+    const BoneAffine* bones,
+    uint32_t numInfluences);
+
+void SkinVerticesRange(
+    const VertexSkinned* srcVerts,
+    Vertex* dstVerts,
+    uint32_t start,
+    uint32_t end,
+    const BoneAffine* bones,
+    uint32_t numInfluences);
+
+// Portable path for platforms without SSE or NEON.
+void SkinVerticesScalar(
+    const VertexSkinned* srcVerts,
+    Vertex* dstVerts,
+    uint32_t start,
+    uint32_t end,
+    const BoneAffine* bones,
+    uint32_t numInfluences);
@@ -17,6 +17,8 @@
 #include "ScriptAutoReg.h"
 #include "ScriptFunc.h"
 #include "TimerManager.h"
+#include "JobSystem.h"
+#include "NodePool.h"
 #include "Nodes/Widgets/TextField.h"
 
 #include "System/System.h"
@@ -179,6 +181,7 @@ bool Initialize(InitOptions& initOptions)
     CreateProfiler();
     SCOPED_STAT("Initialize");
 
+    JobSystem::Create();
     Renderer::Create();
     AssetManager::Create();
     NetworkManager::Create();
@@ -234,7 +237,14 @@ bool Initialize(InitOptions& initOptions)
     if (GetEngineState()->mProjectDirectory != "" &&
         initOptions.mUseAssetRegistry)
     {
-        AssetManager::Get()->DiscoverAssetRegistry((GetEngineState()->mProjectDirectory + "AssetRegistry.txt").c_str());
+        // Prefer the packed archive when the project was packaged with one.
+        std::string archivePath = GetEngineState()->mProjectDirectory + "Assets.octa";
+
+        if (!SYS_DoesFileExist(archivePath.c_str(), true) ||
+            !AssetManager::Get()->MountArchive(archivePath.c_str()))
+        {
+            AssetManager::Get()->DiscoverAssetRegistry((GetEngineState()->mProjectDirectory + "AssetRegistry.txt").c_str());
+        }
     }
 #endif
 
@@ -426,6 +436,7 @@ bool Update()
 
     END_FRAME_STAT("Frame");
 
+    UpdateNodePoolStats();
     GetProfiler()->EndFrame();
 
     if (doFrameStep)
@@ -461,6 +472,7 @@ void Shutdown()
     NetworkManager::Destroy();
     Renderer::Destroy();
     AssetManager::Destroy();
+    JobSystem::Destroy();
 
     NET_Shutdown();
     AUD_Shutdown();
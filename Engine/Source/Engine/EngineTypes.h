@@ -2,6 +2,7 @@
 
 #include <string>
 #include <string.h>
+#include <unordered_map>
 
 #include "Constants.h"
 #include "Maths.h"
@@ -436,6 +437,31 @@ struct ReliablePacket
     uint16_t mSeq = 0;
 };
 
+// Per-client bookkeeping for a node that is relevant to that client.
+struct NetRelevantNode
+{
+    NetId mNetId = INVALID_NET_ID;
+    float mPriority = 0.0f;
+    bool mStale = false;
+    bool mReliable = false;
+};
+
+#define NET_BASELINE_HISTORY 16
+
+// Packed (quantized) replication state of one node, used as the reference for delta encoding.
+// The server keeps one per client per node, the client keeps one per node.
+struct NetBaseline
+{
+    std::vector<uint32_t> mAcked;
+    std::vector<uint32_t> mHistory; // NET_BASELINE_HISTORY snapshots of mNumWords words, indexed by seq
+    uint8_t mHistorySeq[NET_BASELINE_HISTORY] = {};
+    uint16_t mHistoryValid = 0;
+    uint32_t mNumWords = 0;
+    uint8_t mAckedSeq = 0;
+    uint8_t mNextSeq = 0;
+    bool mHasAck = false;
+};
+
 struct NetHostProfile
 {
     static const uint32_t sSendBufferSize = 512;
@@ -452,6 +478,14 @@ struct NetHostProfile
     uint16_t mOutgoingUnreliableSeq = 0;
     uint16_t mIncomingUnreliableSeq = 0;
     bool mReady = true;
+
+    // Relevancy (server side only)
+    glm::vec3 mViewPosition = {};
+    NetId mViewNetId = INVALID_NET_ID;
+    std::vector<NetRelevantNode> mRelevantNodes; // Sorted by net id
+
+    // Packed replication baselines (server side only)
+    std::unordered_map<NetId, NetBaseline> mBaselines;
 };
 
 typedef NetHostProfile NetClient;
@@ -2,13 +2,20 @@
 
 #include "Utilities.h"
 
+#include <string>
+#include <unordered_map>
+
 #ifdef GetClassName
 #undef GetClassName
 #endif
 
 #define DECLARE_FACTORY_MANAGER(Base) \
     static std::vector<Factory*>& GetFactoryList(); \
+    static std::unordered_map<TypeId, Factory*>& GetFactoryTypeMap(); \
+    static std::unordered_map<std::string, Factory*>& GetFactoryNameMap(); \
     static TypeId RegisterFactory(Factory* factory, uint32_t typeIdMod = 0); \
+    static Factory* FindFactory(const char* typeName); \
+    static Factory* FindFactory(TypeId typeId); \
     static Base* CreateInstance(const char* typeName); \
     static Base* CreateInstance(TypeId typeId);
 
@@ -19,43 +26,59 @@
         return sFactoryList; \
     } \
     \
+    std::unordered_map<TypeId, Factory*>& Base::GetFactoryTypeMap() \
+    { \
+        static std::unordered_map<TypeId, Factory*> sFactoryTypeMap; \
+        return sFactoryTypeMap; \
+    } \
+    \
+    std::unordered_map<std::string, Factory*>& Base::GetFactoryNameMap() \
+    { \
+        static std::unordered_map<std::string, Factory*> sFactoryNameMap; \
+        return sFactoryNameMap; \
+    } \
+    \
     TypeId Base::RegisterFactory(Factory* factory, uint32_t typeIdMod) \
     { \
-        std::vector<Factory*>& factoryList = GetFactoryList(); \
         const char* name = factory->GetClassName(); \
         TypeId typeId = (OctHashString(name) + typeIdMod); \
         if (typeId == 0) { typeId++; } \
-        for (uint32_t i = 0; i < factoryList.size(); ++i) { \
-            if (strncmp(factoryList[i]->GetClassName(), name, MAX_PATH_SIZE) == 0) { \
-                LogError("Conflicting class name found in factory's RegisterClass() - %s", name); OCT_ASSERT(0); typeId = 0; break; } \
-            if (factoryList[i]->GetType() == typeId) { \
-                LogError("Conflicting TypeId %x encountered in " #Base " factory manager's RegisterClass() - [%s] and [%s]", (uint32_t)typeId, factoryList[i]->GetClassName(), name); \
-                LogError("Use special case of XXXXX_FACTORY() with hash add number to avoid conflict."); OCT_ASSERT(0); typeId = 0; break; } \
-        } \
-        if (typeId != 0) { factoryList.push_back(factory); } \
+        auto nameIt = GetFactoryNameMap().find(name); \
+        auto typeIt = GetFactoryTypeMap().find(typeId); \
+        if (nameIt != GetFactoryNameMap().end()) { \
+            LogError("Conflicting class name found in factory's RegisterClass() - %s", name); OCT_ASSERT(0); typeId = 0; } \
+        else if (typeIt != GetFactoryTypeMap().end()) { \
+            LogError("Conflicting TypeId %x encountered in " #Base " factory manager's RegisterClass() - [%s] and [%s]", (uint32_t)typeId, typeIt->second->GetClassName(), name); \
+            LogError("Use special case of XXXXX_FACTORY() with hash add number to avoid conflict."); OCT_ASSERT(0); typeId = 0; } \
+        if (typeId != 0) { \
+            GetFactoryList().push_back(factory); \
+            GetFactoryTypeMap().insert({ typeId, factory }); \
+            GetFactoryNameMap().insert({ name, factory }); } \
         return typeId; \
     } \
     \
+    Factory* Base::FindFactory(const char* typeName) \
+    { \
+        auto it = GetFactoryNameMap().find(typeName); \
+        return (it != GetFactoryNameMap().end()) ? it->second : nullptr; \
+    } \
+    \
+    Factory* Base::FindFactory(TypeId typeId) \
+    { \
+        auto it = GetFactoryTypeMap().find(typeId); \
+        return (it != GetFactoryTypeMap().end()) ? it->second : nullptr; \
+    } \
+    \
     Base* Base::CreateInstance(const char* typeName) \
     { \
-        std::vector<Factory*>& factoryList = GetFactoryList(); \
-        Base* retObject = nullptr; \
-        for (uint32_t i = 0; i < factoryList.size(); ++i) { \
-            if (strncmp(factoryList[i]->GetClassName(), typeName, MAX_PATH_SIZE) == 0) { \
-                retObject = (Base*) factoryList[i]->Create(); break; } \
-        } \
-        return retObject; \
+        Factory* factory = FindFactory(typeName); \
+        return factory ? (Base*) factory->Create() : nullptr; \
     }\
     \
     Base* Base::CreateInstance(TypeId typeId) \
     { \
-        std::vector<Factory*>& factoryList = GetFactoryList(); \
-        Base* retObject = nullptr; \
-        for (uint32_t i = 0; i < factoryList.size(); ++i) { \
-            if (factoryList[i]->GetType() == typeId) { \
-                retObject = (Base*) factoryList[i]->Create(); break; } \
-        } \
-        return retObject; \
+        Factory* factory = FindFactory(typeId); \
+        return factory ? (Base*) factory->Create() : nullptr; \
     }
 
 class Factory
@@ -81,6 +104,11 @@ public:
         return "Class";
     }
 
+    virtual uint32_t GetInstanceSize() const
+    {
+        return 0;
+    }
+
 protected:
     TypeId mType = 0;
 };
@@ -100,6 +128,7 @@ protected:
         Factory_##Class() { mType = BaseClass::RegisterFactory(this, TypeMod); } \
         virtual void* Create() override { return new Class(); } \
         virtual const char* GetClassName() const override { return #Class; } \
+        virtual uint32_t GetInstanceSize() const override { return uint32_t(sizeof(Class)); } \
     }; \
     static Factory_##Class sFactory_##Class; \
     TypeId Class::GetType() const { return sFactory_##Class.GetType(); } \
@@ -0,0 +1,181 @@
+#include "FrustumCuller.h"
+#include "CameraFrustum.h"
+#include "JobSystem.h"
+#include "Assertion.h"
+
+#if defined(__AVX__)
+#define CULL_AVX 1
+#include <immintrin.h>
+#elif defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define CULL_SSE 1
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON)
+#define CULL_NEON 1
+#include <arm_neon.h>
+#endif
+
+void FrustumCuller::SetFrustum(const CameraFrustum& frustum)
+{
+    frustum.GetPlanes(mPlanes);
+}
+
+void FrustumCuller::Clear()
+{
+    mCenterX.clear();
+    mCenterY.clear();
+    mCenterZ.clear();
+    mRadius.clear();
+}
+
+void FrustumCuller::Reserve(uint32_t count)
+{
+    mCenterX.reserve(count);
+    mCenterY.reserve(count);
+    mCenterZ.reserve(count);
+    mRadius.reserve(count);
+}
+
+void FrustumCuller::AddSphere(glm::vec3 center, float radius)
+{
+    mCenterX.push_back(center.x);
+    mCenterY.push_back(center.y);
+    mCenterZ.push_back(center.z);
+    mRadius.push_back(radius);
+}
+
+uint32_t FrustumCuller::GetNumSpheres() const
+{
+    return uint32_t(mRadius.size());
+}
+
+// Below this many spheres, splitting the work across threads costs more than it saves.
+static const uint32_t kParallelCullThreshold = 4096;
+static const uint32_t kCullBatchSize = 1024;
+
+void FrustumCuller::Cull(uint8_t* outVisible) const
+{
+    const uint32_t numSpheres = GetNumSpheres();
+    JobSystem* jobSystem = JobSystem::Get();
+
+    if (jobSystem != nullptr &&
+        numSpheres >= kParallelCullThreshold)
+    {
+        jobSystem->ParallelFor(numSpheres, kCullBatchSize, [&](uint32_t start, uint32_t end)
+        {
+            CullRange(start, end - start, outVisible);
+        });
+    }
+    else
+    {
+        CullRange(0, numSpheres, outVisible);
+    }
+}
+
+void FrustumCuller::CullRange(uint32_t start, uint32_t count, uint8_t* outVisible) const
+{
+    OCT_ASSERT(start + count <= GetNumSpheres());
+
+    uint32_t i = start;
+    const uint32_t end = start + count;
+
+    const float* cxs = mCenterX.data();
+    const float* cys = mCenterY.data();
+    const float* czs = mCenterZ.data();
+    const float* rs = mRadius.data();
+
+    // A sphere is visible when its signed distance to every (inward facing) plane is >= -radius.
+#if CULL_AVX
+    for (; i + 8 <= end; i += 8)
+    {
+        __m256 cx = _mm256_loadu_ps(cxs + i);
+        __m256 cy = _mm256_loadu_ps(cys + i);
+        __m256 cz = _mm256_loadu_ps(czs + i);
+        __m256 negR = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(rs + i));
+        __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+
+        for (uint32_t p = 0; p < 6; ++p)
+        {
+            __m256 dist = _mm256_add_ps(
+                _mm256_add_ps(_mm256_mul_ps(cx, _mm256_set1_ps(mPlanes[p].x)), _mm256_mul_ps(cy, _mm256_set1_ps(mPlanes[p].y))),
+                _mm256_add_ps(_mm256_mul_ps(cz, _mm256_set1_ps(mPlanes[p].z)), _mm256_set1_ps(mPlanes[p].w)));
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(dist, negR, _CMP_GE_OQ));
+        }
+
+        int32_t mask = _mm256_movemask_ps(inside);
+        for (uint32_t k = 0; k < 8; ++k)
+        {
+            outVisible[i + k] = uint8_t((mask >> k) & 1);
+        }
+    }
+#elif CULL_SSE
+    for (; i + 4 <= end; i += 4)
+    {
+        __m128 cx = _mm_loadu_ps(cxs + i);
+        __m128 cy = _mm_loadu_ps(cys + i);
+        __m128 cz = _mm_loadu_ps(czs + i);
+        __m128 negR = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(rs + i));
+        __m128 inside = _mm_cmpeq_ps(cx, cx);
+
+        for (uint32_t p = 0; p < 6; ++p)
+        {
+            __m128 dist = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(cx, _mm_set1_ps(mPlanes[p].x)), _mm_mul_ps(cy, _mm_set1_ps(mPlanes[p].y))),
+                _mm_add_ps(_mm_mul_ps(cz, _mm_set1_ps(mPlanes[p].z)), _mm_set1_ps(mPlanes[p].w)));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(dist, negR));
+        }
+
+        int32_t mask = _mm_movemask_ps(inside);
+        outVisible[i + 0] = uint8_t(mask & 1);
+        outVisible[i + 1] = uint8_t((mask >> 1) & 1);
+        outVisible[i + 2] = uint8_t((mask >> 2) & 1);
+        outVisible[i + 3] = uint8_t((mask >> 3) & 1);
+    }
+#elif CULL_NEON
+    for (; i + 4 <= end; i += 4)
+    {
+        float32x4_t cx = vld1q_f32(cxs + i);
+        float32x4_t cy = vld1q_f32(cys + i);
+        float32x4_t cz = vld1q_f32(czs + i);
+        float32x4_t negR = vnegq_f32(vld1q_f32(rs + i));
+        uint32x4_t inside = vdupq_n_u32(0xffffffff);
+
+        for (uint32_t p = 0; p < 6; ++p)
+        {
+            float32x4_t dist = vdupq_n_f32(mPlanes[p].w);
+            dist = vmlaq_n_f32(dist, cx, mPlanes[p].x);
+            dist = vmlaq_n_f32(dist, cy, mPlanes[p].y);
+            dist = vmlaq_n_f32(dist, cz, mPlanes[p].z);
+            inside = vandq_u32(inside, vcgeq_f32(dist, negR));
+        }
+
+        outVisible[i + 0] = uint8_t(vgetq_lane_u32(inside, 0) & 1);
+        outVisible[i + 1] = uint8_t(vgetq_lane_u32(inside, 1) & 1);
+        outVisible[i + 2] = uint8_t(vgetq_lane_u32(inside, 2) & 1);
+        outVisible[i + 3] = uint8_t(vgetq_lane_u32(inside, 3) & 1);
+    }
+#endif
+
+    // Remaining spheres (or all of them on platforms without SIMD)
+    CullRangeScalar(i, end, outVisible);
+}
+
+void FrustumCuller::CullRangeScalar(uint32_t start, uint32_t end, uint8_t* outVisible) const
+{
+    for (uint32_t i = start; i < end; ++i)
+    {
+        float negR = -mRadius[i];
+        bool inside = true;
+
+        for (uint32_t p = 0; p < 6; ++p)
+        {
+            float dist = mCenterX[i] * mPlanes[p].x +
+                mCenterY[i] * mPlanes[p].y +
+                mCenterZ[i] * mPlanes[p].z +
+                mPlanes[p].w;
+
+            inside = inside && (dist >= negR);
+        }
+
+        outVisible[i] = inside ? 1 : 0;
+    }
+}
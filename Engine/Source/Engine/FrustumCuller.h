@@ -0,0 +1,64 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+#include "Maths.h"
+
+class CameraFrustum;
+
+// Tests batches of bounding spheres against the 6 planes of a CameraFrustum.
+// Spheres are stored as separate x/y/z/radius arrays so that 4 (SSE/NEON) or
+// 8 (AVX) spheres can be tested per instruction. Large batches are split into
+// ranges that are culled in parallel on the JobSystem.
+class FrustumCuller
+{
+public:
+
+    void SetFrustum(const CameraFrustum& frustum);
+
+    void Clear();
+    void Reserve(uint32_t count);
+    void AddSphere(glm::vec3 center, float radius);
+    uint32_t GetNumSpheres() const;
+
+    // Writes 1 to outVisible[i] if sphere i intersects the frustum, otherwise 0.
+    void Cull(uint8_t* outVisible) const;
+    void CullRange(uint32_t start, uint32_t count, uint8_t* outVisible) const;
+
+private:
+
+    void CullRangeScalar(uint32_t start, uint32_t end, uint8_t* outVisible) const;
+
+    glm::vec4 mPlanes[6] = {};
+
+    std::vector<float> mCenterX;
+    std::vector<float> mCenterY;
+    std::vector<float> mCenterZ;
+    std::vector<float> mRadius;
+};
+
+// Removes the elements whose visible flag is 0 while preserving the order of the rest.
+// Returns the number of removed elements.
+template<typename T>
+uint32_t CompactVisible(std::vector<T>& elements, const uint8_t* visible)
+{
+    uint32_t numVisible = 0;
+
+    for (uint32_t i = 0; i < elements.size(); ++i)
+    {
+        if (visible[i])
+        {
+            if (numVisible != i)
+            {
+                elements[numVisible] = elements[i];
+            }
+
+            numVisible++;
+        }
+    }
+
+    uint32_t numCulled = uint32_t(elements.size()) - numVisible;
+    elements.resize(numVisible);
+    return numCulled;
+}
@@ -0,0 +1,394 @@
+#include "JobSystem.h"
+#include "Assertion.h"
+#include "Log.h"
+
+#include "System/System.h"
+
+#include <thread>
+
+JobSystem* JobSystem::sInstance = nullptr;
+
+// Index of the queue owned by the current thread. Worker threads own queues 1 to N,
+// while the main thread (and any other thread that submits jobs) uses queue 0.
+static thread_local uint32_t sQueueIndex = 0;
+
+void JobSpinLock::Lock()
+{
+    while (mFlag.test_and_set(std::memory_order_acquire))
+    {
+        std::this_thread::yield();
+    }
+}
+
+void JobSpinLock::Unlock()
+{
+    mFlag.clear(std::memory_order_release);
+}
+
+JobCounter::JobCounter() :
+    mCount(0)
+{
+
+}
+
+JobCounter::~JobCounter()
+{
+    OCT_ASSERT(IsDone());
+}
+
+bool JobCounter::IsDone() const
+{
+    return mCount.load() == 0;
+}
+
+void JobSystem::Create(int32_t numWorkers)
+{
+    Destroy();
+    sInstance = new JobSystem(numWorkers);
+}
+
+void JobSystem::Destroy()
+{
+    if (sInstance != nullptr)
+    {
+        delete sInstance;
+        sInstance = nullptr;
+    }
+}
+
+JobSystem* JobSystem::Get()
+{
+    return sInstance;
+}
+
+JobSystem::JobSystem(int32_t numRequestedWorkers) :
+    mNumQueuedJobs(0),
+    mNumSleeping(0),
+    mShutdown(false)
+{
+    uint32_t numWorkers = 0;
+
+#if JOB_SYSTEM_THREADED
+    if (numRequestedWorkers >= 0)
+    {
+        numWorkers = uint32_t(numRequestedWorkers);
+    }
+    else
+    {
+        // Leave one core for the main thread, which also runs jobs while waiting on them.
+        uint32_t numCores = std::thread::hardware_concurrency();
+        numWorkers = (numCores > 1) ? (numCores - 1) : 0;
+    }
+#endif
+
+    for (uint32_t i = 0; i < numWorkers + 1; ++i)
+    {
+        mQueues.push_back(new JobQueue());
+    }
+
+    if (numWorkers > 0)
+    {
+        mWakeSemaphore = SYS_CreateSemaphore(0);
+
+        for (uint32_t i = 0; i < numWorkers; ++i)
+        {
+            WorkerArgs* args = new WorkerArgs();
+            args->mJobSystem = this;
+            args->mQueueIndex = i + 1;
+            mWorkers.push_back(SYS_CreateThread(WorkerThreadFunc, args));
+        }
+    }
+
+    LogDebug("JobSystem created with %d worker threads", numWorkers);
+}
+
+JobSystem::~JobSystem()
+{
+    if (mWorkers.size() > 0)
+    {
+        mShutdown = true;
+        SYS_SignalSemaphore(mWakeSemaphore, uint32_t(mWorkers.size()));
+
+        for (uint32_t i = 0; i < mWorkers.size(); ++i)
+        {
+            SYS_JoinThread(mWorkers[i]);
+            SYS_DestroyThread(mWorkers[i]);
+        }
+
+        mWorkers.clear();
+
+        SYS_DestroySemaphore(mWakeSemaphore);
+        mWakeSemaphore = nullptr;
+    }
+
+    for (uint32_t i = 0; i < mQueues.size(); ++i)
+    {
+        OCT_ASSERT(mQueues[i]->mJobs.size() == 0);
+        delete mQueues[i];
+    }
+
+    mQueues.clear();
+}
+
+void JobSystem::Run(const JobFunc& func, JobCounter* counter)
+{
+    Job job;
+    job.mFunc = func;
+    job.mCounter = counter;
+
+    if (counter != nullptr)
+    {
+        counter->mCount++;
+    }
+
+    Schedule(job);
+}
+
+void JobSystem::RunAfter(JobCounter* dependency, const JobFunc& func, JobCounter* counter)
+{
+    Job job;
+    job.mFunc = func;
+    job.mCounter = counter;
+
+    if (counter != nullptr)
+    {
+        counter->mCount++;
+    }
+
+    bool scheduleNow = true;
+
+    if (dependency != nullptr)
+    {
+        // The final decrement happens under this lock (see FinishJob()), so the dependency
+        // either hasn't finished yet and will pick up the continuation, or it already has.
+        dependency->mLock.Lock();
+
+        if (!dependency->IsDone())
+        {
+            dependency->mContinuations.push_back(job);
+            scheduleNow = false;
+        }
+
+        dependency->mLock.Unlock();
+    }
+
+    if (scheduleNow)
+    {
+        Schedule(job);
+    }
+}
+
+void JobSystem::Wait(JobCounter* counter)
+{
+    while (!counter->IsDone())
+    {
+        if (!RunNextJob())
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    // The worker that finished the last job may still be inside the counter's lock.
+    // Wait for it to leave, since the counter is usually destroyed as soon as this returns.
+    counter->mLock.Lock();
+    counter->mLock.Unlock();
+}
+
+void JobSystem::ParallelFor(uint32_t count, uint32_t batchSize, const ParallelForFunc& func)
+{
+    if (count == 0)
+        return;
+
+    batchSize = (batchSize > 0) ? batchSize : 1;
+    uint32_t numBatches = (count + batchSize - 1) / batchSize;
+
+    if (numBatches == 1 || mWorkers.size() == 0)
+    {
+        func(0, count);
+        return;
+    }
+
+    // Instead of a job per batch, a few helper jobs pull batches until none are left.
+    // This keeps the scheduling cost independent of the batch count.
+    std::atomic<uint32_t> nextBatch(0);
+
+    auto processBatches = [&]()
+    {
+        while (true)
+        {
+            uint32_t batch = nextBatch.fetch_add(1);
+
+            if (batch >= numBatches)
+                break;
+
+            uint32_t start = batch * batchSize;
+            uint32_t end = start + batchSize;
+            end = (end < count) ? end : count;
+
+            func(start, end);
+        }
+    };
+
+    uint32_t numHelpers = numBatches - 1;
+    numHelpers = (numHelpers < mWorkers.size()) ? numHelpers : uint32_t(mWorkers.size());
+
+    JobCounter counter;
+
+    for (uint32_t i = 0; i < numHelpers; ++i)
+    {
+        Run(processBatches, &counter);
+    }
+
+    processBatches();
+    Wait(&counter);
+}
+
+uint32_t JobSystem::GetNumWorkers() const
+{
+    return uint32_t(mWorkers.size());
+}
+
+ThreadFuncRet JobSystem::WorkerThreadFunc(void* arg)
+{
+    WorkerArgs* args = (WorkerArgs*)arg;
+    JobSystem* jobSystem = args->mJobSystem;
+    sQueueIndex = args->mQueueIndex;
+    delete args;
+
+    while (!jobSystem->mShutdown)
+    {
+        if (jobSystem->RunNextJob())
+            continue;
+
+        // Register as sleeping before checking for work one last time, so that
+        // a job queued in between is guaranteed to see us and signal the semaphore.
+        jobSystem->mNumSleeping++;
+
+        if (jobSystem->mNumQueuedJobs.load() == 0 &&
+            !jobSystem->mShutdown)
+        {
+            SYS_WaitSemaphore(jobSystem->mWakeSemaphore);
+        }
+
+        jobSystem->mNumSleeping--;
+    }
+
+    THREAD_RETURN();
+}
+
+void JobSystem::Schedule(Job& job)
+{
+    if (mWorkers.size() == 0)
+    {
+        Execute(job);
+        return;
+    }
+
+    JobQueue* queue = mQueues[sQueueIndex];
+
+    mNumQueuedJobs++;
+    queue->mLock.Lock();
+    queue->mJobs.push_back(std::move(job));
+    queue->mLock.Unlock();
+
+    if (mNumSleeping.load() > 0)
+    {
+        SYS_SignalSemaphore(mWakeSemaphore, 1);
+    }
+}
+
+bool JobSystem::PopJob(uint32_t queueIndex, Job& outJob)
+{
+    JobQueue* queue = mQueues[queueIndex];
+    bool popped = false;
+
+    queue->mLock.Lock();
+    if (queue->mJobs.size() > 0)
+    {
+        outJob = std::move(queue->mJobs.back());
+        queue->mJobs.pop_back();
+        popped = true;
+    }
+    queue->mLock.Unlock();
+
+    if (popped)
+    {
+        mNumQueuedJobs--;
+    }
+
+    return popped;
+}
+
+bool JobSystem::StealJob(uint32_t thiefIndex, Job& outJob)
+{
+    const uint32_t numQueues = uint32_t(mQueues.size());
+
+    for (uint32_t i = 1; i < numQueues; ++i)
+    {
+        JobQueue* queue = mQueues[(thiefIndex + i) % numQueues];
+        bool stolen = false;
+
+        queue->mLock.Lock();
+        if (queue->mJobs.size() > 0)
+        {
+            outJob = std::move(queue->mJobs.front());
+            queue->mJobs.pop_front();
+            stolen = true;
+        }
+        queue->mLock.Unlock();
+
+        if (stolen)
+        {
+            mNumQueuedJobs--;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool JobSystem::RunNextJob()
+{
+    Job job;
+
+    if (mNumQueuedJobs.load() > 0 &&
+        (PopJob(sQueueIndex, job) || StealJob(sQueueIndex, job)))
+    {
+        Execute(job);
+        return true;
+    }
+
+    return false;
+}
+
+void JobSystem::Execute(Job& job)
+{
+    job.mFunc();
+    FinishJob(job.mCounter);
+}
+
+void JobSystem::FinishJob(JobCounter* counter)
+{
+    if (counter == nullptr)
+    {
+        return;
+    }
+
+    std::vector<Job> continuations;
+
+    // Decrement and take the continuations in one critical section. Publishing zero first would let
+    // Wait() return and the counter go out of scope while this thread is still using it.
+    counter->mLock.Lock();
+
+    if (counter->mCount.fetch_sub(1) == 1)
+    {
+        continuations.swap(counter->mContinuations);
+    }
+
+    counter->mLock.Unlock();
+
+    for (uint32_t i = 0; i < continuations.size(); ++i)
+    {
+        Schedule(continuations[i]);
+    }
+}
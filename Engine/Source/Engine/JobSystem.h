@@ -0,0 +1,118 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include <deque>
+#include <atomic>
+#include <functional>
+
+#include "System/SystemTypes.h"
+
+// Consoles only have a single core available to the game, so jobs run inline on the calling thread.
+#define JOB_SYSTEM_THREADED (PLATFORM_WINDOWS || PLATFORM_LINUX || PLATFORM_ANDROID)
+
+typedef std::function<void()> JobFunc;
+typedef std::function<void(uint32_t start, uint32_t end)> ParallelForFunc;
+
+class JobCounter;
+
+struct Job
+{
+    JobFunc mFunc;
+    JobCounter* mCounter = nullptr;
+};
+
+// Tiny spin lock for the job queues. Critical sections are only a few instructions long.
+class JobSpinLock
+{
+public:
+
+    void Lock();
+    void Unlock();
+
+private:
+
+    std::atomic_flag mFlag = ATOMIC_FLAG_INIT;
+};
+
+// Tracks a group of jobs. The count goes up when a job is added with this counter and down when it finishes.
+// Jobs can be scheduled to run once the counter reaches zero with JobSystem::RunAfter().
+// A counter must outlive its jobs, so always Wait() on it before it goes out of scope.
+class JobCounter
+{
+public:
+
+    JobCounter();
+    ~JobCounter();
+
+    bool IsDone() const;
+
+private:
+
+    friend class JobSystem;
+
+    std::atomic<int32_t> mCount;
+    JobSpinLock mLock;
+    std::vector<Job> mContinuations;
+};
+
+// Each thread owns a queue. Owners push and pop at the back (most recent job, still in cache)
+// while idle threads steal from the front of other queues.
+struct JobQueue
+{
+    JobSpinLock mLock;
+    std::deque<Job> mJobs;
+};
+
+class JobSystem
+{
+public:
+
+    // numWorkers < 0 creates one worker per core, minus one for the main thread.
+    static void Create(int32_t numWorkers = -1);
+    static void Destroy();
+    static JobSystem* Get();
+
+    // Queues a job. If counter is not null, it is incremented now and decremented when the job finishes.
+    void Run(const JobFunc& func, JobCounter* counter = nullptr);
+
+    // Queues a job that will only start once dependency reaches zero.
+    void RunAfter(JobCounter* dependency, const JobFunc& func, JobCounter* counter = nullptr);
+
+    // Runs other jobs on the calling thread until the counter reaches zero.
+    void Wait(JobCounter* counter);
+
+    // Splits [0, count) into batches of up to batchSize elements and calls func(start, end) for each batch.
+    // The calling thread processes batches too and only returns once every batch has finished.
+    void ParallelFor(uint32_t count, uint32_t batchSize, const ParallelForFunc& func);
+
+    uint32_t GetNumWorkers() const;
+
+private:
+
+    struct WorkerArgs
+    {
+        JobSystem* mJobSystem = nullptr;
+        uint32_t mQueueIndex = 0;
+    };
+
+    static JobSystem* sInstance;
+    JobSystem(int32_t numWorkers);
+    ~JobSystem();
+
+    static ThreadFuncRet WorkerThreadFunc(void* arg);
+
+    void Schedule(Job& job);
+    bool PopJob(uint32_t queueIndex, Job& outJob);
+    bool StealJob(uint32_t thiefIndex, Job& outJob);
+    bool RunNextJob();
+    void Execute(Job& job);
+    void FinishJob(JobCounter* counter);
+
+    std::vector<ThreadObject*> mWorkers;
+    std::vector<JobQueue*> mQueues;
+    SemaphoreObject* mWakeSemaphore = nullptr;
+    std::atomic<uint32_t> mNumQueuedJobs;
+    std::atomic<uint32_t> mNumSleeping;
+    std::atomic<bool> mShutdown;
+};
@@ -0,0 +1,362 @@
+#include "LuaBytecode.h"
+#include "Engine.h"
+#include "Log.h"
+#include "Utilities.h"
+
+#include <string.h>
+
+uint32_t HashScriptSource(const char* data, uint32_t size)
+{
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+
+    for (uint32_t i = 0; i < size; ++i)
+    {
+        hash ^= uint8_t(data[i]);
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+bool IsCookedScript(const char* data, uint32_t size)
+{
+    return size >= COOKED_SCRIPT_HEADER_SIZE &&
+        memcmp(data, COOKED_SCRIPT_MAGIC, 4) == 0;
+}
+
+uint32_t GetCookedScriptHash(const char* data, uint32_t size)
+{
+    OCT_ASSERT(IsCookedScript(data, size));
+
+    // Always little endian, independent of the platform it was cooked for.
+    const uint8_t* bytes = (const uint8_t*)data + 4;
+    return uint32_t(bytes[0]) |
+        (uint32_t(bytes[1]) << 8) |
+        (uint32_t(bytes[2]) << 16) |
+        (uint32_t(bytes[3]) << 24);
+}
+
+#if EDITOR
+
+// Lua 5.3 type tags for constants in a dumped chunk (see lobject.h)
+static const uint8_t kLuaConstNil = LUA_TNIL;
+static const uint8_t kLuaConstBool = LUA_TBOOLEAN;
+static const uint8_t kLuaConstFloat = LUA_TNUMBER | (0 << 4);
+static const uint8_t kLuaConstInt = LUA_TNUMBER | (1 << 4);
+static const uint8_t kLuaConstShortStr = LUA_TSTRING | (0 << 4);
+static const uint8_t kLuaConstLongStr = LUA_TSTRING | (1 << 4);
+
+// Rewrites a chunk produced by lua_dump() on this machine for a platform with a different size_t
+// width or byte order. With LUA_32BITS, every other field the loader checks is already 4 bytes everywhere.
+class BytecodeTranscoder
+{
+public:
+
+    BytecodeTranscoder(const std::string& src, uint32_t dstSizeT, bool dstBigEndian, std::string& dst) :
+        mSrc((const uint8_t*)src.data()),
+        mSrcSize(src.size()),
+        mDst(dst),
+        mDstSizeT(dstSizeT),
+        mDstBigEndian(dstBigEndian)
+    {
+
+    }
+
+    bool Transcode()
+    {
+        // Header
+        CopyBytes(4); // LUA_SIGNATURE
+        CopyBytes(2); // LUAC_VERSION, LUAC_FORMAT
+        CopyBytes(6); // LUAC_DATA
+
+        uint8_t intSize = CopyByte();
+        mSrcSizeT = ReadByte();
+        WriteByte(uint8_t(mDstSizeT));
+        uint8_t instructionSize = CopyByte();
+        uint8_t integerSize = CopyByte();
+        uint8_t numberSize = CopyByte();
+
+        if (intSize != 4 || instructionSize != 4 || integerSize != 4 || numberSize != 4 ||
+            (mSrcSizeT != 4 && mSrcSizeT != 8))
+        {
+            LogError("Unsupported Lua bytecode layout, is LUA_32BITS defined?");
+            return false;
+        }
+
+        CopyWord(); // LUAC_INT
+        CopyWord(); // LUAC_NUM
+
+        CopyByte(); // Number of upvalues
+        CopyFunction();
+
+        return !mError && mPos == mSrcSize;
+    }
+
+private:
+
+    uint8_t ReadByte()
+    {
+        if (mPos + 1 > mSrcSize)
+        {
+            mError = true;
+            return 0;
+        }
+
+        return mSrc[mPos++];
+    }
+
+    uint64_t ReadValue(uint32_t size)
+    {
+        if (mPos + size > mSrcSize)
+        {
+            mError = true;
+            mPos = mSrcSize;
+            return 0;
+        }
+
+        uint64_t value = 0;
+
+        if (size == 4)
+        {
+            uint32_t value32;
+            memcpy(&value32, mSrc + mPos, 4);
+            value = value32;
+        }
+        else
+        {
+            memcpy(&value, mSrc + mPos, 8);
+        }
+
+        mPos += size;
+        return value;
+    }
+
+    void WriteByte(uint8_t value)
+    {
+        mDst.push_back(char(value));
+    }
+
+    void WriteValue(uint64_t value, uint32_t size)
+    {
+        for (uint32_t i = 0; i < size; ++i)
+        {
+            uint32_t shift = mDstBigEndian ? (size - 1 - i) * 8 : i * 8;
+            WriteByte(uint8_t(value >> shift));
+        }
+    }
+
+    uint8_t CopyByte()
+    {
+        uint8_t value = ReadByte();
+        WriteByte(value);
+        return value;
+    }
+
+    void CopyBytes(size_t count)
+    {
+        if (mPos + count > mSrcSize)
+        {
+            mError = true;
+            mPos = mSrcSize;
+            return;
+        }
+
+        mDst.append((const char*)mSrc + mPos, count);
+        mPos += count;
+    }
+
+    // int, Instruction, lua_Integer and lua_Number are all 4 bytes.
+    uint32_t CopyWord()
+    {
+        uint32_t value = uint32_t(ReadValue(4));
+        WriteValue(value, 4);
+        return value;
+    }
+
+    int32_t CopyCount()
+    {
+        int32_t count = int32_t(CopyWord());
+
+        if (count < 0)
+        {
+            mError = true;
+            count = 0;
+        }
+
+        return count;
+    }
+
+    void CopyString()
+    {
+        uint8_t shortSize = CopyByte();
+        uint64_t size = shortSize;
+
+        if (shortSize == 0xFF)
+        {
+            size = ReadValue(mSrcSizeT);
+
+            if (mDstSizeT == 4 && size > 0xFFFFFFFFull)
+            {
+                mError = true;
+                return;
+            }
+
+            WriteValue(size, mDstSizeT);
+        }
+
+        // The size includes the terminating zero, which isn't saved.
+        if (size > 0)
+        {
+            CopyBytes(size_t(size - 1));
+        }
+    }
+
+    void CopyFunction()
+    {
+        CopyString(); // Source
+        CopyWord(); // linedefined
+        CopyWord(); // lastlinedefined
+        CopyBytes(3); // numparams, is_vararg, maxstacksize
+
+        int32_t numCode = CopyCount();
+        for (int32_t i = 0; i < numCode && !mError; ++i)
+        {
+            CopyWord();
+        }
+
+        int32_t numConstants = CopyCount();
+        for (int32_t i = 0; i < numConstants && !mError; ++i)
+        {
+            uint8_t type = CopyByte();
+
+            if (type == kLuaConstNil)
+            {
+
+            }
+            else if (type == kLuaConstBool)
+            {
+                CopyByte();
+            }
+            else if (type == kLuaConstFloat || type == kLuaConstInt)
+            {
+                CopyWord();
+            }
+            else if (type == kLuaConstShortStr || type == kLuaConstLongStr)
+            {
+                CopyString();
+            }
+            else
+            {
+                mError = true;
+            }
+        }
+
+        int32_t numUpvalues = CopyCount();
+        CopyBytes(size_t(numUpvalues) * 2); // instack, idx
+
+        int32_t numProtos = CopyCount();
+        for (int32_t i = 0; i < numProtos && !mError; ++i)
+        {
+            CopyFunction();
+        }
+
+        // Debug info
+        int32_t numLineInfo = CopyCount();
+        for (int32_t i = 0; i < numLineInfo && !mError; ++i)
+        {
+            CopyWord();
+        }
+
+        int32_t numLocVars = CopyCount();
+        for (int32_t i = 0; i < numLocVars && !mError; ++i)
+        {
+            CopyString();
+            CopyWord(); // startpc
+            CopyWord(); // endpc
+        }
+
+        int32_t numUpvalueNames = CopyCount();
+        for (int32_t i = 0; i < numUpvalueNames && !mError; ++i)
+        {
+            CopyString();
+        }
+    }
+
+    const uint8_t* mSrc = nullptr;
+    size_t mSrcSize = 0;
+    size_t mPos = 0;
+    std::string& mDst;
+    uint32_t mSrcSizeT = 0;
+    uint32_t mDstSizeT = 0;
+    bool mDstBigEndian = false;
+    bool mError = false;
+};
+
+static int WriteBytecode(lua_State* L, const void* data, size_t size, void* userData)
+{
+    std::string* bytecode = (std::string*)userData;
+    bytecode->append((const char*)data, size);
+    return 0;
+}
+
+static uint32_t GetPlatformSizeT(Platform platform)
+{
+    switch (platform)
+    {
+    case Platform::Windows:
+    case Platform::Linux:
+    case Platform::Android:
+        return 8;
+    case Platform::Count:
+        return uint32_t(sizeof(size_t));
+    default:
+        return 4;
+    }
+}
+
+bool CookScript(const std::string& source, const std::string& chunkName, Platform platform, std::string& outCookedScript)
+{
+    bool success = false;
+    outCookedScript.clear();
+
+#if LUA_ENABLED
+    lua_State* L = GetLua();
+
+    if (luaL_loadbuffer(L, source.c_str(), source.size(), chunkName.c_str()) != LUA_OK)
+    {
+        LogError("Failed to compile %s: %s", chunkName.c_str(), lua_tostring(L, -1));
+        lua_pop(L, 1);
+        return false;
+    }
+
+    // Consoles don't ship with the debugger, so drop line info and local names there.
+    bool strip = (platform == Platform::GameCube ||
+        platform == Platform::Wii ||
+        platform == Platform::N3DS);
+
+    std::string bytecode;
+    lua_dump(L, WriteBytecode, &bytecode, strip ? 1 : 0);
+    lua_pop(L, 1);
+
+    uint32_t hash = HashScriptSource(source.c_str(), uint32_t(source.size()));
+
+    outCookedScript.append(COOKED_SCRIPT_MAGIC, 4);
+    outCookedScript.push_back(char(hash & 0xff));
+    outCookedScript.push_back(char((hash >> 8) & 0xff));
+    outCookedScript.push_back(char((hash >> 16) & 0xff));
+    outCookedScript.push_back(char((hash >> 24) & 0xff));
+
+    BytecodeTranscoder transcoder(bytecode, GetPlatformSizeT(platform), IsBigEndianPlatform(platform), outCookedScript);
+    success = transcoder.Transcode();
+
+    if (!success)
+    {
+        LogError("Failed to convert bytecode for %s", chunkName.c_str());
+        outCookedScript.clear();
+    }
+#endif
+
+    return success;
+}
+#endif
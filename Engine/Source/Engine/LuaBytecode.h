@@ -0,0 +1,23 @@
+#pragma once
+
+#include <stdint.h>
+#include <string>
+
+#include "EngineTypes.h"
+
+// Cooked scripts are a small header (magic + hash of the source they were compiled from)
+// followed by Lua bytecode for the target platform. The magic starts with the same escape
+// byte as Lua's own signature, so a cooked script is never mistaken for source.
+#define COOKED_SCRIPT_MAGIC "\x1bOCT"
+#define COOKED_SCRIPT_HEADER_SIZE 8
+
+uint32_t HashScriptSource(const char* data, uint32_t size);
+
+bool IsCookedScript(const char* data, uint32_t size);
+uint32_t GetCookedScriptHash(const char* data, uint32_t size);
+
+#if EDITOR
+// Compiles source and writes a cooked script whose bytecode matches the size_t width and byte order
+// of the target platform. Debug info is stripped for consoles. Returns false if the source doesn't compile.
+bool CookScript(const std::string& source, const std::string& chunkName, Platform platform, std::string& outCookedScript);
+#endif
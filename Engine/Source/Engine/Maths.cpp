@@ -336,6 +336,59 @@ void Maths::SeedRand(uint32_t seed)
     srand(seed);
 }
 
+uint32_t Maths::MakeRandState(uint32_t seed)
+{
+    // Murmur3 finalizer, so similar seeds don't start out with similar sequences.
+    seed ^= seed >> 16;
+    seed *= 0x85ebca6bu;
+    seed ^= seed >> 13;
+    seed *= 0xc2b2ae35u;
+    seed ^= seed >> 16;
+
+    // Xorshift gets stuck at zero.
+    return (seed != 0) ? seed : 1;
+}
+
+float Maths::RandFloat(uint32_t& state)
+{
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return float(state >> 8) / float(1 << 24);
+}
+
+float Maths::RandRange(uint32_t& state, float min, float max)
+{
+    return min + (max - min) * RandFloat(state);
+}
+
+glm::vec2 Maths::RandRange(uint32_t& state, glm::vec2 min, glm::vec2 max)
+{
+    glm::vec2 retRand;
+    retRand.x = RandRange(state, min.x, max.x);
+    retRand.y = RandRange(state, min.y, max.y);
+    return retRand;
+}
+
+glm::vec3 Maths::RandRange(uint32_t& state, glm::vec3 min, glm::vec3 max)
+{
+    glm::vec3 retRand;
+    retRand.x = RandRange(state, min.x, max.x);
+    retRand.y = RandRange(state, min.y, max.y);
+    retRand.z = RandRange(state, min.z, max.z);
+    return retRand;
+}
+
+glm::vec4 Maths::RandRange(uint32_t& state, glm::vec4 min, glm::vec4 max)
+{
+    glm::vec4 retRand;
+    retRand.x = RandRange(state, min.x, max.x);
+    retRand.y = RandRange(state, min.y, max.y);
+    retRand.z = RandRange(state, min.z, max.z);
+    retRand.w = RandRange(state, min.w, max.w);
+    return retRand;
+}
+
 float Maths::RotateYawTowardDirection(float srcYaw, glm::vec3 dir, float speed, float deltaTime)
 {
     float targetYaw = RADIANS_TO_DEGREES * atan2f(-dir.x, -dir.z);
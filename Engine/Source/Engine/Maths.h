@@ -38,6 +38,15 @@ public:
 
     static void SeedRand(uint32_t seed);
 
+    // Same as RandRange() but drawing from a caller owned xorshift state instead of rand(),
+    // so they're safe to use from job threads. MakeRandState() scrambles a seed into a valid state.
+    static uint32_t MakeRandState(uint32_t seed);
+    static float RandFloat(uint32_t& state);
+    static float RandRange(uint32_t& state, float min, float max);
+    static glm::vec2 RandRange(uint32_t& state, glm::vec2 min, glm::vec2 max);
+    static glm::vec3 RandRange(uint32_t& state, glm::vec3 min, glm::vec3 max);
+    static glm::vec4 RandRange(uint32_t& state, glm::vec4 min, glm::vec4 max);
+
     static float Damp(float source, float target, float smoothing, float deltaTime);
     static glm::vec3 Damp(glm::vec3 source, glm::vec3 target, float smoothing, float deltaTime);
     static glm::vec4 Damp(glm::vec4 source, glm::vec4 target, float smoothing, float deltaTime);
@@ -0,0 +1,253 @@
+#include "MeshBlocks.h"
+#include "Stream.h"
+#include "Log.h"
+#include "Assertion.h"
+#include "Utilities.h"
+
+#include "System/SystemConstants.h"
+
+#include <stddef.h>
+#include <string.h>
+#include <vector>
+
+static_assert(sizeof(Vertex) % 4 == 0, "Vertex must be made of 4 byte words");
+static_assert(sizeof(VertexColor) % 4 == 0, "VertexColor must be made of 4 byte words");
+static_assert(sizeof(VertexSkinned) % 4 == 0, "VertexSkinned must be made of 4 byte words");
+
+static bool IsNativeBigEndian()
+{
+    return ENDIAN_SWAP != 0;
+}
+
+static uint32_t GetBlockVertexSize(VertexType type)
+{
+    switch (type)
+    {
+    case VertexType::Vertex: return sizeof(Vertex);
+    case VertexType::VertexColor: return sizeof(VertexColor);
+    case VertexType::VertexSkinned: return sizeof(VertexSkinned);
+    default: OCT_ASSERT(0); return 0;
+    }
+}
+
+static void SwapWords32(uint8_t* data, uint32_t numWords)
+{
+    for (uint32_t i = 0; i < numWords; ++i)
+    {
+        uint8_t* word = data + i * 4;
+        uint8_t c0 = word[0];
+        uint8_t c1 = word[1];
+        word[0] = word[3];
+        word[1] = word[2];
+        word[2] = c1;
+        word[3] = c0;
+    }
+}
+
+static void SwapWords16(uint8_t* data, uint32_t numWords)
+{
+    for (uint32_t i = 0; i < numWords; ++i)
+    {
+        uint8_t* word = data + i * 2;
+        uint8_t c0 = word[0];
+        word[0] = word[1];
+        word[1] = c0;
+    }
+}
+
+static void SwapIndices(uint8_t* data, uint32_t numIndices, uint32_t indexSize)
+{
+    if (indexSize == 2)
+    {
+        SwapWords16(data, numIndices);
+    }
+    else
+    {
+        SwapWords32(data, numIndices);
+    }
+}
+
+static void SwapVertices(uint8_t* data, uint32_t numVertices, VertexType type)
+{
+    if (type == VertexType::VertexSkinned)
+    {
+        // Bone indices are single bytes, everything around them is a 4 byte word.
+        for (uint32_t i = 0; i < numVertices; ++i)
+        {
+            uint8_t* vertex = data + i * sizeof(VertexSkinned);
+            SwapWords32(vertex, offsetof(VertexSkinned, mBoneIndices) / 4);
+            SwapWords32(vertex + offsetof(VertexSkinned, mBoneWeights), MAX_BONE_INFLUENCES);
+        }
+    }
+    else
+    {
+        SwapWords32(data, numVertices * GetBlockVertexSize(type) / 4);
+    }
+}
+
+uint32_t GetPlatformIndexSize(Platform platform)
+{
+    switch (platform)
+    {
+    case Platform::Windows:
+    case Platform::Linux:
+    case Platform::Android:
+        return 4;
+    case Platform::Count:
+        return uint32_t(sizeof(IndexType));
+    default:
+        return 2;
+    }
+}
+
+void WriteVertexBlock(Stream& stream, const void* vertices, uint32_t numVertices, VertexType type, Platform platform)
+{
+    uint32_t vertexSize = GetBlockVertexSize(type);
+    bool bigEndian = IsBigEndianPlatform(platform);
+
+    stream.WriteBool(bigEndian);
+    stream.WriteUint8(uint8_t(vertexSize));
+
+    if (bigEndian == IsNativeBigEndian())
+    {
+        stream.WriteBlock((const uint8_t*)vertices, numVertices * vertexSize);
+    }
+    else
+    {
+        std::vector<uint8_t> data((const uint8_t*)vertices, (const uint8_t*)vertices + numVertices * vertexSize);
+        SwapVertices(data.data(), numVertices, type);
+        stream.WriteBlock(data.data(), uint32_t(data.size()));
+    }
+}
+
+void ReadVertexBlock(Stream& stream, void* vertices, uint32_t numVertices, VertexType type)
+{
+    bool bigEndian = stream.ReadBool();
+    uint32_t vertexSize = stream.ReadUint8();
+    uint32_t expectedSize = GetBlockVertexSize(type);
+
+    if (vertexSize != expectedSize)
+    {
+        LogError("Vertex block has %d byte vertices, expected %d", vertexSize, expectedSize);
+        stream.SkipBlock(numVertices * vertexSize);
+        memset(vertices, 0, numVertices * expectedSize);
+        return;
+    }
+
+    stream.ReadBlock((uint8_t*)vertices, numVertices * vertexSize);
+
+    if (bigEndian != IsNativeBigEndian())
+    {
+        SwapVertices((uint8_t*)vertices, numVertices, type);
+    }
+}
+
+void WriteIndexBlock(Stream& stream, const IndexType* indices, uint32_t numIndices, Platform platform)
+{
+    uint32_t indexSize = GetPlatformIndexSize(platform);
+    bool bigEndian = IsBigEndianPlatform(platform);
+
+    std::vector<uint8_t> data(numIndices * indexSize);
+
+    for (uint32_t i = 0; i < numIndices; ++i)
+    {
+        if (indexSize == 2)
+        {
+            uint16_t index = uint16_t(indices[i]);
+            memcpy(&data[i * 2], &index, 2);
+        }
+        else
+        {
+            uint32_t index = uint32_t(indices[i]);
+            memcpy(&data[i * 4], &index, 4);
+        }
+    }
+
+    if (bigEndian != IsNativeBigEndian())
+    {
+        SwapIndices(data.data(), numIndices, indexSize);
+    }
+
+    stream.WriteBool(bigEndian);
+    stream.WriteUint8(uint8_t(indexSize));
+    stream.WriteBlock(data.data(), uint32_t(data.size()));
+}
+
+void ReadIndexBlock(Stream& stream, IndexType* indices, uint32_t numIndices)
+{
+    bool bigEndian = stream.ReadBool();
+    uint32_t indexSize = stream.ReadUint8();
+    bool swap = (bigEndian != IsNativeBigEndian());
+
+    if (indexSize == sizeof(IndexType))
+    {
+        stream.ReadBlock((uint8_t*)indices, numIndices * indexSize);
+
+        if (swap)
+        {
+            SwapIndices((uint8_t*)indices, numIndices, indexSize);
+        }
+    }
+    else if (indexSize == 2 || indexSize == 4)
+    {
+        // Saved for a platform with a different index width.
+        std::vector<uint8_t> data(numIndices * indexSize);
+        stream.ReadBlock(data.data(), uint32_t(data.size()));
+
+        if (swap)
+        {
+            SwapIndices(data.data(), numIndices, indexSize);
+        }
+
+        for (uint32_t i = 0; i < numIndices; ++i)
+        {
+            if (indexSize == 2)
+            {
+                uint16_t index;
+                memcpy(&index, &data[i * 2], 2);
+                indices[i] = IndexType(index);
+            }
+            else
+            {
+                uint32_t index;
+                memcpy(&index, &data[i * 4], 4);
+                indices[i] = IndexType(index);
+            }
+        }
+    }
+    else
+    {
+        LogError("Index block has invalid index size %d", indexSize);
+        stream.SkipBlock(numIndices * indexSize);
+        memset(indices, 0, numIndices * sizeof(IndexType));
+    }
+}
+
+void WriteFloatBlock(Stream& stream, const float* values, uint32_t numValues, Platform platform)
+{
+    bool bigEndian = IsBigEndianPlatform(platform);
+
+    stream.WriteBool(bigEndian);
+
+    if (bigEndian == IsNativeBigEndian())
+    {
+        stream.WriteBlock((const uint8_t*)values, numValues * sizeof(float));
+    }
+    else
+    {
+        std::vector<uint8_t> data((const uint8_t*)values, (const uint8_t*)(values + numValues));
+        SwapWords32(data.data(), numValues);
+        stream.WriteBlock(data.data(), uint32_t(data.size()));
+    }
+}
+
+void ReadFloatBlock(Stream& stream, float* values, uint32_t numValues)
+{
+    bool bigEndian = stream.ReadBool();
+    stream.ReadBlock((uint8_t*)values, numValues * sizeof(float));
+
+    if (bigEndian != IsNativeBigEndian())
+    {
+        SwapWords32((uint8_t*)values, numValues);
+    }
+}
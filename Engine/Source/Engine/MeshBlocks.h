@@ -0,0 +1,25 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "EngineTypes.h"
+#include "Vertex.h"
+#include "Graphics/GraphicsTypes.h"
+
+class Stream;
+
+// Vertex, index and instance arrays are saved as aligned blocks in the byte order and index width
+// of the platform they are cooked for, so loading them is a single memcpy into the destination array.
+// Each block records its layout, so a block saved for a different platform is still converted on load.
+
+uint32_t GetPlatformIndexSize(Platform platform);
+
+// Only Vertex, VertexColor and VertexSkinned are supported.
+void WriteVertexBlock(Stream& stream, const void* vertices, uint32_t numVertices, VertexType type, Platform platform);
+void ReadVertexBlock(Stream& stream, void* vertices, uint32_t numVertices, VertexType type);
+
+void WriteIndexBlock(Stream& stream, const IndexType* indices, uint32_t numIndices, Platform platform);
+void ReadIndexBlock(Stream& stream, IndexType* indices, uint32_t numIndices);
+
+void WriteFloatBlock(Stream& stream, const float* values, uint32_t numValues, Platform platform);
+void ReadFloatBlock(Stream& stream, float* values, uint32_t numValues);
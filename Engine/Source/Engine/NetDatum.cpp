@@ -3,9 +3,183 @@
 #include "AssetRef.h"
 #include "Log.h"
 #include "Script.h"
+#include "AssetManager.h"
+#include "NetworkManager.h"
+#include "Utilities.h"
 
 #include <string.h>
 
+// Changed words wider than a byte are sent as a zigzag encoded difference from the baseline
+// when it is small enough: 0 + 6 bits, 10 + 12 bits, otherwise 11 + the full word.
+static const uint32_t kDeltaSmallBits = 6;
+static const uint32_t kDeltaMediumBits = 12;
+
+static uint32_t GetWordMask(uint32_t bits)
+{
+    return (bits >= 32) ? 0xffffffff : ((1u << bits) - 1);
+}
+
+static void WriteWordDelta(BitStream& stream, uint32_t word, uint32_t base, uint32_t bits)
+{
+    if (word == base)
+    {
+        stream.WriteBool(false);
+        return;
+    }
+
+    stream.WriteBool(true);
+
+    if (bits <= 8)
+    {
+        stream.WriteBits(word, bits);
+        return;
+    }
+
+    // Wrap the difference to the word width and sign extend it.
+    uint32_t mask = GetWordMask(bits);
+    uint32_t diff = (word - base) & mask;
+    bool negative = (diff & (1u << (bits - 1))) != 0;
+    int32_t signedDiff = negative ? int32_t(diff | ~mask) : int32_t(diff);
+    uint32_t zigzag = (uint32_t(signedDiff) << 1) ^ (negative ? 0xffffffff : 0);
+
+    if (zigzag < (1u << kDeltaSmallBits))
+    {
+        stream.WriteBool(false);
+        stream.WriteBits(zigzag, kDeltaSmallBits);
+    }
+    else if (zigzag < (1u << kDeltaMediumBits))
+    {
+        stream.WriteBool(true);
+        stream.WriteBool(false);
+        stream.WriteBits(zigzag, kDeltaMediumBits);
+    }
+    else
+    {
+        stream.WriteBool(true);
+        stream.WriteBool(true);
+        stream.WriteBits(word, bits);
+    }
+}
+
+static uint32_t ReadWordDelta(BitStream& stream, uint32_t base, uint32_t bits)
+{
+    if (!stream.ReadBool())
+    {
+        return base;
+    }
+
+    if (bits <= 8)
+    {
+        return stream.ReadBits(bits);
+    }
+
+    uint32_t zigzag = 0;
+
+    if (!stream.ReadBool())
+    {
+        zigzag = stream.ReadBits(kDeltaSmallBits);
+    }
+    else if (!stream.ReadBool())
+    {
+        zigzag = stream.ReadBits(kDeltaMediumBits);
+    }
+    else
+    {
+        return stream.ReadBits(bits);
+    }
+
+    uint32_t diff = (zigzag >> 1) ^ ((zigzag & 1) ? 0xffffffff : 0);
+    return (base + diff) & GetWordMask(bits);
+}
+
+static uint32_t FloatToWord(float value, const NetQuantization& quant)
+{
+    if (quant.mMode == NetQuantizeMode::Range)
+    {
+        return BitStream::QuantizeFloat(value, quant.mMin, quant.mMax, quant.mBits);
+    }
+
+    uint32_t word = 0;
+    memcpy(&word, &value, sizeof(float));
+    return word;
+}
+
+static float WordToFloat(uint32_t word, const NetQuantization& quant)
+{
+    if (quant.mMode == NetQuantizeMode::Range)
+    {
+        return BitStream::DequantizeFloat(word, quant.mMin, quant.mMax, quant.mBits);
+    }
+
+    float value = 0.0f;
+    memcpy(&value, &word, sizeof(float));
+    return value;
+}
+
+static uint32_t IntToWord(int32_t value, const NetQuantization& quant)
+{
+    if (quant.mMode == NetQuantizeMode::RangedInt)
+    {
+        int32_t min = int32_t(quant.mMin);
+        int32_t max = int32_t(quant.mMax);
+        return uint32_t(glm::clamp(value, min, max) - min);
+    }
+
+    return uint32_t(value);
+}
+
+static int32_t WordToInt(uint32_t word, const NetQuantization& quant)
+{
+    if (quant.mMode == NetQuantizeMode::RangedInt)
+    {
+        int32_t min = int32_t(quant.mMin);
+        int32_t max = int32_t(quant.mMax);
+        return int32_t(glm::min(word, uint32_t(max - min)) + uint32_t(min));
+    }
+
+    return int32_t(word);
+}
+
+static std::string GetPackedAssetName(const AssetRef& assetRef)
+{
+    Asset* asset = assetRef.Get();
+    return (asset != nullptr && !asset->IsTransient()) ? asset->GetName() : std::string();
+}
+
+NetQuantization NetQuantization::Range(float min, float max, uint8_t bits)
+{
+    OCT_ASSERT(max > min);
+    OCT_ASSERT(bits > 0 && bits <= 31);
+
+    NetQuantization quant;
+    quant.mMode = NetQuantizeMode::Range;
+    quant.mMin = min;
+    quant.mMax = max;
+    quant.mBits = bits;
+    return quant;
+}
+
+NetQuantization NetQuantization::RangedInt(int32_t min, int32_t max)
+{
+    OCT_ASSERT(max >= min);
+
+    NetQuantization quant;
+    quant.mMode = NetQuantizeMode::RangedInt;
+    quant.mMin = float(min);
+    quant.mMax = float(max);
+    return quant;
+}
+
+NetQuantization NetQuantization::Rotation(uint8_t bits)
+{
+    OCT_ASSERT(bits > 0 && bits <= 31);
+
+    NetQuantization quant;
+    quant.mMode = NetQuantizeMode::Rotation;
+    quant.mBits = bits;
+    return quant;
+}
+
 NetDatum::NetDatum()
 {
 
@@ -113,6 +287,256 @@ void NetDatum::PostReplicate()
     }
 }
 
+NetDatum& NetDatum::SetQuantization(const NetQuantization& quantization)
+{
+    mQuantization = quantization;
+    return *this;
+}
+
+const NetQuantization& NetDatum::GetQuantization() const
+{
+    return mQuantization;
+}
+
+uint32_t NetDatum::GetNumPackedWords() const
+{
+    return mCount * GetWordsPerElement();
+}
+
+bool NetDatum::IsPackedBlob() const
+{
+    return (mType == DatumType::String || mType == DatumType::Asset);
+}
+
+void NetDatum::GatherPackedWords(uint32_t* outWords) const
+{
+    const uint32_t wordsPerElement = GetWordsPerElement();
+    const NetQuantization& quant = mQuantization;
+
+    for (uint32_t e = 0; e < mCount; ++e)
+    {
+        uint32_t* words = outWords + e * wordsPerElement;
+
+        switch (mType)
+        {
+            case DatumType::Integer: words[0] = IntToWord(mData.i[e], quant); break;
+            case DatumType::Short: words[0] = IntToWord(mData.sh[e], quant); break;
+            case DatumType::Byte: words[0] = IntToWord(mData.by[e], quant); break;
+            case DatumType::Bool: words[0] = mData.b[e] ? 1 : 0; break;
+            case DatumType::Float: words[0] = FloatToWord(mData.f[e], quant); break;
+            case DatumType::Vector2D:
+            {
+                words[0] = FloatToWord(mData.v2[e].x, quant);
+                words[1] = FloatToWord(mData.v2[e].y, quant);
+                break;
+            }
+            case DatumType::Vector:
+            {
+                if (quant.mMode == NetQuantizeMode::Rotation)
+                {
+                    BitStream::QuantizeQuat(glm::quat(mData.v3[e] * DEGREES_TO_RADIANS), quant.mBits, words);
+                }
+                else
+                {
+                    words[0] = FloatToWord(mData.v3[e].x, quant);
+                    words[1] = FloatToWord(mData.v3[e].y, quant);
+                    words[2] = FloatToWord(mData.v3[e].z, quant);
+                }
+                break;
+            }
+            case DatumType::Color:
+            {
+                words[0] = FloatToWord(mData.v4[e].x, quant);
+                words[1] = FloatToWord(mData.v4[e].y, quant);
+                words[2] = FloatToWord(mData.v4[e].z, quant);
+                words[3] = FloatToWord(mData.v4[e].w, quant);
+                break;
+            }
+            case DatumType::Pointer:
+            {
+                RTTI* rtti = mData.p[e];
+                Node* node = rtti ? rtti->As<Node>() : nullptr;
+                words[0] = node ? node->GetNetId() : INVALID_NET_ID;
+                break;
+            }
+            case DatumType::String: words[0] = OctHashString(mData.s[e].c_str()); break;
+            case DatumType::Asset: words[0] = OctHashString(GetPackedAssetName(mData.as[e]).c_str()); break;
+
+            // Tables and functions can't be replicated.
+            case DatumType::Table:
+            case DatumType::Function:
+            case DatumType::Count: break;
+        }
+
+        for (uint32_t w = 0; w < wordsPerElement; ++w)
+        {
+            words[w] &= GetWordMask(GetWordBits(w));
+        }
+    }
+}
+
+void NetDatum::WritePacked(BitStream& stream, const uint32_t* words, const uint32_t* baseWords) const
+{
+    if (IsPackedBlob())
+    {
+        for (uint32_t e = 0; e < mCount; ++e)
+        {
+            stream.WriteString((mType == DatumType::String) ? mData.s[e] : GetPackedAssetName(mData.as[e]));
+        }
+
+        return;
+    }
+
+    const uint32_t wordsPerElement = GetWordsPerElement();
+
+    for (uint32_t i = 0; i < mCount * wordsPerElement; ++i)
+    {
+        uint32_t bits = GetWordBits(i % wordsPerElement);
+
+        if (baseWords != nullptr)
+        {
+            WriteWordDelta(stream, words[i], baseWords[i], bits);
+        }
+        else
+        {
+            stream.WriteBits(words[i], bits);
+        }
+    }
+}
+
+void NetDatum::ReadPacked(BitStream& stream, const uint32_t* baseWords, uint32_t* outWords, Datum& outValue) const
+{
+    if (IsPackedBlob())
+    {
+        std::string value;
+
+        for (uint32_t e = 0; e < mCount; ++e)
+        {
+            stream.ReadString(value);
+            outWords[e] = OctHashString(value.c_str());
+
+            if (mType == DatumType::String)
+            {
+                outValue.PushBack(value);
+            }
+            else
+            {
+                outValue.PushBack(value.empty() ? (Asset*)nullptr : LoadAsset(value));
+            }
+        }
+
+        return;
+    }
+
+    const uint32_t wordsPerElement = GetWordsPerElement();
+
+    for (uint32_t i = 0; i < mCount * wordsPerElement; ++i)
+    {
+        uint32_t bits = GetWordBits(i % wordsPerElement);
+        outWords[i] = baseWords ? ReadWordDelta(stream, baseWords[i], bits) : stream.ReadBits(bits);
+    }
+
+    UnpackWords(outWords, outValue);
+}
+
+void NetDatum::UnpackWords(const uint32_t* words, Datum& outValue) const
+{
+    OCT_ASSERT(!IsPackedBlob());
+
+    const uint32_t wordsPerElement = GetWordsPerElement();
+    const NetQuantization& quant = mQuantization;
+
+    for (uint32_t e = 0; e < mCount; ++e)
+    {
+        const uint32_t* w = words + e * wordsPerElement;
+
+        switch (mType)
+        {
+            case DatumType::Integer: outValue.PushBack(WordToInt(w[0], quant)); break;
+            case DatumType::Short:
+            {
+                int32_t value = (quant.mMode == NetQuantizeMode::RangedInt) ? WordToInt(w[0], quant) : int16_t(uint16_t(w[0]));
+                outValue.PushBack(int16_t(value));
+                break;
+            }
+            case DatumType::Byte: outValue.PushBack(uint8_t(WordToInt(w[0], quant))); break;
+            case DatumType::Bool: outValue.PushBack(w[0] != 0); break;
+            case DatumType::Float: outValue.PushBack(WordToFloat(w[0], quant)); break;
+            case DatumType::Vector2D: outValue.PushBack(glm::vec2(WordToFloat(w[0], quant), WordToFloat(w[1], quant))); break;
+            case DatumType::Vector:
+            {
+                if (quant.mMode == NetQuantizeMode::Rotation)
+                {
+                    glm::quat rotation = BitStream::DequantizeQuat(w, quant.mBits);
+                    outValue.PushBack(glm::vec3(glm::eulerAngles(rotation) * RADIANS_TO_DEGREES));
+                }
+                else
+                {
+                    outValue.PushBack(glm::vec3(WordToFloat(w[0], quant), WordToFloat(w[1], quant), WordToFloat(w[2], quant)));
+                }
+                break;
+            }
+            case DatumType::Color:
+            {
+                outValue.PushBack(glm::vec4(
+                    WordToFloat(w[0], quant),
+                    WordToFloat(w[1], quant),
+                    WordToFloat(w[2], quant),
+                    WordToFloat(w[3], quant)));
+                break;
+            }
+            case DatumType::Pointer: outValue.PushBack((RTTI*)NetworkManager::Get()->GetNetNode(NetId(w[0]))); break;
+
+            default: break;
+        }
+    }
+}
+
+uint32_t NetDatum::GetWordsPerElement() const
+{
+    switch (mType)
+    {
+        case DatumType::Vector2D: return 2;
+        case DatumType::Vector: return (mQuantization.mMode == NetQuantizeMode::Rotation) ? 4 : 3;
+        case DatumType::Color: return 4;
+
+        case DatumType::Table:
+        case DatumType::Function:
+        case DatumType::Count: return 0;
+
+        default: return 1;
+    }
+}
+
+uint32_t NetDatum::GetWordBits(uint32_t word) const
+{
+    const NetQuantization& quant = mQuantization;
+    const bool range = (quant.mMode == NetQuantizeMode::Range);
+    const uint32_t intRangeBits = BitStream::GetBitsRequired(uint32_t(int32_t(quant.mMax) - int32_t(quant.mMin)));
+
+    switch (mType)
+    {
+        case DatumType::Integer: return (quant.mMode == NetQuantizeMode::RangedInt) ? intRangeBits : 32;
+        case DatumType::Short: return (quant.mMode == NetQuantizeMode::RangedInt) ? intRangeBits : 16;
+        case DatumType::Byte: return (quant.mMode == NetQuantizeMode::RangedInt) ? intRangeBits : 8;
+        case DatumType::Bool: return 1;
+        case DatumType::Float:
+        case DatumType::Vector2D:
+        case DatumType::Color: return range ? quant.mBits : 32;
+        case DatumType::Vector:
+        {
+            if (quant.mMode == NetQuantizeMode::Rotation)
+            {
+                return (word == 0) ? 2 : quant.mBits;
+            }
+
+            return range ? quant.mBits : 32;
+        }
+
+        default: return 32;
+    }
+}
+
 void NetDatum::Destroy()
 {
     if (mPrevData.vp != nullptr)
@@ -1,9 +1,33 @@
 #pragma once
 
 #include "Datum.h"
+#include "BitStream.h"
 
 #include <string>
 
+enum class NetQuantizeMode : uint8_t
+{
+    None,
+    Range,      // Float / vector components mapped onto [mMin, mMax] with mBits each
+    RangedInt,  // Integer / short / byte values clamped to [mMin, mMax]
+    Rotation,   // Euler angles (degrees) sent as a smallest three quaternion with mBits per component
+
+    Count
+};
+
+// How a replicated datum is packed when packed replication is enabled.
+struct NetQuantization
+{
+    static NetQuantization Range(float min, float max, uint8_t bits);
+    static NetQuantization RangedInt(int32_t min, int32_t max);
+    static NetQuantization Rotation(uint8_t bits);
+
+    NetQuantizeMode mMode = NetQuantizeMode::None;
+    uint8_t mBits = 0;
+    float mMin = 0.0f;
+    float mMax = 0.0f;
+};
+
 class NetDatum : public Datum
 {
 public:
@@ -17,13 +41,30 @@ public:
         bool alwaysReplicate = false);
     bool ShouldReplicate() const;
     void PostReplicate();
+
+    NetDatum& SetQuantization(const NetQuantization& quantization);
+    const NetQuantization& GetQuantization() const;
+
+    // Packed replication. Every element is quantized into a fixed number of words so a node's
+    // state is a flat word array that can be delta encoded against a baseline.
+    // Strings and assets are "blobs": their single word is a hash and the value is always sent in full.
+    uint32_t GetNumPackedWords() const;
+    bool IsPackedBlob() const;
+    void GatherPackedWords(uint32_t* outWords) const;
+    void WritePacked(BitStream& stream, const uint32_t* words, const uint32_t* baseWords) const;
+    void ReadPacked(BitStream& stream, const uint32_t* baseWords, uint32_t* outWords, Datum& outValue) const;
+    void UnpackWords(const uint32_t* words, Datum& outValue) const;
     
 protected:
     virtual void Destroy() override;
 
     DatumData mPrevData = {};
     uint32_t mPrevCount = 0;
+    uint32_t GetWordsPerElement() const;
+    uint32_t GetWordBits(uint32_t word) const;
+
     bool mAlwaysReplicate = false;
+    NetQuantization mQuantization;
 };
 
 class ScriptNetDatum : public NetDatum
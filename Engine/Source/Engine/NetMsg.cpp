@@ -647,3 +647,95 @@ void NetMsgAck::Execute(NetHost sender)
     NetMsg::Execute(sender);
     NetworkManager::Get()->HandleAck(sender, mSequenceNumber);
 }
+
+void NetMsgReplicatePacked::Read(Stream& stream)
+{
+    NetMsg::Read(stream);
+    mNodeNetId = stream.ReadUint32();
+    mSequence = stream.ReadUint8();
+    mBaseline = stream.ReadUint8();
+    mFlags = stream.ReadUint8();
+    mSize = stream.ReadUint16();
+
+    // Like NetMsgReplicate, assume the receive buffer persists until Execute() is called.
+    if (stream.GetPos() + mSize <= stream.GetSize())
+    {
+        mData = stream.GetData() + stream.GetPos();
+        stream.SetPos(stream.GetPos() + mSize);
+    }
+    else
+    {
+        LogWarning("Truncated ReplicatePacked message.");
+        mData = nullptr;
+        mSize = 0;
+        stream.SetPos(stream.GetSize());
+    }
+}
+
+void NetMsgReplicatePacked::Write(Stream& stream) const
+{
+    NetMsg::Write(stream);
+    stream.WriteUint32(mNodeNetId);
+    stream.WriteUint8(mSequence);
+    stream.WriteUint8(mBaseline);
+    stream.WriteUint8(mFlags);
+    stream.WriteUint16(mSize);
+    stream.WriteBytes((const uint8_t*)mData, mSize);
+
+    OCT_ASSERT(stream.GetPos() < OCT_MAX_MSG_BODY_SIZE);
+}
+
+void NetMsgReplicatePacked::Execute(NetHost sender)
+{
+    NetMsg::Execute(sender);
+
+    if (mData != nullptr)
+    {
+        NetworkManager::Get()->HandleReplicatePacked(sender, *this);
+    }
+}
+
+bool NetMsgReplicatePacked::IsReliable() const
+{
+    return mReliable;
+}
+
+void NetMsgReplicateAck::Read(Stream& stream)
+{
+    NetMsg::Read(stream);
+    uint32_t numAcks = glm::min<uint32_t>(stream.ReadUint8(), MaxAcks);
+
+    mNetIds.resize(numAcks);
+    mSequences.resize(numAcks);
+
+    for (uint32_t i = 0; i < numAcks; ++i)
+    {
+        mNetIds[i] = stream.ReadUint32();
+        mSequences[i] = stream.ReadUint8();
+    }
+}
+
+void NetMsgReplicateAck::Write(Stream& stream) const
+{
+    NetMsg::Write(stream);
+
+    OCT_ASSERT(mNetIds.size() == mSequences.size());
+    OCT_ASSERT(mNetIds.size() <= MaxAcks);
+    stream.WriteUint8(uint8_t(mNetIds.size()));
+
+    for (uint32_t i = 0; i < mNetIds.size(); ++i)
+    {
+        stream.WriteUint32(mNetIds[i]);
+        stream.WriteUint8(mSequences[i]);
+    }
+}
+
+void NetMsgReplicateAck::Execute(NetHost sender)
+{
+    NetMsg::Execute(sender);
+
+    for (uint32_t i = 0; i < mNetIds.size(); ++i)
+    {
+        NetworkManager::Get()->HandleReplicateAck(sender, mNetIds[i], mSequences[i]);
+    }
+}
@@ -34,6 +34,8 @@ enum class NetMsgType : uint8_t
     InvokeScript,
     Broadcast,
     Ack,
+    ReplicatePacked,
+    ReplicateAck,
 
     Count
 };
@@ -186,3 +188,38 @@ struct NetMsgAck : public NetMsg
 
     uint16_t mSequenceNumber = 0;
 };
+
+// Bit packed, quantized replicated state of one node (native data followed by script data).
+// When mFlags has BaselineFlag, values are delta encoded against the snapshot mBaseline
+// that the client previously acknowledged.
+struct NetMsgReplicatePacked : public NetMsg
+{
+    NET_MSG_INTERFACE(ReplicatePacked);
+
+    virtual bool IsReliable() const override;
+
+    static const uint8_t BaselineFlag = 0x01;
+    static const uint8_t ScriptFlag = 0x02;
+    static const uint32_t HeaderSize = 10;
+
+    NetId mNodeNetId = INVALID_NET_ID;
+    uint8_t mSequence = 0;
+    uint8_t mBaseline = 0;
+    uint8_t mFlags = 0;
+    bool mReliable = false;
+
+    // Points at the packed bits. When reading, this points into the receive buffer.
+    const char* mData = nullptr;
+    uint16_t mSize = 0;
+};
+
+// Client -> server acknowledgement of received packed snapshots.
+struct NetMsgReplicateAck : public NetMsg
+{
+    NET_MSG_INTERFACE(ReplicateAck);
+
+    static const uint32_t MaxAcks = 64;
+
+    std::vector<NetId> mNetIds;
+    std::vector<uint8_t> mSequences;
+};
@@ -7,12 +7,16 @@
 #include "Profiler.h"
 #include "Maths.h"
 #include "Script.h"
+#include "Nodes/3D/Node3d.h"
+#include "BitStream.h"
 
 #include "LuaBindings/Network_Lua.h"
 
 #include "Network/NetPlatformEpic.h"
 #include "Network/NetPlatformSteam.h"
 
+#include <algorithm>
+
 #ifdef SendMessage
 #undef SendMessage
 #endif
@@ -292,6 +296,8 @@ void NetworkManager::PostTickUpdate(float deltaTime)
 
     if (mNetStatus == NetStatus::Client)
     {
+        SendReplicateAcks();
+
         mPingTimer += deltaTime;
         if (mPingTimer >= OCT_PING_INTERVAL)
         {
@@ -833,6 +839,149 @@ bool NetworkManager::IsIncrementalReplicationEnabled() const
     return mIncrementalReplication;
 }
 
+void NetworkManager::EnableRelevancy(bool enable)
+{
+    if (mRelevancy != enable)
+    {
+        // Clients' relevant sets track what has been spawned on them, so toggling mid-session
+        // would either drop those sets and respawn everything or leave nodes spawned that are never destroyed.
+        if (mNetStatus != NetStatus::Local)
+        {
+            LogError("NetworkManager::EnableRelevancy() called while in a session. Enable it before opening a session.");
+            OCT_ASSERT(0);
+            return;
+        }
+
+        mRelevancy = enable;
+        mRelevancyGrid.clear();
+        mAlwaysRelevantNodes.clear();
+    }
+}
+
+bool NetworkManager::IsRelevancyEnabled() const
+{
+    return mRelevancy;
+}
+
+void NetworkManager::SetRelevancyRadius(float radius)
+{
+    OCT_ASSERT(radius > 0.0f);
+    mRelevancyRadius = glm::max(radius, 0.001f);
+
+    // Cell size matches the radius, so the grid needs to be rebuilt from scratch.
+    mRelevancyGrid.clear();
+}
+
+float NetworkManager::GetRelevancyRadius() const
+{
+    return mRelevancyRadius;
+}
+
+void NetworkManager::SetRelevancyBudget(uint32_t bytes)
+{
+    mRelevancyBudget = bytes;
+}
+
+uint32_t NetworkManager::GetRelevancyBudget() const
+{
+    return mRelevancyBudget;
+}
+
+void NetworkManager::SetClientViewPosition(NetHostId hostId, glm::vec3 position)
+{
+    NetClient* client = FindNetClient(hostId);
+
+    if (client != nullptr)
+    {
+        client->mViewPosition = position;
+        client->mViewNetId = INVALID_NET_ID;
+    }
+}
+
+void NetworkManager::SetClientViewNode(NetHostId hostId, Node* node)
+{
+    NetClient* client = FindNetClient(hostId);
+
+    if (client != nullptr)
+    {
+        client->mViewNetId = (node != nullptr) ? node->GetNetId() : INVALID_NET_ID;
+    }
+}
+
+static NetRelevantNode* FindRelevantNode(std::vector<NetRelevantNode>& relevantNodes, NetId netId)
+{
+    auto it = std::lower_bound(relevantNodes.begin(), relevantNodes.end(), netId,
+        [](const NetRelevantNode& entry, NetId id) { return entry.mNetId < id; });
+
+    return (it != relevantNodes.end() && it->mNetId == netId) ? &(*it) : nullptr;
+}
+
+bool NetworkManager::IsRelevant(NetHostId hostId, Node* node) const
+{
+    if (!mRelevancy)
+    {
+        return true;
+    }
+
+    for (uint32_t i = 0; i < mClients.size(); ++i)
+    {
+        if (mClients[i].mHost.mId == hostId)
+        {
+            const std::vector<NetRelevantNode>& relevantNodes = mClients[i].mRelevantNodes;
+            NetId netId = node->GetNetId();
+
+            auto it = std::lower_bound(relevantNodes.begin(), relevantNodes.end(), netId,
+                [](const NetRelevantNode& entry, NetId id) { return entry.mNetId < id; });
+
+            return (it != relevantNodes.end() && it->mNetId == netId);
+        }
+    }
+
+    return false;
+}
+
+void NetworkManager::EnablePackedReplication(bool enable)
+{
+    mPackedReplication = enable;
+}
+
+bool NetworkManager::IsPackedReplicationEnabled() const
+{
+    return mPackedReplication;
+}
+
+void NetworkManager::SetPositionQuantization(float extent, uint8_t bits)
+{
+    // An extent or bit count of 0 sends full precision positions.
+    mPositionExtent = extent;
+    mPositionBits = bits;
+}
+
+void NetworkManager::SetRotationQuantization(uint8_t bits)
+{
+    mRotationBits = bits;
+}
+
+NetQuantization NetworkManager::GetPositionQuantization() const
+{
+    if (mPositionExtent > 0.0f && mPositionBits > 0)
+    {
+        return NetQuantization::Range(-mPositionExtent, mPositionExtent, mPositionBits);
+    }
+
+    return NetQuantization();
+}
+
+NetQuantization NetworkManager::GetRotationQuantization() const
+{
+    if (mRotationBits > 0)
+    {
+        return NetQuantization::Rotation(mRotationBits);
+    }
+
+    return NetQuantization();
+}
+
 int32_t NetworkManager::GetBytesSent() const
 {
     return mBytesSent;
@@ -908,7 +1057,8 @@ void NetworkManager::AddNetNode(Node* node, NetId netId)
                 mNetNodeMap.insert({ netId, node });
 
                 // The server needs to send Spawn messages for newly added network actors.
-                if (NetIsServer())
+                // With relevancy enabled, spawns are sent per client once the node becomes relevant.
+                if (NetIsServer() && !mRelevancy)
                 {
                     NetworkManager::Get()->SendSpawnMessage(node, nullptr);
                 }
@@ -928,7 +1078,33 @@ void NetworkManager::RemoveNetNode(Node* node)
         // Send destroy message
         if (NetIsServer())
         {
-            NetworkManager::Get()->SendDestroyMessage(node, nullptr);
+            if (mRelevancy)
+            {
+                // Only clients that spawned the node need to destroy it.
+                for (uint32_t i = 0; i < mClients.size(); ++i)
+                {
+                    std::vector<NetRelevantNode>& relevantNodes = mClients[i].mRelevantNodes;
+                    NetRelevantNode* entry = FindRelevantNode(relevantNodes, netId);
+
+                    if (entry != nullptr)
+                    {
+                        SendDestroyMessage(node, &mClients[i]);
+                        relevantNodes.erase(relevantNodes.begin() + (entry - relevantNodes.data()));
+                    }
+                }
+            }
+            else
+            {
+                NetworkManager::Get()->SendDestroyMessage(node, nullptr);
+            }
+        }
+
+        // Drop any packed replication baselines for this node.
+        mBaselines.erase(netId);
+
+        for (uint32_t i = 0; i < mClients.size(); ++i)
+        {
+            mClients[i].mBaselines.erase(netId);
         }
 
         // This node was assigned a net id, so it should exist in our net actor map.
@@ -1011,9 +1187,10 @@ void NetworkManager::HandleConnect(NetHost host, uint32_t gameCode, uint32_t ver
                 return false;
             };
 
+            // With relevancy enabled, nodes are spawned as they become relevant in UpdateRelevancy().
             World* world = GetWorld(0);
             Node* worldRoot = world ? world->GetRootNode() : nullptr;
-            if (worldRoot != nullptr)
+            if (worldRoot != nullptr && !mRelevancy)
             {
                 // Make sure to traverse non-inverted because the parents need to be replicated first.
                 worldRoot->Traverse(spawnNode, false);
@@ -1188,6 +1365,19 @@ void NetworkManager::HandleReady(NetHost host)
             // Resend any pending outgoing reliable messages
             ResendOutgoingReliablePackets(client);
 
+            if (mRelevancy)
+            {
+                // Queue the full state of everything the client has spawned so far.
+                // ReplicateRelevantNodes() will send it in priority order.
+                for (uint32_t i = 0; i < client->mRelevantNodes.size(); ++i)
+                {
+                    client->mRelevantNodes[i].mStale = true;
+                    client->mRelevantNodes[i].mReliable = true;
+                }
+
+                return;
+            }
+
             // Now that client has loaded the level(s) and spawned actors,
             // Forcefully replicate the initial state of all actors
             auto repNode = [&](Node* node) -> bool
@@ -1326,7 +1516,21 @@ void NetworkManager::SendInvokeMsg(NetMsgInvoke& msg, Node* node, NetFunc* func,
     }
     case NetFuncType::Multicast:
     {
-        SendMessageToAllClients(&msg);
+        if (mRelevancy)
+        {
+            // Like replication, only clients the node is relevant to (and so spawned on) get the call.
+            for (uint32_t i = 0; i < mClients.size(); ++i)
+            {
+                if (FindRelevantNode(mClients[i].mRelevantNodes, msg.mNodeNetId) != nullptr)
+                {
+                    SendMessage(&msg, &mClients[i]);
+                }
+            }
+        }
+        else
+        {
+            SendMessageToAllClients(&msg);
+        }
         break;
     }
 
@@ -1445,6 +1649,11 @@ void NetworkManager::UpdateReplication(float deltaTime)
     Node* incRepNode = nullptr;
     World* world = GetWorld(0);
 
+    if (mRelevancy)
+    {
+        UpdateRelevancy(world);
+    }
+
     if (mIncrementalReplication)
     {
         uint32_t& incTier = world->GetIncrementalRepTier();
@@ -1484,9 +1693,20 @@ void NetworkManager::UpdateReplication(float deltaTime)
         {
             Node* node = repVector[repIndex];
             bool forceRep = (node == incRepNode);
-            bool nodeReplicated = ReplicateNode(node, INVALID_HOST_ID, forceRep, false);
 
-            if (nodeReplicated)
+            if (mRelevancy)
+            {
+                // Changes are queued per client and sent by priority in ReplicateRelevantNodes().
+                MarkRelevantNodeStale(node, forceRep);
+            }
+            else if (mPackedReplication)
+            {
+                if (ReplicateNodePacked(node, forceRep))
+                {
+                    numNodesReplicated++;
+                }
+            }
+            else if (ReplicateNode(node, INVALID_HOST_ID, forceRep, false))
             {
                 numNodesReplicated++;
             }
@@ -1525,6 +1745,11 @@ void NetworkManager::UpdateReplication(float deltaTime)
         uint32_t count = (vectorSize + 3) / 4;
         replicateTier(repVector, repIndex, count);
     }
+
+    if (mRelevancy)
+    {
+        ReplicateRelevantNodes(deltaTime);
+    }
 }
 
 template<typename T>
@@ -1608,141 +1833,1018 @@ bool NetworkManager::ReplicateNode(Node* node, NetId hostId, bool force, bool re
     return nodeReplicated;
 }
 
-void NetworkManager::UpdateHostConnections(float deltaTime)
+static uint64_t GetRelevancyCellKey(glm::ivec3 cell)
 {
-    float clampedDeltaTime = glm::min(deltaTime, 0.333f);
+    // 21 bits per axis is plenty for any reasonable radius / world size.
+    return (uint64_t(uint32_t(cell.x) & 0x1fffff) << 42) |
+        (uint64_t(uint32_t(cell.y) & 0x1fffff) << 21) |
+        uint64_t(uint32_t(cell.z) & 0x1fffff);
+}
 
-    if (IsServer())
-    {
-        for (int32_t i = int32_t(mClients.size()) - 1; i >= 0; --i)
-        {
-            mClients[i].mTimeSinceLastMsg += clampedDeltaTime;
+static glm::ivec3 GetRelevancyCell(glm::vec3 position, float cellSize)
+{
+    return glm::ivec3(glm::floor(position / cellSize));
+}
 
-            if (mClients[i].mTimeSinceLastMsg >= mInactiveTimeout ||
-                mClients[i].mOutgoingPackets.size() > sMaxOutgoingPackets)
-            {
-                Kick(mClients[i].mHost.mId, NetMsgKick::Reason::Timeout);
-            }
-        }
+static uint32_t GetNodeDepth(Node* node)
+{
+    uint32_t depth = 0;
+
+    while (node->GetParent() != nullptr)
+    {
+        node = node->GetParent();
+        ++depth;
     }
-    else if (IsClient())
+
+    return depth;
+}
+
+template<typename T>
+static bool HasDirtyData(const std::vector<T>& repData)
+{
+    for (uint32_t i = 0; i < repData.size(); ++i)
     {
-        mServer.mTimeSinceLastMsg += clampedDeltaTime;
-        if (mServer.mTimeSinceLastMsg >= mInactiveTimeout ||
-            mServer.mOutgoingPackets.size() > sMaxOutgoingPackets)
+        if (repData[i].ShouldReplicate())
         {
-            Disconnect();
-
-            if (mKickCallback.mFuncPointer != nullptr)
-            {
-                mKickCallback.mFuncPointer(NetMsgKick::Reason::Timeout);
-            }
-            if (mKickCallback.mScriptFunc.IsValid())
-            {
-                Datum reasonArg = (int32_t)NetMsgKick::Reason::Timeout;
-                mKickCallback.mScriptFunc.Call(1, &reasonArg);
-            }
+            return true;
         }
     }
+
+    return false;
 }
 
-int32_t NetworkManager::RecvFrom(char* buffer, uint32_t size, NetHost& outHost)
+template<typename T>
+static void PostReplicateData(std::vector<T>& repData)
 {
-    int32_t bytes = 0;
-
-    if (mInOnlineSession && mOnlinePlatform)
+    for (uint32_t i = 0; i < repData.size(); ++i)
     {
-        bytes = mOnlinePlatform->RecvMessage(buffer, size, outHost);
+        repData[i].PostReplicate();
     }
-    else
+}
+
+template<typename T>
+static uint32_t GetReplicationSize(const std::vector<T>& repData)
+{
+    uint32_t size = 0;
+
+    for (uint32_t i = 0; i < repData.size(); ++i)
     {
-        bytes = NET_SocketRecvFrom(mSocket, buffer, size, outHost.mIpAddress, outHost.mPort);
+        size += repData[i].GetSerializationSize() + sizeof(uint16_t);
     }
 
-    return bytes;
+    return (size > 0) ? (size + RepMsgHeaderSize) : 0;
 }
 
-void NetworkManager::SendTo(const NetHost& host, const char* buffer, uint32_t size)
+static float GetReplicationRateWeight(ReplicationRate rate)
 {
-    if (mInOnlineSession && mOnlinePlatform)
-    {
-        mOnlinePlatform->SendMessage(host, buffer, size);
-        mBytesSent += size;
-    }
-    else
+    // Matches the fraction of each tier that UpdateReplication() visits per frame.
+    switch (rate)
     {
-        mBytesSent += NET_SocketSendTo(
-            mSocket,
-            buffer,
-            size,
-            host.mIpAddress,
-            host.mPort);
+    case ReplicationRate::High: return 1.0f;
+    case ReplicationRate::Medium: return 0.5f;
+    case ReplicationRate::Low: return 0.25f;
+    default: return 1.0f;
     }
 }
 
-void NetworkManager::ProcessIncomingPackets(float deltaTime)
+void NetworkManager::UpdateRelevancy(World* world)
 {
-    int32_t bytes = 0;
-    NetHost sender;
+    SCOPED_STAT("UpdateRelevancy");
 
-    while ((bytes = RecvFrom(sRecvBuffer, OCT_RECV_BUFFER_SIZE, sender)) > 0)
-    {   
-        Stream stream(sRecvBuffer, bytes);
-        NetMsgType msgType = (NetMsgType) sRecvBuffer[OCT_PACKET_HEADER_SIZE];
+    Node* rootNode = world->GetRootNode();
+    const bool useCallback = (mRelevancyCallback.mFuncPointer != nullptr || mRelevancyCallback.mScriptFunc.IsValid());
 
-        // Find which NetHost the message was from.
-        // if there is no matching NetHost then ignore this message (unless it is a "Connect" message)
-        sender.mId = INVALID_HOST_ID;
+    // Rebuild the grid. Occupied cells are kept around so their vectors don't need to be reallocated
+    // every frame, but cells that were left empty last frame are erased so the map doesn't keep
+    // every cell a node has ever passed through.
+    for (auto it = mRelevancyGrid.begin(); it != mRelevancyGrid.end();)
+    {
+        if (it->second.empty())
+        {
+            it = mRelevancyGrid.erase(it);
+        }
+        else
+        {
+            it->second.clear();
+            ++it;
+        }
+    }
 
-        NetHostProfile* senderProfile = nullptr;
+    mAlwaysRelevantNodes.clear();
 
-        // Connect messages are only executed on the Server
-        bool connectMsg = mNetStatus == NetStatus::Server && 
-                          msgType == NetMsgType::Connect;
+    for (uint32_t r = 0; r < (uint32_t)ReplicationRate::Count; ++r)
+    {
+        const std::vector<Node*>& repVector = world->GetReplicatedNodeVector((ReplicationRate)r);
 
-        if (mNetStatus == NetStatus::Server)
+        for (uint32_t i = 0; i < repVector.size(); ++i)
         {
-            for (uint32_t i = 0; i < mClients.size(); ++i)
-            {
-                if ((mInOnlineSession && mClients[i].mHost.mOnlineId == sender.mOnlineId) || 
-                    (mClients[i].mHost.mIpAddress == sender.mIpAddress &&
-                    mClients[i].mHost.mPort == sender.mPort))
-                {
-                    OCT_ASSERT(mClients[i].mHost.mId != INVALID_HOST_ID);
-                    sender.mId = mClients[i].mHost.mId;
-                    mClients[i].mTimeSinceLastMsg = 0.0f;
+            Node* node = repVector[i];
 
-                    senderProfile = &mClients[i];
+            if (node->GetNetId() == INVALID_NET_ID)
+                continue;
 
-                    break;
-                }
+            // Nodes without a position can't be filtered by distance, and the root must always
+            // exist on clients since spawning a node without a parent replaces their root.
+            if (useCallback || !node->IsNode3D() || node == rootNode)
+            {
+                mAlwaysRelevantNodes.push_back(node);
             }
-        }
-        else
-        {
-            if ((mInOnlineSession && mServer.mHost.mOnlineId == sender.mOnlineId) ||
-                (mServer.mHost.mIpAddress == sender.mIpAddress &&
-                mServer.mHost.mPort == sender.mPort))
+            else
             {
-                OCT_ASSERT(mServer.mHost.mId == SERVER_HOST_ID);
-                sender.mId = mServer.mHost.mId;
-                mServer.mTimeSinceLastMsg = 0.0f;
-
-                senderProfile = &mServer;
+                Node3D* node3d = static_cast<Node3D*>(node);
+                glm::ivec3 cell = GetRelevancyCell(node3d->GetWorldPosition(), mRelevancyRadius);
+                mRelevancyGrid[GetRelevancyCellKey(cell)].push_back(node3d);
             }
         }
+    }
 
-        if (!connectMsg &&
-            (sender.mId == INVALID_HOST_ID || senderProfile == nullptr))
-        {
-            LogDebug("Unrecognized host: %08x:%u", sender.mIpAddress, sender.mPort);
-            continue;
-        }
+    static std::vector<Node*> sRelevantNodes;
+    const float radius2 = mRelevancyRadius * mRelevancyRadius;
 
-        uint16_t seq = stream.ReadUint16();
-        bool reliable = stream.ReadBool();
+    for (uint32_t c = 0; c < mClients.size(); ++c)
+    {
+        NetClient* client = &mClients[c];
+        sRelevantNodes.clear();
 
-        bool processMsg = false;
+        Node* viewNode = (client->mViewNetId != INVALID_NET_ID) ? GetNetNode(client->mViewNetId) : nullptr;
+
+        if (viewNode != nullptr)
+        {
+            if (viewNode->IsNode3D())
+            {
+                client->mViewPosition = static_cast<Node3D*>(viewNode)->GetWorldPosition();
+            }
+
+            // A client always needs to know about the node it is viewing from.
+            sRelevantNodes.push_back(viewNode);
+        }
+
+        if (useCallback)
+        {
+            for (uint32_t i = 0; i < mAlwaysRelevantNodes.size(); ++i)
+            {
+                Node* node = mAlwaysRelevantNodes[i];
+
+                if (node == rootNode || EvaluateRelevancyCallback(client, node))
+                {
+                    sRelevantNodes.push_back(node);
+                }
+            }
+        }
+        else
+        {
+            sRelevantNodes.insert(sRelevantNodes.end(), mAlwaysRelevantNodes.begin(), mAlwaysRelevantNodes.end());
+
+            // Cell size equals the radius, so the neighboring cells cover the whole view sphere.
+            glm::ivec3 center = GetRelevancyCell(client->mViewPosition, mRelevancyRadius);
+
+            for (int32_t x = -1; x <= 1; ++x)
+            {
+                for (int32_t y = -1; y <= 1; ++y)
+                {
+                    for (int32_t z = -1; z <= 1; ++z)
+                    {
+                        auto it = mRelevancyGrid.find(GetRelevancyCellKey(center + glm::ivec3(x, y, z)));
+
+                        if (it == mRelevancyGrid.end())
+                            continue;
+
+                        const std::vector<Node3D*>& cellNodes = it->second;
+
+                        for (uint32_t i = 0; i < cellNodes.size(); ++i)
+                        {
+                            glm::vec3 delta = cellNodes[i]->GetWorldPosition() - client->mViewPosition;
+
+                            if (glm::dot(delta, delta) <= radius2)
+                            {
+                                sRelevantNodes.push_back(cellNodes[i]);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        // Clients can only attach spawned nodes to parents they know about,
+        // so every replicated ancestor of a relevant node is relevant too.
+        uint32_t numDirect = uint32_t(sRelevantNodes.size());
+
+        for (uint32_t i = 0; i < numDirect; ++i)
+        {
+            Node* parent = sRelevantNodes[i]->GetParent();
+
+            while (parent != nullptr &&
+                parent->IsReplicated() &&
+                parent->GetNetId() != INVALID_NET_ID)
+            {
+                sRelevantNodes.push_back(parent);
+                parent = parent->GetParent();
+            }
+        }
+
+        std::sort(sRelevantNodes.begin(), sRelevantNodes.end(), [](Node* a, Node* b)
+        {
+            return a->GetNetId() < b->GetNetId();
+        });
+
+        sRelevantNodes.erase(std::unique(sRelevantNodes.begin(), sRelevantNodes.end()), sRelevantNodes.end());
+
+        UpdateRelevantSet(client, sRelevantNodes);
+    }
+}
+
+void NetworkManager::UpdateRelevantSet(NetClient* client, std::vector<Node*>& relevantNodes)
+{
+    static std::vector<NetRelevantNode> sNewSet;
+    static std::vector<Node*> sEntered;
+    static std::vector<Node*> sLeft;
+    sNewSet.clear();
+    sEntered.clear();
+    sLeft.clear();
+
+    std::vector<NetRelevantNode>& oldSet = client->mRelevantNodes;
+
+    // Both lists are sorted by net id, so a single merge pass finds what entered and left.
+    uint32_t o = 0;
+    uint32_t n = 0;
+
+    while (o < oldSet.size() || n < relevantNodes.size())
+    {
+        NetId oldId = (o < oldSet.size()) ? oldSet[o].mNetId : UINT32_MAX;
+        NetId newId = (n < relevantNodes.size()) ? relevantNodes[n]->GetNetId() : UINT32_MAX;
+
+        if (oldId < newId)
+        {
+            Node* node = GetNetNode(oldId);
+            if (node != nullptr)
+            {
+                sLeft.push_back(node);
+            }
+            ++o;
+        }
+        else if (newId < oldId)
+        {
+            NetRelevantNode entry;
+            entry.mNetId = newId;
+            entry.mStale = true;
+            entry.mReliable = true;
+            sNewSet.push_back(entry);
+            sEntered.push_back(relevantNodes[n]);
+            ++n;
+        }
+        else
+        {
+            sNewSet.push_back(oldSet[o]);
+            ++o;
+            ++n;
+        }
+    }
+
+    oldSet.swap(sNewSet);
+
+    if (sLeft.size() > 0)
+    {
+        // Children before parents, so the client never destroys a subtree we still track.
+        std::sort(sLeft.begin(), sLeft.end(), [](Node* a, Node* b)
+        {
+            return GetNodeDepth(a) > GetNodeDepth(b);
+        });
+
+        for (uint32_t i = 0; i < sLeft.size(); ++i)
+        {
+            SendDestroyMessage(sLeft[i], client);
+            client->mBaselines.erase(sLeft[i]->GetNetId());
+        }
+    }
+
+    if (sEntered.size() > 0)
+    {
+        // Parents before children, so the client can attach each node as it is spawned.
+        std::sort(sEntered.begin(), sEntered.end(), [](Node* a, Node* b)
+        {
+            return GetNodeDepth(a) < GetNodeDepth(b);
+        });
+
+        for (uint32_t i = 0; i < sEntered.size(); ++i)
+        {
+            SendSpawnMessage(sEntered[i], client);
+        }
+    }
+}
+
+bool NetworkManager::EvaluateRelevancyCallback(NetClient* client, Node* node)
+{
+    bool relevant = false;
+
+    if (mRelevancyCallback.mFuncPointer != nullptr)
+    {
+        relevant = mRelevancyCallback.mFuncPointer(client, node);
+    }
+    else if (mRelevancyCallback.mScriptFunc.IsValid())
+    {
+        Datum args[2];
+        WriteNetHostProfile(*client, args[0]);
+        args[1] = node;
+
+        Datum ret = mRelevancyCallback.mScriptFunc.CallR(2, args);
+        relevant = (ret.GetType() == DatumType::Bool) && ret.GetBool();
+    }
+
+    return relevant;
+}
+
+void NetworkManager::MarkRelevantNodeStale(Node* node, bool force)
+{
+    Script* script = node->GetScript();
+    bool scriptActive = (script != nullptr && script->IsActive());
+    bool needsForcedRep = node->NeedsForcedReplication();
+
+    bool dirty = force ||
+        needsForcedRep ||
+        HasDirtyData(node->GetReplicatedData()) ||
+        (scriptActive && HasDirtyData(script->GetReplicatedData()));
+
+    if (!dirty)
+        return;
+
+    NetId netId = node->GetNetId();
+
+    for (uint32_t i = 0; i < mClients.size(); ++i)
+    {
+        NetRelevantNode* entry = FindRelevantNode(mClients[i].mRelevantNodes, netId);
+
+        if (entry != nullptr)
+        {
+            entry->mStale = true;
+            entry->mReliable = entry->mReliable || needsForcedRep;
+        }
+    }
+
+    // The change has been recorded for every client that cares about it. Clients that don't
+    // will receive the full state if the node becomes relevant to them later.
+    PostReplicateData(node->GetReplicatedData());
+
+    if (scriptActive)
+    {
+        PostReplicateData(script->GetReplicatedData());
+    }
+
+    node->ClearForcedReplication();
+}
+
+void NetworkManager::ReplicateRelevantNodes(float deltaTime)
+{
+    SCOPED_STAT("ReplicateRelevantNodes");
+
+    struct StaleNode
+    {
+        NetRelevantNode* mEntry;
+        Node* mNode;
+    };
+
+    static std::vector<StaleNode> sStaleNodes;
+
+    for (uint32_t c = 0; c < mClients.size(); ++c)
+    {
+        NetClient* client = &mClients[c];
+
+        if (!client->mReady)
+            continue;
+
+        sStaleNodes.clear();
+
+        for (uint32_t i = 0; i < client->mRelevantNodes.size(); ++i)
+        {
+            NetRelevantNode& entry = client->mRelevantNodes[i];
+
+            if (!entry.mStale)
+                continue;
+
+            Node* node = GetNetNode(entry.mNetId);
+
+            if (node == nullptr)
+                continue;
+
+            // Nodes that wait longer, replicate more often, and are closer to the viewer win.
+            float proximity = 1.0f;
+
+            if (node->IsNode3D())
+            {
+                float dist = glm::distance(static_cast<Node3D*>(node)->GetWorldPosition(), client->mViewPosition);
+                proximity = 1.0f - glm::clamp(dist / mRelevancyRadius, 0.0f, 1.0f);
+            }
+
+            entry.mPriority += GetReplicationRateWeight(node->GetReplicationRate()) * (1.0f + proximity);
+            sStaleNodes.push_back({ &entry, node });
+        }
+
+        std::sort(sStaleNodes.begin(), sStaleNodes.end(), [](const StaleNode& a, const StaleNode& b)
+        {
+            return a.mEntry->mPriority > b.mEntry->mPriority;
+        });
+
+        uint32_t bytesSent = 0;
+
+        for (uint32_t i = 0; i < sStaleNodes.size(); ++i)
+        {
+            Node* node = sStaleNodes[i].mNode;
+            NetRelevantNode* entry = sStaleNodes[i].mEntry;
+
+            if (mPackedReplication)
+            {
+                if (bytesSent > 0 && bytesSent >= mRelevancyBudget)
+                    break;
+
+                uint32_t packedSize = ReplicateNodePacked(node, client, entry->mReliable, entry->mReliable);
+                bytesSent += packedSize;
+
+                // Unreliable deltas stay stale until the client has acknowledged the current state.
+                entry->mPriority = 0.0f;
+                entry->mStale = (packedSize > 0 && !entry->mReliable);
+                entry->mReliable = false;
+                continue;
+            }
+
+            uint32_t size = GetReplicationSize(node->GetReplicatedData());
+
+            Script* script = node->GetScript();
+            if (script != nullptr && script->IsActive())
+            {
+                size += GetReplicationSize(script->GetReplicatedData());
+            }
+
+            // Always send at least one node so a tiny budget can't starve a client.
+            if (bytesSent > 0 && bytesSent + size > mRelevancyBudget)
+                break;
+
+            // Dirty state is tracked per node rather than per client, so send the full state.
+            ReplicateNode(node, client->mHost.mId, true, entry->mReliable);
+            bytesSent += size;
+
+            entry->mPriority = 0.0f;
+            entry->mStale = false;
+            entry->mReliable = false;
+        }
+    }
+}
+
+template<typename T>
+static void GatherPackedWords(const std::vector<T>& repData, std::vector<uint32_t>& outWords)
+{
+    for (uint32_t i = 0; i < repData.size(); ++i)
+    {
+        uint32_t start = uint32_t(outWords.size());
+        outWords.resize(start + repData[i].GetNumPackedWords());
+        repData[i].GatherPackedWords(outWords.data() + start);
+    }
+}
+
+template<typename T>
+static uint32_t CountPackedWords(const std::vector<T>& repData)
+{
+    uint32_t numWords = 0;
+
+    for (uint32_t i = 0; i < repData.size(); ++i)
+    {
+        numWords += repData[i].GetNumPackedWords();
+    }
+
+    return numWords;
+}
+
+static void ResetBaseline(NetBaseline& baseline, uint32_t numWords)
+{
+    baseline.mAcked.clear();
+    baseline.mHistory.assign(numWords * NET_BASELINE_HISTORY, 0);
+    baseline.mHistoryValid = 0;
+    baseline.mNumWords = numWords;
+    baseline.mHasAck = false;
+}
+
+static void StoreBaselineHistory(NetBaseline& baseline, uint8_t seq, const uint32_t* words)
+{
+    uint32_t slot = seq % NET_BASELINE_HISTORY;
+
+    if (baseline.mNumWords > 0)
+    {
+        memcpy(&baseline.mHistory[slot * baseline.mNumWords], words, baseline.mNumWords * sizeof(uint32_t));
+    }
+
+    baseline.mHistorySeq[slot] = seq;
+    baseline.mHistoryValid |= uint16_t(1 << slot);
+}
+
+static const uint32_t* FindBaselineHistory(const NetBaseline& baseline, uint8_t seq)
+{
+    uint32_t slot = seq % NET_BASELINE_HISTORY;
+
+    if ((baseline.mHistoryValid & (1 << slot)) &&
+        baseline.mHistorySeq[slot] == seq)
+    {
+        return baseline.mHistory.data() + slot * baseline.mNumWords;
+    }
+
+    return nullptr;
+}
+
+// True if the client is known to hold these words: they match the acked snapshot and
+// every snapshot sent since then, so whichever of those the client applied last is correct.
+static bool IsPackedStateKnown(const NetBaseline& baseline, const uint32_t* words, uint32_t offset, uint32_t count)
+{
+    if (!baseline.mHasAck ||
+        uint8_t(baseline.mNextSeq - baseline.mAckedSeq) > NET_BASELINE_HISTORY ||
+        memcmp(baseline.mAcked.data() + offset, words + offset, count * sizeof(uint32_t)) != 0)
+    {
+        return false;
+    }
+
+    for (uint8_t seq = baseline.mAckedSeq + 1; seq != baseline.mNextSeq; ++seq)
+    {
+        const uint32_t* sent = FindBaselineHistory(baseline, seq);
+
+        if (sent == nullptr ||
+            memcmp(sent + offset, words + offset, count * sizeof(uint32_t)) != 0)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+template<typename T>
+static void WritePackedData(
+    BitStream& stream,
+    const std::vector<T>& repData,
+    const uint32_t* words,
+    const NetBaseline& baseline,
+    const uint32_t* baseWords,
+    uint32_t offset,
+    bool force)
+{
+    for (uint32_t i = 0; i < repData.size(); ++i)
+    {
+        const NetDatum& datum = repData[i];
+        uint32_t numWords = datum.GetNumPackedWords();
+
+        if (numWords == 0)
+            continue;
+
+        if (baseWords != nullptr)
+        {
+            bool present = force || memcmp(words + offset, baseWords + offset, numWords * sizeof(uint32_t)) != 0;
+
+            // Blobs can't be restored from the baseline on the client, so resend them if the
+            // client may be holding a newer, different value.
+            if (!present && datum.IsPackedBlob())
+            {
+                present = !IsPackedStateKnown(baseline, words, offset, numWords);
+            }
+
+            stream.WriteBool(present);
+
+            if (present)
+            {
+                datum.WritePacked(stream, words + offset, baseWords + offset);
+            }
+        }
+        else
+        {
+            datum.WritePacked(stream, words + offset, nullptr);
+        }
+
+        offset += numWords;
+    }
+}
+
+template<typename T>
+static void ReadPackedData(
+    BitStream& stream,
+    const std::vector<T>& repData,
+    const uint32_t* baseWords,
+    uint32_t* outWords,
+    NetMsgReplicate& applyMsg)
+{
+    applyMsg.mIndices.clear();
+    applyMsg.mData.clear();
+
+    for (uint32_t i = 0; i < repData.size(); ++i)
+    {
+        const NetDatum& datum = repData[i];
+        uint32_t numWords = datum.GetNumPackedWords();
+
+        if (numWords == 0)
+            continue;
+
+        bool present = (baseWords == nullptr) || stream.ReadBool();
+
+        if (present)
+        {
+            applyMsg.mIndices.push_back(uint16_t(i));
+            applyMsg.mData.push_back(Datum());
+            datum.ReadPacked(stream, baseWords, outWords, applyMsg.mData.back());
+        }
+        else
+        {
+            memcpy(outWords, baseWords, numWords * sizeof(uint32_t));
+
+            // A newer snapshot may have been applied since the baseline, so restore the baseline value.
+            if (!datum.IsPackedBlob())
+            {
+                applyMsg.mIndices.push_back(uint16_t(i));
+                applyMsg.mData.push_back(Datum());
+                datum.UnpackWords(outWords, applyMsg.mData.back());
+            }
+        }
+
+        outWords += numWords;
+        baseWords = baseWords ? (baseWords + numWords) : nullptr;
+    }
+
+    applyMsg.mNumVariables = uint16_t(applyMsg.mIndices.size());
+}
+
+bool NetworkManager::ReplicateNodePacked(Node* node, bool force)
+{
+    bool replicated = false;
+    bool needsForcedRep = node->NeedsForcedReplication();
+
+    for (uint32_t i = 0; i < mClients.size(); ++i)
+    {
+        // Clients get their initial state from HandleReady().
+        if (mClients[i].mReady &&
+            ReplicateNodePacked(node, &mClients[i], force || needsForcedRep, needsForcedRep) > 0)
+        {
+            replicated = true;
+        }
+    }
+
+    // Changes are tracked against per-client baselines, but keep ShouldReplicate() in sync.
+    PostReplicateData(node->GetReplicatedData());
+
+    Script* script = node->GetScript();
+    if (script != nullptr && script->IsActive())
+    {
+        PostReplicateData(script->GetReplicatedData());
+    }
+
+    node->ClearForcedReplication();
+
+    return replicated;
+}
+
+uint32_t NetworkManager::ReplicateNodePacked(Node* node, NetClient* client, bool force, bool reliable)
+{
+    static std::vector<uint32_t> sWords;
+    static BitStream sBits;
+    sWords.clear();
+    sBits.Reset();
+
+    std::vector<NetDatum>& repData = node->GetReplicatedData();
+
+    Script* script = node->GetScript();
+    std::vector<ScriptNetDatum>* scriptRepData = nullptr;
+    if (script != nullptr && script->IsActive())
+    {
+        scriptRepData = &script->GetReplicatedData();
+    }
+
+    GatherPackedWords(repData, sWords);
+    uint32_t numNativeWords = uint32_t(sWords.size());
+
+    if (scriptRepData != nullptr)
+    {
+        GatherPackedWords(*scriptRepData, sWords);
+    }
+
+    const uint32_t numWords = uint32_t(sWords.size());
+    NetBaseline& baseline = client->mBaselines[node->GetNetId()];
+
+    if (baseline.mNumWords != numWords ||
+        baseline.mHistory.size() != numWords * NET_BASELINE_HISTORY)
+    {
+        ResetBaseline(baseline, numWords);
+    }
+
+    // Reliable messages can arrive long after the client's history has moved on, so they are never deltas.
+    const uint8_t seq = baseline.mNextSeq;
+    const uint32_t* baseWords = nullptr;
+
+    if (!reliable &&
+        baseline.mHasAck &&
+        uint8_t(seq - baseline.mAckedSeq) < NET_BASELINE_HISTORY)
+    {
+        baseWords = baseline.mAcked.data();
+    }
+
+    if (!force &&
+        baseWords != nullptr &&
+        IsPackedStateKnown(baseline, sWords.data(), 0, numWords))
+    {
+        return 0;
+    }
+
+    WritePackedData(sBits, repData, sWords.data(), baseline, baseWords, 0, force);
+
+    if (scriptRepData != nullptr)
+    {
+        WritePackedData(sBits, *scriptRepData, sWords.data(), baseline, baseWords, numNativeWords, force);
+    }
+
+    if (sBits.GetNumBytes() > OCT_MAX_MSG_BODY_SIZE - NetMsgReplicatePacked::HeaderSize)
+    {
+        // Too big for one packet (most likely a long string), so fall back to regular replicate messages.
+        ReplicateNode(node, client->mHost.mId, true, reliable);
+        return sBits.GetNumBytes();
+    }
+
+    NetMsgReplicatePacked msg;
+    msg.mNodeNetId = node->GetNetId();
+    msg.mSequence = seq;
+    msg.mBaseline = baseWords ? baseline.mAckedSeq : 0;
+    msg.mFlags = (baseWords ? NetMsgReplicatePacked::BaselineFlag : 0) |
+        (scriptRepData ? NetMsgReplicatePacked::ScriptFlag : 0);
+    msg.mReliable = reliable;
+    msg.mData = (const char*)sBits.GetData();
+    msg.mSize = uint16_t(sBits.GetNumBytes());
+
+    SendMessage(&msg, client);
+
+    StoreBaselineHistory(baseline, seq, sWords.data());
+    baseline.mNextSeq++;
+
+    return NetMsgReplicatePacked::HeaderSize + msg.mSize;
+}
+
+void NetworkManager::HandleReplicatePacked(NetHost sender, const NetMsgReplicatePacked& msg)
+{
+    if (!NetIsClient())
+        return;
+
+    Node* node = GetNetNode(msg.mNodeNetId);
+
+    if (node == nullptr)
+    {
+        LogWarning("ReplicatePacked message received for unknown netid %08x.", msg.mNodeNetId);
+        return;
+    }
+
+    std::vector<NetDatum>& repData = node->GetReplicatedData();
+    std::vector<ScriptNetDatum>* scriptRepData = nullptr;
+
+    if (msg.mFlags & NetMsgReplicatePacked::ScriptFlag)
+    {
+        Script* script = node->GetScript();
+
+        if (script == nullptr)
+        {
+            LogWarning("ReplicatePacked message received for unregistered script on %s.", node->GetName().c_str());
+            return;
+        }
+
+        scriptRepData = &script->GetReplicatedData();
+    }
+
+    uint32_t numNativeWords = CountPackedWords(repData);
+    uint32_t numWords = numNativeWords + (scriptRepData ? CountPackedWords(*scriptRepData) : 0);
+
+    NetBaseline& baseline = mBaselines[msg.mNodeNetId];
+
+    if (baseline.mNumWords != numWords ||
+        baseline.mHistory.size() != numWords * NET_BASELINE_HISTORY)
+    {
+        ResetBaseline(baseline, numWords);
+    }
+
+    const uint32_t* baseWords = nullptr;
+
+    if (msg.mFlags & NetMsgReplicatePacked::BaselineFlag)
+    {
+        baseWords = FindBaselineHistory(baseline, msg.mBaseline);
+
+        if (baseWords == nullptr)
+        {
+            // Without an ack the server will fall back to sending the full state.
+            LogDebug("Missing baseline %u for netid %08x.", (uint32_t)msg.mBaseline, msg.mNodeNetId);
+            return;
+        }
+    }
+
+    static std::vector<uint32_t> sWords;
+    sWords.resize(numWords);
+
+    BitStream bits(msg.mData, msg.mSize);
+    ReadPackedData(bits, repData, baseWords, sWords.data(), sMsgReplicate);
+
+    if (scriptRepData != nullptr)
+    {
+        ReadPackedData(bits, *scriptRepData, baseWords ? (baseWords + numNativeWords) : nullptr, sWords.data() + numNativeWords, sMsgReplicateScript);
+    }
+
+    if (bits.IsOverflowed())
+    {
+        LogWarning("Malformed ReplicatePacked message received for netid %08x.", msg.mNodeNetId);
+        return;
+    }
+
+    StoreBaselineHistory(baseline, msg.mSequence, sWords.data());
+
+    // Apply through the regular replicate messages so OnRep handlers behave the same.
+    if (sMsgReplicate.mNumVariables > 0)
+    {
+        sMsgReplicate.mNodeNetId = msg.mNodeNetId;
+        sMsgReplicate.Execute(sender);
+    }
+
+    if (scriptRepData != nullptr && sMsgReplicateScript.mNumVariables > 0)
+    {
+        sMsgReplicateScript.mNodeNetId = msg.mNodeNetId;
+        sMsgReplicateScript.Execute(sender);
+    }
+
+    mReplicateAcks.mNetIds.push_back(msg.mNodeNetId);
+    mReplicateAcks.mSequences.push_back(msg.mSequence);
+
+    if (mReplicateAcks.mNetIds.size() >= NetMsgReplicateAck::MaxAcks)
+    {
+        SendReplicateAcks();
+    }
+}
+
+void NetworkManager::HandleReplicateAck(NetHost sender, NetId netId, uint8_t sequence)
+{
+    if (!NetIsServer())
+        return;
+
+    NetClient* client = FindNetClient(sender.mId);
+
+    if (client == nullptr)
+        return;
+
+    auto it = client->mBaselines.find(netId);
+
+    if (it == client->mBaselines.end())
+        return;
+
+    NetBaseline& baseline = it->second;
+    const uint32_t* words = FindBaselineHistory(baseline, sequence);
+
+    // Acks can arrive out of order, only move the baseline forward.
+    if (words != nullptr &&
+        (!baseline.mHasAck || int8_t(sequence - baseline.mAckedSeq) > 0))
+    {
+        baseline.mAcked.assign(words, words + baseline.mNumWords);
+        baseline.mAckedSeq = sequence;
+        baseline.mHasAck = true;
+    }
+}
+
+void NetworkManager::SendReplicateAcks()
+{
+    if (mReplicateAcks.mNetIds.size() > 0)
+    {
+        SendMessage(&mReplicateAcks, &mServer);
+
+        mReplicateAcks.mNetIds.clear();
+        mReplicateAcks.mSequences.clear();
+    }
+}
+
+void NetworkManager::UpdateHostConnections(float deltaTime)
+{
+    float clampedDeltaTime = glm::min(deltaTime, 0.333f);
+
+    if (IsServer())
+    {
+        for (int32_t i = int32_t(mClients.size()) - 1; i >= 0; --i)
+        {
+            mClients[i].mTimeSinceLastMsg += clampedDeltaTime;
+
+            if (mClients[i].mTimeSinceLastMsg >= mInactiveTimeout ||
+                mClients[i].mOutgoingPackets.size() > sMaxOutgoingPackets)
+            {
+                Kick(mClients[i].mHost.mId, NetMsgKick::Reason::Timeout);
+            }
+        }
+    }
+    else if (IsClient())
+    {
+        mServer.mTimeSinceLastMsg += clampedDeltaTime;
+        if (mServer.mTimeSinceLastMsg >= mInactiveTimeout ||
+            mServer.mOutgoingPackets.size() > sMaxOutgoingPackets)
+        {
+            Disconnect();
+
+            if (mKickCallback.mFuncPointer != nullptr)
+            {
+                mKickCallback.mFuncPointer(NetMsgKick::Reason::Timeout);
+            }
+            if (mKickCallback.mScriptFunc.IsValid())
+            {
+                Datum reasonArg = (int32_t)NetMsgKick::Reason::Timeout;
+                mKickCallback.mScriptFunc.Call(1, &reasonArg);
+            }
+        }
+    }
+}
+
+int32_t NetworkManager::RecvFrom(char* buffer, uint32_t size, NetHost& outHost)
+{
+    int32_t bytes = 0;
+
+    if (mInOnlineSession && mOnlinePlatform)
+    {
+        bytes = mOnlinePlatform->RecvMessage(buffer, size, outHost);
+    }
+    else
+    {
+        bytes = NET_SocketRecvFrom(mSocket, buffer, size, outHost.mIpAddress, outHost.mPort);
+    }
+
+    return bytes;
+}
+
+void NetworkManager::SendTo(const NetHost& host, const char* buffer, uint32_t size)
+{
+    if (mInOnlineSession && mOnlinePlatform)
+    {
+        mOnlinePlatform->SendMessage(host, buffer, size);
+        mBytesSent += size;
+    }
+    else
+    {
+        mBytesSent += NET_SocketSendTo(
+            mSocket,
+            buffer,
+            size,
+            host.mIpAddress,
+            host.mPort);
+    }
+}
+
+void NetworkManager::ProcessIncomingPackets(float deltaTime)
+{
+    int32_t bytes = 0;
+    NetHost sender;
+
+    while ((bytes = RecvFrom(sRecvBuffer, OCT_RECV_BUFFER_SIZE, sender)) > 0)
+    {   
+        Stream stream(sRecvBuffer, bytes);
+        NetMsgType msgType = (NetMsgType) sRecvBuffer[OCT_PACKET_HEADER_SIZE];
+
+        // Find which NetHost the message was from.
+        // if there is no matching NetHost then ignore this message (unless it is a "Connect" message)
+        sender.mId = INVALID_HOST_ID;
+
+        NetHostProfile* senderProfile = nullptr;
+
+        // Connect messages are only executed on the Server
+        bool connectMsg = mNetStatus == NetStatus::Server && 
+                          msgType == NetMsgType::Connect;
+
+        if (mNetStatus == NetStatus::Server)
+        {
+            for (uint32_t i = 0; i < mClients.size(); ++i)
+            {
+                if ((mInOnlineSession && mClients[i].mHost.mOnlineId == sender.mOnlineId) || 
+                    (mClients[i].mHost.mIpAddress == sender.mIpAddress &&
+                    mClients[i].mHost.mPort == sender.mPort))
+                {
+                    OCT_ASSERT(mClients[i].mHost.mId != INVALID_HOST_ID);
+                    sender.mId = mClients[i].mHost.mId;
+                    mClients[i].mTimeSinceLastMsg = 0.0f;
+
+                    senderProfile = &mClients[i];
+
+                    break;
+                }
+            }
+        }
+        else
+        {
+            if ((mInOnlineSession && mServer.mHost.mOnlineId == sender.mOnlineId) ||
+                (mServer.mHost.mIpAddress == sender.mIpAddress &&
+                mServer.mHost.mPort == sender.mPort))
+            {
+                OCT_ASSERT(mServer.mHost.mId == SERVER_HOST_ID);
+                sender.mId = mServer.mHost.mId;
+                mServer.mTimeSinceLastMsg = 0.0f;
+
+                senderProfile = &mServer;
+            }
+        }
+
+        if (!connectMsg &&
+            (sender.mId == INVALID_HOST_ID || senderProfile == nullptr))
+        {
+            LogDebug("Unrecognized host: %08x:%u", sender.mIpAddress, sender.mPort);
+            continue;
+        }
+
+        uint16_t seq = stream.ReadUint16();
+        bool reliable = stream.ReadBool();
+
+        bool processMsg = false;
 
         if (connectMsg)
         {
@@ -1857,6 +2959,8 @@ void NetworkManager::ProcessMessages(NetHost sender, Stream& stream)
             NET_MSG_CASE(InvokeScript)
             //NET_MSG_CASE(Broadcast)
             NET_MSG_CASE(Ack)
+            NET_MSG_CASE(ReplicatePacked)
+            NET_MSG_CASE(ReplicateAck)
 
         default: break;
         }
@@ -1945,6 +3049,10 @@ void NetworkManager::ResetToLocalStatus()
                 });
         }
 
+        mBaselines.clear();
+        mReplicateAcks.mNetIds.clear();
+        mReplicateAcks.mSequences.clear();
+
         mSocket = NET_INVALID_SOCKET;
         mNetStatus = NetStatus::Local;
         mHostId = INVALID_HOST_ID;
@@ -3,6 +3,7 @@
 #include "EngineTypes.h"
 #include "NetMsg.h"
 #include "NetFunc.h"
+#include "NetDatum.h"
 #include "ScriptFunc.h"
 #include "Nodes/Node.h"
 
@@ -19,7 +20,9 @@
 #endif
 
 class Node;
+class Node3D;
 class Script;
+class World;
 
 bool NetIsClient();
 bool NetIsServer();
@@ -33,6 +36,7 @@ typedef void(*NetCallbackAcceptFP)();
 typedef void(*NetCallbackRejectFP)(NetMsgReject::Reason);
 typedef void(*NetCallbackDisconnectFP)(NetClient*);
 typedef void(*NetCallbackKickFP)(NetMsgKick::Reason);
+typedef bool(*NetCallbackRelevancyFP)(NetClient*, Node*);
 
 class NetworkManager
 {
@@ -100,6 +104,30 @@ public:
     void EnableIncrementalReplication(bool enable);
     bool IsIncrementalReplicationEnabled() const;
 
+    // Relevancy filtering. When enabled, each client is only sent spawn/destroy/replication
+    // messages for nodes that are relevant to it (within the view radius of its view position,
+    // or as decided by the relevancy callback). Stale nodes are sent in priority order until
+    // the per-client byte budget for the frame is used up. Enable before opening a session.
+    void EnableRelevancy(bool enable);
+    bool IsRelevancyEnabled() const;
+    void SetRelevancyRadius(float radius);
+    float GetRelevancyRadius() const;
+    void SetRelevancyBudget(uint32_t bytes);
+    uint32_t GetRelevancyBudget() const;
+    void SetClientViewPosition(NetHostId hostId, glm::vec3 position);
+    void SetClientViewNode(NetHostId hostId, Node* node);
+    bool IsRelevant(NetHostId hostId, Node* node) const;
+
+    // Packed replication sends quantized, bit packed node state that is delta encoded against
+    // the last snapshot each client acknowledged. Only the server's setting matters, but the
+    // quantization settings must match on every host before replicated nodes are added.
+    void EnablePackedReplication(bool enable);
+    bool IsPackedReplicationEnabled() const;
+    void SetPositionQuantization(float extent, uint8_t bits);
+    void SetRotationQuantization(uint8_t bits);
+    NetQuantization GetPositionQuantization() const;
+    NetQuantization GetRotationQuantization() const;
+
     int32_t GetBytesSent() const;
     int32_t GetBytesReceived() const;
     float GetUploadRate() const;
@@ -124,6 +152,8 @@ public:
     void HandleKick(NetMsgKick::Reason reason);
     void HandleAck(NetHost host, uint16_t sequenceNumber);
     void HandleReady(NetHost host);
+    void HandleReplicatePacked(NetHost sender, const NetMsgReplicatePacked& msg);
+    void HandleReplicateAck(NetHost sender, NetId netId, uint8_t sequence);
     void HandleBroadcast(
         NetHost host,
         uint32_t gameCode,
@@ -138,12 +168,14 @@ public:
     void SetRejectCallback(NetCallbackRejectFP cb) { mRejectCallback.mFuncPointer = cb; }
     void SetDisconnectCallback(NetCallbackDisconnectFP cb) { mDisconnectCallback.mFuncPointer = cb; }
     void SetKickCallback(NetCallbackKickFP cb) { mKickCallback.mFuncPointer = cb; }
+    void SetRelevancyCallback(NetCallbackRelevancyFP cb) { mRelevancyCallback.mFuncPointer = cb; }
 
     void SetScriptConnectCallback(const ScriptFunc& func) { mConnectCallback.mScriptFunc = func; }
     void SetScriptAcceptCallback(const ScriptFunc& func) { mAcceptCallback.mScriptFunc = func; }
     void SetScriptRejectCallback(const ScriptFunc& func) { mRejectCallback.mScriptFunc = func; }
     void SetScriptDisconnectCallback(const ScriptFunc& func) { mDisconnectCallback.mScriptFunc = func; }
     void SetScriptKickCallback(const ScriptFunc& func) { mKickCallback.mScriptFunc = func; }
+    void SetScriptRelevancyCallback(const ScriptFunc& func) { mRelevancyCallback.mScriptFunc = func; }
 
 private:
 
@@ -152,6 +184,14 @@ private:
 
     void UpdateReplication(float deltaTime);
     bool ReplicateNode(Node* node, NetId hostId, bool force, bool reliable);
+    void UpdateRelevancy(World* world);
+    void UpdateRelevantSet(NetClient* client, std::vector<Node*>& relevantNodes);
+    bool EvaluateRelevancyCallback(NetClient* client, Node* node);
+    void MarkRelevantNodeStale(Node* node, bool force);
+    void ReplicateRelevantNodes(float deltaTime);
+    bool ReplicateNodePacked(Node* node, bool force);
+    uint32_t ReplicateNodePacked(Node* node, NetClient* client, bool force, bool reliable);
+    void SendReplicateAcks();
     void UpdateHostConnections(float deltaTime);
     void ProcessIncomingPackets(float deltaTime);
     void ProcessMessages(NetHost sender, Stream& stream);
@@ -195,9 +235,23 @@ private:
     bool mIncrementalReplication = true;
     bool mInOnlineSession = false;
 
+    std::unordered_map<uint64_t, std::vector<Node3D*>> mRelevancyGrid;
+    std::vector<Node*> mAlwaysRelevantNodes;
+    float mRelevancyRadius = 50.0f;
+    uint32_t mRelevancyBudget = 1400;
+    bool mRelevancy = false;
+
+    std::unordered_map<NetId, NetBaseline> mBaselines;
+    NetMsgReplicateAck mReplicateAcks;
+    float mPositionExtent = 0.0f;
+    uint8_t mPositionBits = 0;
+    uint8_t mRotationBits = 12;
+    bool mPackedReplication = false;
+
     ScriptableFP<NetCallbackConnectFP> mConnectCallback;
     ScriptableFP<NetCallbackAcceptFP> mAcceptCallback;
     ScriptableFP<NetCallbackRejectFP> mRejectCallback;
     ScriptableFP<NetCallbackDisconnectFP> mDisconnectCallback;
     ScriptableFP<NetCallbackKickFP> mKickCallback;
+    ScriptableFP<NetCallbackRelevancyFP> mRelevancyCallback;
 };
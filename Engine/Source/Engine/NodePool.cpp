@@ -0,0 +1,267 @@
+#include "NodePool.h"
+#include "Profiler.h"
+#include "Assertion.h"
+#include "Log.h"
+#include "Maths.h"
+
+#include "System/System.h"
+
+#include <thread>
+
+// Plain pointer array so the pools outlive any node freed during static destruction.
+static NodePool* sNodePools[NODE_POOL_NUM_SIZE_CLASSES] = {};
+
+#ifndef NDEBUG
+// Thread that allocated the first node. Every later allocation and free must happen on it.
+static std::thread::id sNodeThreadId;
+
+static bool IsOnNodeThread()
+{
+    if (sNodeThreadId == std::thread::id())
+    {
+        sNodeThreadId = std::this_thread::get_id();
+    }
+
+    return (sNodeThreadId == std::this_thread::get_id());
+}
+#endif
+
+static uint32_t GetSizeClass(size_t size)
+{
+    OCT_ASSERT(size > 0);
+    return uint32_t((size + NODE_POOL_GRANULARITY - 1) / NODE_POOL_GRANULARITY) - 1;
+}
+
+static NodePool* GetNodePool(size_t size)
+{
+    NodePool* pool = nullptr;
+
+    if (size <= NODE_POOL_MAX_BLOCK_SIZE)
+    {
+        uint32_t sizeClass = GetSizeClass(size);
+        pool = sNodePools[sizeClass];
+
+        if (pool == nullptr)
+        {
+            pool = new NodePool((sizeClass + 1) * NODE_POOL_GRANULARITY);
+            sNodePools[sizeClass] = pool;
+        }
+    }
+
+    return pool;
+}
+
+NodePool::NodePool(uint32_t blockSize) :
+    mBlockSize(blockSize)
+{
+    OCT_ASSERT(blockSize >= sizeof(FreeBlock));
+    OCT_ASSERT(blockSize % NODE_POOL_GRANULARITY == 0);
+    mBlocksPerSlab = glm::max<uint32_t>(NODE_POOL_SLAB_SIZE / blockSize, 8);
+}
+
+NodePool::~NodePool()
+{
+    OCT_ASSERT(mNumLive == 0);
+
+    for (uint32_t i = 0; i < mSlabs.size(); ++i)
+    {
+        SYS_AlignedFree(mSlabs[i]);
+    }
+
+    mSlabs.clear();
+    mFreeList = nullptr;
+}
+
+void* NodePool::Alloc()
+{
+    if (mFreeList == nullptr)
+    {
+        AllocateSlab(mBlocksPerSlab);
+    }
+
+    FreeBlock* block = mFreeList;
+    mFreeList = block->mNext;
+
+    mNumLive++;
+    mPeakLive = glm::max(mPeakLive, mNumLive);
+
+    return block;
+}
+
+void NodePool::Free(void* block)
+{
+    OCT_ASSERT(block != nullptr);
+    OCT_ASSERT(mNumLive > 0);
+
+    FreeBlock* freeBlock = (FreeBlock*)block;
+    freeBlock->mNext = mFreeList;
+    mFreeList = freeBlock;
+
+    mNumLive--;
+}
+
+void NodePool::Reserve(uint32_t numBlocks)
+{
+    uint32_t numFree = GetNumFree();
+
+    if (numBlocks > numFree)
+    {
+        AllocateSlab(numBlocks - numFree);
+    }
+}
+
+uint32_t NodePool::GetBlockSize() const
+{
+    return mBlockSize;
+}
+
+uint32_t NodePool::GetNumLive() const
+{
+    return mNumLive;
+}
+
+uint32_t NodePool::GetNumFree() const
+{
+    return mNumBlocks - mNumLive;
+}
+
+uint32_t NodePool::GetPeakLive() const
+{
+    return mPeakLive;
+}
+
+uint32_t NodePool::GetNumSlabs() const
+{
+    return uint32_t(mSlabs.size());
+}
+
+uint32_t NodePool::GetNumBytesReserved() const
+{
+    return mNumBlocks * mBlockSize;
+}
+
+void NodePool::AllocateSlab(uint32_t numBlocks)
+{
+    OCT_ASSERT(numBlocks > 0);
+
+    uint8_t* slab = (uint8_t*)SYS_AlignedMalloc(size_t(numBlocks) * mBlockSize, NODE_POOL_GRANULARITY);
+    mSlabs.push_back(slab);
+
+    // Thread the new blocks onto the free list in address order, so consecutive allocations are contiguous.
+    for (int32_t i = int32_t(numBlocks) - 1; i >= 0; --i)
+    {
+        FreeBlock* block = (FreeBlock*)(slab + size_t(i) * mBlockSize);
+        block->mNext = mFreeList;
+        mFreeList = block;
+    }
+
+    mNumBlocks += numBlocks;
+}
+
+void* AllocateNodeMemory(size_t size)
+{
+    // Async loads run on loader threads, but they must never create nodes.
+    OCT_ASSERT(IsOnNodeThread());
+
+#if NODE_POOL_ALLOCATION
+    NodePool* pool = GetNodePool(size);
+
+    if (pool != nullptr)
+    {
+        return pool->Alloc();
+    }
+#endif
+
+    void* memory = SYS_AlignedMalloc(size, NODE_POOL_GRANULARITY);
+    OCT_ASSERT(memory != nullptr);
+    return memory;
+}
+
+void FreeNodeMemory(void* memory, size_t size)
+{
+    if (memory == nullptr)
+    {
+        return;
+    }
+
+    OCT_ASSERT(IsOnNodeThread());
+
+#if NODE_POOL_ALLOCATION
+    NodePool* pool = GetNodePool(size);
+
+    if (pool != nullptr)
+    {
+        pool->Free(memory);
+        return;
+    }
+#endif
+
+    SYS_AlignedFree(memory);
+}
+
+void ReserveNodeMemory(size_t size, uint32_t count)
+{
+#if NODE_POOL_ALLOCATION
+    NodePool* pool = GetNodePool(size);
+
+    if (pool != nullptr)
+    {
+        pool->Reserve(count);
+    }
+#endif
+}
+
+void UpdateNodePoolStats()
+{
+#if NODE_POOL_ALLOCATION && PROFILING_ENABLED
+    Profiler* profiler = GetProfiler();
+
+    if (profiler == nullptr)
+    {
+        return;
+    }
+
+    uint32_t numLive = 0;
+    uint32_t numFree = 0;
+    uint32_t numSlabs = 0;
+    uint32_t numBytes = 0;
+
+    for (uint32_t i = 0; i < NODE_POOL_NUM_SIZE_CLASSES; ++i)
+    {
+        if (sNodePools[i] != nullptr)
+        {
+            numLive += sNodePools[i]->GetNumLive();
+            numFree += sNodePools[i]->GetNumFree();
+            numSlabs += sNodePools[i]->GetNumSlabs();
+            numBytes += sNodePools[i]->GetNumBytesReserved();
+        }
+    }
+
+    profiler->SetCounterStat("Pooled Nodes", numLive);
+    profiler->SetCounterStat("Free Node Blocks", numFree);
+    profiler->SetCounterStat("Node Slabs", numSlabs);
+    profiler->SetCounterStat("Node Pool KB", numBytes / 1024);
+#endif
+}
+
+void LogNodePoolStats()
+{
+    LogDebug("----- Node Pools -----");
+
+    for (uint32_t i = 0; i < NODE_POOL_NUM_SIZE_CLASSES; ++i)
+    {
+        const NodePool* pool = sNodePools[i];
+
+        if (pool != nullptr)
+        {
+            LogDebug("%4u bytes: %u live, %u free, %u peak, %u slabs",
+                pool->GetBlockSize(),
+                pool->GetNumLive(),
+                pool->GetNumFree(),
+                pool->GetPeakLive(),
+                pool->GetNumSlabs());
+        }
+    }
+
+    LogDebug("----------------------");
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+#include "Constants.h"
+
+// Nodes are carved out of per-size slabs instead of the general heap. Sizes are rounded up to
+// NODE_POOL_GRANULARITY, so every node class lands in the pool for its size class, which classes
+// of the same rounded size share. This only recycles memory: a destroyed node is still fully
+// destructed, its block goes back on the pool's free list, and the next node of that size is
+// constructed from scratch in it.
+//
+// Deliberately not done: per-type pools that keep destroyed node objects alive and reset them
+// for reuse. Every node class would need a Reset() that mirrors its constructor (and its
+// Create/Destroy, script and NodeHandle state) and stays in sync with it, and a missed field
+// would leak state from one spawn into the next. Running the constructor again is that reset.
+#define NODE_POOL_GRANULARITY 16
+#define NODE_POOL_MAX_BLOCK_SIZE 4096
+#define NODE_POOL_SLAB_SIZE (32 * 1024)
+#define NODE_POOL_NUM_SIZE_CLASSES (NODE_POOL_MAX_BLOCK_SIZE / NODE_POOL_GRANULARITY)
+
+class NodePool
+{
+public:
+
+    NodePool(uint32_t blockSize);
+    ~NodePool();
+
+    void* Alloc();
+    void Free(void* block);
+
+    // Make sure at least numBlocks can be allocated without allocating another slab.
+    void Reserve(uint32_t numBlocks);
+
+    uint32_t GetBlockSize() const;
+    uint32_t GetNumLive() const;
+    uint32_t GetNumFree() const;
+    uint32_t GetPeakLive() const;
+    uint32_t GetNumSlabs() const;
+    uint32_t GetNumBytesReserved() const;
+
+private:
+
+    struct FreeBlock
+    {
+        FreeBlock* mNext;
+    };
+
+    void AllocateSlab(uint32_t numBlocks);
+
+    uint32_t mBlockSize = 0;
+    uint32_t mBlocksPerSlab = 0;
+    FreeBlock* mFreeList = nullptr;
+    std::vector<void*> mSlabs;
+    uint32_t mNumBlocks = 0;
+    uint32_t mNumLive = 0;
+    uint32_t mPeakLive = 0;
+};
+
+// Called by Node's operator new/delete. The pools aren't locked, so nodes must only be created and
+// destroyed on the thread that allocated the first node (the main thread). This is asserted.
+void* AllocateNodeMemory(size_t size);
+void FreeNodeMemory(void* memory, size_t size);
+
+void ReserveNodeMemory(size_t size, uint32_t count);
+
+// Publishes pool totals as Profiler counters. Called once per frame.
+void UpdateNodePoolStats();
+void LogNodePoolStats();
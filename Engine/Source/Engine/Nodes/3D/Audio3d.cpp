@@ -93,7 +93,7 @@ void Audio3D::GatherProxyDraws(std::vector<DebugDraw>& inoutDraws)
             debugDraw.mMesh = LoadAsset<StaticMesh>("SM_Sphere");
             debugDraw.mNode = this;
             debugDraw.mColor = glm::vec4(0.3f, 0.8f, 0.8f, 1.0f);
-            debugDraw.mTransform = glm::scale(mTransform, { 0.2f, 0.2f, 0.2f });
+            debugDraw.mTransform = glm::scale(GetTransform(), { 0.2f, 0.2f, 0.2f });
             inoutDraws.push_back(debugDraw);
         }
 
@@ -106,7 +106,7 @@ void Audio3D::GatherProxyDraws(std::vector<DebugDraw>& inoutDraws)
                 debugDraw.mMesh = LoadAsset<StaticMesh>("SM_Sphere");
                 debugDraw.mNode = this;
                 debugDraw.mColor = glm::vec4(0.3f, 0.8f, 0.8f, 1.0f);
-                debugDraw.mTransform = glm::scale(mTransform, { mInnerRadius, mInnerRadius, mInnerRadius });
+                debugDraw.mTransform = glm::scale(GetTransform(), { mInnerRadius, mInnerRadius, mInnerRadius });
                 inoutDraws.push_back(debugDraw);
             }
 
@@ -116,7 +116,7 @@ void Audio3D::GatherProxyDraws(std::vector<DebugDraw>& inoutDraws)
                 debugDraw.mMesh = LoadAsset<StaticMesh>("SM_Sphere");
                 debugDraw.mNode = this;
                 debugDraw.mColor = glm::vec4(0.3f, 0.8f, 0.8f, 1.0f);
-                debugDraw.mTransform = glm::scale(mTransform, { mOuterRadius, mOuterRadius, mOuterRadius });
+                debugDraw.mTransform = glm::scale(GetTransform(), { mOuterRadius, mOuterRadius, mOuterRadius });
                 inoutDraws.push_back(debugDraw);
             }
         }
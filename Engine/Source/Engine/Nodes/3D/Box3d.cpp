@@ -66,7 +66,7 @@ void Box3D::GatherProxyDraws(std::vector<DebugDraw>& inoutDraws)
     debugDraw.mMesh = LoadAsset<StaticMesh>("SM_Cube");
     debugDraw.mNode = this;
     debugDraw.mColor = color;
-    debugDraw.mTransform = glm::scale(mTransform, extentScale);
+    debugDraw.mTransform = glm::scale(GetTransform(), extentScale);
     inoutDraws.push_back(debugDraw);
 
 #endif
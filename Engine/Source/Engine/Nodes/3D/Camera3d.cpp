@@ -63,7 +63,7 @@ void Camera3D::GatherProxyDraws(std::vector<DebugDraw>& inoutDraws)
     if (this != GetWorld()->GetActiveCamera())
     {
         glm::mat4 transform = glm::rotate(DEGREES_TO_RADIANS * -90.0f, glm::vec3(1.0f, 0.0f, 0.0f));
-        transform = mTransform * transform;
+        transform = GetWorldTransformRef() * transform;
 
         DebugDraw debugDraw;
         debugDraw.mMesh = LoadAsset<StaticMesh>("SM_Cone");
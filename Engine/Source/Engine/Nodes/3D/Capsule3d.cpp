@@ -78,7 +78,7 @@ void Capsule3D::GatherProxyDraws(std::vector<DebugDraw>& inoutDraws)
         debugDraw.mMesh = LoadAsset<StaticMesh>("SM_CapsuleCylinder");
         debugDraw.mNode = this;
         debugDraw.mColor = color;
-        debugDraw.mTransform = glm::scale(mTransform, { rScale, hScale, rScale });
+        debugDraw.mTransform = glm::scale(GetTransform(), { rScale, hScale, rScale });
         inoutDraws.push_back(debugDraw);
     }
 
@@ -89,7 +89,7 @@ void Capsule3D::GatherProxyDraws(std::vector<DebugDraw>& inoutDraws)
         debugDraw.mNode = this;
         debugDraw.mColor = color;
         glm::mat4 trans = MakeTransform({ 0.0f, halfHeight, 0.0f }, {}, { rScale, rScale, rScale });
-        debugDraw.mTransform = mTransform * trans;
+        debugDraw.mTransform = GetTransform() * trans;
         inoutDraws.push_back(debugDraw);
     }
 
@@ -100,7 +100,7 @@ void Capsule3D::GatherProxyDraws(std::vector<DebugDraw>& inoutDraws)
         debugDraw.mNode = this;
         debugDraw.mColor = color;
         glm::mat4 trans = MakeTransform({ 0.0f, -halfHeight, 0.0f }, {180.0f, 0.0f, 0.0f}, { rScale, rScale, rScale });
-        debugDraw.mTransform = mTransform * trans;
+        debugDraw.mTransform = GetTransform() * trans;
         inoutDraws.push_back(debugDraw);
     }
 
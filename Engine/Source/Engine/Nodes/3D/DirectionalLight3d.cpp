@@ -73,7 +73,7 @@ void DirectionalLight3D::GatherProxyDraws(std::vector<DebugDraw>& inoutDraws)
         debugDraw.mNode = this;
         debugDraw.mColor = color;
         glm::mat4 trans = MakeTransform({}, { -90.0f, 0.0f, 0.0f}, { scale * 0.5, scale, scale * 0.5});
-        debugDraw.mTransform = mTransform * trans; // glm::scale(mTransform, { rScale, hScale, rScale });
+        debugDraw.mTransform = GetTransform() * trans; // glm::scale(GetTransform(), { rScale, hScale, rScale });
         inoutDraws.push_back(debugDraw);
     }
 
@@ -84,7 +84,7 @@ void DirectionalLight3D::GatherProxyDraws(std::vector<DebugDraw>& inoutDraws)
         debugDraw.mNode = this;
         debugDraw.mColor = color;
         glm::mat4 trans = MakeTransform({0.0f, 0.0f, -2.0f * scale}, { -90.0f, 0.0f, 0.0f }, { scale, scale, scale });
-        debugDraw.mTransform = mTransform * trans;
+        debugDraw.mTransform = GetTransform() * trans;
         inoutDraws.push_back(debugDraw);
     }
 #endif
@@ -1,9 +1,14 @@
 #include "Nodes/3D/InstancedMesh3d.h"
 #include "Assets/StaticMesh.h"
+#include "MeshBlocks.h"
 
 FORCE_LINK_DEF(InstancedMesh3D);
 DEFINE_NODE(InstancedMesh3D, StaticMesh3D);
 
+// Instance data is serialized as one block of floats.
+static const uint32_t kInstanceDataFloats = 9;
+static_assert(sizeof(MeshInstanceData) == kInstanceDataFloats * sizeof(float), "MeshInstanceData must be tightly packed floats");
+
 InstancedMesh3D::InstancedMesh3D()
 {
     mName = "Instanced Mesh";
@@ -65,12 +70,7 @@ void InstancedMesh3D::SaveStream(Stream& stream, Platform platform)
     StaticMesh3D::SaveStream(stream, platform);
 
     stream.WriteUint32((uint32_t)mInstanceData.size());
-    for (uint32_t i = 0; i < mInstanceData.size(); ++i)
-    {
-        stream.WriteVec3(mInstanceData[i].mPosition);
-        stream.WriteVec3(mInstanceData[i].mRotation);
-        stream.WriteVec3(mInstanceData[i].mScale);
-    }
+    WriteFloatBlock(stream, (const float*)mInstanceData.data(), uint32_t(mInstanceData.size()) * kInstanceDataFloats, platform);
 }
 
 void InstancedMesh3D::LoadStream(Stream& stream, Platform platform, uint32_t version)
@@ -79,11 +79,19 @@ void InstancedMesh3D::LoadStream(Stream& stream, Platform platform, uint32_t ver
 
     uint32_t numInstances = stream.ReadUint32();
     mInstanceData.resize(numInstances);
-    for (uint32_t i = 0; i < numInstances; ++i)
+
+    if (version >= ASSET_VERSION_MESH_BLOCKS)
     {
-        mInstanceData[i].mPosition = stream.ReadVec3();
-        mInstanceData[i].mRotation = stream.ReadVec3();
-        mInstanceData[i].mScale = stream.ReadVec3();
+        ReadFloatBlock(stream, (float*)mInstanceData.data(), numInstances * kInstanceDataFloats);
+    }
+    else
+    {
+        for (uint32_t i = 0; i < numInstances; ++i)
+        {
+            mInstanceData[i].mPosition = stream.ReadVec3();
+            mInstanceData[i].mRotation = stream.ReadVec3();
+            mInstanceData[i].mScale = stream.ReadVec3();
+        }
     }
 
     if (ShouldUnroll())
@@ -221,6 +229,8 @@ void InstancedMesh3D::UpdateInstanceData()
 
         mInstanceDataDirty = false;
         mInstanceDataUpdatedThisFrame = true;
+
+        UpdateSpatialBounds();
     }
 }
 
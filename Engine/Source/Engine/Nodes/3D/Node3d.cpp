@@ -3,6 +3,8 @@
 #include "AssetManager.h"
 #include "Nodes/Node.h"
 #include "World.h"
+#include "NetworkManager.h"
+#include "TransformHierarchy.h"
 #include "Renderer.h"
 #include "Maths.h"
 #include "Assets/SkeletalMesh.h"
@@ -79,15 +81,18 @@ Node3D::Node3D() :
     mScale(1,1,1),
     mRotationQuat({0, 0, 0}),
     mTransform(1.0f),
-    mParentBoneIndex(-1),
-    mTransformDirty(true)
+    mTransformDirty(true),
+    mParentBoneIndex(-1)
 {
     mName = "Transform";
 }
 
 Node3D::~Node3D()
 {
-
+    if (mTransformHierarchy != nullptr)
+    {
+        mTransformHierarchy->Remove(this);
+    }
 }
 
 void Node3D::Create()
@@ -131,8 +136,10 @@ void Node3D::GatherReplicatedData(std::vector<NetDatum>& outData)
 
     if (mReplicateTransform)
     {
-        outData.push_back(NetDatum(DatumType::Vector, this, &mPosition, 1, OnRep_RootPosition));
-        outData.push_back(NetDatum(DatumType::Vector, this, &mRotationEuler, 1, OnRep_RootRotation));
+        // Quantization only affects packed replication.
+        NetworkManager* netMan = NetworkManager::Get();
+        outData.push_back(NetDatum(DatumType::Vector, this, &mPosition, 1, OnRep_RootPosition).SetQuantization(netMan->GetPositionQuantization()));
+        outData.push_back(NetDatum(DatumType::Vector, this, &mRotationEuler, 1, OnRep_RootRotation).SetQuantization(netMan->GetRotationQuantization()));
         outData.push_back(NetDatum(DatumType::Vector, this, &mScale, 1, OnRep_RootScale));
     }
 }
@@ -157,7 +164,7 @@ void Node3D::AttachToBone(SkeletalMesh3D* parent, int32_t boneIndex, bool keepWo
     }
 
     Attach(parent, keepWorldTransform, childIndex);
-    mParentBoneIndex = boneIndex;
+    SetParentBoneIndex(boneIndex);
 
     if (keepWorldTransform)
     {
@@ -167,7 +174,14 @@ void Node3D::AttachToBone(SkeletalMesh3D* parent, int32_t boneIndex, bool keepWo
 
 void Node3D::MarkTransformDirty()
 {
-    mTransformDirty = true;
+    if (mTransformHierarchy != nullptr)
+    {
+        mTransformHierarchy->MarkDirty(mTransformIndex, TransformHierarchy::kLocalDirty);
+    }
+    else
+    {
+        mTransformDirty = true;
+    }
 
     // TODO-NODE: Consider propogating this to children nodes. 
     // It looks like Godot does it this way, and might remove some one-frame-delay bugs.
@@ -184,6 +198,11 @@ void Node3D::MarkTransformDirty()
 
 bool Node3D::IsTransformDirty() const
 {
+    if (mTransformHierarchy != nullptr)
+    {
+        return mTransformHierarchy->IsDirty(mTransformIndex);
+    }
+
     return mTransformDirty;
 }
 
@@ -193,53 +212,41 @@ void Node3D::UpdateTransform(bool updateChildren)
     Node3D* parent = (mParent && mParent->IsNode3D()) ? static_cast<Node3D*>(mParent) : nullptr;
 
     if (parent != nullptr &&
-        parent->mTransformDirty)
+        parent->IsTransformDirty())
     {
         parent->UpdateTransform(false);
     }
 
-    if (mTransformDirty)
+    if (IsTransformDirty())
     {
-        // Update transform
-        mTransform = glm::mat4(1);
+        glm::mat4 localTransform = UpdateLocalTransform();
 
-        // Force uniform scale if the component has children.
-        // Non-uniform scale was causing problems for children components because shear was 
-        // getting introduced into the child transforms if the parent had any rotation.
-        // Relevant Github issues:
-        // https://github.com/BabylonJS/Babylon.js/issues/10579
-        // https://github.com/mrdoob/three.js/issues/3845
-        // https://github.com/armory3d/armory/issues/2211
-        glm::vec3 scale = mScale;
-        if (GetNumChildren() > 0)
+        if (mTransformHierarchy != nullptr)
         {
-            scale = glm::vec3(mScale.x, mScale.x, mScale.x);
+            mTransformHierarchy->SetLocalTransform(mTransformIndex, localTransform);
         }
-        
-        mTransform = glm::translate(mTransform, mPosition);
-        mTransform *= glm::toMat4(mRotationQuat);
-        mTransform = glm::scale(mTransform, scale);
+
+        glm::mat4& transform = GetWorldTransformRef();
+        transform = localTransform;
 
         if (parent != nullptr)
         {
             // Concatenate parent transform with this transform
-            mTransform = GetParentTransform() * mTransform;
+            transform = GetParentTransform() * transform;
         }
 
-        // Recursively mark children dirty since their parent has updated.
+        // Mark children dirty since their parent has updated.
         for (uint32_t i = 0; i < mChildren.size(); ++i)
         {
             Node3D* child3d = mChildren[i]->IsNode3D() ? static_cast<Node3D*>(mChildren[i]) : nullptr;
             if (child3d)
             {
-                child3d->MarkTransformDirty();
+                child3d->MarkWorldTransformDirty();
             }
         }
 
-        // Cache off the euler angle rotation.
-        mRotationEuler = GetRotationEuler();
-
-        mTransformDirty = false;
+        ClearTransformDirty();
+        OnTransformUpdated();
     }
 
     // Recursively update child transforms.
@@ -314,16 +321,16 @@ glm::vec3& Node3D::GetScaleRef()
     return mScale;
 }
 
-const glm::mat4& Node3D::GetTransform()
+glm::mat4 Node3D::GetTransform()
 {
     // TODO-NODE: I added this update transform check and made this method non-const.
     // Is this causing any bugs? Performance issues?
-    if (mTransformDirty)
+    if (IsTransformDirty())
     {
         UpdateTransform(false);
     }
 
-    return mTransform;
+    return GetWorldTransformRef();
 }
 
 void Node3D::SetPosition(glm::vec3 position)
@@ -351,15 +358,23 @@ void Node3D::SetScale(glm::vec3 scale)
 
 void Node3D::SetTransform(const glm::mat4& transform)
 {
-    mTransform = transform;
+    // Copy first, the argument could be a reference to our own world transform.
+    glm::mat4 newTransform = transform;
 
     // Update the relative transforms to match the new world transform.
-    SetWorldPosition(Maths::ExtractPosition(transform));
-    SetWorldScale(Maths::ExtractScale(transform));
-    SetWorldRotation(Maths::ExtractRotation(transform));
-    mRotationEuler = GetRotationEuler();
+    SetWorldPosition(Maths::ExtractPosition(newTransform));
+    SetWorldScale(Maths::ExtractScale(newTransform));
+    SetWorldRotation(Maths::ExtractRotation(newTransform));
 
-    mTransformDirty = false;
+    glm::mat4 localTransform = UpdateLocalTransform();
+
+    if (mTransformHierarchy != nullptr)
+    {
+        mTransformHierarchy->SetLocalTransform(mTransformIndex, localTransform);
+    }
+
+    GetWorldTransformRef() = newTransform;
+    ClearTransformDirty();
 
     for (uint32_t i = 0; i < mChildren.size(); ++i)
     {
@@ -367,7 +382,7 @@ void Node3D::SetTransform(const glm::mat4& transform)
         if (child3d)
         {
             //child3d->UpdateTransform();
-            child3d->MarkTransformDirty();
+            child3d->MarkWorldTransformDirty();
         }
     }
 }
@@ -375,14 +390,14 @@ void Node3D::SetTransform(const glm::mat4& transform)
 glm::vec3 Node3D::GetWorldPosition()
 {
     UpdateTransform(false);
-    return Maths::ExtractPosition(mTransform);
+    return Maths::ExtractPosition(GetWorldTransformRef());
 }
 
 glm::vec3 Node3D::GetWorldRotationEuler()
 {
     UpdateTransform(false);
 
-    glm::vec3 eulerAngles = glm::eulerAngles(Maths::ExtractRotation(mTransform)) * RADIANS_TO_DEGREES;
+    glm::vec3 eulerAngles = glm::eulerAngles(Maths::ExtractRotation(GetWorldTransformRef())) * RADIANS_TO_DEGREES;
 
     eulerAngles = EnforceEulerRange(eulerAngles);
 
@@ -392,13 +407,13 @@ glm::vec3 Node3D::GetWorldRotationEuler()
 glm::quat Node3D::GetWorldRotationQuat()
 {
     UpdateTransform(false);
-    return Maths::ExtractRotation(mTransform);
+    return Maths::ExtractRotation(GetWorldTransformRef());
 }
 
 glm::vec3 Node3D::GetWorldScale()
 {
     UpdateTransform(false);
-    return Maths::ExtractScale(mTransform);
+    return Maths::ExtractScale(GetWorldTransformRef());
 }
 
 void Node3D::SetWorldPosition(glm::vec3 position)
@@ -508,7 +523,7 @@ void Node3D::RotateAround(glm::vec3 pivot, glm::vec3 axis, float degrees)
     // Work in world space
     UpdateTransform(false);
 
-    glm::mat4 trans = mTransform;
+    glm::mat4 trans = GetWorldTransformRef();
     trans = glm::translate(trans, pivot);
     trans = glm::rotate(trans, degrees * DEGREES_TO_RADIANS, axis);
     trans = glm::translate(trans, -pivot);
@@ -530,21 +545,21 @@ glm::vec3 Node3D::GetCachedEulerRotation() const
 
 glm::vec3 Node3D::GetForwardVector() const
 {
-     glm::vec3 forwardVector = mTransform * glm::vec4(0.0f, 0.0f, -1.0f, 0.0f);
+     glm::vec3 forwardVector = GetWorldTransformRef() * glm::vec4(0.0f, 0.0f, -1.0f, 0.0f);
      forwardVector = Maths::SafeNormalize(forwardVector);
     return forwardVector;
 }
 
 glm::vec3 Node3D::GetRightVector() const
 {
-    glm::vec3 rightVector = mTransform * glm::vec4(1.0f, 0.0f, 0.0f, 0.0f);
+    glm::vec3 rightVector = GetWorldTransformRef() * glm::vec4(1.0f, 0.0f, 0.0f, 0.0f);
     rightVector = Maths::SafeNormalize(rightVector);
     return rightVector;
 }
 
 glm::vec3 Node3D::GetUpVector() const
 {
-    glm::vec3 upVector = mTransform * glm::vec4(0.0f, 1.0f, 0.0f, 0.0f);
+    glm::vec3 upVector = GetWorldTransformRef() * glm::vec4(0.0f, 1.0f, 0.0f, 0.0f);
     upVector = Maths::SafeNormalize(upVector);
     return upVector;
 }
@@ -612,7 +627,7 @@ void Node3D::Attach(Node* parent, bool keepWorldTransform, int32_t index)
         }
     }
 
-    mParentBoneIndex = -1;
+    SetParentBoneIndex(-1);
 
     // Attach to new parent
     if (parent != nullptr)
@@ -633,5 +648,94 @@ void Node3D::Attach(Node* parent, bool keepWorldTransform, int32_t index)
 void Node3D::SetParent(Node* parent)
 {
     Node::SetParent(parent);
+
+    if (mTransformHierarchy != nullptr)
+    {
+        mTransformHierarchy->UpdateParent(this);
+    }
+
     MarkTransformDirty();
 }
+
+void Node3D::OnTransformUpdated()
+{
+
+}
+
+glm::mat4 Node3D::UpdateLocalTransform()
+{
+    // Force uniform scale if the component has children.
+    // Non-uniform scale was causing problems for children components because shear was 
+    // getting introduced into the child transforms if the parent had any rotation.
+    // Relevant Github issues:
+    // https://github.com/BabylonJS/Babylon.js/issues/10579
+    // https://github.com/mrdoob/three.js/issues/3845
+    // https://github.com/armory3d/armory/issues/2211
+    glm::vec3 scale = mScale;
+    if (GetNumChildren() > 0)
+    {
+        scale = glm::vec3(mScale.x, mScale.x, mScale.x);
+    }
+
+    glm::mat4 transform = glm::mat4(1);
+    transform = glm::translate(transform, mPosition);
+    transform *= glm::toMat4(mRotationQuat);
+    transform = glm::scale(transform, scale);
+
+    // Cache off the euler angle rotation.
+    mRotationEuler = GetRotationEuler();
+
+    return transform;
+}
+
+void Node3D::MarkWorldTransformDirty()
+{
+    if (mTransformHierarchy != nullptr)
+    {
+        mTransformHierarchy->MarkDirty(mTransformIndex, TransformHierarchy::kWorldDirty);
+    }
+    else
+    {
+        mTransformDirty = true;
+    }
+}
+
+void Node3D::ClearTransformDirty()
+{
+    if (mTransformHierarchy != nullptr)
+    {
+        mTransformHierarchy->ClearDirty(mTransformIndex);
+    }
+
+    mTransformDirty = false;
+}
+
+void Node3D::SetParentBoneIndex(int32_t boneIndex)
+{
+    mParentBoneIndex = boneIndex;
+
+    if (mTransformHierarchy != nullptr)
+    {
+        mTransformHierarchy->UpdateParent(this);
+    }
+}
+
+glm::mat4& Node3D::GetWorldTransformRef()
+{
+    if (mTransformHierarchy != nullptr)
+    {
+        return mTransformHierarchy->GetWorldTransform(mTransformIndex);
+    }
+
+    return mTransform;
+}
+
+const glm::mat4& Node3D::GetWorldTransformRef() const
+{
+    if (mTransformHierarchy != nullptr)
+    {
+        return mTransformHierarchy->GetWorldTransform(mTransformIndex);
+    }
+
+    return mTransform;
+}
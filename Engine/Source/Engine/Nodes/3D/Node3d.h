@@ -8,6 +8,7 @@
 #include "AssetRef.h"
 
 class SkeletalMesh3D;
+class TransformHierarchy;
 
 class Node3D : public Node
 {
@@ -47,7 +48,7 @@ public:
     glm::quat& GetRotationQuatRef();
     glm::vec3& GetScaleRef();
 
-    const glm::mat4& GetTransform();
+    glm::mat4 GetTransform();
 
     void SetPosition(glm::vec3 position);
     void SetRotation(glm::vec3 rotation);
@@ -90,16 +91,34 @@ public:
 
 protected:
 
+    friend class TransformHierarchy;
+
     virtual void SetParent(Node* parent) override;
 
+    // Called after the world transform has been recomputed.
+    virtual void OnTransformUpdated();
+
+    glm::mat4 UpdateLocalTransform();
+    void MarkWorldTransformDirty();
+    void ClearTransformDirty();
+    void SetParentBoneIndex(int32_t boneIndex);
+
+    // While the node is in a world, its world transform and dirty state live in the world's TransformHierarchy.
+    glm::mat4& GetWorldTransformRef();
+    const glm::mat4& GetWorldTransformRef() const;
+
     glm::vec3 mPosition;
     glm::vec3 mRotationEuler;
     glm::vec3 mScale;
 
     glm::quat mRotationQuat;
 
+    // Only used when the node isn't registered with a TransformHierarchy.
     glm::mat4 mTransform;
+    bool mTransformDirty;
+
     int32_t mParentBoneIndex;
 
-    bool mTransformDirty;
+    TransformHierarchy* mTransformHierarchy = nullptr;
+    int32_t mTransformIndex = -1;
 };
\ No newline at end of file
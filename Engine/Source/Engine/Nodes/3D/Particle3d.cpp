@@ -10,6 +10,8 @@
 
 #include "Graphics/Graphics.h"
 
+#include <atomic>
+
 #if EDITOR
 #include "EditorState.h"
 #endif
@@ -29,6 +31,14 @@ const char* sParticleOrientationStrings[] =
 };
 static_assert(int32_t(ParticleOrientation::Count) == 7, "Need to update string conversion table");
 
+// Emitters are simulated on job threads, where rand() isn't safe to call, so each one has its own xorshift generator.
+static std::atomic<uint32_t> sNextRandSeed { 0 };
+
+static uint32_t MakeRandSeed(const void* emitter)
+{
+    return Maths::MakeRandState(uint32_t(uintptr_t(emitter)) ^ (sNextRandSeed.fetch_add(1) * 0x9e3779b9u));
+}
+
 bool Particle3D::HandlePropChange(Datum* datum, uint32_t index, const void* newValue)
 {
     Property* prop = static_cast<Property*>(datum);
@@ -48,6 +58,7 @@ bool Particle3D::HandlePropChange(Datum* datum, uint32_t index, const void* newV
 Particle3D::Particle3D()
 {
     mName = "Particle";
+    mRandState = MakeRandSeed(this);
 }
 
 Particle3D::~Particle3D()
@@ -88,7 +99,7 @@ void Particle3D::GatherProxyDraws(std::vector<DebugDraw>& inoutDraws)
         debugDraw.mMesh = LoadAsset<StaticMesh>("SM_Sphere");
         debugDraw.mNode = this;
         debugDraw.mColor = color;
-        debugDraw.mTransform = glm::scale(mTransform, { 0.2f, 0.2f, 0.2f });
+        debugDraw.mTransform = glm::scale(GetWorldTransformRef(), { 0.2f, 0.2f, 0.2f });
         inoutDraws.push_back(debugDraw);
     }
 
@@ -114,7 +125,7 @@ void Particle3D::GatherProxyDraws(std::vector<DebugDraw>& inoutDraws)
         debugDraw.mMesh = LoadAsset<StaticMesh>("SM_Cube");
         debugDraw.mNode = this;
         debugDraw.mColor = color;
-        glm::mat4 transform = glm::translate(mTransform, pos);
+        glm::mat4 transform = glm::translate(GetWorldTransformRef(), pos);
         transform = glm::scale(transform, scale);
         debugDraw.mTransform = transform;
         inoutDraws.push_back(debugDraw);
@@ -193,6 +204,7 @@ void Particle3D::TickCommon(float deltaTime)
 {
     mHasSimulatedThisFrame = false;
     mHasUpdatedVerticesThisFrame = false;
+    mHasGeneratedVerticesThisFrame = false;
 
     if (mAutoDestroy)
     {
@@ -283,6 +295,7 @@ void Particle3D::SetParticleSystem(ParticleSystem* particleSystem)
     if (mParticleSystem.Get<ParticleSystem>() != particleSystem)
     {
         mParticleSystem = particleSystem;
+        UpdateSpatialBounds();
     }
 }
 
@@ -563,17 +576,17 @@ void Particle3D::SpawnNewParticles(float deltaTime)
         {
             Particle newParticle;
 
-            newParticle.mLifetime = Maths::RandRange(params.mLifetimeMin, params.mLifetimeMax);
+            newParticle.mLifetime = Maths::RandRange(mRandState, params.mLifetimeMin, params.mLifetimeMax);
             if (system->IsRadialSpawn())
             {
                 // Doing the powf(x,1/3) seems to be important for getting a uniform distribution in sphere.
-                float distUnit = Maths::RandRange(params.mPositionMin.x, params.mPositionMax.x);
+                float distUnit = Maths::RandRange(mRandState, params.mPositionMin.x, params.mPositionMax.x);
                 distUnit = Maths::Map(distUnit, params.mPositionMin.x, params.mPositionMax.x, 0.0f, 1.0f);
                 distUnit = powf(distUnit, 1 / 3.0f);
                 distUnit = Maths::Map(distUnit, 0.0f, 1.0f, params.mPositionMin.x, params.mPositionMax.x);
 
-                float yaw = Maths::RandRange(0.0f, PI * 2.0f);
-                float pitch = Maths::RandRange(-PI/2.0f, PI/2.0f);
+                float yaw = Maths::RandRange(mRandState, 0.0f, PI * 2.0f);
+                float pitch = Maths::RandRange(mRandState, -PI/2.0f, PI/2.0f);
                 glm::vec3 newPos = glm::vec3(0.0f, 0.0f, distUnit);
                 newPos = glm::rotate(newPos, pitch, glm::vec3(1.0f, 0.0f, 0.0f));
                 newPos = glm::rotate(newPos, yaw, glm::vec3(0.0f, 1.0f, 0.0f));
@@ -584,17 +597,17 @@ void Particle3D::SpawnNewParticles(float deltaTime)
             }
             else
             {
-                newParticle.mPosition = Maths::RandRange(params.mPositionMin, params.mPositionMax);
+                newParticle.mPosition = Maths::RandRange(mRandState, params.mPositionMin, params.mPositionMax);
             }
-            newParticle.mVelocity = Maths::RandRange(params.mVelocityMin, params.mVelocityMax);
-            newParticle.mSize = Maths::RandRange(params.mSizeMin, params.mSizeMax);
-            newParticle.mRotation = Maths::RandRange(params.mRotationMin, params.mRotationMax);
-            newParticle.mRotationSpeed = Maths::RandRange(params.mRotationSpeedMin, params.mRotationSpeedMax);
+            newParticle.mVelocity = Maths::RandRange(mRandState, params.mVelocityMin, params.mVelocityMax);
+            newParticle.mSize = Maths::RandRange(mRandState, params.mSizeMin, params.mSizeMax);
+            newParticle.mRotation = Maths::RandRange(mRandState, params.mRotationMin, params.mRotationMax);
+            newParticle.mRotationSpeed = Maths::RandRange(mRandState, params.mRotationSpeedMin, params.mRotationSpeedMax);
 
             if (system->IsRatioLocked())
             {
                 float ratioYX = params.mSizeMax.x != 0.0f ? (params.mSizeMax.y / params.mSizeMax.x) : 1.0f;
-                newParticle.mSize.x = Maths::RandRange(params.mSizeMin.x, params.mSizeMax.x);
+                newParticle.mSize.x = Maths::RandRange(mRandState, params.mSizeMin.x, params.mSizeMax.x);
                 newParticle.mSize.y = ratioYX * newParticle.mSize.x;
             }
 
@@ -609,8 +622,8 @@ void Particle3D::SpawnNewParticles(float deltaTime)
             if (!mUseLocalSpace)
             {
                 // Make sure to do this step AFTER RADIAL VELOCITY
-                newParticle.mPosition = mTransform * glm::vec4(newParticle.mPosition, 1.0f);
-                newParticle.mVelocity = mTransform * glm::vec4(newParticle.mVelocity, 0.0f);
+                newParticle.mPosition = GetWorldTransformRef() * glm::vec4(newParticle.mPosition, 1.0f);
+                newParticle.mVelocity = GetWorldTransformRef() * glm::vec4(newParticle.mVelocity, 0.0f);
             }
 
             mParticles.push_back(newParticle);
@@ -625,6 +638,19 @@ void Particle3D::UpdateVertexBuffer()
     if (system == nullptr || mHasUpdatedVerticesThisFrame)
         return;
 
+    GenerateVertices();
+    GFX_UpdateParticleCompVertexBuffer(this, mVertices);
+
+    mHasUpdatedVerticesThisFrame = true;
+}
+
+void Particle3D::GenerateVertices()
+{
+    ParticleSystem* system = mParticleSystem.Get<ParticleSystem>();
+
+    if (system == nullptr || mHasGeneratedVerticesThisFrame)
+        return;
+
     uint32_t numParticles = (uint32_t)mParticles.size();
     mVertices.resize(numParticles * 4);
 
@@ -734,8 +760,8 @@ void Particle3D::UpdateVertexBuffer()
 
         if (mUseLocalSpace && mOrientation == ParticleOrientation::Billboard)
         {
-            rightAxis = glm::vec4(rightAxis, 0.0f) * mTransform;
-            upAxis = glm::vec4(upAxis, 0.0f) * mTransform;
+            rightAxis = glm::vec4(rightAxis, 0.0f) * GetWorldTransformRef();
+            upAxis = glm::vec4(upAxis, 0.0f) * GetWorldTransformRef();
         }
 
         //   0----2
@@ -759,8 +785,6 @@ void Particle3D::UpdateVertexBuffer()
         verts[3].mColor = color32;
     }
 
-    GFX_UpdateParticleCompVertexBuffer(this, mVertices);
-
-    mHasUpdatedVerticesThisFrame = true;
+    mHasGeneratedVerticesThisFrame = true;
 }
 
@@ -58,6 +58,9 @@ public:
     void Simulate(float deltaTime);
     void UpdateVertexBuffer();
 
+    // Builds the particle quads without uploading them, so it can run on a worker thread.
+    void GenerateVertices();
+
     void Reset();
     void EnableEmission(bool enable);
     bool IsEmissionEnabled() const;
@@ -127,8 +130,10 @@ protected:
     std::vector<VertexParticle> mVertices;
     float mEmissionCounter = 0.0f;
     uint32_t mLoop = 0;
+    uint32_t mRandState = 1;
     bool mHasSimulatedThisFrame = false;
     bool mHasUpdatedVerticesThisFrame = false;
+    bool mHasGeneratedVerticesThisFrame = false;
 
     // Properties
     ParticleSystemRef mParticleSystem;
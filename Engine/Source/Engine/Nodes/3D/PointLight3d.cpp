@@ -70,7 +70,7 @@ void PointLight3D::GatherProxyDraws(std::vector<DebugDraw>& inoutDraws)
         debugDraw.mMesh = LoadAsset<StaticMesh>("SM_Sphere");
         debugDraw.mNode = this;
         debugDraw.mColor = color;
-        debugDraw.mTransform = glm::scale(mTransform, { 0.2f, 0.2f, 0.2f });
+        debugDraw.mTransform = glm::scale(GetTransform(), { 0.2f, 0.2f, 0.2f });
         inoutDraws.push_back(debugDraw);
     }
 
@@ -81,7 +81,7 @@ void PointLight3D::GatherProxyDraws(std::vector<DebugDraw>& inoutDraws)
         debugDraw.mMesh = LoadAsset<StaticMesh>("SM_Sphere");
         debugDraw.mNode = this;
         debugDraw.mColor = color;
-        debugDraw.mTransform = glm::scale(mTransform, { mRadius, mRadius, mRadius });
+        debugDraw.mTransform = glm::scale(GetTransform(), { mRadius, mRadius, mRadius });
         inoutDraws.push_back(debugDraw);
     }
 #endif // EDITOR
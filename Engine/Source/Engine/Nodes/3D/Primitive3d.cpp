@@ -168,7 +168,7 @@ void Primitive3D::Tick(float deltaTime)
 
     if (gameTickEnabled && mPhysicsEnabled)
     {
-        if (mTransformDirty)
+        if (IsTransformDirty())
         {
             UpdateTransform(false);
         }
@@ -252,15 +252,16 @@ void Primitive3D::Render()
 
 }
 
-void Primitive3D::UpdateTransform(bool updateChildren)
+void Primitive3D::OnTransformUpdated()
 {
-    bool updateRigidBody = (mPhysicsEnabled || mCollisionEnabled || mOverlapsEnabled) && mTransformDirty && IsRigidBodyInWorld();
-    Node3D::UpdateTransform(updateChildren);
-    
-    if (updateRigidBody)
+    Node3D::OnTransformUpdated();
+
+    if ((mPhysicsEnabled || mCollisionEnabled || mOverlapsEnabled) && IsRigidBodyInWorld())
     {
         FullSyncRigidBodyTransform();
     }
+
+    UpdateSpatialBounds();
 }
 
 void Primitive3D::SetTransform(const glm::mat4& transform)
@@ -271,6 +272,8 @@ void Primitive3D::SetTransform(const glm::mat4& transform)
     {
         FullSyncRigidBodyTransform();
     }
+
+    UpdateSpatialBounds();
 }
 
 void Primitive3D::EnablePhysics(bool enable)
@@ -785,15 +788,34 @@ Bounds Primitive3D::GetBounds() const
     // Transform the local bounds into world bounds.
     Bounds localBounds = GetLocalBounds();
     Bounds worldBounds;
-    worldBounds.mCenter = mTransform * glm::vec4(localBounds.mCenter, 1.0f);
+    const glm::mat4& worldTransform = GetWorldTransformRef();
+    worldBounds.mCenter = worldTransform * glm::vec4(localBounds.mCenter, 1.0f);
 
-    glm::vec3 absScale = Maths::ExtractScale(mTransform);
+    glm::vec3 absScale = Maths::ExtractScale(worldTransform);
     float maxScale = glm::max(glm::max(absScale.x, absScale.y), absScale.z);
     worldBounds.mRadius = maxScale * localBounds.mRadius;
 
     return worldBounds;
 }
 
+void Primitive3D::UpdateSpatialBounds()
+{
+    if (mSpatialNode != nullptr && mWorld != nullptr)
+    {
+        mWorld->GetSpatialIndex().Update(this);
+    }
+}
+
+btDbvtNode* Primitive3D::GetSpatialNode() const
+{
+    return mSpatialNode;
+}
+
+void Primitive3D::SetSpatialNode(btDbvtNode* node)
+{
+    mSpatialNode = node;
+}
+
 Bounds Primitive3D::GetLocalBounds() const
 {
     // Derived classes should implement a way of getting their local bounds.
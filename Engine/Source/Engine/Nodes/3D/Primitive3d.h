@@ -62,7 +62,6 @@ public:
     virtual void SetWorld(World* world) override;
     virtual void Render() override;
 
-    virtual void UpdateTransform(bool updateChildren) override;
     virtual void SetTransform(const glm::mat4& transform) override;
 
     void EnablePhysics(bool enable);
@@ -138,6 +137,12 @@ public:
     Bounds GetBounds() const;
     virtual Bounds GetLocalBounds() const;
 
+    // Refit this primitive's leaf in the world's SpatialIndex.
+    // Needs to be called whenever GetLocalBounds() would return something new.
+    void UpdateSpatialBounds();
+    btDbvtNode* GetSpatialNode() const;
+    void SetSpatialNode(btDbvtNode* node);
+
     virtual void GatherProxyDraws(std::vector<DebugDraw>& inoutDraws) override;
 
     static bool HandlePropChange(Datum* datum, uint32_t index, const void* newValue);
@@ -146,6 +151,8 @@ public:
 
 protected:
 
+    virtual void OnTransformUpdated() override;
+
     static btCollisionShape* GetEmptyCollisionShape();
 
     bool IsRigidBodyInWorld() const;
@@ -155,6 +162,7 @@ protected:
     btRigidBody* mRigidBody = nullptr;
     OctaveMotionState* mMotionState = nullptr;
     btCollisionShape* mCollisionShape = nullptr;
+    btDbvtNode* mSpatialNode = nullptr;
 
     float mCullDistance = 0.0f;
 
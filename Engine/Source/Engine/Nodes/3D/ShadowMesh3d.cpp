@@ -52,7 +52,7 @@ void ShadowMesh3D::GatherProxyDraws(std::vector<DebugDraw>& inoutDraws)
 
     DebugDraw debugDraw;
     debugDraw.mMesh = mStaticMesh.Get<StaticMesh>();
-    debugDraw.mTransform = mTransform;
+    debugDraw.mTransform = GetTransform();
     debugDraw.mColor = glm::vec4(0.6f, 0.0f, 1.0f, 1.0f);
     debugDraw.mNode = this;
     inoutDraws.push_back(debugDraw);
@@ -1,6 +1,7 @@
 #include "Nodes/3D/SkeletalMesh3d.h"
 #include "Nodes/3D/StaticMesh3d.h"
 #include "Assets/SkeletalMesh.h"
+#include "AnimCompression.h"
 #include "Renderer.h"
 #include "AssetManager.h"
 #include "Log.h"
@@ -9,6 +10,9 @@
 
 #include "Graphics/Graphics.h"
 
+#include <string.h>
+#include <algorithm>
+
 static const char* sBoneInfluenceModeStrings[] =
 {
     "One Bone",
@@ -165,6 +169,12 @@ void SkeletalMesh3D::SetSkeletalMesh(SkeletalMesh* skeletalMesh)
     {
         mSkeletalMesh = skeletalMesh;
 
+        // Animation indices are specific to a mesh.
+        for (uint32_t i = 0; i < mActiveAnimations.size(); ++i)
+        {
+            mActiveAnimations[i].mAnimIndex = -1;
+        }
+
         if (skeletalMesh != nullptr)
         {
             if (GFX_IsCpuSkinningRequired(this))
@@ -186,11 +196,14 @@ void SkeletalMesh3D::SetSkeletalMesh(SkeletalMesh* skeletalMesh)
 
             // Resize and clear matrices to identity matrix.
             mBoneMatrices.resize(skeletalMesh->GetNumBones(), glm::mat4(1));
+            mSkinnedPose.clear();
         }
         else
         {
             mBoneMatrices.resize(0);
         }
+
+        UpdateSpatialBounds();
     }
 }
 
@@ -389,6 +402,7 @@ bool SkeletalMesh3D::IsInheritPoseEnabled() const
 void SkeletalMesh3D::SetBoundsRadiusOverride(float radius)
 {
     mBoundsRadiusOverride = radius;
+    UpdateSpatialBounds();
 }
 
 float SkeletalMesh3D::GetBoundsRadiusOverride() const
@@ -472,69 +486,93 @@ void SkeletalMesh3D::SetScriptAnimEventHandler(const ScriptFunc& func)
     mAnimEventHandler.mScriptFunc = func;
 }
 
-glm::vec3 SkeletalMesh3D::InterpolateScale(float time, const Channel& channel)
+glm::vec3 SkeletalMesh3D::InterpolateScale(float time, const Animation& anim, const Channel& channel, uint32_t& cursor)
 {
-    if (channel.mScaleKeys.size() == 1)
+    const float* times = anim.mScaleTimes.data() + channel.mScaleStart;
+    const glm::vec3* values = anim.mScaleValues.data() + channel.mScaleStart;
+
+    if (channel.mNumScaleKeys == 0)
     {
-        return channel.mScaleKeys[0].mValue;
+        return glm::vec3(1.0f);
     }
 
-    uint32_t index = FindScaleIndex(time, channel);
+    if (channel.mNumScaleKeys == 1)
+    {
+        return values[0];
+    }
+
+    uint32_t index = FindKeyIndex(time, times, channel.mNumScaleKeys, cursor);
     uint32_t nextIndex = index + 1;
-    OCT_ASSERT(nextIndex < channel.mScaleKeys.size());
+    OCT_ASSERT(nextIndex < channel.mNumScaleKeys);
 
-    float deltaTime = channel.mScaleKeys[nextIndex].mTime - channel.mScaleKeys[index].mTime;
-    float factor = (time - channel.mScaleKeys[index].mTime) / deltaTime;
+    float deltaTime = times[nextIndex] - times[index];
+    float factor = (time - times[index]) / deltaTime;
     factor = glm::clamp(factor, 0.0f, 1.0f);
     OCT_ASSERT(factor >= 0.0f && factor <= 1.0f);
 
-    glm::vec3 startScale = channel.mScaleKeys[index].mValue;
-    glm::vec3 endScale = channel.mScaleKeys[nextIndex].mValue;
+    glm::vec3 startScale = values[index];
+    glm::vec3 endScale = values[nextIndex];
     glm::vec3 retScale = glm::mix(startScale, endScale, factor);
     return retScale;
 }
 
-glm::quat SkeletalMesh3D::InterpolateRotation(float time, const Channel& channel)
+glm::quat SkeletalMesh3D::InterpolateRotation(float time, const Animation& anim, const Channel& channel, uint32_t& cursor)
 {
-    if (channel.mRotationKeys.size() == 1)
+    const float* times = anim.mRotationTimes.data() + channel.mRotationStart;
+    const glm::quat* values = anim.mRotationValues.data() + channel.mRotationStart;
+
+    if (channel.mNumRotationKeys == 0)
     {
-        return channel.mRotationKeys[0].mValue;
+        return glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
     }
 
-    uint32_t index = FindRotationIndex(time, channel);
+    if (channel.mNumRotationKeys == 1)
+    {
+        return values[0];
+    }
+
+    uint32_t index = FindKeyIndex(time, times, channel.mNumRotationKeys, cursor);
     uint32_t nextIndex = index + 1;
-    OCT_ASSERT(nextIndex < channel.mRotationKeys.size());
+    OCT_ASSERT(nextIndex < channel.mNumRotationKeys);
 
-    float deltaTime = channel.mRotationKeys[nextIndex].mTime - channel.mRotationKeys[index].mTime;
-    float factor = (time - channel.mRotationKeys[index].mTime) / deltaTime;
+    float deltaTime = times[nextIndex] - times[index];
+    float factor = (time - times[index]) / deltaTime;
     factor = glm::clamp(factor, 0.0f, 1.0f);
     OCT_ASSERT(factor >= 0.0f && factor <= 1.0f);
 
-    glm::quat startQuat = channel.mRotationKeys[index].mValue;
-    glm::quat endQuat = channel.mRotationKeys[nextIndex].mValue;
+    glm::quat startQuat = values[index];
+    glm::quat endQuat = values[nextIndex];
     glm::quat retQuat = glm::slerp(startQuat, endQuat, factor);
     retQuat = glm::normalize(retQuat);
     return retQuat;
 }
 
-glm::vec3 SkeletalMesh3D::InterpolatePosition(float time, const Channel& channel)
+glm::vec3 SkeletalMesh3D::InterpolatePosition(float time, const Animation& anim, const Channel& channel, uint32_t& cursor)
 {
-    if (channel.mPositionKeys.size() == 1)
+    const float* times = anim.mPositionTimes.data() + channel.mPositionStart;
+    const glm::vec3* values = anim.mPositionValues.data() + channel.mPositionStart;
+
+    if (channel.mNumPositionKeys == 0)
+    {
+        return glm::vec3(0.0f);
+    }
+
+    if (channel.mNumPositionKeys == 1)
     {
-        return channel.mPositionKeys[0].mValue;
+        return values[0];
     }
 
-    uint32_t index = FindPositionIndex(time, channel);
+    uint32_t index = FindKeyIndex(time, times, channel.mNumPositionKeys, cursor);
     uint32_t nextIndex = index + 1;
-    OCT_ASSERT(nextIndex < channel.mPositionKeys.size());
+    OCT_ASSERT(nextIndex < channel.mNumPositionKeys);
 
-    float deltaTime = channel.mPositionKeys[nextIndex].mTime - channel.mPositionKeys[index].mTime;
-    float factor = (time - channel.mPositionKeys[index].mTime) / deltaTime;
+    float deltaTime = times[nextIndex] - times[index];
+    float factor = (time - times[index]) / deltaTime;
     factor = glm::clamp(factor, 0.0f, 1.0f);
     OCT_ASSERT(factor >= 0.0f && factor <= 1.0f);
 
-    glm::vec3 startPos = channel.mPositionKeys[index].mValue;
-    glm::vec3 endPos = channel.mPositionKeys[nextIndex].mValue;
+    glm::vec3 startPos = values[index];
+    glm::vec3 endPos = values[nextIndex];
     glm::vec3 retPos = glm::mix(startPos, endPos, factor);
     return retPos;
 }
@@ -571,49 +609,42 @@ void SkeletalMesh3D::DetectTriggeredAnimEvents(
     }
 }
 
-uint32_t SkeletalMesh3D::FindScaleIndex(float time, const Channel& channel)
+uint32_t SkeletalMesh3D::FindKeyIndex(float time, const float* keyTimes, uint32_t numKeys, uint32_t& cursor)
 {
-    OCT_ASSERT(channel.mScaleKeys.size() > 0);
-
-    for (uint32_t i = 0; i < channel.mScaleKeys.size() - 1; ++i)
-    {
-        if (time < channel.mScaleKeys[i + 1].mTime)
-        {
-            return i;
-        }
-    }
-
-    return uint32_t(channel.mScaleKeys.size() - 2);
-}
+    // Returns the key that starts the segment containing time, clamped to the first/last segment.
+    OCT_ASSERT(numKeys >= 2);
+    const uint32_t lastSegment = numKeys - 2;
 
-uint32_t SkeletalMesh3D::FindRotationIndex(float time, const Channel& channel)
-{
-    OCT_ASSERT(channel.mRotationKeys.size() > 0);
+    uint32_t index = glm::min(cursor, lastSegment);
 
-    for (uint32_t i = 0; i < channel.mRotationKeys.size() - 1; ++i)
+    if (index == 0 || time >= keyTimes[index])
     {
-        if (time < channel.mRotationKeys[i + 1].mTime)
+        // Normal playback only moves forward a key or two per frame, so step from the cursor.
+        // Anything further than that is treated as a seek.
+        const uint32_t kMaxSteps = 4;
+        uint32_t steps = 0;
+
+        while (index < lastSegment &&
+            time >= keyTimes[index + 1] &&
+            steps < kMaxSteps)
         {
-            return i;
+            ++index;
+            ++steps;
         }
-    }
-
-    return uint32_t(channel.mRotationKeys.size() - 2);
-}
-
-uint32_t SkeletalMesh3D::FindPositionIndex(float time, const Channel& channel)
-{
-    OCT_ASSERT(channel.mPositionKeys.size() > 0);
 
-    for (uint32_t i = 0; i < channel.mPositionKeys.size() - 1; ++i)
-    {
-        if (time < channel.mPositionKeys[i + 1].mTime)
+        if (index == lastSegment || time < keyTimes[index + 1])
         {
-            return i;
+            cursor = index;
+            return index;
         }
     }
 
-    return uint32_t(channel.mPositionKeys.size() - 2);
+    // Seeked (looped, reversed, or skipped ahead) so binary search for the first key after time.
+    const float* upper = std::upper_bound(keyTimes + 1, keyTimes + numKeys, time);
+    index = glm::min(uint32_t(upper - (keyTimes + 1)), lastSegment);
+
+    cursor = index;
+    return index;
 }
 
 glm::mat4 SkeletalMesh3D::GetBoneTransform(const std::string& name) const
@@ -666,7 +697,7 @@ glm::vec3 SkeletalMesh3D::GetBonePosition(int32_t boneIndex) const
         boneIndex < (int32_t)mBoneMatrices.size())
     {
         glm::mat4 offset = glm::inverse(mesh->GetBone(boneIndex).mOffsetMatrix);
-        glm::mat4 transform = mTransform * mBoneMatrices[boneIndex] * offset;
+        glm::mat4 transform = GetWorldTransformRef() * mBoneMatrices[boneIndex] * offset;
         retPosition.x = transform[3][0];
         retPosition.y = transform[3][1];
         retPosition.z = transform[3][2];
@@ -685,7 +716,7 @@ glm::quat SkeletalMesh3D::GetBoneRotationQuat(int32_t boneIndex) const
         boneIndex < (int32_t)mBoneMatrices.size())
     {
         glm::mat4 offset = glm::inverse(mesh->GetBone(boneIndex).mOffsetMatrix);
-        glm::mat4 transform = mTransform * mBoneMatrices[boneIndex] * offset;
+        glm::mat4 transform = GetWorldTransformRef() * mBoneMatrices[boneIndex] * offset;
 
         retRotation = Maths::ExtractRotation(transform);
     }
@@ -713,7 +744,7 @@ glm::vec3 SkeletalMesh3D::GetBoneScale(int32_t boneIndex) const
         boneIndex < (int32_t)mBoneMatrices.size())
     {
         glm::mat4 offset = glm::inverse(mesh->GetBone(boneIndex).mOffsetMatrix);
-        glm::mat4 transform = mTransform * mBoneMatrices[boneIndex] * offset;
+        glm::mat4 transform = GetWorldTransformRef() * mBoneMatrices[boneIndex] * offset;
 
         retScale = Maths::ExtractScale(transform);
     }
@@ -840,17 +871,22 @@ void SkeletalMesh3D::UpdateAnimation(float deltaTime, bool updateBones)
     if (mHasAnimatedThisFrame)
         return;
 
-    static std::vector<DecompTransform> sDecompTransforms;
-    static std::vector<AnimEvent> sAnimEvents;
-    sAnimEvents.clear();
+    EvaluateAnimation(deltaTime, updateBones);
+    FinalizeAnimation();
+}
+
+void SkeletalMesh3D::EvaluateAnimation(float deltaTime, bool updateBones)
+{
+    if (mHasAnimatedThisFrame)
+        return;
+
+    // Scratch space is per thread since multiple meshes can be evaluated at once.
+    thread_local std::vector<DecompTransform> sDecompTransforms;
     sDecompTransforms.clear();
 
     SkeletalMesh* mesh = mSkeletalMesh.Get<SkeletalMesh>();
 
-    bool inheritPose = mInheritPose && 
-        updateBones &&
-        mParent != nullptr && 
-        mParent->GetType() == SkeletalMesh3D::GetStaticType();
+    bool inheritPose = updateBones && IsInheritingPose();
 
     if (inheritPose &&
         mesh != nullptr)
@@ -898,7 +934,27 @@ void SkeletalMesh3D::UpdateAnimation(float deltaTime, bool updateBones)
 
         for (int32_t i = 0; i < (int32_t)mActiveAnimations.size(); ++i)
         {
-            const Animation* anim = mesh->GetAnimation(mActiveAnimations[i].mName.c_str());
+            ActiveAnimation& activeAnim = mActiveAnimations[i];
+            const Animation* anim = mesh->GetAnimation(activeAnim.mAnimIndex);
+
+            // The cached index goes stale if the mesh (or its lookup mesh) is reimported
+            // or its animations are reordered, so make sure it still points at the same animation.
+            if (anim == nullptr ||
+                anim->mName != activeAnim.mName)
+            {
+                activeAnim.mAnimIndex = mesh->FindAnimationIndex(activeAnim.mName.c_str());
+                activeAnim.mKeyCursors.clear();
+                anim = mesh->GetAnimation(activeAnim.mAnimIndex);
+            }
+
+            // Compressed animations can still have raw tracks, so they need cursors too.
+            if (anim != nullptr &&
+                activeAnim.mKeyCursors.size() != anim->mChannels.size())
+            {
+                activeAnim.mKeyCursors.clear();
+                activeAnim.mKeyCursors.resize(anim->mChannels.size());
+            }
+
             bool animFinished = false;
 
             if (anim != nullptr)
@@ -956,9 +1012,23 @@ void SkeletalMesh3D::UpdateAnimation(float deltaTime, bool updateBones)
 
                                 if (boneIndex != -1)
                                 {
-                                    glm::vec3 scale = InterpolateScale(tickTime, anim->mChannels[i]);
-                                    glm::quat rotation = InterpolateRotation(tickTime, anim->mChannels[i]);
-                                    glm::vec3 position = InterpolatePosition(tickTime, anim->mChannels[i]);
+                                    const Channel& channel = anim->mChannels[i];
+                                    glm::vec3 scale;
+                                    glm::quat rotation;
+                                    glm::vec3 position;
+
+                                    AnimKeyCursor& cursor = activeAnim.mKeyCursors[i];
+
+                                    // Tracks without compressed keys use the raw ones.
+                                    scale = (channel.mScaleTrack.mNumKeys > 0) ?
+                                        SampleCompressedVec3(*anim, channel.mScaleTrack, tickTime) :
+                                        InterpolateScale(tickTime, *anim, channel, cursor.mScale);
+                                    rotation = (channel.mRotationTrack.mNumKeys > 0) ?
+                                        SampleCompressedQuat(*anim, channel.mRotationTrack, tickTime) :
+                                        InterpolateRotation(tickTime, *anim, channel, cursor.mRotation);
+                                    position = (channel.mPositionTrack.mNumKeys > 0) ?
+                                        SampleCompressedVec3(*anim, channel.mPositionTrack, tickTime) :
+                                        InterpolatePosition(tickTime, *anim, channel, cursor.mPosition);
 
                                     if (bonesUpdated)
                                     {
@@ -981,7 +1051,7 @@ void SkeletalMesh3D::UpdateAnimation(float deltaTime, bool updateBones)
 
                         if (anim->mEventTracks.size() > 0)
                         {
-                            DetectTriggeredAnimEvents(*anim, prevTickTime, tickTime, animationSpeed, sAnimEvents);
+                            DetectTriggeredAnimEvents(*anim, prevTickTime, tickTime, animationSpeed, mPendingAnimEvents);
                         }
 
                         bonesUpdated = true;
@@ -1048,32 +1118,6 @@ void SkeletalMesh3D::UpdateAnimation(float deltaTime, bool updateBones)
                 CpuSkinVertices();
             }
         }
-
-        // Fire off any events that triggered.
-        if (mAnimEventHandler.mFuncPointer != nullptr)
-        {
-            for (uint32_t i = 0; i < sAnimEvents.size(); ++i)
-            {
-                sAnimEvents[i].mNode = this;
-                mAnimEventHandler.mFuncPointer(sAnimEvents[i]);
-            }
-        }
-        if (mAnimEventHandler.mScriptFunc.IsValid())
-        {
-            for (uint32_t i = 0; i < sAnimEvents.size(); ++i)
-            {
-                sAnimEvents[i].mNode = this;
-
-                Datum animTable;
-                animTable.SetPointerField("node", sAnimEvents[i].mNode);
-                animTable.SetStringField("name", sAnimEvents[i].mName);
-                animTable.SetStringField("animation", sAnimEvents[i].mAnimation);
-                animTable.SetFloatField("time", sAnimEvents[i].mTime);
-                animTable.SetVectorField("value", sAnimEvents[i].mValue);
-
-                mAnimEventHandler.mScriptFunc.Call(1, &animTable);
-            }
-        }
     }
 
     // CPU skinned characters need to update their verts even if they are paused
@@ -1086,15 +1130,61 @@ void SkeletalMesh3D::UpdateAnimation(float deltaTime, bool updateBones)
         CpuSkinVertices();
     }
 
-    if (updateBones)
+    mPendingAttachedUpdate = updateBones;
+    mHasAnimatedThisFrame = true;
+}
+
+void SkeletalMesh3D::FinalizeAnimation()
+{
+    if (mPendingSkinUploads > 0)
     {
-        UpdateAttachedChildren(deltaTime);
+        GFX_UpdateSkeletalMeshCompVertexBuffer(this, mSkinnedVertices);
+        mPendingSkinUploads--;
     }
 
-    mHasAnimatedThisFrame = true;
+    // Fire off any events that triggered.
+    if (mAnimEventHandler.mFuncPointer != nullptr)
+    {
+        for (uint32_t i = 0; i < mPendingAnimEvents.size(); ++i)
+        {
+            mPendingAnimEvents[i].mNode = this;
+            mAnimEventHandler.mFuncPointer(mPendingAnimEvents[i]);
+        }
+    }
+    if (mAnimEventHandler.mScriptFunc.IsValid())
+    {
+        for (uint32_t i = 0; i < mPendingAnimEvents.size(); ++i)
+        {
+            mPendingAnimEvents[i].mNode = this;
+
+            Datum animTable;
+            animTable.SetPointerField("node", mPendingAnimEvents[i].mNode);
+            animTable.SetStringField("name", mPendingAnimEvents[i].mName);
+            animTable.SetStringField("animation", mPendingAnimEvents[i].mAnimation);
+            animTable.SetFloatField("time", mPendingAnimEvents[i].mTime);
+            animTable.SetVectorField("value", mPendingAnimEvents[i].mValue);
+
+            mAnimEventHandler.mScriptFunc.Call(1, &animTable);
+        }
+    }
+
+    mPendingAnimEvents.clear();
+
+    if (mPendingAttachedUpdate)
+    {
+        UpdateAttachedChildren();
+        mPendingAttachedUpdate = false;
+    }
+}
+
+bool SkeletalMesh3D::IsInheritingPose() const
+{
+    return mInheritPose &&
+        mParent != nullptr &&
+        mParent->GetType() == SkeletalMesh3D::GetStaticType();
 }
 
-void SkeletalMesh3D::UpdateAttachedChildren(float deltaTime)
+void SkeletalMesh3D::UpdateAttachedChildren()
 {
     bool isAnimating = !mAnimationPaused &&
         (mAnimationSpeed != 0.0f) &&
@@ -1119,44 +1209,29 @@ void SkeletalMesh3D::CpuSkinVertices()
     SkeletalMesh* mesh = mSkeletalMesh.Get<SkeletalMesh>();
     if (mesh != nullptr)
     {
-        mSkinnedVertices.resize(mesh->GetNumVertices());
-        const std::vector<VertexSkinned>& verts = mesh->GetVertices();
+        thread_local std::vector<BoneAffine> sBones;
+        ConvertBoneMatrices(mBoneMatrices, sBones);
 
-        if (mBoneInfluenceMode == BoneInfluenceMode::One)
-        {
-            for (uint32_t i = 0; i < mesh->GetNumVertices(); ++i)
-            {
-                const VertexSkinned& srcVert = verts[i];
-                Vertex& dstVert = mSkinnedVertices[i];
-
-                glm::mat4 transform = mBoneMatrices[srcVert.mBoneIndices[0]];
+        uint32_t numVerts = mesh->GetNumVertices();
 
-                dstVert.mPosition = transform * glm::vec4(srcVert.mPosition, 1.0f);
-                dstVert.mNormal = transform * glm::vec4(srcVert.mNormal, 0.0f);
-                dstVert.mTexcoord0 = srcVert.mTexcoord0;
-                dstVert.mTexcoord1 = srcVert.mTexcoord1;
-            }
-        }
-        else
+        // Idle and paused characters keep the same pose, so there is nothing to skin or upload.
+        // Changing the influence mode changes the result even with the same pose.
+        if (mSkinnedVertices.size() == numVerts &&
+            mSkinnedInfluenceMode == mBoneInfluenceMode &&
+            mSkinnedPose.size() == sBones.size() &&
+            memcmp(mSkinnedPose.data(), sBones.data(), sBones.size() * sizeof(BoneAffine)) == 0)
         {
-            for (uint32_t i = 0; i < mesh->GetNumVertices(); ++i)
-            {
-                const VertexSkinned& srcVert = verts[i];
-                Vertex& dstVert = mSkinnedVertices[i];
-
-                static_assert(MAX_BONE_INFLUENCES == 4, "Need to adjust this code or convert to loop.");
-                glm::mat4 transform = mBoneMatrices[srcVert.mBoneIndices[0]] * srcVert.mBoneWeights[0];
-                transform += mBoneMatrices[srcVert.mBoneIndices[1]] * srcVert.mBoneWeights[1];
-                transform += mBoneMatrices[srcVert.mBoneIndices[2]] * srcVert.mBoneWeights[2];
-                transform += mBoneMatrices[srcVert.mBoneIndices[3]] * srcVert.mBoneWeights[3];
-
-                dstVert.mPosition = transform * glm::vec4(srcVert.mPosition, 1.0f);
-                dstVert.mNormal = transform * glm::vec4(srcVert.mNormal, 0.0f);
-                dstVert.mTexcoord0 = srcVert.mTexcoord0;
-                dstVert.mTexcoord1 = srcVert.mTexcoord1;
-            }
+            return;
         }
 
-        GFX_UpdateSkeletalMeshCompVertexBuffer(this, mSkinnedVertices);
+        mSkinnedPose.swap(sBones);
+        mSkinnedInfluenceMode = mBoneInfluenceMode;
+        mSkinnedVertices.resize(numVerts);
+
+        uint32_t numInfluences = (mBoneInfluenceMode == BoneInfluenceMode::One) ? 1 : MAX_BONE_INFLUENCES;
+        SkinVertices(mesh->GetVertices().data(), mSkinnedVertices.data(), numVerts, mSkinnedPose.data(), numInfluences);
+
+        // Uploaded in FinalizeAnimation() since this may be running on a worker thread.
+        mPendingSkinUploads = MAX_FRAMES;
     }
 }
@@ -3,6 +3,7 @@
 #include "Nodes/3D/Mesh3d.h"
 #include "AssetRef.h"
 #include "Vertex.h"
+#include "CpuSkinning.h"
 
 enum class BoneInfluenceMode
 {
@@ -25,6 +26,14 @@ struct AnimEvent;
 struct Channel;
 struct Animation;
 
+// Key index each channel sampled last, so playback only has to step forward from there.
+struct AnimKeyCursor
+{
+    uint32_t mPosition = 0;
+    uint32_t mRotation = 0;
+    uint32_t mScale = 0;
+};
+
 struct ActiveAnimation
 {
     std::string mName;
@@ -32,6 +41,10 @@ struct ActiveAnimation
     float mSpeed = 1.0f;;
     float mWeight = 0.0f;
     bool mLoop = false;
+
+    // Resolved from mName the first time the animation is evaluated, and again if it no longer matches.
+    int32_t mAnimIndex = -1;
+    std::vector<AnimKeyCursor> mKeyCursors;
 };
 
 struct QueuedAnimation
@@ -131,6 +144,13 @@ public:
 
     void UpdateAnimation(float deltaTime, bool updateBones);
 
+    // UpdateAnimation() split in two so that the pose can be evaluated on a worker thread.
+    // EvaluateAnimation() only touches this node (unless it inherits its parent's pose),
+    // while FinalizeAnimation() uploads skinned vertices and fires anim events on the main thread.
+    void EvaluateAnimation(float deltaTime, bool updateBones);
+    void FinalizeAnimation();
+    bool IsInheritingPose() const;
+
     virtual Bounds GetLocalBounds() const override;
 
     int32_t FindBoneIndex(const std::string& name) const;
@@ -145,9 +165,9 @@ protected:
 
     void TickCommon(float deltaTime);
 
-    glm::vec3 InterpolateScale(float time, const Channel& channel);
-    glm::quat InterpolateRotation(float time, const Channel& channel);
-    glm::vec3 InterpolatePosition(float time, const Channel& channel);
+    glm::vec3 InterpolateScale(float time, const Animation& anim, const Channel& channel, uint32_t& cursor);
+    glm::quat InterpolateRotation(float time, const Animation& anim, const Channel& channel, uint32_t& cursor);
+    glm::vec3 InterpolatePosition(float time, const Animation& anim, const Channel& channel, uint32_t& cursor);
     void DetectTriggeredAnimEvents(
         const Animation& animation,
         float prevTickTime,
@@ -155,27 +175,30 @@ protected:
         float animationSpeed,
         std::vector<AnimEvent>& outEvents);
 
-    uint32_t FindScaleIndex(float time, const Channel& channel);
-    uint32_t FindRotationIndex(float time, const Channel& channel);
-    uint32_t FindPositionIndex(float time, const Channel& channel);
+    static uint32_t FindKeyIndex(float time, const float* keyTimes, uint32_t numKeys, uint32_t& cursor);
 
-    void UpdateAttachedChildren(float deltaTime);
+    void UpdateAttachedChildren();
     void CpuSkinVertices();
 
     SkeletalMeshRef mSkeletalMesh;
     std::vector<glm::mat4> mBoneMatrices;
     std::vector<Vertex> mSkinnedVertices; // Used by CPU skinning only.
+    std::vector<BoneAffine> mSkinnedPose; // Bones that mSkinnedVertices were skinned with.
+    BoneInfluenceMode mSkinnedInfluenceMode = BoneInfluenceMode::Four; // Influence mode they were skinned with.
 
     ScriptableFP<AnimEventHandlerFP> mAnimEventHandler;
     std::string mDefaultAnimation;
     float mAnimationSpeed = 1.0f;
     std::vector<ActiveAnimation> mActiveAnimations;
     std::vector<QueuedAnimation> mQueuedAnimations;
+    std::vector<AnimEvent> mPendingAnimEvents;
     float mBoundsRadiusOverride = 0.0f;
     bool mAnimationPaused;
     bool mRevertToBindPose;
     bool mInheritPose;
     bool mHasAnimatedThisFrame;
+    uint8_t mPendingSkinUploads = 0; // Every buffered frame needs the new vertices.
+    bool mPendingAttachedUpdate = false;
 
     BoneInfluenceMode mBoneInfluenceMode;
     AnimationUpdateMode mAnimationUpdateMode;
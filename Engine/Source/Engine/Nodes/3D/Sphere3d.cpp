@@ -65,7 +65,7 @@ void Sphere3D::GatherProxyDraws(std::vector<DebugDraw>& inoutDraws)
     debugDraw.mMesh = LoadAsset<StaticMesh>("SM_Sphere");
     debugDraw.mNode = this;
     debugDraw.mColor = color;
-    debugDraw.mTransform = glm::scale(mTransform, { radiusScale, radiusScale, radiusScale });
+    debugDraw.mTransform = glm::scale(GetTransform(), { radiusScale, radiusScale, radiusScale });
 
     inoutDraws.push_back(debugDraw);
 
@@ -144,6 +144,7 @@ void StaticMesh3D::SetStaticMesh(StaticMesh* staticMesh)
         mStaticMesh = staticMesh;
         RecreateCollisionShape();
         ClearInstanceColors();
+        UpdateSpatialBounds();
     }
 }
 
@@ -223,7 +224,7 @@ void StaticMesh3D::GatherProxyDraws(std::vector<DebugDraw>& inoutDraws)
         if (staticMesh != nullptr &&
             mCollisionShape != nullptr)
         {
-            DrawDebugCollision(inoutDraws, mCollisionShape, mTransform);
+            DrawDebugCollision(inoutDraws, mCollisionShape, GetWorldTransformRef());
         }
     }
 #endif
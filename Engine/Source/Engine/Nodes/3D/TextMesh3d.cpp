@@ -437,4 +437,5 @@ void TextMesh3D::UpdateVertexData()
 void TextMesh3D::UpdateBounds()
 {
     mBounds = ComputeBounds(mVertices);
+    UpdateSpatialBounds();
 }
@@ -10,6 +10,7 @@
 #include "Script.h"
 #include "ObjectRef.h"
 #include "NetworkManager.h"
+#include "NodePool.h"
 #include "Assets/Scene.h"
 
 #include "Nodes/3D/Node3d.h"
@@ -56,6 +57,8 @@
     }
 
 std::unordered_map<TypeId, NetFuncMap> Node::sTypeNetFuncMap;
+std::vector<NodeHandleSlot> Node::sHandleSlots;
+std::vector<uint32_t> Node::sFreeHandleSlots;
 
 #define ENABLE_SCRIPT_FUNCS 1
 
@@ -160,14 +163,40 @@ void Node::Destruct(Node* node)
     }
 }
 
+void* Node::operator new(size_t size)
+{
+    return AllocateNodeMemory(size);
+}
+
+void Node::operator delete(void* memory, size_t size)
+{
+    FreeNodeMemory(memory, size);
+}
+
+void Node::PrewarmPool(TypeId typeId, uint32_t count)
+{
+    Factory* factory = Node::FindFactory(typeId);
+
+    if (factory != nullptr)
+    {
+        ReserveNodeMemory(factory->GetInstanceSize(), count);
+    }
+    else
+    {
+        LogWarning("PrewarmPool: Unknown node type %08x", (uint32_t)typeId);
+    }
+}
+
 Node::Node()
 {
     mName = "Node";
+    AcquireHandle();
 }
 
 Node::~Node()
 {
-
+    // Destroy() normally releases the handle already.
+    ReleaseHandle();
 }
 
 void Node::Create()
@@ -202,21 +231,16 @@ void Node::Destroy()
     }
 
     // Unref userdata is it was created by Node_Lua::Create().
+    // The userdata's node handle goes stale below, so it doesn't need to be cleared.
     if (mUserdataRef != LUA_REFNIL)
     {
         lua_State* L = GetLua();
-
-        // Clear the userdata's mNode member.
-        lua_rawgeti(L, LUA_REGISTRYINDEX, mUserdataRef);
-        Node_Lua* nodeLua = (Node_Lua*) lua_touserdata(L, -1);
-        nodeLua->mNode = nullptr;
-        lua_pop(L, 1);
-
         luaL_unref(L, LUA_REGISTRYINDEX, mUserdataRef);
         mUserdataRef = LUA_REFNIL;
     }
 
-    NodeRef::EraseReferencesToObject(this);
+    // Invalidates every NodeRef (and script userdata) pointing at this node.
+    ReleaseHandle();
 
 #if EDITOR
     GetEditorState()->HandleNodeDestroy(this);
@@ -639,6 +663,32 @@ void Node::EndOverlap(Primitive3D* thisNode, Primitive3D* otherNode)
     }
 }
 
+void Node::BeginOverlapBatch(Primitive3D* thisNode, Primitive3D* const* otherNodes, uint32_t numOthers)
+{
+    if (mScript != nullptr)
+    {
+        mScript->BeginOverlapBatch(thisNode, otherNodes, numOthers);
+    }
+
+    if (mParent != nullptr)
+    {
+        mParent->BeginOverlapBatch(thisNode, otherNodes, numOthers);
+    }
+}
+
+void Node::EndOverlapBatch(Primitive3D* thisNode, Primitive3D* const* otherNodes, uint32_t numOthers)
+{
+    if (mScript != nullptr)
+    {
+        mScript->EndOverlapBatch(thisNode, otherNodes, numOthers);
+    }
+
+    if (mParent != nullptr)
+    {
+        mParent->EndOverlapBatch(thisNode, otherNodes, numOthers);
+    }
+}
+
 void Node::OnCollision(
     Primitive3D* thisNode,
     Primitive3D* otherNode,
@@ -1605,6 +1655,56 @@ bool Node::HasAuthority() const
     return NetIsAuthority();
 }
 
+NodeHandle Node::GetHandle() const
+{
+    return mHandle;
+}
+
+void Node::AcquireHandle()
+{
+    OCT_ASSERT(mHandle.mGeneration == 0);
+    uint32_t index = 0;
+
+    if (sFreeHandleSlots.size() > 0)
+    {
+        index = sFreeHandleSlots.back();
+        sFreeHandleSlots.pop_back();
+    }
+    else
+    {
+        index = uint32_t(sHandleSlots.size());
+        sHandleSlots.emplace_back();
+    }
+
+    NodeHandleSlot& slot = sHandleSlots[index];
+    OCT_ASSERT(slot.mNode == nullptr);
+    slot.mNode = this;
+
+    mHandle.mIndex = index;
+    mHandle.mGeneration = slot.mGeneration;
+}
+
+void Node::ReleaseHandle()
+{
+    if (mHandle.mGeneration != 0)
+    {
+        NodeHandleSlot& slot = sHandleSlots[mHandle.mIndex];
+        OCT_ASSERT(slot.mNode == this && slot.mGeneration == mHandle.mGeneration);
+
+        slot.mNode = nullptr;
+        slot.mGeneration++;
+
+        // Generation 0 is reserved for null handles.
+        if (slot.mGeneration == 0)
+        {
+            slot.mGeneration = 1;
+        }
+
+        sFreeHandleSlots.push_back(mHandle.mIndex);
+        mHandle = NodeHandle();
+    }
+}
+
 int Node::GetUserdataRef() const
 {
     return mUserdataRef;
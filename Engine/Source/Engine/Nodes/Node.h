@@ -42,6 +42,31 @@ typedef std::unordered_map<std::string, NetFunc> NetFuncMap;
 // Can also use a lambda for Traverse() and ForEach() functions
 typedef bool(*NodeTraversalFP)(Node*);
 
+// Weak reference to a node: a slot in the node handle table plus the generation of that slot
+// when the handle was made. Once the node is destroyed the slot's generation moves on, so stale
+// handles resolve to nullptr without having to find and clear them.
+struct NodeHandle
+{
+    uint32_t mIndex = 0;
+    uint32_t mGeneration = 0;
+
+    bool operator==(const NodeHandle& other) const
+    {
+        return mIndex == other.mIndex && mGeneration == other.mGeneration;
+    }
+
+    bool operator!=(const NodeHandle& other) const
+    {
+        return !operator==(other);
+    }
+};
+
+struct NodeHandleSlot
+{
+    Node* mNode = nullptr;
+    uint32_t mGeneration = 1;
+};
+
 #if 0
 struct NodeNetData
 {
@@ -68,6 +93,11 @@ public:
     static Node* Construct(TypeId typeId);
     static void Destruct(Node* node);
 
+    // Node memory comes from NodePool. Prewarming avoids allocating slabs mid-game when a burst of nodes spawns.
+    static void* operator new(size_t size);
+    static void operator delete(void* memory, size_t size);
+    static void PrewarmPool(TypeId typeId, uint32_t count);
+
     Node();
     virtual ~Node();
 
@@ -98,6 +128,8 @@ public:
 
     virtual void BeginOverlap(Primitive3D* thisComp, Primitive3D* otherComp);
     virtual void EndOverlap(Primitive3D* thisComp, Primitive3D* otherComp);
+    virtual void BeginOverlapBatch(Primitive3D* thisComp, Primitive3D* const* otherComps, uint32_t numOthers);
+    virtual void EndOverlapBatch(Primitive3D* thisComp, Primitive3D* const* otherComps, uint32_t numOthers);
     virtual void OnCollision(
         Primitive3D* thisComp,
         Primitive3D* otherComp,
@@ -234,6 +266,25 @@ public:
     int GetUserdataRef() const;
     void SetUserdataRef(int ref);
 
+    NodeHandle GetHandle() const;
+
+    static Node* ResolveHandle(NodeHandle handle)
+    {
+        Node* ret = nullptr;
+
+        if (handle.mIndex < sHandleSlots.size())
+        {
+            const NodeHandleSlot& slot = sHandleSlots[handle.mIndex];
+
+            if (slot.mGeneration == handle.mGeneration)
+            {
+                ret = slot.mNode;
+            }
+        }
+
+        return ret;
+    }
+
     NetFunc* FindNetFunc(const char* name);
     NetFunc* FindNetFunc(uint16_t index);
 
@@ -362,8 +413,15 @@ protected:
 
     void SendNetFunc(NetFunc* func, uint32_t numParams, const Datum** params);
 
+    void AcquireHandle();
+    void ReleaseHandle();
+
     static std::unordered_map<TypeId, NetFuncMap> sTypeNetFuncMap;
 
+    // Nodes are only created and destroyed on the main thread.
+    static std::vector<NodeHandleSlot> sHandleSlots;
+    static std::vector<uint32_t> sFreeHandleSlots;
+
     std::string mName;
 
     World* mWorld = nullptr;
@@ -401,6 +459,7 @@ protected:
 
     Script* mScript = nullptr;
     int mUserdataRef = LUA_REFNIL;
+    NodeHandle mHandle;
     //NodeNetData* mNetData = nullptr;
 
 #if EDITOR
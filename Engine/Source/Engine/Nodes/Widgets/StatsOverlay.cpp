@@ -12,6 +12,7 @@ FORCE_LINK_DEF(StatsOverlay);
 DEFINE_NODE(StatsOverlay, Canvas);
 
 #define DEFAULT_STAT_COLOR glm::vec4(0.4f, 1.0f, 0.4f, 1.0f)
+#define COUNTER_STAT_COLOR glm::vec4(0.4f, 0.8f, 1.0f, 1.0f)
 
 StatsOverlay::StatsOverlay()
 {
@@ -57,6 +58,7 @@ void StatsOverlay::TickCommon(float deltaTime)
     case StatDisplayMode::AllStatText:
         numStats = (uint32_t)GetProfiler()->GetCpuFrameStats().size();
         numStats += (uint32_t)GetProfiler()->GetGpuStats().size();
+        numStats += (uint32_t)GetProfiler()->GetCounterStats().size();
         break;
     case StatDisplayMode::Memory:
         numStats = 1;
@@ -64,6 +66,9 @@ void StatsOverlay::TickCommon(float deltaTime)
     case StatDisplayMode::Network:
         numStats = 2;
         break;
+    case StatDisplayMode::CounterText:
+        numStats = (uint32_t)GetProfiler()->GetCounterStats().size();
+        break;
     default:
         numStats = 0;
         break;
@@ -118,7 +123,8 @@ void StatsOverlay::TickCommon(float deltaTime)
     {
         const std::vector<CpuStat>& cpuStats = GetProfiler()->GetCpuFrameStats();
         const std::vector<GpuStat>& gpuStats = GetProfiler()->GetGpuStats();
-        OCT_ASSERT(numStats <= (cpuStats.size() + gpuStats.size()));
+        const std::vector<CounterStat>& counterStats = GetProfiler()->GetCounterStats();
+        OCT_ASSERT(numStats <= (cpuStats.size() + gpuStats.size() + counterStats.size()));
         uint32_t uStat = 0;
 
         if (mDisplayMode == StatDisplayMode::CpuStatBars ||
@@ -144,6 +150,19 @@ void StatsOverlay::TickCommon(float deltaTime)
                 ++uStat;
             }
         }
+
+        if (mDisplayMode == StatDisplayMode::CounterText ||
+            mDisplayMode == StatDisplayMode::AllStatText)
+        {
+            // Counters last
+            for (uint32_t i = 0; i < counterStats.size(); ++i)
+            {
+                char valueString[24];
+                snprintf(valueString, 24, "%lld", (long long)counterStats[i].mValue);
+                SetStatText(uStat, counterStats[i].mName, valueString, COUNTER_STAT_COLOR, statY);
+                ++uStat;
+            }
+        }
     }
 }
 
@@ -158,6 +177,13 @@ StatDisplayMode StatsOverlay::GetDisplayMode() const
 }
 
 void StatsOverlay::SetStatText(uint32_t index, const char* key, float value, glm::vec4 color, float& y)
+{
+    char valueString[16];
+    snprintf(valueString, 16, "%.2f", value);
+    SetStatText(index, key, valueString, color, y);
+}
+
+void StatsOverlay::SetStatText(uint32_t index, const char* key, const char* value, glm::vec4 color, float& y)
 {
     float keyX = 0.0f;
     float valueX = 150.0f;
@@ -170,9 +196,7 @@ void StatsOverlay::SetStatText(uint32_t index, const char* key, float value, glm
     valueText->SetColor(color);
 
     keyText->SetText(key);
-    char valueString[16];
-    snprintf(valueString, 16, "%.2f", value);
-    valueText->SetText(valueString);
+    valueText->SetText(value);
 
     keyText->SetPosition(keyX, y);
     valueText->SetPosition(valueX, y);
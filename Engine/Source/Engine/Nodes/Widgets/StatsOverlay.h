@@ -14,6 +14,7 @@ enum class StatDisplayMode
     AllStatText,
     Memory,
     Network,
+    CounterText,
 
     Count
 };
@@ -34,6 +35,7 @@ public:
     StatDisplayMode GetDisplayMode() const;
 
     void SetStatText(uint32_t index, const char* key, float value, glm::vec4 color, float& y);
+    void SetStatText(uint32_t index, const char* key, const char* value, glm::vec4 color, float& y);
 
     float mTextSize = 14.0f;
 
@@ -120,6 +120,35 @@ void Profiler::SetGpuStatTime(const char* name, float time)
 #endif
 }
 
+void Profiler::SetCounterStat(const char* name, int64_t value)
+{
+#if PROFILING_ENABLED
+    CounterStat* counterStat = nullptr;
+    for (uint32_t i = 0; i < mCounterStats.size(); ++i)
+    {
+        if (strncmp(mCounterStats[i].mName, name, STAT_NAME_LENGTH) == 0)
+        {
+            counterStat = &mCounterStats[i];
+            break;
+        }
+    }
+
+    if (counterStat == nullptr)
+    {
+        mCounterStats.push_back(CounterStat());
+        counterStat = &(mCounterStats.back());
+        strncpy(counterStat->mName, name, STAT_NAME_LENGTH);
+    }
+
+    counterStat->mValue = value;
+#endif
+}
+
+const std::vector<CounterStat>& Profiler::GetCounterStats() const
+{
+    return mCounterStats;
+}
+
 CpuStat* Profiler::FindCpuStat(const char* name, bool persistent)
 {
     std::vector<CpuStat>& stats = persistent ? mCpuPersistentStats : mCpuFrameStats;
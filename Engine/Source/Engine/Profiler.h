@@ -26,6 +26,13 @@ struct GpuStat
     float mSmoothedTime = 0.0f;
 };
 
+// A value that isn't a timing, like an object or allocation count. Set whenever it changes.
+struct CounterStat
+{
+    char mName[STAT_NAME_BUFFER_LENGTH] = {};
+    int64_t mValue = 0;
+};
+
 class Profiler
 {
 public:
@@ -40,6 +47,9 @@ public:
     void EndGpuStat(const char* name);
     void SetGpuStatTime(const char* name, float time);
 
+    void SetCounterStat(const char* name, int64_t value);
+    const std::vector<CounterStat>& GetCounterStats() const;
+
     CpuStat* FindCpuStat(const char* name, bool persistent);
     const std::vector<CpuStat>& GetCpuFrameStats() const;
 
@@ -54,6 +64,7 @@ protected:
     std::vector<CpuStat> mCpuFrameStats;
     std::vector<CpuStat> mCpuPersistentStats;
     std::vector<GpuStat> mGpuStats;
+    std::vector<CounterStat> mCounterStats;
 };
 
 void CreateProfiler();
@@ -17,6 +17,10 @@
 #include "Line.h"
 #include "Maths.h"
 #include "InputDevices.h"
+#include "CameraFrustum.h"
+#include "FrustumCuller.h"
+#include "SpatialIndex.h"
+#include "JobSystem.h"
 
 #include "Graphics/Graphics.h"
 #include "Graphics/GraphicsConstants.h"
@@ -53,6 +57,8 @@
 using namespace std;
 using namespace std::chrono;
 
+static void SetupCameraFrustum(Camera3D* camera, CameraFrustum& frustum);
+
 Renderer* Renderer::sInstance = nullptr;
 
 void Renderer::Create()
@@ -515,6 +521,7 @@ void Renderer::GatherDrawData(World* world)
     mWireframeDraws.clear();
     mCollisionDraws.clear();
     mWidgetDraws.clear();
+    mDrawsPreCulled = false;
 
     Camera3D* camera = world ? world->GetActiveCamera() : nullptr;
 
@@ -523,6 +530,97 @@ void Renderer::GatherDrawData(World* world)
     {
         glm::vec3 cameraPos = camera->GetWorldPosition();
 
+        // When frustum culling, primitives are gathered with a hierarchical query on the world's
+        // SpatialIndex so that whole culled subtrees are skipped without touching their nodes.
+        // The editor's "only render selected" paint mode still needs the full traversal.
+        const bool useSpatialIndex = enable3D && mFrustumCulling && !onlySelected;
+        CameraFrustum frustum;
+
+        if (useSpatialIndex)
+        {
+            SetupCameraFrustum(camera, frustum);
+        }
+
+        // Returns true if the primitive was added to the draw lists.
+        auto addPrimitiveDrawData = [&](Primitive3D* prim, bool frustumTest) -> bool
+        {
+            DrawData data = prim->GetDrawData();
+            data.mNodeType = prim->GetType();
+
+            bool simpleShadow = (data.mNodeType == ShadowMesh3D::GetStaticType());
+
+            if (frustumTest)
+            {
+                // Spatial index leaves are padded, so do an exact test on the draw bounds.
+                bool inFrustum = frustum.mOrtho ?
+                    frustum.IsSphereInFrustumOrtho(data.mBounds.mCenter, data.mBounds.mRadius) :
+                    frustum.IsSphereInFrustum(data.mBounds.mCenter, data.mBounds.mRadius);
+
+                if (!inFrustum)
+                {
+                    return false;
+                }
+            }
+
+            bool distanceCulled = false;
+            data.mDistance2 = glm::distance2(cameraPos, data.mBounds.mCenter);
+            const float cullDist = prim->GetCullDistance();
+            if (cullDist > 0.0f)
+            {
+                const float cullDist2 = cullDist * cullDist;
+                if (data.mDistance2 > cullDist2)
+                {
+                    distanceCulled = true;
+                }
+            }
+
+            if (data.mNode == nullptr ||
+                distanceCulled)
+            {
+                return false;
+            }
+
+            if (simpleShadow)
+            {
+                mSimpleShadowDraws.push_back(data);
+            }
+            else
+            {
+                switch (data.mBlendMode)
+                {
+                case BlendMode::Opaque:
+                case BlendMode::Masked:
+                    if (prim->ShouldReceiveSimpleShadows())
+                    {
+                        mOpaqueDraws.push_back(data);
+                    }
+                    else
+                    {
+                        mPostShadowOpaqueDraws.push_back(data);
+                    }
+                    break;
+                case BlendMode::Translucent:
+                case BlendMode::Additive:
+                    mTranslucentDraws.push_back(data);
+                    break;
+                default:
+                    break;
+                }
+
+                if (prim->ShouldCastShadows())
+                {
+                    mShadowDraws.push_back(data);
+                }
+
+                if (mDebugMode == DEBUG_WIREFRAME)
+                {
+                    mWireframeDraws.push_back(data);
+                }
+            }
+
+            return true;
+        };
+
         auto gatherDrawData = [&](Node* node) -> bool
         {
             if (!node->IsVisible())
@@ -544,64 +642,9 @@ void Renderer::GatherDrawData(World* world)
 
             if (enable3D && node->IsPrimitive3D())
             {
-                DrawData data = node->GetDrawData();
-                data.mNodeType = node->GetType();
-
-                Primitive3D* prim = (Primitive3D*)node;
-                bool simpleShadow = (data.mNodeType == ShadowMesh3D::GetStaticType());
-
-                bool distanceCulled = false;
-                data.mDistance2 = glm::distance2(cameraPos, data.mBounds.mCenter);
-                const float cullDist = prim ? prim->GetCullDistance() : 0.0f;
-                if (cullDist > 0.0f)
+                if (!useSpatialIndex)
                 {
-                    const float cullDist2 = cullDist * cullDist;
-                    if (data.mDistance2 > cullDist2)
-                    {
-                        distanceCulled = true;
-                    }
-                }
-
-                if (data.mNode != nullptr &&
-                    !distanceCulled)
-                {
-                    if (simpleShadow)
-                    {
-                        mSimpleShadowDraws.push_back(data);
-                    }
-                    else
-                    {
-                        switch (data.mBlendMode)
-                        {
-                        case BlendMode::Opaque:
-                        case BlendMode::Masked:
-                            if (prim->ShouldReceiveSimpleShadows())
-                            {
-                                mOpaqueDraws.push_back(data);
-                            }
-                            else
-                            {
-                                mPostShadowOpaqueDraws.push_back(data);
-                            }
-                            break;
-                        case BlendMode::Translucent:
-                        case BlendMode::Additive:
-                            mTranslucentDraws.push_back(data);
-                            break;
-                        default:
-                            break;
-                        }
-
-                        if (prim->ShouldCastShadows())
-                        {
-                            mShadowDraws.push_back(data);
-                        }
-
-                        if (mDebugMode == DEBUG_WIREFRAME)
-                        {
-                            mWireframeDraws.push_back(data);
-                        }
-                    }
+                    addPrimitiveDrawData(static_cast<Primitive3D*>(node), false);
                 }
             }
             else if (enable2D && node->IsWidget())
@@ -640,10 +683,75 @@ void Renderer::GatherDrawData(World* world)
 
         if (world != nullptr)
         {
-            if (world->GetRootNode() != nullptr)
+            if (useSpatialIndex)
+            {
+                static std::vector<Primitive3D*> sFrustumPrims;
+                sFrustumPrims.clear();
+
+                world->GetSpatialIndex().QueryFrustum(frustum, sFrustumPrims);
+
+                for (uint32_t i = 0; i < sFrustumPrims.size(); ++i)
+                {
+                    Primitive3D* prim = sFrustumPrims[i];
+
+                    // The traversal would have skipped hidden subtrees, so check the whole parent chain.
+                    if (prim->IsVisible(true) &&
+                        addPrimitiveDrawData(prim, true))
+                    {
+                        HandleCullResult(prim, true);
+                    }
+                }
+
+                // Culled skeletal meshes and particles are never returned by the query,
+                // but they may still need to update depending on their settings.
+                // Nodes that were already queued as visible above are left as they are.
+                const std::vector<SkeletalMesh3D*>& skMeshes = world->GetSkeletalMeshes();
+                for (uint32_t i = 0; i < skMeshes.size(); ++i)
+                {
+                    if (skMeshes[i]->IsVisible(true))
+                    {
+                        HandleCullResult(skMeshes[i], false);
+                    }
+                }
+
+                const std::vector<Particle3D*>& particles = world->GetParticles();
+                for (uint32_t i = 0; i < particles.size(); ++i)
+                {
+                    if (particles[i]->IsVisible(true))
+                    {
+                        HandleCullResult(particles[i], false);
+                    }
+                }
+
+                mDrawsPreCulled = true;
+            }
+
+            bool needsTraversal = !useSpatialIndex;
+#if DEBUG_DRAW_ENABLED
+            needsTraversal = needsTraversal || mEnableProxyRendering || (mDebugMode == DEBUG_COLLISION);
+#endif
+
+            if (world->GetRootNode() != nullptr &&
+                needsTraversal)
             {
                 world->GetRootNode()->Traverse(gatherDrawData);
             }
+            else if (enable2D && world->HasWidgets())
+            {
+                // Only walk the widget subtrees instead of the whole world.
+                const std::vector<Widget*>& rootWidgets = world->GetRootWidgets();
+
+                for (uint32_t i = 0; i < rootWidgets.size(); ++i)
+                {
+                    Node* parent = rootWidgets[i]->GetParent();
+
+                    // The traversal would have skipped hidden subtrees, so check the whole parent chain.
+                    if (parent == nullptr || parent->IsVisible(true))
+                    {
+                        rootWidgets[i]->Traverse(gatherDrawData);
+                    }
+                }
+            }
 
             // Need to render these widgets even if in 3D mode.
             enable2D = true;
@@ -968,12 +1076,8 @@ void Renderer::RenderDebugDraws(const std::vector<DebugDraw>& draws, PipelineCon
 #endif
 }
 
-void Renderer::FrustumCull(Camera3D* camera)
+static void SetupCameraFrustum(Camera3D* camera, CameraFrustum& frustum)
 {
-    if (camera == nullptr)
-        return;
-
-    CameraFrustum frustum;
     frustum.SetPosition(camera->GetWorldPosition());
     frustum.SetBasis(
         camera->GetForwardVector(),
@@ -1005,13 +1109,27 @@ void Renderer::FrustumCull(Camera3D* camera)
             nearZ,
             farZ);
     }
+}
+
+void Renderer::FrustumCull(Camera3D* camera)
+{
+    if (camera == nullptr)
+        return;
+
+    CameraFrustum frustum;
+    SetupCameraFrustum(camera, frustum);
 
     int32_t drawsCulled = 0;
-    drawsCulled += FrustumCullDraws(frustum, mOpaqueDraws);
-    drawsCulled += FrustumCullDraws(frustum, mSimpleShadowDraws);
-    drawsCulled += FrustumCullDraws(frustum, mPostShadowOpaqueDraws);
-    drawsCulled += FrustumCullDraws(frustum, mTranslucentDraws);
-    drawsCulled += FrustumCullDraws(frustum, mWireframeDraws);
+
+    // Draws gathered from the spatial index were already culled against this frustum.
+    if (!mDrawsPreCulled)
+    {
+        drawsCulled += FrustumCullDraws(frustum, mOpaqueDraws);
+        drawsCulled += FrustumCullDraws(frustum, mSimpleShadowDraws);
+        drawsCulled += FrustumCullDraws(frustum, mPostShadowOpaqueDraws);
+        drawsCulled += FrustumCullDraws(frustum, mTranslucentDraws);
+        drawsCulled += FrustumCullDraws(frustum, mWireframeDraws);
+    }
     //LogDebug("Draws culled: %d", drawsCulled);
 
     int32_t lightsCulled = 0;
@@ -1029,152 +1147,214 @@ void Renderer::FrustumCull(Camera3D* camera)
 #endif
 }
 
-static inline void HandleCullResult(DrawData& drawData, bool inFrustum)
+void Renderer::HandleCullResult(Node* node, bool inFrustum)
 {
-    if (drawData.mNodeType == SkeletalMesh3D::GetStaticType())
+    std::vector<VisibleUpdate>* updates = nullptr;
+
+    if (node == nullptr)
     {
-        SkeletalMesh3D* skNode = static_cast<SkeletalMesh3D*>(drawData.mNode);
+        return;
+    }
 
-        if (inFrustum)
-        {
-            skNode->UpdateAnimation(GetEngineState()->mGameDeltaTime, true);
-        }
-        else
-        {
-            AnimationUpdateMode animMode = skNode->GetAnimationUpdateMode();
-            if (animMode == AnimationUpdateMode::AlwaysUpdateTimeAndBones)
-            {
-                skNode->UpdateAnimation(GetEngineState()->mGameDeltaTime, true);
-            }
-            else if (animMode == AnimationUpdateMode::AlwaysUpdateTime)
-            {
-                skNode->UpdateAnimation(GetEngineState()->mGameDeltaTime, false);
-            }
-        }
+    // Checked with As<>() so that subclasses get the same update as the World registers them with.
+    if (node->As<SkeletalMesh3D>() != nullptr)
+    {
+        updates = &mSkeletalUpdates;
+    }
+    else if (node->As<Particle3D>() != nullptr)
+    {
+        updates = &mParticleUpdates;
     }
-    else if (drawData.mNodeType == Particle3D::GetStaticType())
+    else
     {
-        Particle3D* pNode = static_cast<Particle3D*>(drawData.mNode);
+        return;
+    }
 
-        if (inFrustum)
-        {
-            pNode->Simulate(GetEngineState()->mGameDeltaTime);
-            pNode->UpdateVertexBuffer();
-        }
-        else if (pNode->ShouldAlwaysSimulate())
-        {
-            pNode->Simulate(GetEngineState()->mGameDeltaTime);
-        }
+    // A node can have draws in multiple lists, so only queue it once.
+    // If any of its draws passed culling, it gets the in-frustum update.
+    auto it = mVisibleUpdateIndices.find(node);
+
+    if (it == mVisibleUpdateIndices.end())
+    {
+        mVisibleUpdateIndices.insert({ node, uint32_t(updates->size()) });
+        updates->push_back(VisibleUpdate(node, inFrustum));
+    }
+    else if (inFrustum)
+    {
+        (*updates)[it->second].mInFrustum = true;
     }
 }
 
-int32_t Renderer::FrustumCullDraws(const CameraFrustum& frustum, std::vector<DrawData>& drawData)
+static bool ShouldUpdateAnimation(SkeletalMesh3D* skNode, bool inFrustum, bool& outUpdateBones)
 {
-    int32_t drawsCulled = 0;
+    AnimationUpdateMode animMode = skNode->GetAnimationUpdateMode();
+    outUpdateBones = inFrustum || (animMode == AnimationUpdateMode::AlwaysUpdateTimeAndBones);
+    return outUpdateBones || (animMode == AnimationUpdateMode::AlwaysUpdateTime);
+}
+
+void Renderer::UpdateVisibleNodes()
+{
+    SCOPED_FRAME_STAT("Visible Update");
+
+    const float deltaTime = GetEngineState()->mGameDeltaTime;
+    JobSystem* jobSystem = JobSystem::Get();
 
-    // Some code duplication below, but I'm doing this to make sure the branching on ortho doesn't impact performance so much.
-    if (frustum.mOrtho)
     {
-        for (int32_t i = int32_t(drawData.size()) - 1; i >= 0; --i)
+        SCOPED_FRAME_STAT("Animation");
+
+        // Meshes that inherit their parent's pose may need to animate the parent first,
+        // so those are left for the serial pass below.
+        jobSystem->ParallelFor(uint32_t(mSkeletalUpdates.size()), 1, [&](uint32_t start, uint32_t end)
         {
-            bool inFrustum = frustum.IsSphereInFrustumOrtho(drawData[i].mBounds.mCenter, drawData[i].mBounds.mRadius);
-            HandleCullResult(drawData[i], inFrustum);
+            for (uint32_t i = start; i < end; ++i)
+            {
+                SkeletalMesh3D* skNode = static_cast<SkeletalMesh3D*>(mSkeletalUpdates[i].mNode);
+                bool updateBones = false;
+
+                if (!skNode->IsInheritingPose() &&
+                    ShouldUpdateAnimation(skNode, mSkeletalUpdates[i].mInFrustum, updateBones))
+                {
+                    skNode->EvaluateAnimation(deltaTime, updateBones);
+                }
+            }
+        });
+
+        for (uint32_t i = 0; i < mSkeletalUpdates.size(); ++i)
+        {
+            SkeletalMesh3D* skNode = static_cast<SkeletalMesh3D*>(mSkeletalUpdates[i].mNode);
+            bool updateBones = false;
 
-            if (!inFrustum)
+            if (ShouldUpdateAnimation(skNode, mSkeletalUpdates[i].mInFrustum, updateBones))
             {
-                drawData.erase(drawData.begin() + i);
-                drawsCulled++;
+                if (skNode->IsInheritingPose())
+                {
+                    skNode->UpdateAnimation(deltaTime, updateBones);
+                }
+                else
+                {
+                    skNode->FinalizeAnimation();
+                }
             }
         }
     }
-    else
+
     {
-        for (int32_t i = int32_t(drawData.size()) - 1; i >= 0; --i)
+        SCOPED_FRAME_STAT("Particles");
+
+        jobSystem->ParallelFor(uint32_t(mParticleUpdates.size()), 1, [&](uint32_t start, uint32_t end)
         {
-            bool inFrustum = frustum.IsSphereInFrustum(drawData[i].mBounds.mCenter, drawData[i].mBounds.mRadius);
-            HandleCullResult(drawData[i], inFrustum);
+            for (uint32_t i = start; i < end; ++i)
+            {
+                Particle3D* pNode = static_cast<Particle3D*>(mParticleUpdates[i].mNode);
+
+                if (mParticleUpdates[i].mInFrustum)
+                {
+                    pNode->Simulate(deltaTime);
+                    pNode->GenerateVertices();
+                }
+                else if (pNode->ShouldAlwaysSimulate())
+                {
+                    pNode->Simulate(deltaTime);
+                }
+            }
+        });
 
-            if (!inFrustum)
+        // Vertex buffer uploads have to happen on the main thread.
+        for (uint32_t i = 0; i < mParticleUpdates.size(); ++i)
+        {
+            if (mParticleUpdates[i].mInFrustum)
             {
-                drawData.erase(drawData.begin() + i);
-                drawsCulled++;
+                static_cast<Particle3D*>(mParticleUpdates[i].mNode)->UpdateVertexBuffer();
             }
         }
     }
 
-    return drawsCulled;
+    mSkeletalUpdates.clear();
+    mParticleUpdates.clear();
+    mVisibleUpdateIndices.clear();
+}
+
+int32_t Renderer::FrustumCullDraws(const CameraFrustum& frustum, std::vector<DrawData>& drawData)
+{
+    static FrustumCuller sCuller;
+    static std::vector<uint8_t> sVisible;
+
+    const uint32_t numDraws = uint32_t(drawData.size());
+    sCuller.SetFrustum(frustum);
+    sCuller.Clear();
+    sCuller.Reserve(numDraws);
+
+    for (uint32_t i = 0; i < numDraws; ++i)
+    {
+        sCuller.AddSphere(drawData[i].mBounds.mCenter, drawData[i].mBounds.mRadius);
+    }
+
+    sVisible.resize(numDraws);
+    sCuller.Cull(sVisible.data());
+
+    for (uint32_t i = 0; i < numDraws; ++i)
+    {
+        HandleCullResult(drawData[i].mNode, sVisible[i] != 0);
+    }
+
+    return int32_t(CompactVisible(drawData, sVisible.data()));
 }
 
 int32_t Renderer::FrustumCullDraws(const CameraFrustum& frustum, std::vector<DebugDraw>& drawData)
 {
-    int32_t drawsCulled = 0;
+    static FrustumCuller sCuller;
+    static std::vector<uint8_t> sVisible;
 
-    for (int32_t i = int32_t(drawData.size()) - 1; i >= 0; --i)
+    const uint32_t numDraws = uint32_t(drawData.size());
+    sCuller.SetFrustum(frustum);
+    sCuller.Clear();
+    sCuller.Reserve(numDraws);
+
+    for (uint32_t i = 0; i < numDraws; ++i)
     {
         Bounds meshBounds = drawData[i].mMesh->GetBounds();
-        Bounds worldBounds;
-        worldBounds.mCenter = drawData[i].mTransform * glm::vec4(meshBounds.mCenter, 1.0f);
+        glm::vec3 worldCenter = drawData[i].mTransform * glm::vec4(meshBounds.mCenter, 1.0f);
 
         glm::vec3 absScale = Maths::ExtractScale(drawData[i].mTransform);
         float maxScale = glm::max(glm::max(absScale.x, absScale.y), absScale.z);
-        worldBounds.mRadius = maxScale * meshBounds.mRadius;
-
-        bool cull = false;
-
-        if (frustum.mOrtho)
-        {
-            cull = !frustum.IsSphereInFrustumOrtho(worldBounds.mCenter, worldBounds.mRadius);
-        }
-        else
-        {
-            cull = !frustum.IsSphereInFrustum(worldBounds.mCenter, worldBounds.mRadius);
-        }
 
-        if (cull)
-        {
-            drawData.erase(drawData.begin() + i);
-            drawsCulled++;
-        }
+        sCuller.AddSphere(worldCenter, maxScale * meshBounds.mRadius);
     }
 
-    return drawsCulled;
+    sVisible.resize(numDraws);
+    sCuller.Cull(sVisible.data());
+
+    return int32_t(CompactVisible(drawData, sVisible.data()));
 }
 
 int32_t Renderer::FrustumCullLights(const CameraFrustum& frustum, std::vector<LightData>& lightData)
 {
-    int32_t lightsCulled = 0;
+    static FrustumCuller sCuller;
+    static std::vector<uint8_t> sVisible;
 
-    // Some code duplication below, but I'm doing this to make sure the branching on ortho doesn't impact performance so much.
-    if (frustum.mOrtho)
-    {
-        for (int32_t i = int32_t(lightData.size()) - 1; i >= 0; --i)
-        {
-            bool directional = (lightData[i].mType == LightType::Directional);
-            bool inFrustum = directional || frustum.IsSphereInFrustumOrtho(lightData[i].mPosition, lightData[i].mRadius);
+    const uint32_t numLights = uint32_t(lightData.size());
+    sCuller.SetFrustum(frustum);
+    sCuller.Clear();
+    sCuller.Reserve(numLights);
 
-            if (!inFrustum)
-            {
-                lightData.erase(lightData.begin() + i);
-                lightsCulled++;
-            }
-        }
+    for (uint32_t i = 0; i < numLights; ++i)
+    {
+        sCuller.AddSphere(lightData[i].mPosition, lightData[i].mRadius);
     }
-    else
+
+    sVisible.resize(numLights);
+    sCuller.Cull(sVisible.data());
+
+    for (uint32_t i = 0; i < numLights; ++i)
     {
-        for (int32_t i = int32_t(lightData.size()) - 1; i >= 0; --i)
+        // Directional lights are never culled.
+        if (lightData[i].mType == LightType::Directional)
         {
-            bool directional = (lightData[i].mType == LightType::Directional);
-            bool inFrustum = directional || frustum.IsSphereInFrustum(lightData[i].mPosition, lightData[i].mRadius);
-
-            if (!inFrustum)
-            {
-                lightData.erase(lightData.begin() + i);
-                lightsCulled++;
-            }
+            sVisible[i] = 1;
         }
     }
 
-    return lightsCulled;
+    return int32_t(CompactVisible(lightData, sVisible.data()));
 }
 
 void Renderer::Render(World* world, int32_t screenIndex)
@@ -1222,15 +1402,17 @@ void Renderer::Render(World* world, int32_t screenIndex)
     {
         SCOPED_FRAME_STAT("Culling");
 
+        // Camera matrices need to be up to date before gathering because
+        // draws may be culled against the camera frustum while gathering.
+        if (enable3D && activeCamera != nullptr)
+        {
+            activeCamera->ComputeMatrices();
+        }
+
         GatherDrawData(world);
 
         if (enable3D)
         {
-            if (activeCamera != nullptr)
-            {
-                activeCamera->ComputeMatrices();
-            }
-
             GatherLightData(world);
 
             if (mFrustumCulling)
@@ -1240,6 +1422,8 @@ void Renderer::Render(World* world, int32_t screenIndex)
         }
     }
 
+    UpdateVisibleNodes();
+
     // Still update UI and cull when minimized (to update animation and particle simulation)
     if (!GetEngineState()->mWindowMinimized)
     {
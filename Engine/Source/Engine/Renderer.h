@@ -3,6 +3,7 @@
 #include <vector>
 #include "glm/glm.hpp"
 #include <array>
+#include <unordered_map>
 
 #include "EngineTypes.h"
 #include "Assets/Texture.h"
@@ -32,6 +33,15 @@ struct FadingLight
     FadingLight(Light3D* comp) : mComponent(comp) {}
 };
 
+// A skeletal mesh or particle node that needs to be updated this frame, and whether it passed culling.
+struct VisibleUpdate
+{
+    Node* mNode = nullptr;
+    bool mInFrustum = false;
+
+    VisibleUpdate(Node* node, bool inFrustum) : mNode(node), mInFrustum(inFrustum) {}
+};
+
 struct LightDistance2
 {
     Light3D* mComponent = nullptr;
@@ -200,6 +210,8 @@ private:
     int32_t FrustumCullDraws(const CameraFrustum& frustum, std::vector<DrawData>& drawData);
     int32_t FrustumCullDraws(const CameraFrustum& frustum, std::vector<DebugDraw>& drawData);
     int32_t FrustumCullLights(const CameraFrustum& frustum, std::vector<LightData>& lightData);
+    void HandleCullResult(Node* node, bool inFrustum);
+    void UpdateVisibleNodes();
 
     void RenderShadowCasters(World* world);
     void RenderSelectedGeometry(World* world);
@@ -227,6 +239,10 @@ private:
     std::vector<DebugDraw> mDebugDraws;
     std::vector<DebugDraw> mCollisionDraws;
 
+    std::vector<VisibleUpdate> mSkeletalUpdates;
+    std::vector<VisibleUpdate> mParticleUpdates;
+    std::unordered_map<Node*, uint32_t> mVisibleUpdateIndices;
+
     World* mCurrentWorld = nullptr;
     uint32_t mFrameIndex = 0;
     uint32_t mScreenIndex = 0;
@@ -235,6 +251,7 @@ private:
     DebugMode mDebugMode = DEBUG_NONE;
     BoundsDebugMode mBoundsDebugMode = BoundsDebugMode::Off;
     bool mFrustumCulling = true;
+    bool mDrawsPreCulled = false;
     bool mEnableProxyRendering = false;
     bool mEnable3dRendering = true;
     bool mEnable2dRendering = true;
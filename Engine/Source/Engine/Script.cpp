@@ -19,6 +19,42 @@
 #include "LuaBindings/World_Lua.h"
 
 std::unordered_map<std::string, ScriptNetFuncMap> Script::sScriptNetFuncMap;
+std::vector<Script*> Script::sTickBatch;
+bool Script::sTickBatching = false;
+int Script::sTickBatchRunnerRef = LUA_REFNIL;
+int Script::sTickBatchTableRef = LUA_REFNIL;
+
+static const char* sScriptCallbackNames[] =
+{
+    "Tick",
+    "EditorTick",
+    "BeginOverlap",
+    "EndOverlap",
+    "BeginOverlapBatch",
+    "EndOverlapBatch",
+    "OnCollision"
+};
+static_assert(OCT_ARRAY_SIZE(sScriptCallbackNames) == int(ScriptCallback::Count), "Need to update callback name array");
+
+// Batch table holds (func, self) pairs. Entries are nil'd as they run so finished
+// instances can be collected, and a destroyed instance simply leaves a hole.
+static const char* sTickBatchRunnerSource =
+    "local batch, count, deltaTime, onError = ...\n"
+    "for i = 1, count * 2, 2 do\n"
+    "    local func = batch[i]\n"
+    "    if func then\n"
+    "        local ok, err = pcall(func, batch[i + 1], deltaTime)\n"
+    "        if not ok then onError(err) end\n"
+    "    end\n"
+    "    batch[i] = nil\n"
+    "    batch[i + 1] = nil\n"
+    "end\n";
+
+static int OnTickBatchError(lua_State* L)
+{
+    LogError("Lua Error: %s\n", lua_tostring(L, 1));
+    return 0;
+}
 
 bool Script::HandleScriptPropChange(Datum* datum, uint32_t index, const void* newValue)
 {
@@ -77,6 +113,11 @@ bool Script::HandleForeignScriptPropChange(Datum* datum, uint32_t index, const v
 Script::Script(Node* owner)
 {
     mOwner = owner;
+
+    for (uint32_t i = 0; i < uint32_t(ScriptCallback::Count); ++i)
+    {
+        mCallbackRefs[i] = LUA_REFNIL;
+    }
 }
 
 Script::~Script()
@@ -91,6 +132,15 @@ Node* Script::GetOwner()
 
 void Script::Tick(float deltaTime)
 {
+#if LUA_BATCHED_TICK
+    if (sTickBatching)
+    {
+        // Tick and replicated data download happen in EndTickBatch()
+        QueueTick();
+        return;
+    }
+#endif
+
     CallTick(deltaTime);
 
     if (NetIsServer())
@@ -439,6 +489,20 @@ void Script::SetScriptProperties(const std::vector<Property>& srcProps)
     CopyPropertyValues(mScriptProps, srcProps);
 }
 
+void Script::CopyScriptPropertyValue(uint32_t index, const Property& srcProp)
+{
+    OCT_ASSERT(index < mScriptProps.size());
+    Property& scriptProp = mScriptProps[index];
+
+    if (scriptProp.IsArray() &&
+        scriptProp.GetCount() != srcProp.GetCount())
+    {
+        scriptProp.SetCount(srcProp.GetCount());
+    }
+
+    scriptProp.SetValue(srcProp.mData.vp, 0, srcProp.mCount);
+}
+
 void Script::GatherReplicatedData()
 {
 #if LUA_ENABLED
@@ -866,7 +930,27 @@ void Script::ExecuteNetFunc(uint16_t index, uint32_t numParams, const Datum** pa
             if (lua_isuserdata(L, -1))
             {
                 int udIdx = lua_gettop(L);
-                lua_getfield(L, udIdx, netFunc->mName.c_str());
+
+                // Same lookup order as CacheCallbacks(): a function set on the instance overrides the class.
+                lua_getuservalue(L, udIdx);
+                lua_pushstring(L, netFunc->mName.c_str());
+                lua_rawget(L, -2);
+                lua_remove(L, -2); // Pop uservalue
+
+                if (!lua_isfunction(L, -1))
+                {
+                    lua_pop(L, 1);
+                    int funcRef = ScriptUtils::GetClassFunctionRef(mClassName, netFunc->mName.c_str());
+
+                    if (funcRef != LUA_REFNIL)
+                    {
+                        lua_rawgeti(L, LUA_REGISTRYINDEX, funcRef);
+                    }
+                    else
+                    {
+                        lua_getfield(L, udIdx, netFunc->mName.c_str());
+                    }
+                }
 
                 if (lua_isfunction(L, -1))
                 {
@@ -1204,36 +1288,54 @@ bool Script::InvokeNetFunc(const char* name, uint32_t numParams, const Datum** p
 void Script::BeginOverlap(Primitive3D* thisNode, Primitive3D* otherNode)
 {
 #if LUA_ENABLED
-    if (mHandleBeginOverlap && IsActive())
+    if (IsActive() && PushCallback(ScriptCallback::BeginOverlap))
     {
         lua_State* L = GetLua();
 
-        // Grab the ud
         lua_rawgeti(L, LUA_REGISTRYINDEX, mUserdataRef);
-
         OCT_ASSERT(lua_isuserdata(L, -1));
-        int udIdx = lua_gettop(L);
-        lua_getfield(L, udIdx, "BeginOverlap");
+        Node_Lua::Create(L, thisNode);
+        Node_Lua::Create(L, otherNode);
+
+        // Func at -4
+        // Instance table (as arg1) at -3
+        // thisComp (as arg2) at -2
+        // othercomp as (arg3) at -1
+        LuaFuncCall(3);
+    }
+#endif
+}
 
-        if (lua_isfunction(L, -1))
+void Script::BeginOverlapBatch(Primitive3D* thisNode, Primitive3D* const* otherNodes, uint32_t numOthers)
+{
+#if LUA_ENABLED
+    if (IsActive() && HasCallback(ScriptCallback::BeginOverlapBatch))
+    {
+        CallOverlapBatch(ScriptCallback::BeginOverlapBatch, thisNode, otherNodes, numOthers);
+    }
+    else
+    {
+        for (uint32_t i = 0; i < numOthers; ++i)
         {
-            lua_pushvalue(L, udIdx);
-            Node_Lua::Create(L, thisNode);
-            Node_Lua::Create(L, otherNode);
-
-            // Instance table at -5
-            // Func at -4
-            // Instance table (as arg1) at -3
-            // thisComp (as arg2) at -2
-            // othercomp as (arg3) at -1
-            LuaFuncCall(3);
+            BeginOverlap(thisNode, otherNodes[i]);
         }
-        else
+    }
+#endif
+}
+
+void Script::EndOverlapBatch(Primitive3D* thisNode, Primitive3D* const* otherNodes, uint32_t numOthers)
+{
+#if LUA_ENABLED
+    if (IsActive() && HasCallback(ScriptCallback::EndOverlapBatch))
+    {
+        CallOverlapBatch(ScriptCallback::EndOverlapBatch, thisNode, otherNodes, numOthers);
+    }
+    else
+    {
+        for (uint32_t i = 0; i < numOthers; ++i)
         {
-            lua_pop(L, 1); // pop nil function
+            EndOverlap(thisNode, otherNodes[i]);
         }
-
-        lua_pop(L, 1); // pop instance table
     }
 #endif
 }
@@ -1241,35 +1343,20 @@ void Script::BeginOverlap(Primitive3D* thisNode, Primitive3D* otherNode)
 void Script::EndOverlap(Primitive3D* thisNode, Primitive3D* otherNode)
 {
 #if LUA_ENABLED
-    if (mHandleEndOverlap && IsActive())
+    if (IsActive() && PushCallback(ScriptCallback::EndOverlap))
     {
         lua_State* L = GetLua();
 
         lua_rawgeti(L, LUA_REGISTRYINDEX, mUserdataRef);
-
         OCT_ASSERT(lua_isuserdata(L, -1));
-        int udIdx = lua_gettop(L);
-        lua_getfield(L, udIdx, "EndOverlap");
-
-        if (lua_isfunction(L, -1))
-        {
-            lua_pushvalue(L, udIdx);
-            Node_Lua::Create(L, thisNode);
-            Node_Lua::Create(L, otherNode);
-
-            // Instance table at -5
-            // Func at -4
-            // Instance table (as arg1) at -3
-            // thisNode (as arg2) at -2
-            // otherNode as (arg3) at -1
-            LuaFuncCall(3);
-        }
-        else
-        {
-            lua_pop(L, 1); // pop nil function
-        }
-
-        lua_pop(L, 1); // pop instance table
+        Node_Lua::Create(L, thisNode);
+        Node_Lua::Create(L, otherNode);
+
+        // Func at -4
+        // Instance table (as arg1) at -3
+        // thisNode (as arg2) at -2
+        // otherNode as (arg3) at -1
+        LuaFuncCall(3);
     }
 #endif
 }
@@ -1282,32 +1369,19 @@ void Script::OnCollision(
     btPersistentManifold* manifold)
 {
 #if LUA_ENABLED
-    if (mHandleOnCollision && IsActive())
+    if (IsActive() && PushCallback(ScriptCallback::OnCollision))
     {
         lua_State* L = GetLua();
 
-        lua_rawgeti(L, LUA_REGISTRYINDEX, mUserdataRef);
+        lua_rawgeti(L, LUA_REGISTRYINDEX, mUserdataRef);        // arg1 - self
         OCT_ASSERT(lua_isuserdata(L, -1));
-        int udIdx = lua_gettop(L);
-        lua_getfield(L, udIdx, "OnCollision");
-
-        if (lua_isfunction(L, -1))
-        {
-            lua_pushvalue(L, udIdx);                                // arg1 - self
-            Node_Lua::Create(L, thisNode);                          // arg2 - thisNode
-            Node_Lua::Create(L, otherNode);                         // arg3 - otherNode
-            Vector_Lua::Create(L, glm::vec4(impactPoint, 0.0f));    // arg4 - impactPoint
-            Vector_Lua::Create(L, glm::vec4(impactNormal, 0.0f));   // arg5 - impactNormal
-            // TODO: Do we want to handle manifold points?
-
-            LuaFuncCall(5);
-        }
-        else
-        {
-            lua_pop(L, 1); // pop nil function
-        }
+        Node_Lua::Create(L, thisNode);                          // arg2 - thisNode
+        Node_Lua::Create(L, otherNode);                         // arg3 - otherNode
+        Vector_Lua::Create(L, glm::vec4(impactPoint, 0.0f));    // arg4 - impactPoint
+        Vector_Lua::Create(L, glm::vec4(impactNormal, 0.0f));   // arg5 - impactNormal
+        // TODO: Do we want to handle manifold points?
 
-        lua_pop(L, 1); // pop instance table
+        LuaFuncCall(5);
     }
 #endif
 }
@@ -1625,17 +1699,15 @@ void Script::CreateScriptInstance()
             OCT_ASSERT(lua_gettop(L) == classTableIdx);
             lua_setfield(L, uvIdx, OCT_CLASS_TABLE_KEY); // Pops script class metatable
 
-            mTickEnabled = CheckIfFunctionExists("Tick");
-            mHandleBeginOverlap = CheckIfFunctionExists("BeginOverlap");
-            mHandleEndOverlap = CheckIfFunctionExists("EndOverlap");
-            mHandleOnCollision = CheckIfFunctionExists("OnCollision");
-
             SetWorld(mOwner->GetWorld());
 
             // Is calling Create() here causing issues? It used to be called after gathering properties.
             // If this causes a problem, consider calling a separate function like PreCreate() or Init() or something.
             CallFunction("Create");
 
+            // Resolve callbacks after Create() so functions it assigns on the instance are picked up.
+            CacheCallbacks();
+
             UploadScriptProperties();
             GatherScriptProperties();
 
@@ -1690,8 +1762,21 @@ void Script::DestroyScriptInstance()
             lua_setfield(L, uvIdx, OCT_CLASS_TABLE_KEY);
 
             lua_pop(L, 1); // Pop userdata
+
+            if (mTickBatchIndex >= 0)
+            {
+                // Leave a hole in the pending tick batch.
+                lua_rawgeti(L, LUA_REGISTRYINDEX, sTickBatchTableRef);
+                lua_pushnil(L);
+                lua_rawseti(L, -2, mTickBatchIndex * 2 + 1);
+                lua_pushnil(L);
+                lua_rawseti(L, -2, mTickBatchIndex * 2 + 2);
+                lua_pop(L, 1);
+            }
         }
 
+        ReleaseCallbacks();
+
         mUserdataRef = LUA_REFNIL;
         mClassName = "";
 
@@ -1699,10 +1784,11 @@ void Script::DestroyScriptInstance()
         mReplicatedData.clear();
     }
 
-    mTickEnabled = false;
-    mHandleBeginOverlap = false;
-    mHandleEndOverlap = false;
-    mHandleOnCollision = false;
+    if (mTickBatchIndex >= 0)
+    {
+        sTickBatch[mTickBatchIndex] = nullptr;
+        mTickBatchIndex = -1;
+    }
 #endif
 }
 
@@ -1716,77 +1802,239 @@ bool Script::LuaFuncCall(int numArgs, int numResults)
 void Script::CallTick(float deltaTime)
 {
 #if LUA_ENABLED
+    if (IsActive() && PushCallback(GetTickCallback()))
+    {
+        lua_State* L = GetLua();
+
+        lua_rawgeti(L, LUA_REGISTRYINDEX, mUserdataRef);
+        OCT_ASSERT(lua_isuserdata(L, -1));
+        lua_pushnumber(L, deltaTime);
+
+        // Func at -3
+        // Instance table (as arg0) at -2
+        // deltaTime as (arg1) at -1
+        LuaFuncCall(2);
+    }
+#endif
+}
+
+void Script::QueueTick()
+{
+#if LUA_ENABLED
+    OCT_ASSERT(mTickBatchIndex == -1);
+
+    if (mTickBatchIndex == -1)
+    {
+        mTickBatchIndex = int32_t(sTickBatch.size());
+        sTickBatch.push_back(this);
 
+        if (IsActive() && PushCallback(GetTickCallback()))
+        {
+            lua_State* L = GetLua();
+
+            lua_rawgeti(L, LUA_REGISTRYINDEX, sTickBatchTableRef);
+            lua_insert(L, -2);
+            lua_rawseti(L, -2, mTickBatchIndex * 2 + 1); // Pops func
+            lua_rawgeti(L, LUA_REGISTRYINDEX, mUserdataRef);
+            lua_rawseti(L, -2, mTickBatchIndex * 2 + 2); // Pops userdata
+            lua_pop(L, 1); // Pop batch table
+        }
+    }
+#endif
+}
+
+ScriptCallback Script::GetTickCallback() const
+{
 #if EDITOR
-    if (IsActive())
+    return IsGameTickEnabled() ? ScriptCallback::Tick : ScriptCallback::EditorTick;
+#else
+    return ScriptCallback::Tick;
+#endif
+}
+
+void Script::BeginTickBatch()
+{
+#if LUA_ENABLED && LUA_BATCHED_TICK
+    OCT_ASSERT(!sTickBatching && sTickBatch.size() == 0);
+
+    if (sTickBatchRunnerRef == LUA_REFNIL)
     {
-        if (IsGameTickEnabled())
+        lua_State* L = GetLua();
+
+        if (luaL_loadstring(L, sTickBatchRunnerSource) != LUA_OK)
         {
-            CallFunction("Tick", deltaTime);
+            LogError("Failed to compile tick batch runner: %s", lua_tostring(L, -1));
+            lua_pop(L, 1);
+            return;
         }
-        else
+
+        sTickBatchRunnerRef = luaL_ref(L, LUA_REGISTRYINDEX);
+
+        lua_newtable(L);
+        sTickBatchTableRef = luaL_ref(L, LUA_REGISTRYINDEX);
+    }
+
+    sTickBatching = true;
+#endif
+}
+
+void Script::EndTickBatch(float deltaTime)
+{
+#if LUA_ENABLED && LUA_BATCHED_TICK
+    if (!sTickBatching)
+    {
+        return;
+    }
+
+    sTickBatching = false;
+
+    if (sTickBatch.size() > 0)
+    {
+        lua_State* L = GetLua();
+
+        lua_rawgeti(L, LUA_REGISTRYINDEX, sTickBatchRunnerRef);
+        lua_rawgeti(L, LUA_REGISTRYINDEX, sTickBatchTableRef);
+        lua_pushinteger(L, lua_Integer(sTickBatch.size()));
+        lua_pushnumber(L, deltaTime);
+        lua_pushcfunction(L, OnTickBatchError);
+        ScriptUtils::CallLuaFunc(4);
+
+        // Scripts destroyed while the batch was running have already cleared their entry.
+        bool server = NetIsServer();
+
+        for (uint32_t i = 0; i < sTickBatch.size(); ++i)
         {
-            CallFunction("EditorTick", deltaTime);
+            Script* script = sTickBatch[i];
+
+            if (script != nullptr)
+            {
+                script->mTickBatchIndex = -1;
+
+                if (server)
+                {
+                    script->DownloadReplicatedData();
+                }
+            }
         }
+
+        sTickBatch.clear();
     }
-#else
-    if (IsActive() && mTickEnabled)
+#endif
+}
+
+void Script::CacheCallbacks()
+{
+#if LUA_ENABLED
+    ReleaseCallbacks();
+
+    if (IsActive())
     {
         lua_State* L = GetLua();
 
         lua_rawgeti(L, LUA_REGISTRYINDEX, mUserdataRef);
         OCT_ASSERT(lua_isuserdata(L, -1));
+        lua_getuservalue(L, -1);
+        int uvIdx = lua_gettop(L);
+        OCT_ASSERT(lua_istable(L, uvIdx));
 
-        lua_getfield(L, -1, "Tick");
-
-        if (lua_isfunction(L, -1))
+        for (uint32_t i = 0; i < uint32_t(ScriptCallback::Count); ++i)
         {
-            lua_pushvalue(L, -2);
-            lua_pushnumber(L, deltaTime);
-
-            // Instance table at -4
-            // Func at -3
-            // Instance table (as arg0) at -2
-            // deltaTime as (arg1) at -1
-            LuaFuncCall(2);
+            // Same lookup order as NodeWrapperIndex: fields set on the instance first, then the class.
+            lua_pushstring(L, sScriptCallbackNames[i]);
+            lua_rawget(L, uvIdx);
+
+            if (lua_isfunction(L, -1))
+            {
+                mCallbackRefs[i] = luaL_ref(L, LUA_REGISTRYINDEX); // Pops function
+                mOwnedCallbackRefs |= (1 << i);
+            }
+            else
+            {
+                lua_pop(L, 1);
+                mCallbackRefs[i] = ScriptUtils::GetClassFunctionRef(mClassName, sScriptCallbackNames[i]);
+            }
         }
-        else
+
+        lua_pop(L, 2); // Pop uservalue + userdata
+    }
+
+    mCallbackGeneration = ScriptUtils::GetScriptGeneration();
+#endif
+}
+
+void Script::ReleaseCallbacks()
+{
+#if LUA_ENABLED
+    lua_State* L = GetLua();
+
+    for (uint32_t i = 0; i < uint32_t(ScriptCallback::Count); ++i)
+    {
+        // Refs that came from the class cache are owned by ScriptUtils.
+        if ((mOwnedCallbackRefs & (1 << i)) && L != nullptr)
         {
-            lua_pop(L, 1);
+            luaL_unref(L, LUA_REGISTRYINDEX, mCallbackRefs[i]);
         }
 
-        lua_pop(L, 1);
+        mCallbackRefs[i] = LUA_REFNIL;
     }
-#endif // EDITOR
 
-#endif // LUA_ENABLED
+    mOwnedCallbackRefs = 0;
+#endif
+}
+
+bool Script::HasCallback(ScriptCallback callback)
+{
+    if (mCallbackGeneration != ScriptUtils::GetScriptGeneration())
+    {
+        // A script file was (re)loaded since the refs were resolved.
+        CacheCallbacks();
+    }
 
+    return mCallbackRefs[uint32_t(callback)] != LUA_REFNIL;
 }
 
-bool Script::CheckIfFunctionExists(const char* funcName)
+bool Script::PushCallback(ScriptCallback callback)
 {
-    bool exists = false;
+    bool pushed = false;
 
 #if LUA_ENABLED
-    if (IsActive())
+    if (HasCallback(callback))
+    {
+        lua_rawgeti(GetLua(), LUA_REGISTRYINDEX, mCallbackRefs[uint32_t(callback)]);
+        pushed = true;
+    }
+#endif
+
+    return pushed;
+}
+
+void Script::CallOverlapBatch(ScriptCallback callback, Primitive3D* thisNode, Primitive3D* const* otherNodes, uint32_t numOthers)
+{
+#if LUA_ENABLED
+    if (PushCallback(callback))
     {
         lua_State* L = GetLua();
 
         lua_rawgeti(L, LUA_REGISTRYINDEX, mUserdataRef);
         OCT_ASSERT(lua_isuserdata(L, -1));
+        Node_Lua::Create(L, thisNode);
 
-        lua_getfield(L, -1, funcName);
+        lua_createtable(L, int(numOthers), 0);
+        int arrayIdx = lua_gettop(L);
 
-        if (lua_isfunction(L, -1))
+        for (uint32_t i = 0; i < numOthers; ++i)
         {
-            exists = true;
+            Node_Lua::Create(L, otherNodes[i]);
+            lua_rawseti(L, arrayIdx, int(i + 1));
         }
 
-        lua_pop(L, 2);
+        // Func at -4
+        // Instance table (as arg1) at -3
+        // thisNode (as arg2) at -2
+        // otherNodes array (as arg3) at -1
+        LuaFuncCall(3);
     }
 #endif
-
-    return exists;
 }
 
 
@@ -18,6 +18,20 @@ struct Node_Lua;
 
 typedef std::unordered_map<std::string, ScriptNetFunc> ScriptNetFuncMap;
 
+// Script functions called by the engine on a regular basis. Their registry refs are cached per instance.
+enum class ScriptCallback : uint8_t
+{
+    Tick,
+    EditorTick,
+    BeginOverlap,
+    EndOverlap,
+    BeginOverlapBatch,
+    EndOverlapBatch,
+    OnCollision,
+
+    Count
+};
+
 class Script
 {
 public:
@@ -54,6 +68,11 @@ public:
 
     void BeginOverlap(Primitive3D* thisNode, Primitive3D* otherNode);
     void EndOverlap(Primitive3D* thisNode, Primitive3D* otherNode);
+
+    // Calls BeginOverlapBatch/EndOverlapBatch(thisNode, otherNodes) if the script defines it,
+    // otherwise falls back to one BeginOverlap/EndOverlap call per other node.
+    void BeginOverlapBatch(Primitive3D* thisNode, Primitive3D* const* otherNodes, uint32_t numOthers);
+    void EndOverlapBatch(Primitive3D* thisNode, Primitive3D* const* otherNodes, uint32_t numOthers);
     void OnCollision(
         Primitive3D* thisNode,
         Primitive3D* otherNode,
@@ -93,8 +112,17 @@ public:
     const std::vector<Property>& GetScriptProperties() const;
     void SetScriptProperties(const std::vector<Property>& srcProps);
 
+    // Same result as copying srcProp into the property appended by AppendScriptProperties() at index,
+    // without making the copy or searching for the script property by name.
+    void CopyScriptPropertyValue(uint32_t index, const Property& srcProp);
+
     static bool OnRepHandler(Datum* datum, uint32_t index, const void* newValue);
 
+    // While a tick batch is open, script ticks are queued instead of called and then all run
+    // from a single Lua loop in EndTickBatch(). Only has an effect when LUA_BATCHED_TICK is enabled.
+    static void BeginTickBatch();
+    static void EndTickBatch(float deltaTime);
+
 protected:
 
     static bool HandleScriptPropChange(Datum* datum, uint32_t index, const void* newValue);
@@ -113,20 +141,32 @@ protected:
     void UploadDatum(Datum& datum, const char* varName);
 
     void CallTick(float deltaTime);
+    void QueueTick();
+    ScriptCallback GetTickCallback() const;
 
-    bool CheckIfFunctionExists(const char* funcName);
+    void CacheCallbacks();
+    void ReleaseCallbacks();
+    bool HasCallback(ScriptCallback callback);
+    bool PushCallback(ScriptCallback callback);
+
+    void CallOverlapBatch(ScriptCallback callback, Primitive3D* thisNode, Primitive3D* const* otherNodes, uint32_t numOthers);
 
     static std::unordered_map<std::string, ScriptNetFuncMap> sScriptNetFuncMap;
 
+    static std::vector<Script*> sTickBatch;
+    static bool sTickBatching;
+    static int sTickBatchRunnerRef;
+    static int sTickBatchTableRef;
+
     Node* mOwner = nullptr;
     int mUserdataRef = LUA_REFNIL;
     std::string mFileName;
     std::string mClassName;
     std::vector<Property> mScriptProps;
     std::vector<ScriptNetDatum> mReplicatedData;
-    bool mTickEnabled = false;
-    bool mHandleBeginOverlap = false;
-    bool mHandleEndOverlap = false;
-    bool mHandleOnCollision = false;
+    int mCallbackRefs[uint32_t(ScriptCallback::Count)];
+    uint32_t mCallbackGeneration = 0;
+    uint32_t mOwnedCallbackRefs = 0; // Bit per callback, set if the ref was taken from an instance field
+    int32_t mTickBatchIndex = -1;
 };
 
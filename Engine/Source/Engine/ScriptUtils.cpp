@@ -1,11 +1,14 @@
 #include "ScriptUtils.h"
 #include "System/System.h"
+#include "LuaBytecode.h"
 
 std::unordered_set<std::string> ScriptUtils::sLoadedLuaFiles;
 std::unordered_set<std::string> ScriptUtils::sLoadingLuaFiles;
 EmbeddedFile* ScriptUtils::sEmbeddedScripts = nullptr;
 uint32_t ScriptUtils::sNumEmbeddedScripts = 0;
 uint32_t ScriptUtils::sNumScriptInstances = 0;
+uint32_t ScriptUtils::sScriptGeneration = 0;
+std::unordered_map<std::string, std::unordered_map<std::string, int>> ScriptUtils::sClassFunctionRefs;
 bool ScriptUtils::sBreakOnScriptError = false;
 
 bool ScriptUtils::IsScriptLoaded(const std::string& className)
@@ -59,6 +62,10 @@ bool ScriptUtils::LoadScriptFile(const std::string& fileName, const std::string&
 #if LUA_ENABLED
     sLoadingLuaFiles.insert(fileName);
 
+    // Running the file can replace functions on this class (or any class it modifies),
+    // so drop every cached function ref.
+    ClearClassFunctionRefs();
+
     lua_State* L = GetLua();
     successful = RunScript(fileName.c_str());
 
@@ -247,16 +254,24 @@ bool ScriptUtils::RunScript(const char* fileName, Datum* ret)
 
     std::string fullFileName = GetEngineState()->mProjectDirectory + "Scripts/" + relativeFileName;
 
+    // Packaged builds may only contain the cooked bytecode (.luac) next to / instead of the source.
+    bool sourceExists = false;
+    bool cookedExists = false;
+
     if (!fileExists)
     {
-        fileExists = SYS_DoesFileExist(fullFileName.c_str(), true);
+        sourceExists = SYS_DoesFileExist(fullFileName.c_str(), true);
+        cookedExists = SYS_DoesFileExist((fullFileName + "c").c_str(), true);
+        fileExists = sourceExists || cookedExists;
     }
 
     if (!fileExists)
     {
         // Fall back to Engine script directory
         fullFileName = std::string("Engine/Scripts/") + relativeFileName;
-        fileExists = SYS_DoesFileExist(fullFileName.c_str(), true);
+        sourceExists = SYS_DoesFileExist(fullFileName.c_str(), true);
+        cookedExists = SYS_DoesFileExist((fullFileName + "c").c_str(), true);
+        fileExists = sourceExists || cookedExists;
     }
 
     if (fileExists)
@@ -274,12 +289,40 @@ bool ScriptUtils::RunScript(const char* fileName, Datum* ret)
         else
         {
             Stream luaStream;
-            luaStream.ReadFile(fullFileName.c_str(), true);
+            luaStream.ReadFile(cookedExists ? (fullFileName + "c").c_str() : fullFileName.c_str(), true);
             luaString.assign(luaStream.GetData(), luaStream.GetSize());
         }
 
+        const char* luaData = luaString.c_str();
+        size_t luaSize = luaString.size();
+
+        if (IsCookedScript(luaData, uint32_t(luaSize)))
+        {
+#if LUA_BYTECODE_SOURCE_CHECK
+            if (embeddedScript == nullptr && sourceExists)
+            {
+                Stream sourceStream;
+                sourceStream.ReadFile(fullFileName.c_str(), true);
+
+                if (HashScriptSource(sourceStream.GetData(), sourceStream.GetSize()) != GetCookedScriptHash(luaData, uint32_t(luaSize)))
+                {
+                    LogDebug("Cooked script is stale, loading source: %s", className.c_str());
+                    luaString.assign(sourceStream.GetData(), sourceStream.GetSize());
+                    luaData = luaString.c_str();
+                    luaSize = luaString.size();
+                }
+            }
+#endif
+
+            if (IsCookedScript(luaData, uint32_t(luaSize)))
+            {
+                luaData += COOKED_SCRIPT_HEADER_SIZE;
+                luaSize -= COOKED_SCRIPT_HEADER_SIZE;
+            }
+        }
+
         std::string chunkName = "@" + className + ".lua";
-        if (luaL_loadbuffer(L, luaString.c_str(), luaString.size(), chunkName.c_str()) || lua_pcall(L, 0, LUA_MULTRET, 0))
+        if (luaL_loadbuffer(L, luaData, luaSize, chunkName.c_str()) || lua_pcall(L, 0, LUA_MULTRET, 0))
         {
             LogError("Lua Error: %s\n", lua_tostring(L, -1));
             if (sBreakOnScriptError) { OCT_ASSERT(0); }
@@ -350,6 +393,75 @@ void ScriptUtils::CallMethod(int userdataIdx, const char* funcName, uint32_t num
 #endif
 }
 
+int ScriptUtils::GetClassFunctionRef(const std::string& className, const char* funcName)
+{
+    int ref = LUA_REFNIL;
+
+#if LUA_ENABLED
+    std::unordered_map<std::string, int>& classRefs = sClassFunctionRefs[className];
+    auto it = classRefs.find(funcName);
+
+    if (it != classRefs.end())
+    {
+        ref = it->second;
+    }
+    else
+    {
+        lua_State* L = GetLua();
+
+        lua_getglobal(L, className.c_str());
+
+        if (lua_istable(L, -1))
+        {
+            // This will propagate up the class inheritance chain via __index metamethod.
+            lua_getfield(L, -1, funcName);
+
+            if (lua_isfunction(L, -1))
+            {
+                ref = luaL_ref(L, LUA_REGISTRYINDEX); // Pops function
+            }
+            else
+            {
+                lua_pop(L, 1);
+            }
+        }
+
+        lua_pop(L, 1); // Pop class table
+
+        // Missing functions are cached too so classes without a handler don't repeat the lookup.
+        classRefs[funcName] = ref;
+    }
+#endif
+
+    return ref;
+}
+
+void ScriptUtils::ClearClassFunctionRefs()
+{
+#if LUA_ENABLED
+    lua_State* L = GetLua();
+
+    if (L != nullptr)
+    {
+        for (auto& classRefs : sClassFunctionRefs)
+        {
+            for (auto& funcRef : classRefs.second)
+            {
+                luaL_unref(L, LUA_REGISTRYINDEX, funcRef.second);
+            }
+        }
+    }
+#endif
+
+    sClassFunctionRefs.clear();
+    ++sScriptGeneration;
+}
+
+uint32_t ScriptUtils::GetScriptGeneration()
+{
+    return sScriptGeneration;
+}
+
 void ScriptUtils::SetBreakOnScriptError(bool enableBreak)
 {
     sBreakOnScriptError = enableBreak;
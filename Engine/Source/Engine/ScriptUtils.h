@@ -2,6 +2,7 @@
 
 #include "ScriptMacros.h"
 #include <unordered_set>
+#include <unordered_map>
 
 class ScriptUtils
 {
@@ -33,6 +34,14 @@ public:
     static Datum GetField(int userdataIdx, int32_t key);
     static void SetField(int userdataIdx, int32_t key, const Datum& value);
 
+    // Registry ref of a function looked up on a script class table (following its inheritance chain),
+    // or LUA_REFNIL if the class doesn't define it. Cached until the next script file is loaded.
+    static int GetClassFunctionRef(const std::string& className, const char* funcName);
+    static void ClearClassFunctionRefs();
+
+    // Incremented whenever a script file is (re)loaded, so cached function refs can tell they are stale.
+    static uint32_t GetScriptGeneration();
+
 private:
 
     static std::unordered_set<std::string> sLoadedLuaFiles;
@@ -40,6 +49,8 @@ private:
     static EmbeddedFile* sEmbeddedScripts;
     static uint32_t sNumEmbeddedScripts;
     static uint32_t sNumScriptInstances;
+    static uint32_t sScriptGeneration;
+    static std::unordered_map<std::string, std::unordered_map<std::string, int>> sClassFunctionRefs;
 
     static bool sBreakOnScriptError;
 };
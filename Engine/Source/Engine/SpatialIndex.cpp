@@ -0,0 +1,131 @@
+#include "SpatialIndex.h"
+#include "CameraFrustum.h"
+#include "Utilities.h"
+#include "Assertion.h"
+
+#include "Nodes/3D/Primitive3d.h"
+
+// Leaves are padded by this fraction of their radius so that small movements
+// can be absorbed without removing and reinserting the leaf.
+static const float kLeafMarginScale = 0.1f;
+
+struct GatherPrimitivesPolicy : btDbvt::ICollide
+{
+    std::vector<Primitive3D*>* mOutPrims = nullptr;
+
+    GatherPrimitivesPolicy(std::vector<Primitive3D*>& outPrims) : mOutPrims(&outPrims) {}
+
+    void Process(const btDbvtNode* leaf) override
+    {
+        mOutPrims->push_back(reinterpret_cast<Primitive3D*>(leaf->data));
+    }
+};
+
+SpatialIndex::SpatialIndex()
+{
+
+}
+
+SpatialIndex::~SpatialIndex()
+{
+    Clear();
+}
+
+void SpatialIndex::Insert(Primitive3D* prim)
+{
+    OCT_ASSERT(prim->GetSpatialNode() == nullptr);
+
+    btDbvtNode* leaf = mTree.insert(ComputeVolume(prim), prim);
+    prim->SetSpatialNode(leaf);
+}
+
+void SpatialIndex::Remove(Primitive3D* prim)
+{
+    btDbvtNode* leaf = prim->GetSpatialNode();
+
+    if (leaf != nullptr)
+    {
+        mTree.remove(leaf);
+        prim->SetSpatialNode(nullptr);
+    }
+}
+
+void SpatialIndex::Update(Primitive3D* prim)
+{
+    btDbvtNode* leaf = prim->GetSpatialNode();
+
+    if (leaf != nullptr)
+    {
+        btDbvtVolume volume = ComputeVolume(prim);
+        btScalar margin = volume.Extents().x() * kLeafMarginScale;
+
+        // Only reinserts the leaf if the new volume escapes the padded one.
+        mTree.update(leaf, volume, margin);
+    }
+}
+
+void SpatialIndex::Clear()
+{
+    std::vector<Primitive3D*> prims;
+    QueryAll(prims);
+
+    for (uint32_t i = 0; i < prims.size(); ++i)
+    {
+        prims[i]->SetSpatialNode(nullptr);
+    }
+
+    mTree.clear();
+}
+
+void SpatialIndex::QueryFrustum(const CameraFrustum& frustum, std::vector<Primitive3D*>& outPrims) const
+{
+    glm::vec4 planes[6];
+    frustum.GetPlanes(planes);
+
+    btVector3 normals[6];
+    btScalar offsets[6];
+
+    for (uint32_t i = 0; i < 6; ++i)
+    {
+        normals[i] = btVector3(planes[i].x, planes[i].y, planes[i].z);
+        offsets[i] = planes[i].w;
+    }
+
+    // Subtrees that are fully outside of a plane are skipped and subtrees
+    // that are fully inside all planes are gathered without further tests.
+    GatherPrimitivesPolicy policy(outPrims);
+    btDbvt::collideKDOP(mTree.m_root, normals, offsets, 6, policy);
+}
+
+void SpatialIndex::QuerySphere(glm::vec3 center, float radius, std::vector<Primitive3D*>& outPrims) const
+{
+    btDbvtVolume volume = btDbvtVolume::FromCR(GlmToBullet(center), radius);
+    GatherPrimitivesPolicy policy(outPrims);
+    mTree.collideTV(mTree.m_root, volume, policy);
+}
+
+void SpatialIndex::QueryRay(glm::vec3 start, glm::vec3 end, std::vector<Primitive3D*>& outPrims) const
+{
+    GatherPrimitivesPolicy policy(outPrims);
+    btDbvt::rayTest(mTree.m_root, GlmToBullet(start), GlmToBullet(end), policy);
+}
+
+void SpatialIndex::QueryAll(std::vector<Primitive3D*>& outPrims) const
+{
+    if (mTree.m_root != nullptr)
+    {
+        GatherPrimitivesPolicy policy(outPrims);
+        btDbvt::enumLeaves(mTree.m_root, policy);
+    }
+}
+
+uint32_t SpatialIndex::GetNumPrimitives() const
+{
+    return uint32_t(mTree.m_leaves);
+}
+
+btDbvtVolume SpatialIndex::ComputeVolume(Primitive3D* prim)
+{
+    Bounds bounds = prim->GetBounds();
+    return btDbvtVolume::FromCR(GlmToBullet(bounds.mCenter), bounds.mRadius);
+}
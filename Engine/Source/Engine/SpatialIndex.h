@@ -0,0 +1,42 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+#include "Maths.h"
+
+#include <BulletCollision/BroadphaseCollision/btDbvt.h>
+
+class Primitive3D;
+class CameraFrustum;
+
+// Persistent bounding volume hierarchy of all the Primitive3Ds in a World.
+// Leaves are inserted/removed when a primitive enters/leaves the world and are
+// refit incrementally when the primitive's transform or local bounds change.
+// Leaf volumes are padded so that small movements don't require a reinsertion,
+// which means query results are conservative and callers should still do an exact test.
+class SpatialIndex
+{
+public:
+
+    SpatialIndex();
+    ~SpatialIndex();
+
+    void Insert(Primitive3D* prim);
+    void Remove(Primitive3D* prim);
+    void Update(Primitive3D* prim);
+    void Clear();
+
+    void QueryFrustum(const CameraFrustum& frustum, std::vector<Primitive3D*>& outPrims) const;
+    void QuerySphere(glm::vec3 center, float radius, std::vector<Primitive3D*>& outPrims) const;
+    void QueryRay(glm::vec3 start, glm::vec3 end, std::vector<Primitive3D*>& outPrims) const;
+    void QueryAll(std::vector<Primitive3D*>& outPrims) const;
+
+    uint32_t GetNumPrimitives() const;
+
+private:
+
+    static btDbvtVolume ComputeVolume(Primitive3D* prim);
+
+    btDbvt mTree;
+};
@@ -9,11 +9,16 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "Zlib/zlib.h"
+
 #define ACQUIRE_FILE_DIRECTLY 1
 
 #define MAX_FILE_SIZE (1024 * 1024 * 1024)
 #define MAX_STRING_SIZE (1024 * 16)
 
+// Set on a block size when the block didn't shrink and was stored as is.
+#define STORED_BLOCK_FLAG 0x80000000
+
 Stream::Stream() :
     mData(nullptr),
     mSize(0),
@@ -160,6 +165,124 @@ void Stream::SetAsyncRequest(AsyncLoadRequest* request)
     mAsyncRequest = request;
 }
 
+void Stream::WriteCompressed(const char* src, uint32_t size, int32_t level)
+{
+    const uint32_t numBlocks = (size + STREAM_COMPRESSION_BLOCK_SIZE - 1) / STREAM_COMPRESSION_BLOCK_SIZE;
+
+    WriteUint32(size);
+    WriteUint32(numBlocks);
+
+    // Reserve the block size table and fill it in once each block has been compressed.
+    uint32_t tablePos = mPos;
+    for (uint32_t i = 0; i < numBlocks; ++i)
+    {
+        WriteUint32(0);
+    }
+
+    std::vector<uint8_t> blockData(compressBound(STREAM_COMPRESSION_BLOCK_SIZE));
+    std::vector<uint32_t> blockSizes(numBlocks);
+
+    for (uint32_t i = 0; i < numBlocks; ++i)
+    {
+        uint32_t srcOffset = i * STREAM_COMPRESSION_BLOCK_SIZE;
+        uint32_t srcSize = glm::min<uint32_t>(size - srcOffset, STREAM_COMPRESSION_BLOCK_SIZE);
+
+        uLongf dstSize = uLongf(blockData.size());
+        int result = compress2(blockData.data(), &dstSize, (const Bytef*)(src + srcOffset), uLong(srcSize), level);
+
+        if (result == Z_OK && dstSize < srcSize)
+        {
+            WriteBytes(blockData.data(), uint32_t(dstSize));
+            blockSizes[i] = uint32_t(dstSize);
+        }
+        else
+        {
+            WriteBytes((const uint8_t*)(src + srcOffset), srcSize);
+            blockSizes[i] = srcSize | STORED_BLOCK_FLAG;
+        }
+    }
+
+    uint32_t endPos = mPos;
+    mPos = tablePos;
+
+    for (uint32_t i = 0; i < numBlocks; ++i)
+    {
+        WriteUint32(blockSizes[i]);
+    }
+
+    mPos = endPos;
+}
+
+bool Stream::Decompress()
+{
+    uint32_t size = ReadUint32();
+    uint32_t numBlocks = ReadUint32();
+
+    if (size > MAX_FILE_SIZE ||
+        numBlocks != (size + STREAM_COMPRESSION_BLOCK_SIZE - 1) / STREAM_COMPRESSION_BLOCK_SIZE ||
+        mPos + numBlocks * sizeof(uint32_t) > mSize)
+    {
+        LogError("Stream has an invalid compressed block table");
+        return false;
+    }
+
+    uint32_t tablePos = mPos;
+    uint32_t srcPos = tablePos + numBlocks * sizeof(uint32_t);
+    char* dst = (char*)malloc(size);
+
+    for (uint32_t i = 0; i < numBlocks; ++i)
+    {
+        mPos = tablePos + i * sizeof(uint32_t);
+        uint32_t blockSize = ReadUint32();
+
+        bool stored = (blockSize & STORED_BLOCK_FLAG) != 0;
+        blockSize &= ~STORED_BLOCK_FLAG;
+
+        uint32_t dstOffset = i * STREAM_COMPRESSION_BLOCK_SIZE;
+        uint32_t dstSize = glm::min<uint32_t>(size - dstOffset, STREAM_COMPRESSION_BLOCK_SIZE);
+        bool valid = (srcPos + blockSize <= mSize);
+
+        if (valid && stored)
+        {
+            valid = (blockSize == dstSize);
+
+            if (valid)
+            {
+                memcpy(dst + dstOffset, mData + srcPos, dstSize);
+            }
+        }
+        else if (valid)
+        {
+            uLongf inflatedSize = uLongf(dstSize);
+            int result = uncompress((Bytef*)(dst + dstOffset), &inflatedSize, (const Bytef*)(mData + srcPos), uLong(blockSize));
+            valid = (result == Z_OK && inflatedSize == dstSize);
+        }
+
+        if (!valid)
+        {
+            LogError("Stream failed to decompress block %d", i);
+            free(dst);
+            mPos = tablePos;
+            return false;
+        }
+
+        srcPos += blockSize;
+    }
+
+    // Swap in the decompressed buffer. Reset() frees the old data unless it was external.
+    AsyncLoadRequest* asyncRequest = mAsyncRequest;
+    Reset();
+
+    mData = dst;
+    mSize = size;
+    mCapacity = size;
+    mPos = 0;
+    mAsyncRequest = asyncRequest;
+    mExternal = false;
+
+    return true;
+}
+
 void Stream::ReadAsset(AssetRef& asset)
 {
     // TODO: Resort to default asset if failed to load?
@@ -182,7 +305,8 @@ void Stream::ReadAsset(AssetRef& asset)
             if (stub != nullptr)
             {
                 // The asset does exist, so we need to load it.
-                AsyncLoadAsset(assetName, &asset);
+                // Dependencies inherit the priority of the asset that needs them.
+                AsyncLoadAsset(assetName, &asset, mAsyncRequest->mPriority);
 
                 // But also... we need to make sure that this dependency loads before the current async load asset.
                 // So we can add this asset stub to the list of dependent assets on the AsyncLoadRequest object
@@ -303,6 +427,41 @@ void Stream::WriteBytes(const uint8_t* src, uint32_t length)
     }
 }
 
+void Stream::ReadBlock(uint8_t* dst, uint32_t length)
+{
+    AlignPos(STREAM_BLOCK_ALIGNMENT);
+    ReadBytes(dst, length);
+}
+
+void Stream::WriteBlock(const uint8_t* src, uint32_t length)
+{
+    AlignPos(STREAM_BLOCK_ALIGNMENT);
+    WriteBytes(src, length);
+}
+
+void Stream::SkipBlock(uint32_t length)
+{
+    AlignPos(STREAM_BLOCK_ALIGNMENT);
+    OCT_ASSERT(mPos + length <= mSize);
+    mPos = glm::min(mPos + length, mSize);
+}
+
+void Stream::AlignPos(uint32_t alignment)
+{
+    OCT_ASSERT(alignment > 0 && (alignment & (alignment - 1)) == 0);
+    uint32_t alignedPos = (mPos + alignment - 1) & ~(alignment - 1);
+
+    if (alignedPos > mSize)
+    {
+        // Writing past the end, so zero the padding to keep saved files deterministic.
+        uint32_t oldSize = mSize;
+        Grow(alignedPos);
+        memset(&mData[oldSize], 0, alignedPos - oldSize);
+    }
+
+    mPos = alignedPos;
+}
+
 int32_t Stream::ReadInt32()
 {
     int32_t ret = 0;
@@ -12,6 +12,14 @@
 
 #define STREAM_STRING_LEN_BYTES 4
 
+// Compressed data is split into blocks that are deflated independently.
+#define STREAM_COMPRESSION_BLOCK_SIZE (64 * 1024)
+#define STREAM_COMPRESSION_FAST 1
+#define STREAM_COMPRESSION_MAX 9
+
+// Bulk arrays (vertices, indices, instance data) start on this boundary relative to the start of the stream.
+#define STREAM_BLOCK_ALIGNMENT 16
+
 class AssetRef;
 struct AsyncLoadRequest;
 
@@ -35,6 +43,14 @@ public:
 
     void SetAsyncRequest(AsyncLoadRequest* request);
 
+    // Appends src as a table of block sizes followed by the zlib compressed blocks.
+    // Level is a zlib compression level (STREAM_COMPRESSION_FAST to STREAM_COMPRESSION_MAX).
+    void WriteCompressed(const char* src, uint32_t size, int32_t level);
+
+    // Inflates the compressed blocks at the current position directly into a new buffer,
+    // which then replaces the contents of this stream. External streams become owning streams.
+    bool Decompress();
+
     void ReadAsset(AssetRef& asset);
     void WriteAsset(const AssetRef& asset);
 
@@ -46,6 +62,13 @@ public:
 
     uint32_t ReadBytesMax(uint8_t* dst, uint32_t length);
 
+    // Blocks are raw bytes padded to STREAM_BLOCK_ALIGNMENT. No endian swapping is done,
+    // so the caller is responsible for storing them in the byte order of the target platform.
+    void ReadBlock(uint8_t* dst, uint32_t length);
+    void WriteBlock(const uint8_t* src, uint32_t length);
+    void SkipBlock(uint32_t length);
+    void AlignPos(uint32_t alignment);
+
     int32_t ReadInt32();
     uint32_t ReadUint32();
     int16_t ReadInt16();
@@ -2,6 +2,8 @@
 
 #include "Nodes/Node.h"
 
+#include <algorithm>
+
 TimerManager gTimerManager;
 
 TimerManager* GetTimerManager()
@@ -9,175 +11,300 @@ TimerManager* GetTimerManager()
     return &gTimerManager;
 }
 
+bool TimerManager::TimerHeapCompare(const TimerHeapEntry& a, const TimerHeapEntry& b)
+{
+    // std heap functions build a max-heap, so invert to keep the earliest expiry at the front.
+    return a.mExpireTime > b.mExpireTime;
+}
+
 void TimerManager::Update(float deltaTime)
 {
-    static std::vector<TimerData> sTimersToExecute;
-    sTimersToExecute.clear();
+    mTime += deltaTime;
+    mFiredTimers.clear();
 
-    for (int32_t i = 0; i < (int32_t)mTimerData.size(); ++i)
+    // Gather every timer that is due before executing any of them,
+    // otherwise the handler functions could add/remove timers while we are popping the heap.
+    while (mTimerHeap.size() > 0 &&
+        mTimerHeap.front().mExpireTime <= mTime)
     {
-        TimerData* timer = &(mTimerData[i]);
+        TimerHeapEntry entry = mTimerHeap.front();
+        std::pop_heap(mTimerHeap.begin(), mTimerHeap.end(), TimerHeapCompare);
+        mTimerHeap.pop_back();
 
-        if (!timer->mPaused)
+        TimerData& timer = mTimerData[entry.mSlot];
+
+        if (timer.mId == -1 ||
+            timer.mHeapStamp != entry.mStamp)
         {
-            timer->mTimeRemaining -= deltaTime;
+            // Cleared, paused or rescheduled since this entry was pushed.
+            continue;
+        }
 
-            if (timer->mTimeRemaining <= 0.0f)
-            {
-                // Add this to the list of timers to execute.
-                // This has to be done after iterating, otherwise these timer
-                // handler functions could add/remove timers from the timer array.
-                sTimersToExecute.push_back(*timer);
-
-                if (timer->mLoop)
-                {
-                    // If looping, reset time remaining
-                    timer->mTimeRemaining = timer->mDuration;
-                }
-                else
-                {
-                    // If not looping, remove the timer from the vector
-                    mTimerData.erase(mTimerData.begin() + i);
-                    --i;
-                }
-            }
+        mFiredTimers.push_back({ entry.mSlot, timer.mId });
+
+        if (!timer.mLoop)
+        {
+            // Non-looping timers are no longer visible by id once they fire.
+            // The slot is released after the handler runs.
+            mTimerSlots.erase(timer.mId);
         }
     }
 
-    for (uint32_t i = 0; i < sTimersToExecute.size(); ++i)
+    // Looping timers restart from now (like the old per-frame countdown) and fire at most once per update.
+    for (uint32_t i = 0; i < mFiredTimers.size(); ++i)
     {
-        TimerData* timer = &(sTimersToExecute[i]);
+        TimerData& timer = mTimerData[mFiredTimers[i].mSlot];
 
-        // Execute callback handler
-        switch (timer->mType)
+        if (timer.mLoop)
         {
-        case TimerType::Void:
-        {
-            if (timer->mHandler != nullptr)
-            {
-                TimerHandlerFP handler = (TimerHandlerFP)timer->mHandler;
-                handler();
-            }
-            break;
+            ScheduleTimer(mFiredTimers[i].mSlot, mTime + timer.mDuration);
         }
-        case TimerType::Pointer:
+    }
+
+    for (uint32_t i = 0; i < mFiredTimers.size(); ++i)
+    {
+        FiredTimer fired = mFiredTimers[i];
+
+        // An earlier handler may have cleared this timer (and its slot may have been reused).
+        if (fired.mSlot >= int32_t(mTimerData.size()) ||
+            mTimerData[fired.mSlot].mId != fired.mId)
         {
-            if (timer->mHandler != nullptr)
-            {
-                PointerTimerHandlerFP handler = (PointerTimerHandlerFP)timer->mHandler;
-                handler(timer->mPointer);
-            }
-            break;
+            continue;
         }
-        case TimerType::Node:
+
+        mExecutingSlot = fired.mSlot;
+        ExecuteTimer(mTimerData[fired.mSlot]);
+        mExecutingSlot = -1;
+
+        // Free non-looping timers, and looping timers that were cleared by their own handler.
+        if (mTimerSlots.find(fired.mId) == mTimerSlots.end())
         {
-            if (timer->mHandler != nullptr)
-            {
-                NodeTimerHandlerFP handler = (NodeTimerHandlerFP)timer->mHandler;
-                Node* node = timer->mNode.Get();
+            FreeTimer(fired.mSlot);
+        }
+    }
 
-                if (node != nullptr)
-                {
-                    handler(node);
-                }
-            }
-            break;
+    mFiredTimers.clear();
+}
+
+void TimerManager::ExecuteTimer(TimerData& timer)
+{
+    // Execute callback handler
+    switch (timer.mType)
+    {
+    case TimerType::Void:
+    {
+        if (timer.mHandler != nullptr)
+        {
+            TimerHandlerFP handler = (TimerHandlerFP)timer.mHandler;
+            handler();
         }
-        case TimerType::ScriptFunc:
+        break;
+    }
+    case TimerType::Pointer:
+    {
+        if (timer.mHandler != nullptr)
+        {
+            PointerTimerHandlerFP handler = (PointerTimerHandlerFP)timer.mHandler;
+            handler(timer.mPointer);
+        }
+        break;
+    }
+    case TimerType::Node:
+    {
+        if (timer.mHandler != nullptr)
         {
-            if (timer->mScriptFunc.IsValid())
+            NodeTimerHandlerFP handler = (NodeTimerHandlerFP)timer.mHandler;
+            Node* node = timer.mNode.Get();
+
+            if (node != nullptr)
             {
-                timer->mScriptFunc.Call();
+                handler(node);
             }
-            break;
         }
-        default:
-            OCT_ASSERT(0);
-            break;
+        break;
+    }
+    case TimerType::ScriptFunc:
+    {
+        if (timer.mScriptFunc.IsValid())
+        {
+            timer.mScriptFunc.Call();
         }
+        break;
+    }
+    default:
+        OCT_ASSERT(0);
+        break;
     }
 }
 
-int32_t TimerManager::SetTimer(TimerHandlerFP handler, float time, bool loop)
+int32_t TimerManager::AddTimer(const TimerData& timerData)
+{
+    int32_t slot = -1;
+
+    if (mFreeSlots.size() > 0)
+    {
+        slot = mFreeSlots.back();
+        mFreeSlots.pop_back();
+    }
+    else
+    {
+        slot = int32_t(mTimerData.size());
+        mTimerData.emplace_back();
+    }
+
+    TimerData& timer = mTimerData[slot];
+    uint32_t heapStamp = timer.mHeapStamp;
+    timer = timerData;
+    timer.mHeapStamp = heapStamp;
+    timer.mId = mNextTimerId++;
+
+    mTimerSlots[timer.mId] = slot;
+    ScheduleTimer(slot, mTime + timer.mDuration);
+
+    return timer.mId;
+}
+
+void TimerManager::FreeTimer(int32_t slot)
 {
-    int32_t id = mNextTimerId++;
+    TimerData& timer = mTimerData[slot];
+    OCT_ASSERT(timer.mId != -1);
+
+    // Keep the stamp moving forward so heap entries from the previous owner never match.
+    uint32_t heapStamp = timer.mHeapStamp + 1;
+    timer = TimerData();
+    timer.mHeapStamp = heapStamp;
+
+    mFreeSlots.push_back(slot);
+}
 
+void TimerManager::ScheduleTimer(int32_t slot, double expireTime)
+{
+    TimerData& timer = mTimerData[slot];
+    timer.mHeapStamp++;
+    timer.mExpireTime = expireTime;
+
+    TimerHeapEntry entry;
+    entry.mExpireTime = expireTime;
+    entry.mSlot = slot;
+    entry.mStamp = timer.mHeapStamp;
+
+    mTimerHeap.push_back(entry);
+    std::push_heap(mTimerHeap.begin(), mTimerHeap.end(), TimerHeapCompare);
+
+    // Cleared/paused/reset timers leave stale entries behind. Drop them once they outnumber live timers.
+    if (mTimerHeap.size() > 64 &&
+        mTimerHeap.size() > 2 * mTimerSlots.size())
+    {
+        CompactHeap();
+    }
+}
+
+void TimerManager::CompactHeap()
+{
+    auto isStale = [this](const TimerHeapEntry& entry)
+    {
+        const TimerData& timer = mTimerData[entry.mSlot];
+        return timer.mId == -1 || timer.mHeapStamp != entry.mStamp;
+    };
+
+    mTimerHeap.erase(std::remove_if(mTimerHeap.begin(), mTimerHeap.end(), isStale), mTimerHeap.end());
+    std::make_heap(mTimerHeap.begin(), mTimerHeap.end(), TimerHeapCompare);
+}
+
+int32_t TimerManager::SetTimer(TimerHandlerFP handler, float time, bool loop)
+{
     TimerData timerData;
-    timerData.mId = id;
     timerData.mHandler = (void*)handler;
     timerData.mType = TimerType::Void;
     timerData.mDuration = time;
     timerData.mLoop = loop;
     timerData.mTimeRemaining = time;
-    mTimerData.push_back(timerData);
 
-    return id;
+    return AddTimer(timerData);
 }
 
 int32_t TimerManager::SetTimer(void* vp, PointerTimerHandlerFP handler, float time, bool loop)
 {
-    int32_t id = mNextTimerId++;
-
     TimerData timerData;
-    timerData.mId = id;
     timerData.mHandler = (void*)handler;
     timerData.mType = TimerType::Pointer;
     timerData.mPointer = vp;
     timerData.mDuration = time;
     timerData.mLoop = loop;
     timerData.mTimeRemaining = time;
-    mTimerData.push_back(timerData);
 
-    return id;
+    return AddTimer(timerData);
 }
 
 int32_t TimerManager::SetTimer(Node* node, NodeTimerHandlerFP handler, float time, bool loop)
 {
-    int32_t id = mNextTimerId++;
-
     TimerData timerData;
-    timerData.mId = id;
     timerData.mHandler = (void*)handler;
     timerData.mType = TimerType::Node;
     timerData.mNode = node;
     timerData.mDuration = time;
     timerData.mLoop = loop;
     timerData.mTimeRemaining = time;
-    mTimerData.push_back(timerData);
 
-    return id;
+    return AddTimer(timerData);
 }
 
 int32_t TimerManager::SetTimer(ScriptFunc scriptFunc, float time, bool loop)
 {
-    int32_t id = mNextTimerId++;
-
     TimerData timerData;
-    timerData.mId = id;
     timerData.mType = TimerType::ScriptFunc;
     timerData.mScriptFunc = scriptFunc;
     timerData.mDuration = time;
     timerData.mLoop = loop;
     timerData.mTimeRemaining = time;
-    mTimerData.push_back(timerData);
 
-    return id;
+    return AddTimer(timerData);
 }
 
 void TimerManager::ClearAllTimers()
 {
-    mTimerData.clear();
-    mTimerData.shrink_to_fit();
+    if (mExecutingSlot != -1)
+    {
+        // Called from a timer handler. The running timer's data has to stay alive until
+        // its handler returns, Update() frees it afterwards since its id is gone.
+        for (int32_t i = 0; i < int32_t(mTimerData.size()); ++i)
+        {
+            if (i != mExecutingSlot && mTimerData[i].mId != -1)
+            {
+                FreeTimer(i);
+            }
+        }
+
+        mTimerSlots.clear();
+        mTimerHeap.clear();
+    }
+    else
+    {
+        mTimerData.clear();
+        mTimerData.shrink_to_fit();
+        mFreeSlots.clear();
+        mFreeSlots.shrink_to_fit();
+        mTimerSlots.clear();
+        mTimerHeap.clear();
+        mTimerHeap.shrink_to_fit();
+    }
 }
 
 void TimerManager::ClearTimer(int32_t id)
 {
-    int32_t index = -1;
-    FindTimerData(id, &index);
+    auto it = mTimerSlots.find(id);
 
-    if (index >= 0)
+    if (it != mTimerSlots.end())
     {
-        mTimerData.erase(mTimerData.begin() + index);
+        int32_t slot = it->second;
+        mTimerSlots.erase(it);
+
+        // Its heap entry is skipped lazily. If this timer is the one currently executing,
+        // Update() frees the slot once the handler returns.
+        if (slot != mExecutingSlot)
+        {
+            FreeTimer(slot);
+        }
     }
 }
 
@@ -185,29 +312,41 @@ void TimerManager::PauseTimer(int32_t id)
 {
     TimerData* timerData = FindTimerData(id);
 
-    if (timerData)
+    if (timerData && !timerData->mPaused)
     {
+        timerData->mTimeRemaining = float(timerData->mExpireTime - mTime);
         timerData->mPaused = true;
+
+        // Invalidate the scheduled heap entry.
+        timerData->mHeapStamp++;
     }
 }
 
 void TimerManager::ResumeTimer(int32_t id)
 {
-    TimerData* timerData = FindTimerData(id);
+    int32_t slot = -1;
+    TimerData* timerData = FindTimerData(id, &slot);
 
-    if (timerData)
+    if (timerData && timerData->mPaused)
     {
         timerData->mPaused = false;
+        ScheduleTimer(slot, mTime + timerData->mTimeRemaining);
     }
 }
 
 void TimerManager::ResetTimer(int32_t id)
 {
-    TimerData* timerData = FindTimerData(id);
+    int32_t slot = -1;
+    TimerData* timerData = FindTimerData(id, &slot);
 
     if (timerData)
     {
         timerData->mTimeRemaining = timerData->mDuration;
+
+        if (!timerData->mPaused)
+        {
+            ScheduleTimer(slot, mTime + timerData->mDuration);
+        }
     }
 }
 
@@ -218,7 +357,7 @@ float TimerManager::GetTimeRemaining(int32_t id)
 
     if (timerData)
     {
-        ret = timerData->mTimeRemaining;
+        ret = timerData->mPaused ? timerData->mTimeRemaining : float(timerData->mExpireTime - mTime);
     }
 
     return ret;
@@ -230,14 +369,12 @@ TimerData* TimerManager::FindTimerData(int32_t id, int32_t* outIndex)
     TimerData* ret = nullptr;
     int32_t index = -1;
 
-    for (uint32_t i = 0; i < mTimerData.size(); ++i)
+    auto it = mTimerSlots.find(id);
+
+    if (it != mTimerSlots.end())
     {
-        if (mTimerData[i].mId == id)
-        {
-            ret = &(mTimerData[i]);
-            index = (int32_t)i;
-            break;
-        }
+        index = it->second;
+        ret = &(mTimerData[index]);
     }
 
     if (outIndex != nullptr)
@@ -248,4 +385,3 @@ TimerData* TimerManager::FindTimerData(int32_t id, int32_t* outIndex)
     return ret;
 }
 
-
@@ -2,6 +2,9 @@
 
 #include <stdint.h>
 #include <string>
+#include <vector>
+#include <deque>
+#include <unordered_map>
 #include "ObjectRef.h"
 
 class ScriptComponent;
@@ -32,7 +35,9 @@ struct TimerData
     int32_t mId = -1;
     void* mHandler = nullptr;
     float mDuration = 0.0f;
-    float mTimeRemaining = 0.0f;
+    float mTimeRemaining = 0.0f; // Only up to date while paused, otherwise derived from mExpireTime
+    double mExpireTime = 0.0;
+    uint32_t mHeapStamp = 0; // Bumped whenever the timer is rescheduled, so older heap entries are ignored
     bool mLoop = false;
     bool mPaused = false;
     TimerType mType = TimerType::Count;
@@ -61,8 +66,39 @@ public:
 
 protected:
 
+    struct TimerHeapEntry
+    {
+        double mExpireTime = 0.0;
+        int32_t mSlot = -1;
+        uint32_t mStamp = 0;
+    };
+
+    struct FiredTimer
+    {
+        int32_t mSlot = -1;
+        int32_t mId = -1;
+    };
+
+    static bool TimerHeapCompare(const TimerHeapEntry& a, const TimerHeapEntry& b);
+
+    int32_t AddTimer(const TimerData& timerData);
+    void FreeTimer(int32_t slot);
+    void ScheduleTimer(int32_t slot, double expireTime);
+    void CompactHeap();
+    void ExecuteTimer(TimerData& timer);
+
     int32_t mNextTimerId = 0;
-    std::vector<TimerData> mTimerData;
+    double mTime = 0.0;
+
+    // Timers live in stable slots (a deque doesn't move elements when it grows) so a handler
+    // can add timers while its own TimerData is executing. Expiry order is kept in a min-heap
+    // of absolute times, and stale heap entries are skipped lazily.
+    std::deque<TimerData> mTimerData;
+    std::vector<int32_t> mFreeSlots;
+    std::unordered_map<int32_t, int32_t> mTimerSlots;
+    std::vector<TimerHeapEntry> mTimerHeap;
+    std::vector<FiredTimer> mFiredTimers;
+    int32_t mExecutingSlot = -1;
 };
 
 TimerManager* GetTimerManager();
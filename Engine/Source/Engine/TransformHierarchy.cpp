@@ -0,0 +1,283 @@
+#include "TransformHierarchy.h"
+#include "Nodes/3D/Node3d.h"
+#include "Assertion.h"
+
+TransformHierarchy::TransformHierarchy()
+{
+
+}
+
+TransformHierarchy::~TransformHierarchy()
+{
+    Clear();
+}
+
+void TransformHierarchy::Add(Node3D* node)
+{
+    OCT_ASSERT(node->mTransformHierarchy == nullptr);
+
+    // Parents are registered before their children, so appending keeps the parent-first order.
+    int32_t index = int32_t(mNodes.size());
+
+    mNodes.push_back(node);
+    mParentIndices.push_back(FindParentIndex(node));
+    mParentBones.push_back(node->mParentBoneIndex);
+    mLocalTransforms.push_back(glm::mat4(1));
+    mWorldTransforms.push_back(node->mTransform);
+    mDirtyFlags.push_back(0);
+    mUpdated.push_back(0);
+
+    node->mTransformHierarchy = this;
+    node->mTransformIndex = index;
+
+    // The cached local transform isn't valid yet.
+    MarkDirty(index, kLocalDirty);
+}
+
+void TransformHierarchy::Remove(Node3D* node)
+{
+    OCT_ASSERT(node->mTransformHierarchy == this);
+    int32_t index = node->mTransformIndex;
+    OCT_ASSERT(mNodes[index] == node);
+
+    // Hand the world transform back to the node so it stays valid outside of the world.
+    node->mTransform = mWorldTransforms[index];
+    node->mTransformDirty = true;
+    node->mTransformHierarchy = nullptr;
+    node->mTransformIndex = -1;
+
+    // Leave a hole instead of shifting everything down. Holes are compacted on the next Update().
+    mNodes[index] = nullptr;
+    mDirtyFlags[index] = 0;
+    mNumHoles++;
+}
+
+void TransformHierarchy::Clear()
+{
+    for (uint32_t i = 0; i < mNodes.size(); ++i)
+    {
+        if (mNodes[i] != nullptr)
+        {
+            Remove(mNodes[i]);
+        }
+    }
+
+    mNodes.clear();
+    mParentIndices.clear();
+    mParentBones.clear();
+    mLocalTransforms.clear();
+    mWorldTransforms.clear();
+    mDirtyFlags.clear();
+    mUpdated.clear();
+
+    mFirstDirty = UINT32_MAX;
+    mNumHoles = 0;
+    mOrderDirty = false;
+}
+
+void TransformHierarchy::Update()
+{
+    if (mOrderDirty)
+    {
+        RebuildOrder();
+    }
+    else if (mNumHoles > 0)
+    {
+        Compact();
+    }
+
+    const uint32_t numNodes = uint32_t(mNodes.size());
+    const uint32_t firstDirty = mFirstDirty;
+
+    // Anything dirtied by OnTransformUpdated() callbacks will be picked up next time.
+    mFirstDirty = UINT32_MAX;
+
+    for (uint32_t i = firstDirty; i < numNodes; ++i)
+    {
+        int32_t parent = mParentIndices[i];
+        bool parentUpdated = (parent >= int32_t(firstDirty)) && mUpdated[parent];
+
+        mUpdated[i] = 0;
+
+        if (mDirtyFlags[i] == 0 && !parentUpdated)
+            continue;
+
+        Node3D* node = mNodes[i];
+
+        if (mDirtyFlags[i] & kLocalDirty)
+        {
+            mLocalTransforms[i] = node->UpdateLocalTransform();
+        }
+
+        if (parent < 0)
+        {
+            mWorldTransforms[i] = mLocalTransforms[i];
+        }
+        else if (mParentBones[i] == -1)
+        {
+            mWorldTransforms[i] = mWorldTransforms[parent] * mLocalTransforms[i];
+        }
+        else
+        {
+            // Bone attachments need the parent's animated bone transform.
+            mWorldTransforms[i] = node->GetParentTransform() * mLocalTransforms[i];
+        }
+
+        mDirtyFlags[i] = 0;
+        mUpdated[i] = 1;
+
+        node->OnTransformUpdated();
+    }
+}
+
+void TransformHierarchy::UpdateParent(Node3D* node)
+{
+    OCT_ASSERT(node->mTransformHierarchy == this);
+    int32_t index = node->mTransformIndex;
+
+    mParentIndices[index] = FindParentIndex(node);
+    mParentBones[index] = node->mParentBoneIndex;
+
+    if (mParentIndices[index] > index)
+    {
+        mOrderDirty = true;
+    }
+}
+
+uint32_t TransformHierarchy::GetNumTransforms() const
+{
+    return uint32_t(mNodes.size()) - mNumHoles;
+}
+
+int32_t TransformHierarchy::FindParentIndex(Node3D* node) const
+{
+    Node* parent = node->GetParent();
+
+    if (parent != nullptr &&
+        parent->IsNode3D() &&
+        static_cast<Node3D*>(parent)->mTransformHierarchy == this)
+    {
+        return static_cast<Node3D*>(parent)->mTransformIndex;
+    }
+
+    return -1;
+}
+
+void TransformHierarchy::Compact()
+{
+    static std::vector<int32_t> sOrder;
+    sOrder.clear();
+
+    for (uint32_t i = 0; i < mNodes.size(); ++i)
+    {
+        if (mNodes[i] != nullptr)
+        {
+            sOrder.push_back(int32_t(i));
+        }
+    }
+
+    ApplyOrder(sOrder);
+}
+
+void TransformHierarchy::RebuildOrder()
+{
+    static std::vector<int32_t> sOrder;
+    sOrder.clear();
+
+    for (uint32_t i = 0; i < mNodes.size(); ++i)
+    {
+        int32_t parent = mParentIndices[i];
+
+        // Nodes whose parent was removed become roots.
+        if (mNodes[i] != nullptr &&
+            (parent == -1 || mNodes[parent] == nullptr))
+        {
+            AddSubtree(mNodes[i], sOrder);
+        }
+    }
+
+    OCT_ASSERT(sOrder.size() == mNodes.size() - mNumHoles);
+    ApplyOrder(sOrder);
+}
+
+void TransformHierarchy::AddSubtree(Node3D* node, std::vector<int32_t>& order)
+{
+    order.push_back(node->mTransformIndex);
+
+    for (uint32_t i = 0; i < node->GetNumChildren(); ++i)
+    {
+        Node* child = node->GetChild(i);
+
+        if (child->IsNode3D() &&
+            static_cast<Node3D*>(child)->mTransformHierarchy == this)
+        {
+            AddSubtree(static_cast<Node3D*>(child), order);
+        }
+    }
+}
+
+void TransformHierarchy::ApplyOrder(const std::vector<int32_t>& order)
+{
+    const uint32_t numNodes = uint32_t(order.size());
+
+    static std::vector<int32_t> sRemap;
+    sRemap.clear();
+    sRemap.resize(mNodes.size(), -1);
+
+    // Gather into the scratch arrays and swap them in. The old arrays become the scratch
+    // for the next call, so compaction stops allocating once the capacities settle.
+    std::vector<Node3D*>& nodes = mScratchNodes;
+    std::vector<int32_t>& parentIndices = mScratchParentIndices;
+    std::vector<int32_t>& parentBones = mScratchParentBones;
+    std::vector<glm::mat4>& localTransforms = mScratchLocalTransforms;
+    std::vector<glm::mat4>& worldTransforms = mScratchWorldTransforms;
+    std::vector<uint8_t>& dirtyFlags = mScratchDirtyFlags;
+
+    nodes.resize(numNodes);
+    parentIndices.resize(numNodes);
+    parentBones.resize(numNodes);
+    localTransforms.resize(numNodes);
+    worldTransforms.resize(numNodes);
+    dirtyFlags.resize(numNodes);
+
+    for (uint32_t i = 0; i < numNodes; ++i)
+    {
+        int32_t src = order[i];
+        sRemap[src] = int32_t(i);
+
+        nodes[i] = mNodes[src];
+        parentIndices[i] = mParentIndices[src];
+        parentBones[i] = mParentBones[src];
+        localTransforms[i] = mLocalTransforms[src];
+        worldTransforms[i] = mWorldTransforms[src];
+        dirtyFlags[i] = mDirtyFlags[src];
+    }
+
+    mFirstDirty = UINT32_MAX;
+
+    for (uint32_t i = 0; i < numNodes; ++i)
+    {
+        nodes[i]->mTransformIndex = int32_t(i);
+
+        if (parentIndices[i] >= 0)
+        {
+            parentIndices[i] = sRemap[parentIndices[i]];
+        }
+
+        if (dirtyFlags[i] != 0 && mFirstDirty == UINT32_MAX)
+        {
+            mFirstDirty = i;
+        }
+    }
+
+    mNodes.swap(nodes);
+    mParentIndices.swap(parentIndices);
+    mParentBones.swap(parentBones);
+    mLocalTransforms.swap(localTransforms);
+    mWorldTransforms.swap(worldTransforms);
+    mDirtyFlags.swap(dirtyFlags);
+    mUpdated.assign(numNodes, 0);
+
+    mNumHoles = 0;
+    mOrderDirty = false;
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+#include "Maths.h"
+
+class Node3D;
+
+// Flat storage for the transforms of every Node3D in a World.
+// Entries are sorted so that a parent always comes before its children, which lets
+// Update() recompute all dirty world transforms in a single forward sweep instead of
+// traversing the node tree. Node3D keeps its API and reads/writes its entry in place.
+class TransformHierarchy
+{
+public:
+
+    enum DirtyFlags : uint8_t
+    {
+        // Position/rotation/scale changed, so the local matrix needs to be rebuilt.
+        kLocalDirty = 0x01,
+        // Only the parent moved, the cached local matrix is still valid.
+        kWorldDirty = 0x02,
+    };
+
+    TransformHierarchy();
+    ~TransformHierarchy();
+
+    void Add(Node3D* node);
+    void Remove(Node3D* node);
+    void Clear();
+
+    void Update();
+
+    // Refreshes the parent index and bone of a node that is already in the hierarchy.
+    void UpdateParent(Node3D* node);
+    uint32_t GetNumTransforms() const;
+
+    glm::mat4& GetWorldTransform(int32_t index)
+    {
+        return mWorldTransforms[index];
+    }
+
+    const glm::mat4& GetWorldTransform(int32_t index) const
+    {
+        return mWorldTransforms[index];
+    }
+
+    void SetLocalTransform(int32_t index, const glm::mat4& local)
+    {
+        mLocalTransforms[index] = local;
+    }
+
+    bool IsDirty(int32_t index) const
+    {
+        return mDirtyFlags[index] != 0;
+    }
+
+    void MarkDirty(int32_t index, uint8_t flags)
+    {
+        mDirtyFlags[index] |= flags;
+        mFirstDirty = (uint32_t(index) < mFirstDirty) ? uint32_t(index) : mFirstDirty;
+    }
+
+    void ClearDirty(int32_t index)
+    {
+        mDirtyFlags[index] = 0;
+    }
+
+private:
+
+    int32_t FindParentIndex(Node3D* node) const;
+    void Compact();
+    void RebuildOrder();
+    void AddSubtree(Node3D* node, std::vector<int32_t>& order);
+    void ApplyOrder(const std::vector<int32_t>& order);
+
+    std::vector<Node3D*> mNodes;
+    std::vector<int32_t> mParentIndices;
+    std::vector<int32_t> mParentBones;
+    std::vector<glm::mat4> mLocalTransforms;
+    std::vector<glm::mat4> mWorldTransforms;
+    std::vector<uint8_t> mDirtyFlags;
+    std::vector<uint8_t> mUpdated;
+
+    // Reused by ApplyOrder().
+    std::vector<Node3D*> mScratchNodes;
+    std::vector<int32_t> mScratchParentIndices;
+    std::vector<int32_t> mScratchParentBones;
+    std::vector<glm::mat4> mScratchLocalTransforms;
+    std::vector<glm::mat4> mScratchWorldTransforms;
+    std::vector<uint8_t> mScratchDirtyFlags;
+
+    // Sweeps start here since nothing before it can be dirty.
+    uint32_t mFirstDirty = UINT32_MAX;
+
+    // Removed nodes leave holes that are compacted on the next Update().
+    uint32_t mNumHoles = 0;
+
+    // Set when a node was reparented to a node that comes after it.
+    bool mOrderDirty = false;
+};
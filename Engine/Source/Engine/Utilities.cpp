@@ -16,6 +16,7 @@
 #include <sys/stat.h>
 
 #include "System/System.h"
+#include "System/SystemConstants.h"
 #include "Input/Input.h"
 
 #include <btBulletDynamicsCommon.h>
@@ -416,6 +417,20 @@ Property* FindProperty(std::vector<Property>& props, const std::string& name)
     return prop;
 }
 
+void CopyPropertyValue(Property& dstProp, const Property& srcProp)
+{
+    if (dstProp.IsVector())
+    {
+        dstProp.ResizeVector(srcProp.GetCount());
+    }
+    else
+    {
+        OCT_ASSERT(dstProp.mCount == srcProp.mCount);
+    }
+
+    dstProp.SetValue(srcProp.mData.vp, 0, srcProp.mCount);
+}
+
 void CopyPropertyValues(std::vector<Property>& dstProps, const std::vector<Property>& srcProps)
 {
     for (uint32_t i = 0; i < srcProps.size(); ++i)
@@ -435,16 +450,7 @@ void CopyPropertyValues(std::vector<Property>& dstProps, const std::vector<Prope
 
         if (dstProp != nullptr)
         {
-            if (dstProp->IsVector())
-            {
-                dstProp->ResizeVector(srcProp->GetCount());
-            }
-            else
-            {
-                OCT_ASSERT(dstProp->mCount == srcProp->mCount);
-            }
-            
-            dstProp->SetValue(srcProp->mData.vp, 0, srcProp->mCount);
+            CopyPropertyValue(*dstProp, *srcProp);
         }
     }
 }
@@ -472,6 +478,20 @@ const char* GetPlatformString(Platform platform)
     return retString;
 }
 
+bool IsBigEndianPlatform(Platform platform)
+{
+    switch (platform)
+    {
+    case Platform::GameCube:
+    case Platform::Wii:
+        return true;
+    case Platform::Count:
+        return ENDIAN_SWAP != 0;
+    default:
+        return false;
+    }
+}
+
 uint8_t ConvertKeyCodeToChar(uint8_t keyCode, bool shiftDown)
 {
     uint8_t retChar = 0;
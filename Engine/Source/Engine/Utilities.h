@@ -39,12 +39,16 @@ uint32_t OctHashString(const char* key);
 void GatherAllNodeNames(std::vector<std::string>& outNames);
 
 Property* FindProperty(std::vector<Property>& props, const std::string& name);
+void CopyPropertyValue(Property& dstProp, const Property& srcProp);
 void CopyPropertyValues(std::vector<Property>& dstProps, const std::vector<Property>& srcProps);
 
 uint32_t GetStringSerializationSize(const std::string& str);
 
 const char* GetPlatformString(Platform platform);
 
+// Byte order assets are cooked in for the platform. Platform::Count means the one running.
+bool IsBigEndianPlatform(Platform platform);
+
 uint8_t ConvertKeyCodeToChar(uint8_t keyCode, bool shiftDown);
 
 glm::mat4 MakeTransform(glm::vec3 translation, glm::vec3 rotation, glm::vec3 scale);
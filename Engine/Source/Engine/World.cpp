@@ -9,9 +9,11 @@
 #include "NetworkManager.h"
 #include "InputDevices.h"
 #include "Assets/Scene.h"
+#include "Script.h"
 #include "Nodes/3D/StaticMesh3d.h"
 #include "Nodes/3D/PointLight3d.h"
 #include "Nodes/3D/Particle3d.h"
+#include "Nodes/3D/SkeletalMesh3d.h"
 #include "Nodes/3D/Audio3d.h"
 
 #if EDITOR
@@ -87,6 +89,8 @@ void World::Destroy()
     OCT_ASSERT(mRootNode == nullptr);
     mActiveCamera = nullptr;
 
+    mTransformHierarchy.Clear();
+
     mDefaultDynamicsWorld = nullptr;
 
     delete mDynamicsWorld;
@@ -384,6 +388,7 @@ btDbvtBroadphase* World::GetBroadphase()
 
 void World::PurgeOverlaps(Primitive3D* prim)
 {
+    // Erasing keeps the array sorted.
     for (int32_t i = (int32_t)mCurrentOverlaps.size() - 1; i >= 0; --i)
     {
         Primitive3D* primA = mCurrentOverlaps[i].mPrimitiveA;
@@ -396,6 +401,26 @@ void World::PurgeOverlaps(Primitive3D* prim)
             mCurrentOverlaps.erase(mCurrentOverlaps.begin() + i);
         }
     }
+
+    // The primitive may be destroyed while events are being dispatched.
+    // Null out any of its events that haven't been delivered yet.
+    for (uint32_t i = 0; i < mBeginOverlaps.size(); ++i)
+    {
+        if (mBeginOverlaps[i].mPrimitiveA == prim ||
+            mBeginOverlaps[i].mPrimitiveB == prim)
+        {
+            mBeginOverlaps[i] = PrimitivePair();
+        }
+    }
+
+    for (uint32_t i = 0; i < mEndOverlaps.size(); ++i)
+    {
+        if (mEndOverlaps[i].mPrimitiveA == prim ||
+            mEndOverlaps[i].mPrimitiveB == prim)
+        {
+            mEndOverlaps[i] = PrimitivePair();
+        }
+    }
 }
 
 void World::RayTest(glm::vec3 start, glm::vec3 end, uint8_t collisionMask, RayTestResult& outResult, uint32_t numIgnoredObjects, btCollisionObject** ignoreObjects)
@@ -528,11 +553,8 @@ void World::SweepTest(
 
 void World::RegisterNode(Node* node)
 {
-    TypeId nodeType = node->GetType();
-
-    // TODO: Now that components have become nodes, these static type checks don't hold up
-    // if the user inherits from these nodes. Won't be a problem for Lua.
-    if (nodeType == Audio3D::GetStaticType())
+    // Checked with As<>() so that subclasses of these nodes are registered too.
+    if (node->As<Audio3D>() != nullptr)
     {
 #if _DEBUG
         OCT_ASSERT(std::find(mAudios.begin(), mAudios.end(), (Audio3D*)node) == mAudios.end());
@@ -546,7 +568,7 @@ void World::RegisterNode(Node* node)
 #endif
         mLights.push_back((Light3D*)node);
     }
-    else if (nodeType == Camera3D::GetStaticType())
+    else if (node->As<Camera3D>() != nullptr)
     {
         if (mActiveCamera == nullptr ||
             mActiveCamera->IsEditorCamera())
@@ -554,6 +576,29 @@ void World::RegisterNode(Node* node)
             mActiveCamera = node->As<Camera3D>();
         }
     }
+    else if (node->As<SkeletalMesh3D>() != nullptr)
+    {
+        mSkeletalMeshes.push_back((SkeletalMesh3D*)node);
+    }
+    else if (node->As<Particle3D>() != nullptr)
+    {
+        mParticles.push_back((Particle3D*)node);
+    }
+
+    if (node->IsNode3D())
+    {
+        mTransformHierarchy.Add((Node3D*)node);
+    }
+
+    if (node->IsPrimitive3D())
+    {
+        mSpatialIndex.Insert((Primitive3D*)node);
+    }
+    else if (node->IsWidget())
+    {
+        mWidgets.push_back((Widget*)node);
+        mRootWidgetsDirty = true;
+    }
 
     if (node->GetNetId() != INVALID_NET_ID)
     {
@@ -563,9 +608,7 @@ void World::RegisterNode(Node* node)
 
 void World::UnregisterNode(Node* node)
 {
-    TypeId nodeType = node->GetType();
-
-    if (nodeType == Audio3D::GetStaticType())
+    if (node->As<Audio3D>() != nullptr)
     {
         auto it = std::find(mAudios.begin(), mAudios.end(), (Audio3D*)node);
         OCT_ASSERT(it != mAudios.end());
@@ -577,6 +620,35 @@ void World::UnregisterNode(Node* node)
         OCT_ASSERT(it != mLights.end());
         mLights.erase(it);
     }
+    else if (node->As<SkeletalMesh3D>() != nullptr)
+    {
+        auto it = std::find(mSkeletalMeshes.begin(), mSkeletalMeshes.end(), (SkeletalMesh3D*)node);
+        OCT_ASSERT(it != mSkeletalMeshes.end());
+        mSkeletalMeshes.erase(it);
+    }
+    else if (node->As<Particle3D>() != nullptr)
+    {
+        auto it = std::find(mParticles.begin(), mParticles.end(), (Particle3D*)node);
+        OCT_ASSERT(it != mParticles.end());
+        mParticles.erase(it);
+    }
+
+    if (node->IsPrimitive3D())
+    {
+        mSpatialIndex.Remove((Primitive3D*)node);
+    }
+
+    if (node->IsNode3D())
+    {
+        mTransformHierarchy.Remove((Node3D*)node);
+    }
+    else if (node->IsWidget())
+    {
+        auto it = std::find(mWidgets.begin(), mWidgets.end(), (Widget*)node);
+        OCT_ASSERT(it != mWidgets.end());
+        mWidgets.erase(it);
+        mRootWidgetsDirty = true;
+    }
 
     if (node == mAudioReceiver)
     {
@@ -599,6 +671,26 @@ const std::vector<Audio3D*>& World::GetAudios() const
     return mAudios;
 }
 
+const std::vector<SkeletalMesh3D*>& World::GetSkeletalMeshes() const
+{
+    return mSkeletalMeshes;
+}
+
+const std::vector<Particle3D*>& World::GetParticles() const
+{
+    return mParticles;
+}
+
+SpatialIndex& World::GetSpatialIndex()
+{
+    return mSpatialIndex;
+}
+
+TransformHierarchy& World::GetTransformHierarchy()
+{
+    return mTransformHierarchy;
+}
+
 std::vector<Node*>& World::GetReplicatedNodeVector(ReplicationRate rate)
 {
     OCT_ASSERT(rate != ReplicationRate::Count);
@@ -651,6 +743,129 @@ void World::RemoveNodeFromRepVector(Node* node)
     }
 }
 
+static bool IsHandleLess(const NodeHandle& a, const NodeHandle& b)
+{
+    return (a.mIndex != b.mIndex) ? (a.mIndex < b.mIndex) : (a.mGeneration < b.mGeneration);
+}
+
+// Orders pairs by their primitives' node handles instead of their addresses, so overlap events
+// are dispatched in the same order on every run. All pairs of a primitive end up adjacent.
+static bool IsOverlapLess(const PrimitivePair& a, const PrimitivePair& b)
+{
+    if (a.mPrimitiveA != b.mPrimitiveA)
+    {
+        return IsHandleLess(a.mPrimitiveA->GetHandle(), b.mPrimitiveA->GetHandle());
+    }
+
+    return IsHandleLess(a.mPrimitiveB->GetHandle(), b.mPrimitiveB->GetHandle());
+}
+
+void World::UpdateOverlaps()
+{
+    std::sort(mCurrentOverlaps.begin(), mCurrentOverlaps.end(), IsOverlapLess);
+    mCurrentOverlaps.erase(std::unique(mCurrentOverlaps.begin(), mCurrentOverlaps.end()), mCurrentOverlaps.end());
+
+    // Both arrays are sorted, so a single merge pass finds the pairs that only exist in one of them.
+    mBeginOverlaps.clear();
+    mEndOverlaps.clear();
+
+    uint32_t cur = 0;
+    uint32_t prev = 0;
+    const uint32_t numCur = uint32_t(mCurrentOverlaps.size());
+    const uint32_t numPrev = uint32_t(mPreviousOverlaps.size());
+
+    while (cur < numCur || prev < numPrev)
+    {
+        if (prev == numPrev ||
+            (cur < numCur && IsOverlapLess(mCurrentOverlaps[cur], mPreviousOverlaps[prev])))
+        {
+            mBeginOverlaps.push_back(mCurrentOverlaps[cur++]);
+        }
+        else if (cur == numCur ||
+            IsOverlapLess(mPreviousOverlaps[prev], mCurrentOverlaps[cur]))
+        {
+            mEndOverlaps.push_back(mPreviousOverlaps[prev++]);
+        }
+        else
+        {
+            cur++;
+            prev++;
+        }
+    }
+
+    DispatchOverlapEvents(mBeginOverlaps, true);
+    DispatchOverlapEvents(mEndOverlaps, false);
+
+    mBeginOverlaps.clear();
+    mEndOverlaps.clear();
+}
+
+void World::DispatchOverlapEvents(std::vector<PrimitivePair>& events, bool begin)
+{
+    // Events can be nulled out by PurgeOverlaps() if a callback destroys a primitive,
+    // so index the array and check each entry right before using it.
+    if (!mBatchOverlapEvents)
+    {
+        for (uint32_t i = 0; i < events.size(); ++i)
+        {
+            Primitive3D* primA = events[i].mPrimitiveA;
+            Primitive3D* primB = events[i].mPrimitiveB;
+
+            if (primA == nullptr)
+                continue;
+
+            if (begin)
+            {
+                primA->BeginOverlap(primA, primB);
+            }
+            else
+            {
+                primA->EndOverlap(primA, primB);
+            }
+        }
+
+        return;
+    }
+
+    // Events are sorted by their first primitive, so each primitive's events are adjacent.
+    static std::vector<Primitive3D*> sOthers;
+    uint32_t i = 0;
+
+    while (i < events.size())
+    {
+        Primitive3D* prim = events[i].mPrimitiveA;
+
+        if (prim == nullptr)
+        {
+            ++i;
+            continue;
+        }
+
+        sOthers.clear();
+
+        for (; i < events.size(); ++i)
+        {
+            if (events[i].mPrimitiveA == prim)
+            {
+                sOthers.push_back(events[i].mPrimitiveB);
+            }
+            else if (events[i].mPrimitiveA != nullptr)
+            {
+                break;
+            }
+        }
+
+        if (begin)
+        {
+            prim->BeginOverlapBatch(prim, sOthers.data(), uint32_t(sOthers.size()));
+        }
+        else
+        {
+            prim->EndOverlapBatch(prim, sOthers.data(), uint32_t(sOthers.size()));
+        }
+    }
+}
+
 void World::UpdateLines(float deltaTime)
 {
     for (int32_t i = (int32_t)mLines.size() - 1; i >= 0; --i)
@@ -713,7 +928,8 @@ void World::Update(float deltaTime)
             mCollisionDispatcher);
 
         // Update collisions
-        mPreviousOverlaps = mCurrentOverlaps;
+        // Swap instead of copying so both arrays keep their capacity between frames.
+        mPreviousOverlaps.swap(mCurrentOverlaps);
         mCurrentOverlaps.clear();
 
         int32_t numManifolds = mDynamicsWorld->getDispatcher()->getNumManifolds();
@@ -762,35 +978,15 @@ void World::Update(float deltaTime)
                 prim1->OnCollision(prim1, prim0, avgContactPoint1, -avgNormal, manifold);
             }
 
-            if (prim0->AreOverlapsEnabled() && prim1->AreOverlapsEnabled() &&
-                std::find(mCurrentOverlaps.begin(), mCurrentOverlaps.end(), PrimitivePair(prim0, prim1)) == mCurrentOverlaps.end())
+            if (prim0->AreOverlapsEnabled() && prim1->AreOverlapsEnabled())
             {
+                // Duplicates are removed after sorting in UpdateOverlaps().
                 mCurrentOverlaps.push_back({ prim0, prim1 });
                 mCurrentOverlaps.push_back({ prim1, prim0 });
             }
         }
 
-        // Call Begin Overlaps
-        for (auto& pair : mCurrentOverlaps)
-        {
-            bool beginOverlap = std::find(mPreviousOverlaps.begin(), mPreviousOverlaps.end(), pair) == mPreviousOverlaps.end();
-
-            if (beginOverlap)
-            {
-                pair.mPrimitiveA->BeginOverlap(pair.mPrimitiveA, pair.mPrimitiveB);
-            }
-        }
-
-        // Call End Overlaps
-        for (auto& pair : mPreviousOverlaps)
-        {
-            bool endOverlap = std::find(mCurrentOverlaps.begin(), mCurrentOverlaps.end(), pair) == mCurrentOverlaps.end();
-
-            if (endOverlap)
-            {
-                pair.mPrimitiveA->EndOverlap(pair.mPrimitiveA, pair.mPrimitiveB);
-            }
-        }
+        UpdateOverlaps();
     }
 
     UpdateLines(deltaTime);
@@ -799,33 +995,17 @@ void World::Update(float deltaTime)
         SCOPED_FRAME_STAT("Tick");
         if (mRootNode != nullptr)
         {
+            Script::BeginTickBatch();
             mRootNode->RecursiveTick(deltaTime, gameTickEnabled);
+            Script::EndTickBatch(deltaTime);
         }
     }
 
     {
-        // TODO-NODE: Adding this! Make sure it works. I think we need to
-        // make sure transforms are updated so that the bullet dynamics world is in sync.
-        // But maybe not and we only need to update transforms when getting world pos/rot/scale/transform
+        // Make sure transforms are updated so that the bullet dynamics world is in sync.
+        // Parents are stored before their children, so a single sweep updates every dirty transform.
         SCOPED_FRAME_STAT("Transforms");
-        if (mRootNode != nullptr)
-        {
-            auto update3dTransform = [](Node* node) -> bool
-            {
-                if (node->IsNode3D())
-                {
-                    Node3D* node3d = (Node3D*)node;
-                    if (node3d->IsTransformDirty())
-                    {
-                        node3d->UpdateTransform(false);
-                    }
-                }
-
-                return true;
-            };
-
-            mRootNode->Traverse(update3dTransform);
-        }
+        mTransformHierarchy.Update();
     }
 }
 
@@ -1026,22 +1206,56 @@ bool World::IsInternalEdgeSmoothingEnabled() const
     return (gContactAddedCallback != nullptr);
 }
 
+void World::EnableBatchOverlapEvents(bool enable)
+{
+    mBatchOverlapEvents = enable;
+}
+
+bool World::IsBatchOverlapEventsEnabled() const
+{
+    return mBatchOverlapEvents;
+}
+
 void World::DirtyAllWidgets()
 {
-    if (mRootNode != nullptr)
+    for (uint32_t i = 0; i < mWidgets.size(); ++i)
+    {
+        mWidgets[i]->MarkDirty();
+    }
+}
+
+bool World::HasWidgets() const
+{
+    return (mWidgets.size() > 0);
+}
+
+const std::vector<Widget*>& World::GetRootWidgets()
+{
+    if (mRootWidgetsDirty)
     {
-        auto dirtyWidget = [](Node* node) -> bool
+        mRootWidgets.clear();
+
+        // Reparenting or reordering always unregisters and re-registers the moved subtree,
+        // so the order can only change when a widget enters or leaves the world.
+        if (mRootNode != nullptr && mWidgets.size() > 0)
         {
-            if (node->IsWidget())
+            mRootNode->Traverse([&](Node* node) -> bool
             {
-                static_cast<Widget*>(node)->MarkDirty();
-            }
+                if (node->IsWidget())
+                {
+                    // Nested widgets are drawn by their root's traversal.
+                    mRootWidgets.push_back(static_cast<Widget*>(node));
+                    return false;
+                }
 
-            return true;
-        };
+                return true;
+            });
+        }
 
-        mRootNode->Traverse(dirtyWidget);
+        mRootWidgetsDirty = false;
     }
+
+    return mRootWidgets;
 }
 
 void World::UpdateRenderSettings()
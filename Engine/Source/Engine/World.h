@@ -14,12 +14,15 @@
 #include "Line.h"
 #include "EngineTypes.h"
 #include "ObjectRef.h"
+#include "SpatialIndex.h"
+#include "TransformHierarchy.h"
 #include "Nodes/3D/Camera3d.h"
 #include "Nodes/3D/DirectionalLight3d.h"
 
 class Node;
 class Audio3D;
 class Particle3D;
+class SkeletalMesh3D;
 
 class World
 {
@@ -119,6 +122,10 @@ public:
     void RegisterNode(Node* node);
     void UnregisterNode(Node* node);
     const std::vector<Audio3D*>& GetAudios() const;
+    const std::vector<SkeletalMesh3D*>& GetSkeletalMeshes() const;
+    const std::vector<Particle3D*>& GetParticles() const;
+    SpatialIndex& GetSpatialIndex();
+    TransformHierarchy& GetTransformHierarchy();
 
     std::vector<Node*>& GetReplicatedNodeVector(ReplicationRate rate);
     uint32_t& GetReplicatedNodeIndex(ReplicationRate rate);
@@ -134,7 +141,17 @@ public:
     void EnableInternalEdgeSmoothing(bool enable);
     bool IsInternalEdgeSmoothingEnabled() const;
 
+    // When enabled, overlap events are delivered once per primitive with every other primitive
+    // that began/ended overlapping it this frame, instead of once per pair.
+    void EnableBatchOverlapEvents(bool enable);
+    bool IsBatchOverlapEventsEnabled() const;
+
     void DirtyAllWidgets();
+    bool HasWidgets() const;
+
+    // Widgets with no widget ancestor, in the order a traversal from the root node would reach them.
+    // The order is cached until a widget enters or leaves the world.
+    const std::vector<Widget*>& GetRootWidgets();
 
     void UpdateRenderSettings();
 
@@ -191,6 +208,8 @@ public:
 private:
 
     void UpdateLines(float deltaTime);
+    void UpdateOverlaps();
+    void DispatchOverlapEvents(std::vector<PrimitivePair>& events, bool begin);
 
 private:
 
@@ -198,6 +217,13 @@ private:
     std::vector<Line> mLines;
     std::vector<class Light3D*> mLights;
     std::vector<class Audio3D*> mAudios;
+    std::vector<SkeletalMesh3D*> mSkeletalMeshes;
+    std::vector<Particle3D*> mParticles;
+    SpatialIndex mSpatialIndex;
+    TransformHierarchy mTransformHierarchy;
+    std::vector<Widget*> mWidgets;
+    std::vector<Widget*> mRootWidgets;
+    bool mRootWidgetsDirty = true;
     NodeRef mQueuedRootNode;
     glm::vec4 mAmbientLightColor;
     glm::vec4 mShadowColor;
@@ -219,7 +245,11 @@ private:
     btSequentialImpulseConstraintSolver* mSolver = nullptr;
     btDiscreteDynamicsWorld* mDynamicsWorld = nullptr;
     btDiscreteDynamicsWorld* mDefaultDynamicsWorld = nullptr;;
+    // Both overlap arrays are kept sorted so they can be diffed with a single merge pass.
     std::vector<PrimitivePair> mCurrentOverlaps;
     std::vector<PrimitivePair> mPreviousOverlaps;
+    std::vector<PrimitivePair> mBeginOverlaps;
+    std::vector<PrimitivePair> mEndOverlaps;
+    bool mBatchOverlapEvents = false;
 
 };
\ No newline at end of file
@@ -0,0 +1,313 @@
+#if API_VULKAN
+
+#include "Graphics/Vulkan/UiBatcher.h"
+#include "Graphics/Vulkan/VulkanUtils.h"
+#include "Graphics/Vulkan/VulkanContext.h"
+#include "Graphics/Vulkan/PipelineConfigs.h"
+#include "Graphics/Vulkan/DestroyQueue.h"
+
+#include "Nodes/Widgets/Quad.h"
+#include "Nodes/Widgets/Text.h"
+#include "Assets/Texture.h"
+#include "Assets/Font.h"
+#include "Renderer.h"
+#include "Profiler.h"
+#include "Utilities.h"
+#include "Assertion.h"
+#include "Log.h"
+
+// Vertex colors are 8 bits per channel, so only widget colors in [0, 1] can be folded into them.
+static bool CanBakeColor(const glm::vec4& color)
+{
+    return glm::all(glm::greaterThanEqual(color, glm::vec4(0.0f))) &&
+        glm::all(glm::lessThanEqual(color, glm::vec4(1.0f)));
+}
+
+static void BakeVertex(VertexUI& dst, const VertexUI& src, const glm::vec2& position, const glm::mat3& transform, const glm::vec4& color, bool tinted)
+{
+    dst.mPosition = glm::vec2(transform * glm::vec3(position, 1.0f));
+    dst.mTexcoord = src.mTexcoord;
+    dst.mColor = tinted ? ColorFloat4ToUint32(ColorUint32ToFloat4(src.mColor) * color) : src.mColor;
+}
+
+void UiBatcher::Create()
+{
+    GrowVertexBuffer(UI_BATCH_INITIAL_VERTS);
+    mVertices.reserve(UI_BATCH_INITIAL_VERTS);
+}
+
+void UiBatcher::Destroy()
+{
+    if (mVertexBuffer != nullptr)
+    {
+        GetDestroyQueue()->Destroy(mVertexBuffer);
+        mVertexBuffer = nullptr;
+    }
+
+    mCapacity = 0;
+    mVertices.clear();
+}
+
+void UiBatcher::BeginFrame()
+{
+    mVertices.clear();
+    mBatchStart = 0;
+    mBatchImage = nullptr;
+
+    mNumWidgets = 0;
+    mNumDraws = 0;
+    mNumBatchedDraws = 0;
+}
+
+void UiBatcher::BeginPass()
+{
+    OCT_ASSERT(!mActive);
+    mActive = true;
+    mScissorValid = false;
+    mBatchStart = uint32_t(mVertices.size());
+    mBatchImage = nullptr;
+}
+
+void UiBatcher::EndPass()
+{
+    if (!mActive)
+    {
+        return;
+    }
+
+    Flush();
+    UploadVertices();
+
+    mActive = false;
+    mScissorValid = false;
+
+    PublishStats();
+}
+
+bool UiBatcher::IsActive() const
+{
+    return mActive;
+}
+
+bool UiBatcher::AddQuad(Quad* quad)
+{
+    glm::vec4 color = quad->GetColor();
+
+    if (!mActive || !CanBakeColor(color))
+    {
+        return false;
+    }
+
+    Texture* texture = quad->GetTexture() ? quad->GetTexture() : Renderer::Get()->mWhiteTexture.Get<Texture>();
+    const glm::mat3& transform = quad->GetTransform();
+    const VertexUI* srcVerts = quad->GetVertices();
+    bool tinted = (color != glm::vec4(1.0f));
+
+    // The quad's strip (0, 1, 2, 3) becomes the list (0, 1, 2) (2, 1, 3).
+    static const uint32_t kStripToList[6] = { 0, 1, 2, 2, 1, 3 };
+
+    VertexUI* dstVerts = AllocVertices(texture->GetResource()->mImage, 6);
+
+    for (uint32_t i = 0; i < 6; ++i)
+    {
+        const VertexUI& src = srcVerts[kStripToList[i]];
+        BakeVertex(dstVerts[i], src, src.mPosition, transform, color, tinted);
+    }
+
+    mNumWidgets++;
+    return true;
+}
+
+bool UiBatcher::AddText(Text* text)
+{
+    glm::vec4 color = text->GetColor();
+
+    if (!mActive || !CanBakeColor(color))
+    {
+        return false;
+    }
+
+    uint32_t numVerts = TEXT_VERTS_PER_CHAR * text->GetNumVisibleCharacters();
+
+    if (text->GetText().size() == 0 ||
+        text->GetResource()->mVertexBuffer == nullptr ||
+        numVerts == 0)
+    {
+        // Nothing would be drawn.
+        return true;
+    }
+
+    Renderer* renderer = Renderer::Get();
+    Texture* texture = renderer->mWhiteTexture.Get<Texture>();
+    Font* font = text->GetFont();
+
+    if (font != nullptr &&
+        font->GetTexture() != nullptr)
+    {
+        texture = font->GetTexture();
+    }
+
+    // Same math as Text.vert, see BindGeometryDescriptorSet(Text*).
+    int32_t fontSize = font ? font->GetSize() : 32;
+    float scale = text->GetScaledTextSize() / fontSize;
+    glm::vec2 justifiedOffset = text->GetJustifiedOffset();
+    glm::vec2 offset = glm::vec2(text->GetRect().mX, text->GetRect().mY) + justifiedOffset;
+
+    const glm::mat3& transform = text->GetTransform();
+    const VertexUI* srcVerts = text->GetVertices();
+    bool tinted = (color != glm::vec4(1.0f));
+
+    VertexUI* dstVerts = AllocVertices(texture->GetResource()->mImage, numVerts);
+
+    for (uint32_t i = 0; i < numVerts; ++i)
+    {
+        const VertexUI& src = srcVerts[i];
+        BakeVertex(dstVerts[i], src, src.mPosition * scale + offset, transform, color, tinted);
+    }
+
+    mNumWidgets++;
+    return true;
+}
+
+void UiBatcher::Flush()
+{
+    uint32_t numVerts = uint32_t(mVertices.size()) - mBatchStart;
+
+    if (numVerts == 0)
+    {
+        return;
+    }
+
+    OCT_ASSERT(mBatchImage != nullptr);
+    VkCommandBuffer cb = GetCommandBuffer();
+
+    BindPipelineConfig(PipelineConfig::Text);
+
+    VkDeviceSize offset = 0;
+    VkBuffer vertexBuffer = mVertexBuffer->Get();
+    vkCmdBindVertexBuffers(cb, 0, 1, &vertexBuffer, &offset);
+
+    GetVulkanContext()->CommitPipeline();
+
+    // Everything per-widget is already baked into the vertices.
+    TextUniformData ubo = {};
+    ubo.mTransform = glm::mat4(1.0f);
+    ubo.mColor = glm::vec4(1.0f);
+    ubo.mScale = 1.0f;
+    ubo.mPadding1 = 1337;
+    ubo.mPadding2 = 1337;
+    ubo.mDistanceField = false;
+    ubo.mEffect = 0;
+    UniformBlock uniformBlock = WriteUniformBlock(&ubo, sizeof(ubo));
+
+    DescriptorSet::Begin("UI Batch DS")
+        .WriteUniformBuffer(0, uniformBlock)
+        .WriteImage(1, mBatchImage)
+        .Build()
+        .Bind(cb, 1);
+
+    vkCmdDraw(cb, numVerts, 1, mBatchStart, 0);
+
+    mBatchStart = uint32_t(mVertices.size());
+    mBatchImage = nullptr;
+
+    mNumDraws++;
+    mNumBatchedDraws++;
+}
+
+bool UiBatcher::OnScissorChanged(const VkRect2D& rect)
+{
+    // Every widget sets its scissor before drawing, most of them to the same rect.
+    if (mScissorValid &&
+        rect.offset.x == mScissor.offset.x &&
+        rect.offset.y == mScissor.offset.y &&
+        rect.extent.width == mScissor.extent.width &&
+        rect.extent.height == mScissor.extent.height)
+    {
+        return false;
+    }
+
+    // The pending batch was gathered under the old scissor.
+    Flush();
+
+    mScissor = rect;
+    mScissorValid = true;
+    return true;
+}
+
+void UiBatcher::CountUnbatchedDraw()
+{
+    mNumWidgets++;
+    mNumDraws++;
+}
+
+VertexUI* UiBatcher::AllocVertices(Image* image, uint32_t numVerts)
+{
+    OCT_ASSERT(image != nullptr);
+
+    if (image != mBatchImage)
+    {
+        Flush();
+        mBatchImage = image;
+    }
+
+    if (mVertices.size() + numVerts > mCapacity)
+    {
+        // Draws already recorded this frame read from the current buffer, so upload its vertices
+        // and keep it alive until the frame is done. Everything after this goes to a new, larger buffer.
+        Image* batchImage = mBatchImage;
+        Flush();
+        UploadVertices();
+        GrowVertexBuffer(uint32_t(mVertices.size()) + numVerts);
+
+        mVertices.clear();
+        mBatchStart = 0;
+        mBatchImage = batchImage;
+    }
+
+    size_t start = mVertices.size();
+    mVertices.resize(start + numVerts);
+    return &mVertices[start];
+}
+
+void UiBatcher::GrowVertexBuffer(uint32_t minVerts)
+{
+    uint32_t capacity = glm::max<uint32_t>(mCapacity, UI_BATCH_INITIAL_VERTS);
+
+    while (capacity < minVerts)
+    {
+        capacity *= 2;
+    }
+
+    if (mVertexBuffer != nullptr)
+    {
+        LogDebug("Growing UI batch vertex buffer to %u vertices", capacity);
+        GetDestroyQueue()->Destroy(mVertexBuffer);
+        mVertexBuffer = nullptr;
+    }
+
+    mVertexBuffer = new MultiBuffer(BufferType::Vertex, capacity * sizeof(VertexUI), "UI Batch Vertices");
+    mCapacity = capacity;
+}
+
+void UiBatcher::UploadVertices()
+{
+    if (mVertices.size() > 0)
+    {
+        mVertexBuffer->Update(mVertices.data(), mVertices.size() * sizeof(VertexUI), 0);
+    }
+}
+
+void UiBatcher::PublishStats()
+{
+    Profiler* profiler = GetProfiler();
+
+    if (profiler != nullptr)
+    {
+        profiler->SetCounterStat("UI Widgets", mNumWidgets);
+        profiler->SetCounterStat("UI Draws", mNumDraws);
+        profiler->SetCounterStat("UI Batches", mNumBatchedDraws);
+    }
+}
+
+#endif
@@ -0,0 +1,71 @@
+#pragma once
+
+#if API_VULKAN
+
+#include "Graphics/Vulkan/MultiBuffer.h"
+#include "Vertex.h"
+#include "Constants.h"
+
+#include <vulkan/vulkan.h>
+#include <vector>
+
+class Quad;
+class Text;
+class Image;
+
+#define UI_BATCH_INITIAL_VERTS 4096
+
+// Merges consecutive Quad and Text widget draws into as few draws as possible.
+// Each widget's transform, color and text offset/scale are applied to its vertices on the CPU and the
+// result is appended to one shared vertex buffer per frame, which is drawn with the Text pipeline
+// (its shaders reduce to the Quad shaders with an identity transform and white color).
+// A batch is flushed whenever the texture or scissor changes, or a widget that can't be batched is drawn,
+// so widgets still draw in the order they were gathered.
+class UiBatcher
+{
+public:
+
+    void Create();
+    void Destroy();
+
+    void BeginFrame();
+    void BeginPass();
+    void EndPass();
+
+    bool IsActive() const;
+
+    // Returns false if the widget can't be batched and must be drawn on its own.
+    bool AddQuad(Quad* quad);
+    bool AddText(Text* text);
+
+    // Records any pending batch. Call before recording a draw that doesn't go through the batcher.
+    void Flush();
+
+    // Returns false if the scissor is already set to this rect, so setting it again can be skipped.
+    bool OnScissorChanged(const VkRect2D& rect);
+
+    // Counts a UI draw made outside of the batcher.
+    void CountUnbatchedDraw();
+
+private:
+
+    VertexUI* AllocVertices(Image* image, uint32_t numVerts);
+    void GrowVertexBuffer(uint32_t minVerts);
+    void UploadVertices();
+    void PublishStats();
+
+    MultiBuffer* mVertexBuffer = nullptr;
+    std::vector<VertexUI> mVertices;
+    uint32_t mCapacity = 0;
+    uint32_t mBatchStart = 0;
+    Image* mBatchImage = nullptr;
+    VkRect2D mScissor = {};
+    bool mScissorValid = false;
+    bool mActive = false;
+
+    uint32_t mNumWidgets = 0;
+    uint32_t mNumDraws = 0;
+    uint32_t mNumBatchedDraws = 0;
+};
+
+#endif
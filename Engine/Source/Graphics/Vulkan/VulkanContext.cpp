@@ -25,6 +25,7 @@
 #include <string>
 #include <algorithm>
 #include <set>
+#include <unordered_set>
 
 VulkanContext* gVulkanContext = nullptr;
 
@@ -130,6 +131,7 @@ void VulkanContext::Initialize()
     mRayTracer.CreateDynamicRayTraceResources();
 
     mPostProcessChain.Create();
+    mUiBatcher.Create();
 
     CreateCommandBuffers();
     CreateSemaphores();
@@ -241,6 +243,7 @@ void VulkanContext::Destroy()
 
     DestroyRenderPasses();
 
+    mUiBatcher.Destroy();
     DestroyFrameUniformBuffer();
 
     mDestroyQueue.FlushAll();
@@ -321,6 +324,8 @@ void VulkanContext::BeginFrame()
     UpdateGlobalUniformData();
     UpdateGlobalDescriptorSet();
 
+    mUiBatcher.BeginFrame();
+
 #if EDITOR
     ImGui_ImplVulkan_NewFrame();
 #endif
@@ -491,6 +496,13 @@ void VulkanContext::BeginRenderPass(RenderPassId id)
     }
 
     BeginVkRenderPass(rpSetup, barrierNeeded);
+
+#if UI_BATCHING
+    if (mCurrentRenderPassId == RenderPassId::Ui)
+    {
+        mUiBatcher.BeginPass();
+    }
+#endif
 }
 
 void VulkanContext::BeginVkRenderPass(const RenderPassSetup& rpSetup, bool insertBarrier)
@@ -568,6 +580,12 @@ void VulkanContext::EndRenderPass()
         //DeviceWaitIdle();
     }
 
+    if (mCurrentRenderPassId == RenderPassId::Ui)
+    {
+        // Record the last widget batch before Imgui draws on top.
+        mUiBatcher.EndPass();
+    }
+
     if (mCurrentRenderPassId == RenderPassId::Forward)
     {
         // Restore the viewport and scissor in case we were rendering at a different resolution scale.
@@ -2579,6 +2597,11 @@ PostProcessChain* VulkanContext::GetPostProcessChain()
     return &mPostProcessChain;
 }
 
+UiBatcher* VulkanContext::GetUiBatcher()
+{
+    return &mUiBatcher;
+}
+
 VkSurfaceTransformFlagBitsKHR VulkanContext::GetPreTransformFlag() const
 {
     return mPreTransformFlag;
@@ -2699,6 +2722,13 @@ void VulkanContext::SetScissor(int32_t x, int32_t y, int32_t width, int32_t heig
     VkRect2D scissorRect = {};
     scissorRect.offset = { int32_t(scissorData.x), int32_t(scissorData.y )};
     scissorRect.extent = { uint32_t(scissorData.z), uint32_t(scissorData.w )};
+
+    if (mUiBatcher.IsActive() &&
+        !mUiBatcher.OnScissorChanged(scissorRect))
+    {
+        return;
+    }
+
     vkCmdSetScissor(GetCommandBuffer(), 0, 1, &scissorRect);
 }
 
@@ -2714,6 +2744,25 @@ Node3D* VulkanContext::ProcessHitCheck(World* world, int32_t pixelX, int32_t pix
 
     std::vector<Node3D*> nodes;
 
+    // Only primitives whose bounds are under the cursor can be hit, so query the
+    // world's spatial index with the pick ray to avoid rendering every primitive.
+    std::vector<Primitive3D*> rayPrims;
+    std::unordered_set<Node*> hitCandidates;
+    Camera3D* camera = world->GetActiveCamera();
+    const bool filterPrimitives = (camera != nullptr);
+
+    if (filterPrimitives)
+    {
+        glm::vec3 rayStart = camera->ScreenToWorldPosition(pixelX, pixelY);
+        glm::vec3 rayDir = (camera->GetProjectionMode() == ProjectionMode::PERSPECTIVE) ?
+            Maths::SafeNormalize(rayStart - camera->GetWorldPosition()) :
+            camera->GetForwardVector();
+        glm::vec3 rayEnd = rayStart + rayDir * camera->GetFarZ();
+
+        world->GetSpatialIndex().QueryRay(rayStart, rayEnd, rayPrims);
+        hitCandidates.insert(rayPrims.begin(), rayPrims.end());
+    }
+
     // Convert pixelX and pixelY to scene-resolution coordinates
     pixelX = (int32_t)(pixelX * mResolutionScale + 0.5f);
     pixelY = (int32_t)(pixelY * mResolutionScale + 0.5f);
@@ -2751,7 +2800,14 @@ Node3D* VulkanContext::ProcessHitCheck(World* world, int32_t pixelX, int32_t pix
                 // Make foreign nodes select their non-foreign ancestors.
                 uint32_t hitCheckId = node3d->IsForeign() ? node3d->GetParent()->GetHitCheckId() : i;
                 node3d->SetHitCheckId(hitCheckId);
-                node3d->Render(PipelineConfig::HitCheck);
+
+                if (!filterPrimitives ||
+                    !node3d->IsPrimitive3D() ||
+                    hitCandidates.find(node3d) != hitCandidates.end())
+                {
+                    node3d->Render(PipelineConfig::HitCheck);
+                }
+
                 ++i;
 
                 if (Renderer::Get()->IsProxyRenderingEnabled())
@@ -23,6 +23,7 @@
 #include "PipelineCache.h"
 #include "RenderPassCache.h"
 #include "PostProcessChain.h"
+#include "UiBatcher.h"
 
 #if PLATFORM_LINUX
 #include <xcb/xcb.h>
@@ -136,6 +137,7 @@ public:
 
     RayTracer* GetRayTracer();
     PostProcessChain* GetPostProcessChain();
+    UiBatcher* GetUiBatcher();
 
     void RenderPostProcessChain();
 
@@ -315,6 +317,9 @@ private:
     // PostProcess
     PostProcessChain mPostProcessChain;
 
+    // UI
+    UiBatcher mUiBatcher;
+
     // Misc
     int32_t mFrameIndex = 0;
     int32_t mFrameNumber = 0;
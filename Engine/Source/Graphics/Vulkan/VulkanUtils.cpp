@@ -2276,6 +2276,19 @@ void DrawQuad(Quad* quad)
     QuadResource* resource = quad->GetResource();
     VkCommandBuffer cb = GetCommandBuffer();
     VulkanContext* context = GetVulkanContext();
+    UiBatcher* uiBatcher = context->GetUiBatcher();
+
+    if (uiBatcher->IsActive())
+    {
+        if (uiBatcher->AddQuad(quad))
+        {
+            return;
+        }
+
+        // Can't be merged, so draw it on its own after whatever is pending.
+        uiBatcher->Flush();
+        uiBatcher->CountUnbatchedDraw();
+    }
 
     // Make sure to bind the quad pipeline. Quad and text rendering will be interleaved.
     BindPipelineConfig(PipelineConfig::Quad);
@@ -2392,10 +2405,24 @@ void UpdateTextResourceVertexData(Text* text)
 void DrawTextWidget(Text* text)
 {
     TextResource* resource = text->GetResource();
+    UiBatcher* uiBatcher = GetVulkanContext()->GetUiBatcher();
+
+    if (uiBatcher->IsActive() &&
+        uiBatcher->AddText(text))
+    {
+        return;
+    }
 
     if (text->GetText().size() > 0 && resource->mVertexBuffer != nullptr)
     {
         VkCommandBuffer cb = GetCommandBuffer();
+
+        if (uiBatcher->IsActive())
+        {
+            uiBatcher->Flush();
+            uiBatcher->CountUnbatchedDraw();
+        }
+
         BindPipelineConfig(PipelineConfig::Text);
 
         VkDeviceSize offset = 0;
@@ -2498,6 +2525,14 @@ void DrawPoly(Poly* poly)
     if (numVerts > 0)
     {
         VkCommandBuffer cb = GetCommandBuffer();
+        UiBatcher* uiBatcher = GetVulkanContext()->GetUiBatcher();
+
+        // Polys are line strips with their own line width, so they always break the current batch.
+        if (uiBatcher->IsActive())
+        {
+            uiBatcher->Flush();
+            uiBatcher->CountUnbatchedDraw();
+        }
 
         BindPipelineConfig(PipelineConfig::Poly);
 
@@ -40,6 +40,8 @@ int AssetManager_Lua::SaveAsset(lua_State* L)
 int AssetManager_Lua::AsyncLoadAsset(lua_State* L)
 {
     const char* name = CHECK_STRING(L, 1);
+    int32_t priority = 0;
+    if (!lua_isnone(L, 2)) { priority = CHECK_INTEGER(L, 2); }
 
     // Create an Asset_Lua object with a null mAsset member.
     // The async load functionality will fill in the null member after the load as finished.
@@ -47,7 +49,7 @@ int AssetManager_Lua::AsyncLoadAsset(lua_State* L)
     Asset_Lua::Create(L, nullptr, true);
     Asset_Lua* assetLua = (Asset_Lua*) lua_touserdata(L, -1);
 
-    AssetManager::Get()->AsyncLoadAsset(name, &assetLua->mAsset);
+    AssetManager::Get()->AsyncLoadAsset(name, &assetLua->mAsset, priority);
 
     // The newly created Asset_Lua userdata should be on top of the stack.
     return 1;
@@ -83,6 +85,22 @@ int AssetManager_Lua::CreateAndRegisterAsset(lua_State* L)
     return 1;
 }
 
+int AssetManager_Lua::GetLoadStats(lua_State* L)
+{
+    uint64_t bytesRead = AssetManager::Get()->GetNumBytesRead();
+    uint64_t bytesDecoded = AssetManager::Get()->GetNumBytesDecoded();
+
+    lua_pushnumber(L, lua_Number(bytesRead));
+    lua_pushnumber(L, lua_Number(bytesDecoded));
+    return 2;
+}
+
+int AssetManager_Lua::ResetLoadStats(lua_State* L)
+{
+    AssetManager::Get()->ResetLoadStats();
+    return 0;
+}
+
 
 void AssetManager_Lua::Bind()
 {
@@ -106,6 +124,10 @@ void AssetManager_Lua::Bind()
 
     REGISTER_TABLE_FUNC(L, tableIdx, CreateAndRegisterAsset);
 
+    REGISTER_TABLE_FUNC(L, tableIdx, GetLoadStats);
+
+    REGISTER_TABLE_FUNC(L, tableIdx, ResetLoadStats);
+
     lua_setglobal(L, ASSET_MANAGER_LUA_NAME);
     OCT_ASSERT(lua_gettop(L) == 0);
 
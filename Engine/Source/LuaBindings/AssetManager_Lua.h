@@ -15,6 +15,8 @@ struct AssetManager_Lua
     static int AsyncLoadAsset(lua_State* L);
     static int UnloadAsset(lua_State* L);
     static int CreateAndRegisterAsset(lua_State* L);
+    static int GetLoadStats(lua_State* L);
+    static int ResetLoadStats(lua_State* L);
 
     static void Bind();
     static void BindGlobalFunctions();
@@ -11,18 +11,18 @@ Node* CheckNodeWrapper(lua_State* L, int arg)
 {
     luaL_checkudata(L, arg, NODE_WRAPPER_TABLE_NAME);
     Node_Lua* nodeLua = (Node_Lua*)lua_touserdata(L, arg);
+    Node* node = nodeLua->mNode.Get();
 
-    if (nodeLua->mNode == nullptr)
+    if (node == nullptr)
     {
         luaL_error(L, "Attempting to use destroyed node at arg %d", arg);
     }
 
-    return nodeLua->mNode;
+    return node;
 }
 
 Node* CheckNodeLuaType(lua_State* L, int arg, const char* className, const char* classFlag)
 {
-#if LUA_SAFE_NODE
     Node* ret = nullptr;
     Node_Lua* luaObj = static_cast<Node_Lua*>(CheckHierarchyLuaType<Node_Lua>(L, arg, className, classFlag));
 
@@ -36,16 +36,6 @@ Node* CheckNodeLuaType(lua_State* L, int arg, const char* className, const char*
     }
 
     return ret;
-#else
-    Node_Lua* nodeLua = CheckHierarchyLuaType<Node_Lua>(L, arg, className, classFlag);
-
-    if (nodeLua->mNode == nullptr)
-    {
-        luaL_error(L, "Attempting to use destroyed node at arg %d", arg);
-    }
-
-    return nodeLua->mNode;
-#endif
 }
 
 RTTI* CheckRttiLuaType(lua_State* L, int arg)
@@ -59,7 +49,7 @@ RTTI* CheckRttiLuaType(lua_State* L, int arg)
 
     if (isNode)
     {
-        rtti = ((Node_Lua*)lua_touserdata(L, arg))->mNode;
+        rtti = ((Node_Lua*)lua_touserdata(L, arg))->mNode.Get();
     }
     else
     {
@@ -3,6 +3,8 @@
 
 #include "LuaBindings/Network_Lua.h"
 #include "LuaBindings/LuaUtils.h"
+#include "LuaBindings/Node_Lua.h"
+#include "LuaBindings/Vector_Lua.h"
 
 #include "TableDatum.h"
 
@@ -352,6 +354,124 @@ int Network_Lua::IsIncrementalReplicationEnabled(lua_State* L)
     return 1;
 }
 
+int Network_Lua::EnableRelevancy(lua_State* L)
+{
+    bool value = CHECK_BOOLEAN(L, 1);
+
+    NetworkManager::Get()->EnableRelevancy(value);
+
+    return 0;
+}
+
+int Network_Lua::IsRelevancyEnabled(lua_State* L)
+{
+    bool ret = NetworkManager::Get()->IsRelevancyEnabled();
+
+    lua_pushboolean(L, ret);
+    return 1;
+}
+
+int Network_Lua::SetRelevancyRadius(lua_State* L)
+{
+    float value = CHECK_NUMBER(L, 1);
+
+    NetworkManager::Get()->SetRelevancyRadius(value);
+
+    return 0;
+}
+
+int Network_Lua::GetRelevancyRadius(lua_State* L)
+{
+    float ret = NetworkManager::Get()->GetRelevancyRadius();
+
+    lua_pushnumber(L, ret);
+    return 1;
+}
+
+int Network_Lua::SetRelevancyBudget(lua_State* L)
+{
+    uint32_t value = (uint32_t)CHECK_INTEGER(L, 1);
+
+    NetworkManager::Get()->SetRelevancyBudget(value);
+
+    return 0;
+}
+
+int Network_Lua::GetRelevancyBudget(lua_State* L)
+{
+    uint32_t ret = NetworkManager::Get()->GetRelevancyBudget();
+
+    lua_pushinteger(L, (int)ret);
+    return 1;
+}
+
+int Network_Lua::SetClientViewPosition(lua_State* L)
+{
+    NetHostId hostId = (NetHostId)CHECK_INTEGER(L, 1);
+    glm::vec3 position = CHECK_VECTOR(L, 2);
+
+    NetworkManager::Get()->SetClientViewPosition(hostId, position);
+
+    return 0;
+}
+
+int Network_Lua::SetClientViewNode(lua_State* L)
+{
+    NetHostId hostId = (NetHostId)CHECK_INTEGER(L, 1);
+    Node* node = CHECK_NODE(L, 2);
+
+    NetworkManager::Get()->SetClientViewNode(hostId, node);
+
+    return 0;
+}
+
+int Network_Lua::IsRelevant(lua_State* L)
+{
+    NetHostId hostId = (NetHostId)CHECK_INTEGER(L, 1);
+    Node* node = CHECK_NODE(L, 2);
+
+    bool ret = NetworkManager::Get()->IsRelevant(hostId, node);
+
+    lua_pushboolean(L, ret);
+    return 1;
+}
+
+int Network_Lua::EnablePackedReplication(lua_State* L)
+{
+    bool value = CHECK_BOOLEAN(L, 1);
+
+    NetworkManager::Get()->EnablePackedReplication(value);
+
+    return 0;
+}
+
+int Network_Lua::IsPackedReplicationEnabled(lua_State* L)
+{
+    bool ret = NetworkManager::Get()->IsPackedReplicationEnabled();
+
+    lua_pushboolean(L, ret);
+    return 1;
+}
+
+int Network_Lua::SetPositionQuantization(lua_State* L)
+{
+    float extent = CHECK_NUMBER(L, 1);
+    int32_t bits = CHECK_INTEGER(L, 2);
+
+    NetworkManager::Get()->SetPositionQuantization(extent, (uint8_t)glm::clamp(bits, 0, 31));
+
+    return 0;
+}
+
+int Network_Lua::SetRotationQuantization(lua_State* L)
+{
+    int32_t bits = CHECK_INTEGER(L, 1);
+
+    NetworkManager::Get()->SetRotationQuantization((uint8_t)glm::clamp(bits, 0, 31));
+
+    return 0;
+}
+
 int Network_Lua::GetBytesSent(lua_State* L)
 {
     int32_t ret = NetworkManager::Get()->GetBytesSent();
@@ -475,6 +595,16 @@ int Network_Lua::SetKickCallback(lua_State* L)
     return 0;
 }
 
+int Network_Lua::SetRelevancyCallback(lua_State* L)
+{
+    CHECK_FUNCTION(L, 1);
+    ScriptFunc func(L, 1);
+
+    NetworkManager::Get()->SetScriptRelevancyCallback(func);
+
+    return 0;
+}
+
 void Network_Lua::Bind()
 {
     lua_State* L = GetLua();
@@ -520,6 +650,32 @@ void Network_Lua::Bind()
 
     REGISTER_TABLE_FUNC(L, tableIdx, IsIncrementalReplicationEnabled);
 
+    REGISTER_TABLE_FUNC(L, tableIdx, EnableRelevancy);
+
+    REGISTER_TABLE_FUNC(L, tableIdx, IsRelevancyEnabled);
+
+    REGISTER_TABLE_FUNC(L, tableIdx, SetRelevancyRadius);
+
+    REGISTER_TABLE_FUNC(L, tableIdx, GetRelevancyRadius);
+
+    REGISTER_TABLE_FUNC(L, tableIdx, SetRelevancyBudget);
+
+    REGISTER_TABLE_FUNC(L, tableIdx, GetRelevancyBudget);
+
+    REGISTER_TABLE_FUNC(L, tableIdx, SetClientViewPosition);
+
+    REGISTER_TABLE_FUNC(L, tableIdx, SetClientViewNode);
+
+    REGISTER_TABLE_FUNC(L, tableIdx, IsRelevant);
+
+    REGISTER_TABLE_FUNC(L, tableIdx, EnablePackedReplication);
+
+    REGISTER_TABLE_FUNC(L, tableIdx, IsPackedReplicationEnabled);
+
+    REGISTER_TABLE_FUNC(L, tableIdx, SetPositionQuantization);
+
+    REGISTER_TABLE_FUNC(L, tableIdx, SetRotationQuantization);
+
     REGISTER_TABLE_FUNC(L, tableIdx, GetBytesSent);
 
     REGISTER_TABLE_FUNC(L, tableIdx, GetBytesReceived);
@@ -548,6 +704,8 @@ void Network_Lua::Bind()
 
     REGISTER_TABLE_FUNC(L, tableIdx, SetKickCallback);
 
+    REGISTER_TABLE_FUNC(L, tableIdx, SetRelevancyCallback);
+
     lua_setglobal(L, NETWORK_LUA_NAME);
 
     OCT_ASSERT(lua_gettop(L) == 0);
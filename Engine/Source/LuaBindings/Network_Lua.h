@@ -35,6 +35,19 @@ struct Network_Lua
     static int GetNetStatus(lua_State* L);
     static int EnableIncrementalReplication(lua_State* L);
     static int IsIncrementalReplicationEnabled(lua_State* L);
+    static int EnableRelevancy(lua_State* L);
+    static int IsRelevancyEnabled(lua_State* L);
+    static int SetRelevancyRadius(lua_State* L);
+    static int GetRelevancyRadius(lua_State* L);
+    static int SetRelevancyBudget(lua_State* L);
+    static int GetRelevancyBudget(lua_State* L);
+    static int SetClientViewPosition(lua_State* L);
+    static int SetClientViewNode(lua_State* L);
+    static int IsRelevant(lua_State* L);
+    static int EnablePackedReplication(lua_State* L);
+    static int IsPackedReplicationEnabled(lua_State* L);
+    static int SetPositionQuantization(lua_State* L);
+    static int SetRotationQuantization(lua_State* L);
     static int GetBytesSent(lua_State* L);
     static int GetBytesReceived(lua_State* L);
     static int GetUploadRate(lua_State* L);
@@ -51,6 +64,7 @@ struct Network_Lua
     static int SetRejectCallback(lua_State* L);
     static int SetDisconnectCallback(lua_State* L);
     static int SetKickCallback(lua_State* L);
+    static int SetRelevancyCallback(lua_State* L);
 
     static void Bind();
 };
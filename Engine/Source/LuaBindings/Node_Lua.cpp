@@ -160,17 +160,12 @@ int Node_Lua::Destruct(lua_State* L)
 
 int Node_Lua::IsValid(lua_State* L)
 {
-#if LUA_SAFE_NODE
     Node_Lua* luaObj = static_cast<Node_Lua*>(CheckHierarchyLuaType<Node_Lua>(L, 1, NODE_LUA_NAME, NODE_LUA_FLAG));
 
     bool ret = (luaObj->mNode.Get() != nullptr);
 
     lua_pushboolean(L, ret);
     return 1;
-#else
-    lua_pushboolean(L, true);
-    return 1;
-#endif
 }
 
 int Node_Lua::GetName(lua_State* L)
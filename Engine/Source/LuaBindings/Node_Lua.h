@@ -14,11 +14,8 @@
 
 struct Node_Lua
 {
-#if LUA_SAFE_NODE
+    // Scripts can keep a node's userdata after the node is destroyed, so hold a handle rather than a pointer.
     NodeRef mNode;
-#else
-    Node* mNode = nullptr;
-#endif
 
     static int Create(lua_State* L, Node* node);
     static int Construct(lua_State* L);
@@ -442,6 +442,26 @@ int World_Lua::IsInternalEdgeSmoothingEnabled(lua_State* L)
     return 1;
 }
 
+int World_Lua::EnableBatchOverlapEvents(lua_State* L)
+{
+    World* world = CHECK_WORLD(L, 1);
+    bool value = CHECK_BOOLEAN(L, 2);
+
+    world->EnableBatchOverlapEvents(value);
+
+    return 0;
+}
+
+int World_Lua::IsBatchOverlapEventsEnabled(lua_State* L)
+{
+    World* world = CHECK_WORLD(L, 1);
+
+    bool ret = world->IsBatchOverlapEventsEnabled();
+
+    lua_pushboolean(L, ret);
+    return 1;
+}
+
 int World_Lua::SpawnParticle(lua_State* L)
 {
     World* world = CHECK_WORLD(L, 1);
@@ -516,6 +536,10 @@ void World_Lua::Bind()
 
     REGISTER_TABLE_FUNC(L, mtIndex, IsInternalEdgeSmoothingEnabled);
 
+    REGISTER_TABLE_FUNC(L, mtIndex, EnableBatchOverlapEvents);
+
+    REGISTER_TABLE_FUNC(L, mtIndex, IsBatchOverlapEventsEnabled);
+
     REGISTER_TABLE_FUNC(L, mtIndex, SpawnParticle);
 
     // Set the __index metamethod to itself
@@ -53,6 +53,9 @@ struct World_Lua
     static int EnableInternalEdgeSmoothing(lua_State* L);
     static int IsInternalEdgeSmoothingEnabled(lua_State* L);
 
+    static int EnableBatchOverlapEvents(lua_State* L);
+    static int IsBatchOverlapEventsEnabled(lua_State* L);
+
     static int SpawnParticle(lua_State* L);
 
     static void Bind();
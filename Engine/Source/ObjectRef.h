@@ -1,9 +1,10 @@
 #pragma once
 
 #include "Nodes/Node.h"
-#include <vector>
 #include <stdint.h>
 
+// Weak reference that resolves to nullptr once the object is destroyed.
+// Stores a generational handle, so copying, destroying and validating a ref are all O(1).
 template<typename T>
 class ObjectRef
 {
@@ -18,22 +19,16 @@ public:
         Set(object);
     }
 
-    ObjectRef(const ObjectRef<T>& src)
+    ObjectRef(const ObjectRef<T>& src) :
+        mHandle(src.mHandle)
     {
-        Set(src.mObject);
-    }
 
-    ~ObjectRef()
-    {
-        if (mRegistered)
-        {
-            RemoveLiveRef(this);
-        }
     }
 
     ObjectRef& operator=(const ObjectRef<T>& src)
     {
-        return operator=(src.mObject);
+        mHandle = src.mHandle;
+        return *this;
     }
 
     ObjectRef& operator=(const T* srcObject)
@@ -64,73 +59,31 @@ public:
 
     void Set(T* object)
     {
-        mObject = object;
-
-        if (object != nullptr &&
-            !mRegistered)
-        {
-            AddLiveRef(this);
-        }
+        mHandle = (object != nullptr) ? object->GetHandle() : NodeHandle();
     }
 
     T* Get() const
     {
-        return mObject;
+        return static_cast<T*>(T::ResolveHandle(mHandle));
     }
 
-    T*& GetRef()
+    NodeHandle GetHandle() const
     {
-        return mObject;
+        return mHandle;
     }
 
     // For getting a subclass. T must support RTTI
     template<typename S>
     S* Get() const
     {
-        OCT_ASSERT(!mObject || mObject->Is(S::ClassRuntimeId()));
-        return static_cast<S*>(Get());
-    }
-
-    static void EraseReferencesToObject(T* object)
-    {
-        for (uint32_t i = 0; i < sLiveRefs.size(); ++i)
-        {
-            if (sLiveRefs[i]->Get() == object)
-            {
-                sLiveRefs[i]->Set(nullptr);
-            }
-        }
+        T* object = Get();
+        OCT_ASSERT(!object || object->Is(S::ClassRuntimeId()));
+        return static_cast<S*>(object);
     }
 
 private:
 
-    static void AddLiveRef(ObjectRef* ref)
-    {
-        sLiveRefs.push_back(ref);
-        ref->mRegistered = true;
-    }
-
-    static void RemoveLiveRef(ObjectRef* ref)
-    {
-        for (uint32_t i = 0; i < sLiveRefs.size(); ++i)
-        {
-            if (sLiveRefs[i] == ref)
-            {
-                sLiveRefs.erase(sLiveRefs.begin() + i);
-                ref->mRegistered = false;
-                break;
-            }
-        }
-    }
-
-    static std::vector<ObjectRef*> sLiveRefs;
-
-    T* mObject = nullptr;
-    bool mRegistered = false;
+    NodeHandle mHandle;
 };
 
 typedef ObjectRef<Node> NodeRef;
-
-template <typename T>
-std::vector<ObjectRef<T>*> ObjectRef<T>::sLiveRefs;
-
@@ -112,6 +112,30 @@ void SYS_ReleaseFileData(char* data)
     }
 }
 
+bool SYS_MapFile(const char* path, bool isAsset, MappedFile& outFile)
+{
+    // No memory mapping here, so just read the whole file.
+    char* data = nullptr;
+    uint32_t size = 0;
+    SYS_AcquireFileData(path, isAsset, 0, data, size);
+
+    outFile.mData = data;
+    outFile.mSize = size;
+    outFile.mCopied = true;
+
+    return (data != nullptr);
+}
+
+void SYS_UnmapFile(MappedFile& file)
+{
+    if (file.mCopied)
+    {
+        SYS_ReleaseFileData(const_cast<char*>(file.mData));
+    }
+
+    file = MappedFile();
+}
+
 std::string SYS_GetCurrentDirectoryPath()
 {
     char path[MAX_PATH_SIZE] = {};
@@ -307,6 +331,28 @@ void SYS_DestroyMutex(MutexObject* mutex)
     delete mutex;
 }
 
+SemaphoreObject* SYS_CreateSemaphore(uint32_t initialCount)
+{
+    SemaphoreObject* retSemaphore = new SemaphoreObject();
+    LightSemaphore_Init(retSemaphore, int16_t(initialCount), INT16_MAX);
+    return retSemaphore;
+}
+
+void SYS_WaitSemaphore(SemaphoreObject* semaphore)
+{
+    LightSemaphore_Acquire(semaphore, 1);
+}
+
+void SYS_SignalSemaphore(SemaphoreObject* semaphore, uint32_t count)
+{
+    LightSemaphore_Release(semaphore, int32_t(count));
+}
+
+void SYS_DestroySemaphore(SemaphoreObject* semaphore)
+{
+    delete semaphore;
+}
+
 void SYS_Sleep(uint32_t milliseconds)
 {
     svcSleepThread(milliseconds * 1000 * 1000);
@@ -156,6 +156,30 @@ void SYS_ReleaseFileData(char* data)
     }
 }
 
+bool SYS_MapFile(const char* path, bool isAsset, MappedFile& outFile)
+{
+    // No memory mapping here, so just read the whole file.
+    char* data = nullptr;
+    uint32_t size = 0;
+    SYS_AcquireFileData(path, isAsset, 0, data, size);
+
+    outFile.mData = data;
+    outFile.mSize = size;
+    outFile.mCopied = true;
+
+    return (data != nullptr);
+}
+
+void SYS_UnmapFile(MappedFile& file)
+{
+    if (file.mCopied)
+    {
+        SYS_ReleaseFileData(const_cast<char*>(file.mData));
+    }
+
+    file = MappedFile();
+}
+
 std::string SYS_GetCurrentDirectoryPath()
 {
     char path[MAX_PATH_SIZE] = {};
@@ -340,6 +364,38 @@ void SYS_DestroyMutex(MutexObject* mutex)
     delete mutex;
 }
 
+SemaphoreObject* SYS_CreateSemaphore(uint32_t initialCount)
+{
+    SemaphoreObject* retSemaphore = new SemaphoreObject();
+    int32_t status = LWP_SemInit(retSemaphore, initialCount, 0xffffffff);
+
+    if (status < 0)
+    {
+        LogError("Failed to create Semaphore");
+    }
+
+    return retSemaphore;
+}
+
+void SYS_WaitSemaphore(SemaphoreObject* semaphore)
+{
+    LWP_SemWait(*semaphore);
+}
+
+void SYS_SignalSemaphore(SemaphoreObject* semaphore, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        LWP_SemPost(*semaphore);
+    }
+}
+
+void SYS_DestroySemaphore(SemaphoreObject* semaphore)
+{
+    LWP_SemDestroy(*semaphore);
+    delete semaphore;
+}
+
 void SYS_Sleep(uint32_t milliseconds)
 {
     // Uh... not sure how to sleep for a given duration.
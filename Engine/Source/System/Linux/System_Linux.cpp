@@ -14,6 +14,9 @@
 #include <string>
 #include <assert.h>
 #include <signal.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
 
 #if EDITOR
 #include "imgui.h"
@@ -563,6 +566,51 @@ void SYS_ReleaseFileData(char* data)
     }
 }
 
+bool SYS_MapFile(const char* path, bool isAsset, MappedFile& outFile)
+{
+    outFile = MappedFile();
+
+    int fd = open(path, O_RDONLY);
+
+    if (fd < 0)
+    {
+        LogError("Failed to open file: %s", path);
+        return false;
+    }
+
+    struct stat fileStat;
+    void* data = MAP_FAILED;
+
+    if (fstat(fd, &fileStat) == 0 &&
+        fileStat.st_size > 0)
+    {
+        data = mmap(nullptr, size_t(fileStat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+
+    // The mapping stays valid after the descriptor is closed.
+    close(fd);
+
+    if (data == MAP_FAILED)
+    {
+        LogError("Failed to map file: %s", path);
+        return false;
+    }
+
+    outFile.mData = (const char*)data;
+    outFile.mSize = uint32_t(fileStat.st_size);
+    return true;
+}
+
+void SYS_UnmapFile(MappedFile& file)
+{
+    if (file.mData != nullptr)
+    {
+        munmap((void*)file.mData, file.mSize);
+    }
+
+    file = MappedFile();
+}
+
 std::string SYS_GetCurrentDirectoryPath()
 {
     char path[MAX_PATH_SIZE] = {};
@@ -788,6 +836,39 @@ void SYS_DestroyMutex(MutexObject* mutex)
     delete mutex;
 }
 
+SemaphoreObject* SYS_CreateSemaphore(uint32_t initialCount)
+{
+    SemaphoreObject* retSemaphore = new SemaphoreObject();
+    int status = sem_init(retSemaphore, 0, initialCount);
+
+    if (status != 0)
+    {
+        LogError("Failed to create Semaphore");
+    }
+
+    return retSemaphore;
+}
+
+void SYS_WaitSemaphore(SemaphoreObject* semaphore)
+{
+    // Retry if the wait is interrupted by a signal handler.
+    while (sem_wait(semaphore) != 0 && errno == EINTR) {}
+}
+
+void SYS_SignalSemaphore(SemaphoreObject* semaphore, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        sem_post(semaphore);
+    }
+}
+
+void SYS_DestroySemaphore(SemaphoreObject* semaphore)
+{
+    sem_destroy(semaphore);
+    delete semaphore;
+}
+
 void SYS_Sleep(uint32_t milliseconds)
 {
     usleep(milliseconds * 1000);
@@ -16,6 +16,8 @@ void SYS_Update();
 bool SYS_DoesFileExist(const char* path, bool isAsset);
 void SYS_AcquireFileData(const char* path, bool isAsset, int32_t maxSize, char*& outData, uint32_t& outSize);
 void SYS_ReleaseFileData(char* data);
+bool SYS_MapFile(const char* path, bool isAsset, MappedFile& outFile);
+void SYS_UnmapFile(MappedFile& file);
 std::string SYS_GetCurrentDirectoryPath();
 std::string SYS_GetAbsolutePath(const std::string& relativePath);
 void SYS_SetWorkingDirectory(const std::string& dirPath);
@@ -38,6 +40,10 @@ MutexObject* SYS_CreateMutex();
 void SYS_LockMutex(MutexObject* mutex);
 void SYS_UnlockMutex(MutexObject* mutex);
 void SYS_DestroyMutex(MutexObject* mutex);
+SemaphoreObject* SYS_CreateSemaphore(uint32_t initialCount);
+void SYS_WaitSemaphore(SemaphoreObject* semaphore);
+void SYS_SignalSemaphore(SemaphoreObject* semaphore, uint32_t count = 1);
+void SYS_DestroySemaphore(SemaphoreObject* semaphore);
 void SYS_Sleep(uint32_t milliseconds);
 
 // Time
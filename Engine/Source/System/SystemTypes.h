@@ -14,6 +14,7 @@
 #include <unistd.h>
 #include <xcb/xcb.h>
 #include <pthread.h>
+#include <semaphore.h>
 #elif PLATFORM_ANDROID
 #include <stdio.h>
 #include <dirent.h>
@@ -21,8 +22,10 @@
 #include <sys/stat.h>
 #include <unistd.h>
 #include <pthread.h>
+#include <semaphore.h>
 #include <android/native_window.h>
 #include <android/native_activity.h>
+#include <android/asset_manager.h>
 #include <android_native_app_glue.h>
 #elif PLATFORM_DOLPHIN
 #include <gccore.h>
@@ -39,18 +42,22 @@
 #if PLATFORM_WINDOWS
 typedef HANDLE ThreadObject;
 typedef HANDLE MutexObject;
+typedef HANDLE SemaphoreObject;
 typedef DWORD ThreadFuncRet;
 #elif (PLATFORM_LINUX || PLATFORM_ANDROID)
 typedef pthread_t ThreadObject;
 typedef pthread_mutex_t MutexObject;
+typedef sem_t SemaphoreObject;
 typedef void* ThreadFuncRet;
 #elif PLATFORM_DOLPHIN
 typedef lwp_t ThreadObject;
 typedef uint32_t MutexObject;
+typedef sem_t SemaphoreObject;
 typedef void* ThreadFuncRet;
 #elif PLATFORM_3DS
 typedef Thread ThreadObject;
 typedef uint32_t MutexObject;
+typedef LightSemaphore SemaphoreObject;
 typedef void ThreadFuncRet;
 #endif
 
@@ -90,6 +97,24 @@ struct DirEntry
 #endif
 };
 
+// A read-only view of a whole file. On platforms that support it, the data is memory mapped
+// so pages are only brought in when touched. Otherwise the file is read into memory.
+struct MappedFile
+{
+    const char* mData = nullptr;
+    uint32_t mSize = 0;
+
+    // True when the data was read into a heap buffer instead of being mapped.
+    bool mCopied = false;
+
+#if PLATFORM_WINDOWS
+    HANDLE mFileHandle = INVALID_HANDLE_VALUE;
+    HANDLE mMappingHandle = nullptr;
+#elif PLATFORM_ANDROID
+    AAsset* mAsset = nullptr;
+#endif
+};
+
 struct SystemState
 {
 #if PLATFORM_WINDOWS
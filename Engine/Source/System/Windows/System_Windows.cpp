@@ -411,6 +411,65 @@ void SYS_ReleaseFileData(char* data)
     }
 }
 
+bool SYS_MapFile(const char* path, bool isAsset, MappedFile& outFile)
+{
+    outFile = MappedFile();
+
+    HANDLE fileHandle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+    if (fileHandle == INVALID_HANDLE_VALUE)
+    {
+        LogError("Failed to open file: %s", path);
+        return false;
+    }
+
+    LARGE_INTEGER fileSize = {};
+    HANDLE mappingHandle = nullptr;
+    const void* data = nullptr;
+
+    if (GetFileSizeEx(fileHandle, &fileSize) &&
+        fileSize.QuadPart > 0)
+    {
+        mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    }
+
+    if (mappingHandle != nullptr)
+    {
+        data = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+    }
+
+    if (data == nullptr)
+    {
+        LogError("Failed to map file: %s", path);
+
+        if (mappingHandle != nullptr)
+        {
+            CloseHandle(mappingHandle);
+        }
+
+        CloseHandle(fileHandle);
+        return false;
+    }
+
+    outFile.mData = (const char*)data;
+    outFile.mSize = uint32_t(fileSize.QuadPart);
+    outFile.mFileHandle = fileHandle;
+    outFile.mMappingHandle = mappingHandle;
+    return true;
+}
+
+void SYS_UnmapFile(MappedFile& file)
+{
+    if (file.mData != nullptr)
+    {
+        UnmapViewOfFile(file.mData);
+        CloseHandle(file.mMappingHandle);
+        CloseHandle(file.mFileHandle);
+    }
+
+    file = MappedFile();
+}
+
 std::string SYS_GetCurrentDirectoryPath()
 {
     char path[MAX_PATH_SIZE] = {};
@@ -741,6 +800,43 @@ void SYS_DestroyMutex(MutexObject* mutex)
     delete mutex;
 }
 
+SemaphoreObject* SYS_CreateSemaphore(uint32_t initialCount)
+{
+    SemaphoreObject* retSemaphore = new SemaphoreObject();
+
+    *retSemaphore = CreateSemaphore(
+        NULL,                   // default security attributes
+        LONG(initialCount),     // initial count
+        LONG_MAX,               // maximum count
+        NULL);                  // unnamed semaphore
+
+    if (*retSemaphore == 0)
+    {
+        LogError("Failed to create Semaphore");
+    }
+
+    return retSemaphore;
+}
+
+void SYS_WaitSemaphore(SemaphoreObject* semaphore)
+{
+    WaitForSingleObject(*semaphore, INFINITE);
+}
+
+void SYS_SignalSemaphore(SemaphoreObject* semaphore, uint32_t count)
+{
+    if (!ReleaseSemaphore(*semaphore, LONG(count), nullptr))
+    {
+        LogError("Error releasing semaphore");
+    }
+}
+
+void SYS_DestroySemaphore(SemaphoreObject* semaphore)
+{
+    CloseHandle(*semaphore);
+    delete semaphore;
+}
+
 void SYS_Sleep(uint32_t milliseconds)
 {
     Sleep(milliseconds);